@@ -231,8 +231,10 @@ void HelloCubeApplication::Run()
                 .texture = graphics->GetCurrentPresentTexture(),
             } };
 
-            vex::BindlessHandle uvGuideHandle = graphics->GetBindlessHandle(
-                vex::TextureBinding{ .texture = uvGuideTexture, .usage = vex::TextureBindingUsage::ShaderRead });
+            // The texture is read through its bindless handle, tracking it transitions it for the draws.
+            vex::TextureBinding uvGuideBinding{ .texture = uvGuideTexture,
+                                                .usage = vex::TextureBindingUsage::ShaderRead };
+            vex::BindlessHandle uvGuideHandle = graphics->GetBindlessHandle(uvGuideBinding);
 
             struct UniformData
             {
@@ -249,7 +251,7 @@ void HelloCubeApplication::Run()
                                     .indexBuffer = indexBufferBinding,
                                 },
                                 vex::ConstantBinding(UniformData{ static_cast<float>(currentTime), uvGuideHandle }),
-                                {},
+                                { uvGuideBinding },
                                 IndexCount);
             }
             {
@@ -263,7 +265,7 @@ void HelloCubeApplication::Run()
                                 },
                                 vex::ConstantBinding(
                                     UniformData{ static_cast<float>(currentTime), uvGuideHandle }),
-                                {},
+                                { uvGuideBinding },
                                 IndexCount);
             }
             graphics->Submit(ctx);
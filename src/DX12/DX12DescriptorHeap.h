@@ -83,6 +83,27 @@ public:
         return heap;
     }
 
+    // Shader visible heaps cannot be resized in place: they cannot be the source of a descriptor copy, and the GPU
+    // might still be using them.
+    void Resize(u32 newSize)
+        requires(Flags == HeapFlags::NONE)
+    {
+        // DescriptorHeaps cannot resize downwards.
+        if (newSize <= size)
+        {
+            return;
+        }
+
+        ComPtr<ID3D12DescriptorHeap> newHeap = CreateHeap(device, newSize, name);
+        device->CopyDescriptorsSimple(size,
+                                      newHeap->GetCPUDescriptorHandleForHeapStart(),
+                                      heap->GetCPUDescriptorHandleForHeapStart(),
+                                      static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(Type));
+
+        size = newSize;
+        heap = newHeap;
+    }
+
 private:
     static ComPtr<ID3D12DescriptorHeap> CreateHeap(ComPtr<DX12Device>& device, u32 size, const std::string& name)
     {
@@ -105,26 +126,6 @@ private:
         return heap;
     }
 
-    // Resizing a GPU-Visible heap is not supported (avoids having to handle synchronization).
-    void Resize(u32 newSize)
-        requires(Flags == HeapFlags::NONE)
-    {
-        // DescriptorHeaps cannot resize downwards.
-        if (newSize <= size)
-        {
-            return;
-        }
-
-        ComPtr<ID3D12DescriptorHeap> newHeap = CreateHeap(device, newSize, name);
-        device->CopyDescriptorsSimple(size,
-                                      newHeap->GetCPUDescriptorHandleForHeapStart(),
-                                      heap->GetCPUDescriptorHandleForHeapStart(),
-                                      static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(Type));
-
-        size = newSize;
-        heap = newHeap;
-    }
-
     ComPtr<DX12Device> device;
     std::string name;
 
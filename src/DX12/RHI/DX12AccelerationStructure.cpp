@@ -33,8 +33,10 @@ const RHIAccelerationStructureBuildInfo& DX12AccelerationStructure::SetupBLASBui
 
     prebuildInfo = {
         .asByteSize = dx12PrebuildInfo.ResultDataMaxSizeInBytes,
-        .scratchByteSize = dx12PrebuildInfo.ScratchDataSizeInBytes,
-        .updateScratchByteSize = dx12PrebuildInfo.UpdateScratchDataSizeInBytes,
+        .scratchByteSize = AlignUp<u64>(dx12PrebuildInfo.ScratchDataSizeInBytes,
+                                        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT),
+        .updateScratchByteSize = AlignUp<u64>(dx12PrebuildInfo.UpdateScratchDataSizeInBytes,
+                                              D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT),
     };
 
     // Create the actual AS buffer.
@@ -54,6 +56,7 @@ const RHIAccelerationStructureBuildInfo& DX12AccelerationStructure::SetupTLASBui
 {
     VEX_ASSERT(!accelerationStructure.has_value(),
                "Cannot call setup when the acceleration structure is already setup!");
+    instanceCount = static_cast<u32>(desc.instances.size());
 
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS buildInputs{
         .Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL,
@@ -66,8 +69,10 @@ const RHIAccelerationStructureBuildInfo& DX12AccelerationStructure::SetupTLASBui
 
     prebuildInfo = {
         .asByteSize = dx12PrebuildInfo.ResultDataMaxSizeInBytes,
-        .scratchByteSize = dx12PrebuildInfo.ScratchDataSizeInBytes,
-        .updateScratchByteSize = dx12PrebuildInfo.UpdateScratchDataSizeInBytes,
+        .scratchByteSize = AlignUp<u64>(dx12PrebuildInfo.ScratchDataSizeInBytes,
+                                        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT),
+        .updateScratchByteSize = AlignUp<u64>(dx12PrebuildInfo.UpdateScratchDataSizeInBytes,
+                                              D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT),
     };
 
     // Create the actual AS buffer.
@@ -82,6 +87,36 @@ const RHIAccelerationStructureBuildInfo& DX12AccelerationStructure::SetupTLASBui
     return prebuildInfo;
 }
 
+void DX12AccelerationStructure::SetupBLASUpdate(const RHIBLASBuildDesc& desc)
+{
+    VEX_ASSERT(accelerationStructure.has_value(), "Cannot update an acceleration structure which was never built!");
+    VEX_ASSERT(desc.geometries.size() == geometryDescs.size(),
+               "Cannot update a BLAS with a different geometry count than the one it was built with.");
+    InitRayTracingGeometryDesc(desc);
+}
+
+void DX12AccelerationStructure::SetupTLASUpdate(const RHITLASBuildDesc& desc)
+{
+    VEX_ASSERT(accelerationStructure.has_value(), "Cannot update an acceleration structure which was never built!");
+    // The instances are read from the instance buffer passed in when recording the update.
+    VEX_ASSERT(desc.instances.size() == instanceCount,
+               "Cannot update a TLAS with a different instance count than the one it was built with.");
+}
+
+void DX12AccelerationStructure::SetupCompaction(RHIAllocator& allocator, u64 compactedByteSize)
+{
+    VEX_ASSERT(!accelerationStructure.has_value(),
+               "Cannot call setup when the acceleration structure is already setup!");
+
+    BufferDesc asDesc{
+        .name = GetDesc().name,
+        .byteSize = compactedByteSize,
+        .usage = BufferUsage::AccelerationStructure,
+        .memoryLocality = ResourceMemoryLocality::GPUOnly,
+    };
+    accelerationStructure = RHIBuffer(device, allocator, asDesc);
+}
+
 std::vector<std::byte> DX12AccelerationStructure::GetInstanceBufferData(const RHITLASBuildDesc& desc)
 {
     std::vector<D3D12_RAYTRACING_INSTANCE_DESC> instanceDescs;
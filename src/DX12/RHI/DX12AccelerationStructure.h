@@ -24,6 +24,11 @@ public:
     virtual const RHIAccelerationStructureBuildInfo& SetupTLASBuild(RHIAllocator& allocator,
                                                                     const RHITLASBuildDesc& desc) override;
 
+    virtual void SetupBLASUpdate(const RHIBLASBuildDesc& desc) override;
+    virtual void SetupTLASUpdate(const RHITLASBuildDesc& desc) override;
+
+    virtual void SetupCompaction(RHIAllocator& allocator, u64 compactedByteSize) override;
+
     virtual std::vector<std::byte> GetInstanceBufferData(const RHITLASBuildDesc& desc) override;
     virtual u32 GetInstanceBufferStride() override;
 
@@ -32,6 +37,8 @@ private:
 
     ComPtr<DX12Device> device;
     std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometryDescs;
+    // Instance count of the TLAS, which updates must keep.
+    u32 instanceCount = 0;
 };
 
 D3D12_RAYTRACING_GEOMETRY_FLAGS ASGeometryFlagsToDX12GeometryFlags(ASGeometry::Flags flags);
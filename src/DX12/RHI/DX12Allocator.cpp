@@ -20,7 +20,9 @@ Allocation DX12Allocator::AllocateResource(ComPtr<ID3D12Resource>& resource,
                                            HeapType heapType,
                                            u64 forcedAlignment,
                                            D3D12_BARRIER_LAYOUT initialLayout,
-                                           std::optional<D3D12_CLEAR_VALUE> optionalClearValue)
+                                           std::optional<D3D12_CLEAR_VALUE> optionalClearValue,
+                                           ResourceLifetime lifetime,
+                                           TransientMemoryPool* transientPool)
 {
     // Query device for the byte size and alignment of the resource.
     // We cannot compute this ourselves as this depends on hardware/vendors.
@@ -35,7 +37,8 @@ Allocation DX12Allocator::AllocateResource(ComPtr<ID3D12Resource>& resource,
 
     // Allocates and handles finding an optimal place to allocate the memory.
     // No api calls will be made if a valid MemoryRange is already available, making this super fast!
-    Allocation allocation = Allocate(allocInfo.SizeInBytes, allocInfo.Alignment, std::to_underlying(heapType));
+    Allocation allocation =
+        Allocate(allocInfo.SizeInBytes, allocInfo.Alignment, std::to_underlying(heapType), lifetime, transientPool);
 
 #define VEX_DX12_ALLOCATOR_DEBUG_OVERLAPS 0
 #define VEX_DX12_ALLOCATOR_DEBUG_ALLOCATIONS 0
@@ -23,7 +23,9 @@ public:
                                 HeapType heapType,
                                 u64 forcedAlignment = 0,
                                 D3D12_BARRIER_LAYOUT initialLayout = D3D12_BARRIER_LAYOUT_UNDEFINED,
-                                std::optional<D3D12_CLEAR_VALUE> optionalClearValue = std::nullopt);
+                                std::optional<D3D12_CLEAR_VALUE> optionalClearValue = std::nullopt,
+                                ResourceLifetime lifetime = ResourceLifetime::Static,
+                                TransientMemoryPool* transientPool = nullptr);
     void FreeResource(const Allocation& allocation);
 
 protected:
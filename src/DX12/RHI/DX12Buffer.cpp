@@ -14,8 +14,11 @@
 namespace vex::dx12
 {
 
-DX12Buffer::DX12Buffer(ComPtr<DX12Device>& device, RHIAllocator& allocator, const BufferDesc& desc)
-    : RHIBufferBase(allocator, desc)
+DX12Buffer::DX12Buffer(ComPtr<DX12Device>& device,
+                       RHIAllocator& allocator,
+                       const BufferDesc& desc,
+                       ResourceLifetime lifetime)
+    : RHIBufferBase(allocator, desc, lifetime)
     , device(device)
 {
     u64 size = desc.byteSize;
@@ -89,7 +92,13 @@ DX12Buffer::DX12Buffer(ComPtr<DX12Device>& device, RHIAllocator& allocator, cons
         bufferDesc.Flags |= D3D12_RESOURCE_FLAG_USE_TIGHT_ALIGNMENT;
     }
 
-    allocation = allocator.AllocateResource(buffer, bufferDesc, desc.memoryLocality, forcedAlignment);
+    allocation = allocator.AllocateResource(buffer,
+                                            bufferDesc,
+                                            desc.memoryLocality,
+                                            forcedAlignment,
+                                            D3D12_BARRIER_LAYOUT_UNDEFINED,
+                                            std::nullopt,
+                                            lifetime);
 #else
     chk << device->CreateCommittedResource3(&heapProps,
                                             D3D12_HEAP_FLAG_NONE,
@@ -249,6 +258,8 @@ void DX12Buffer::AllocateBindlessHandle(RHIDescriptorPool& descriptorPool,
 
         device->CreateUnorderedAccessView(buffer.Get(), nullptr, &uavDesc, cpuHandle);
     }
+
+    descriptorPool.CommitDescriptor(handle);
 }
 
 } // namespace vex::dx12
@@ -18,7 +18,10 @@ namespace vex::dx12
 class DX12Buffer final : public RHIBufferBase
 {
 public:
-    DX12Buffer(ComPtr<DX12Device>& device, RHIAllocator& allocator, const BufferDesc& desc);
+    DX12Buffer(ComPtr<DX12Device>& device,
+               RHIAllocator& allocator,
+               const BufferDesc& desc,
+               ResourceLifetime lifetime = ResourceLifetime::Static);
     virtual void AllocateBindlessHandle(RHIDescriptorPool& descriptorPool,
                                         BindlessHandle handle,
                                         const BufferViewDesc& viewDesc) override;
@@ -178,7 +178,7 @@ void DX12CommandList::SetPipelineState(const RHIRayTracingPipelineState& rayTrac
     commandList->SetPipelineState1(rayTracingPipelineState.stateObject.Get());
 }
 
-void DX12CommandList::SetLayout(RHIResourceLayout& layout)
+void DX12CommandList::SetLayout(RHIResourceLayout& layout, Span<const byte> localConstantsData)
 {
     ID3D12RootSignature* globalRootSignature = layout.GetRootSignature().Get();
 
@@ -194,7 +194,6 @@ void DX12CommandList::SetLayout(RHIResourceLayout& layout)
         break;
     }
 
-    Span<const byte> localConstantsData = layout.GetLocalConstantsData();
     if (localConstantsData.empty())
     {
         return;
@@ -330,6 +329,42 @@ void DX12CommandList::EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
                                    Span<const RHITextureBarrier> textureBarriers,
                                    Span<const RHIGlobalBarrier> globalBarriers)
 {
+    RecordBarriers(bufferBarriers, textureBarriers, globalBarriers, BarrierSplit::None);
+}
+
+u32 DX12CommandList::BeginSplitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                        Span<const RHITextureBarrier> textureBarriers)
+{
+    RecordBarriers(bufferBarriers, textureBarriers, {}, BarrierSplit::Begin);
+    // DX12 matches the end of split barriers using their resources, no index is required.
+    return 0;
+}
+
+void DX12CommandList::EndSplitBarriers(u32 splitBarrierIndex,
+                                       Span<const RHIBufferBarrier> bufferBarriers,
+                                       Span<const RHITextureBarrier> textureBarriers)
+{
+    RecordBarriers(bufferBarriers, textureBarriers, {}, BarrierSplit::End);
+}
+
+void DX12CommandList::RecordBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                     Span<const RHITextureBarrier> textureBarriers,
+                                     Span<const RHIGlobalBarrier> globalBarriers,
+                                     BarrierSplit split)
+{
+    // The begin of a split barrier synchronizes with the previous accesses, its end with the next accesses.
+    const auto ApplySplit = [split](auto& dx12Barrier)
+    {
+        if (split == BarrierSplit::Begin)
+        {
+            dx12Barrier.SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+        }
+        else if (split == BarrierSplit::End)
+        {
+            dx12Barrier.SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+        }
+    };
+
     std::vector<D3D12_BUFFER_BARRIER> dx12BufferBarriers;
     dx12BufferBarriers.reserve(bufferBarriers.size());
     for (const auto& bb : bufferBarriers)
@@ -345,6 +380,7 @@ void DX12CommandList::EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
         // Buffer range - for now, barrier entire buffer.
         dx12Barrier.Offset = 0;
         dx12Barrier.Size = std::numeric_limits<u64>::max();
+        ApplySplit(dx12Barrier);
         dx12BufferBarriers.push_back(std::move(dx12Barrier));
     }
 
@@ -391,6 +427,19 @@ void DX12CommandList::EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
 
         const auto& desc = tb.texture->GetDesc();
 
+        // Leaving the undefined layout discards the contents of the texture, only the synchronization with the previous
+        // accesses to its memory is kept (eg: those of an aliased transient texture).
+        D3D12_TEXTURE_BARRIER_FLAGS barrierFlags = D3D12_TEXTURE_BARRIER_FLAG_NONE;
+        if (dx12Barrier.LayoutBefore == D3D12_BARRIER_LAYOUT_UNDEFINED)
+        {
+            dx12Barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+            // RT/DS compatible placed resources must have their metadata initialized before use.
+            if (type != QueueType::Copy && desc.usage & (TextureUsage::RenderTarget | TextureUsage::DepthStencil))
+            {
+                barrierFlags = D3D12_TEXTURE_BARRIER_FLAG_DISCARD;
+            }
+        }
+
         // Handle binding subresource, to allow for a transition per-mip / per-slice.
         dx12Barrier.Subresources.IndexOrFirstMipLevel = tb.subresource.startMip;
         dx12Barrier.Subresources.NumMipLevels = tb.subresource.GetMipCount(desc);
@@ -398,7 +447,8 @@ void DX12CommandList::EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
         dx12Barrier.Subresources.NumArraySlices = tb.subresource.GetSliceCount(desc);
         dx12Barrier.Subresources.FirstPlane = tb.subresource.GetStartPlane(desc);
         dx12Barrier.Subresources.NumPlanes = tb.subresource.GetPlaneCount(desc);
-        dx12Barrier.Flags = D3D12_TEXTURE_BARRIER_FLAG_NONE;
+        dx12Barrier.Flags = barrierFlags;
+        ApplySplit(dx12Barrier);
         dx12TextureBarriers.push_back(std::move(dx12Barrier));
     }
 
@@ -509,6 +559,26 @@ void DX12CommandList::DrawIndexed(
     commandList->DrawIndexedInstanced(indexCount, instanceCount, indexOffset, vertexOffset, instanceOffset);
 }
 
+void DX12CommandList::DrawIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    if (type != QueueType::Graphics)
+    {
+        VEX_LOG(Fatal, "Cannot use draw calls with a non-graphics command queue.");
+    }
+
+    ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, indirectArgs);
+}
+
+void DX12CommandList::DrawIndexedIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    if (type != QueueType::Graphics)
+    {
+        VEX_LOG(Fatal, "Cannot use draw calls with a non-graphics command queue.");
+    }
+
+    ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, indirectArgs);
+}
+
 void DX12CommandList::SetVertexBuffers(u32 startSlot, Span<const RHIBufferBinding> vertexBuffers)
 {
     if (type != QueueType::Graphics)
@@ -551,6 +621,16 @@ void DX12CommandList::Dispatch(const std::array<u32, 3>& groupCount)
     }
 }
 
+void DX12CommandList::DispatchIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    if (type == QueueType::Copy)
+    {
+        VEX_LOG(Fatal, "Cannot use dispatch with a non-compute capable command queue.");
+    }
+
+    ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, indirectArgs);
+}
+
 void DX12CommandList::TraceRays(const TraceRaysDesc& rayTracingArgs,
                                 const RHIRayTracingPipelineState& rayTracingPipelineState)
 {
@@ -682,51 +762,122 @@ void DX12CommandList::ResolveTimestampQueries(u32 firstQuery, u32 queryCount)
                                   firstQuery * sizeof(u64));
 }
 
-void DX12CommandList::BuildBLAS(RHIAccelerationStructure& as, RHIBuffer& scratchBuffer)
+void DX12CommandList::BuildBLAS(Span<const RHIBLASBuild> builds, RHIBuffer& scratchBuffer)
 {
-    VEX_ASSERT(as.GetDesc().type == ASType::BottomLevel, "Invalid Acceleration Structure type...");
-    // Build the BLAS.
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc{};
-    buildDesc.Inputs = D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS{
-        .Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL,
-        .Flags = ASBuildFlagsToDX12ASBuildFlags(as.GetDesc().buildFlags),
-        .NumDescs = static_cast<u32>(as.GetGeometryDescs().size()),
-        .DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY,
-        .pGeometryDescs = as.GetGeometryDescs().data(),
-        // TODO(https://trello.com/c/YPn5ypzR): handle opacity micromaps
-    };
-    buildDesc.ScratchAccelerationStructureData = scratchBuffer.GetGPUVirtualAddress();
-    buildDesc.DestAccelerationStructureData = as.GetRHIBuffer().GetGPUVirtualAddress();
-    // TODO(https://trello.com/c/LIEtASpP): handle BLAS update.
-    buildDesc.SourceAccelerationStructureData = NULL;
-    commandList->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
+    // D3D12 builds one acceleration structure per call, consecutive builds with no barrier in between can still
+    // overlap on the GPU.
+    for (const RHIBLASBuild& build : builds)
+    {
+        RHIAccelerationStructure& as = *build.accelerationStructure;
+        VEX_ASSERT(as.GetDesc().type == ASType::BottomLevel, "Invalid Acceleration Structure type...");
+        ASBuild::Flags buildFlags = as.GetDesc().buildFlags;
+        if (build.isUpdate)
+        {
+            buildFlags |= ASBuild::PerformUpdate;
+        }
+
+        // Build the BLAS.
+        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc{};
+        buildDesc.Inputs = D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS{
+            .Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL,
+            .Flags = ASBuildFlagsToDX12ASBuildFlags(buildFlags),
+            .NumDescs = static_cast<u32>(as.GetGeometryDescs().size()),
+            .DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY,
+            .pGeometryDescs = as.GetGeometryDescs().data(),
+            // TODO(https://trello.com/c/YPn5ypzR): handle opacity micromaps
+        };
+        buildDesc.ScratchAccelerationStructureData = scratchBuffer.GetGPUVirtualAddress() + build.scratchOffset;
+        buildDesc.DestAccelerationStructureData = as.GetRHIBuffer().GetGPUVirtualAddress();
+        // Updates are performed in place.
+        buildDesc.SourceAccelerationStructureData = build.isUpdate ? buildDesc.DestAccelerationStructureData : NULL;
+        commandList->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
+    }
 }
 
 void DX12CommandList::BuildTLAS(RHIAccelerationStructure& as,
                                 RHIBuffer& scratchBuffer,
                                 RHIBuffer& uploadBuffer,
-                                const RHITLASBuildDesc& desc)
+                                const RHITLASBuildDesc& desc,
+                                bool isUpdate)
 {
     VEX_ASSERT(as.GetDesc().type == ASType::TopLevel, "Invalid Acceleration Structure type...");
 
+    ASBuild::Flags buildFlags = as.GetDesc().buildFlags;
+    if (isUpdate)
+    {
+        buildFlags |= ASBuild::PerformUpdate;
+    }
+
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc = {};
     buildDesc.Inputs = D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS{
         .Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL,
-        .Flags = ASBuildFlagsToDX12ASBuildFlags(as.GetDesc().buildFlags),
+        .Flags = ASBuildFlagsToDX12ASBuildFlags(buildFlags),
         .NumDescs = static_cast<u32>(desc.instances.size()),
         .DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY,
         .InstanceDescs = uploadBuffer.GetGPUVirtualAddress(),
     };
     buildDesc.ScratchAccelerationStructureData = scratchBuffer.GetGPUVirtualAddress();
     buildDesc.DestAccelerationStructureData = as.GetRHIBuffer().GetGPUVirtualAddress();
-    // TODO(https://trello.com/c/LIEtASpP): handle TLAS update.
-    buildDesc.SourceAccelerationStructureData = NULL;
+    // Updates are performed in place.
+    buildDesc.SourceAccelerationStructureData = isUpdate ? buildDesc.DestAccelerationStructureData : NULL;
     commandList->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
 }
 
+void DX12CommandList::WriteCompactedSizes(Span<const NonNullPtr<RHIAccelerationStructure>> accelerationStructures,
+                                          RHIBuffer& dstBuffer)
+{
+    std::vector<D3D12_GPU_VIRTUAL_ADDRESS> asAddresses;
+    asAddresses.reserve(accelerationStructures.size());
+    for (const NonNullPtr<RHIAccelerationStructure>& as : accelerationStructures)
+    {
+        asAddresses.push_back(as->GetRHIBuffer().GetGPUVirtualAddress());
+    }
+
+    // Each size is written as a D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC (a u64).
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC postbuildInfoDesc{
+        .DestBuffer = dstBuffer.GetGPUVirtualAddress(),
+        .InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE,
+    };
+    commandList->EmitRaytracingAccelerationStructurePostbuildInfo(&postbuildInfoDesc,
+                                                                  static_cast<u32>(asAddresses.size()),
+                                                                  asAddresses.data());
+}
+
+void DX12CommandList::CompactAccelerationStructure(RHIAccelerationStructure& src, RHIAccelerationStructure& dst)
+{
+    commandList->CopyRaytracingAccelerationStructure(dst.GetRHIBuffer().GetGPUVirtualAddress(),
+                                                     src.GetRHIBuffer().GetGPUVirtualAddress(),
+                                                     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT);
+}
+
 RHIScopedGPUEvent DX12CommandList::CreateScopedMarker(const char* label, std::array<float, 3> labelColor)
 {
     return { *this, label, labelColor };
 }
 
+void DX12CommandList::ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE argumentType,
+                                      const RHIIndirectArgsBinding& indirectArgs)
+{
+    // Our command signatures only contain the draw/dispatch arguments, they do not need a root signature.
+    const u64 signatureKey = (static_cast<u64>(argumentType) << 32) | indirectArgs.argsStrideByteSize;
+    ComPtr<ID3D12CommandSignature>& commandSignature = commandSignatures[signatureKey];
+    if (!commandSignature)
+    {
+        D3D12_INDIRECT_ARGUMENT_DESC argumentDesc{ .Type = argumentType };
+        D3D12_COMMAND_SIGNATURE_DESC signatureDesc{
+            .ByteStride = indirectArgs.argsStrideByteSize,
+            .NumArgumentDescs = 1,
+            .pArgumentDescs = &argumentDesc,
+        };
+        chk << device->CreateCommandSignature(&signatureDesc, nullptr, IID_PPV_ARGS(&commandSignature));
+    }
+
+    commandList->ExecuteIndirect(commandSignature.Get(),
+                                 indirectArgs.maxCommandCount,
+                                 indirectArgs.argsBuffer->GetRawBuffer(),
+                                 indirectArgs.argsOffsetByteSize,
+                                 indirectArgs.countBuffer ? indirectArgs.countBuffer->GetRawBuffer() : nullptr,
+                                 indirectArgs.countOffsetByteSize);
+}
+
 } // namespace vex::dx12
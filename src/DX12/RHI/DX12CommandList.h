@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include <RHI/RHI.h>
 #include <RHI/RHICommandList.h>
 
@@ -24,7 +26,7 @@ public:
     virtual void SetPipelineState(const RHIComputePipelineState& computePipelineState) override;
     virtual void SetPipelineState(const RHIRayTracingPipelineState& rayTracingPipelineState) override;
 
-    virtual void SetLayout(RHIResourceLayout& layout) override;
+    virtual void SetLayout(RHIResourceLayout& layout, Span<const byte> localConstantsData) override;
     virtual void SetDescriptorPool(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout) override;
     virtual void SetInputAssembly(InputAssembly inputAssembly) override;
 
@@ -39,6 +41,11 @@ public:
     virtual void EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
                               Span<const RHITextureBarrier> textureBarriers,
                               Span<const RHIGlobalBarrier> globalBarriers) override;
+    virtual u32 BeginSplitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                   Span<const RHITextureBarrier> textureBarriers) override;
+    virtual void EndSplitBarriers(u32 splitBarrierIndex,
+                                  Span<const RHIBufferBarrier> bufferBarriers,
+                                  Span<const RHITextureBarrier> textureBarriers) override;
 
     virtual void BeginRendering(const RHIDrawResources& resources) override;
     virtual void EndRendering() override;
@@ -46,11 +53,14 @@ public:
     virtual void Draw(u32 vertexCount, u32 instanceCount = 1, u32 vertexOffset = 0, u32 instanceOffset = 0) override;
     virtual void DrawIndexed(
         u32 indexCount, u32 instanceCount, u32 indexOffset, u32 vertexOffset, u32 instanceOffset) override;
+    virtual void DrawIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
+    virtual void DrawIndexedIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
 
     virtual void SetVertexBuffers(u32 startSlot, Span<const RHIBufferBinding> vertexBuffers) override;
     virtual void SetIndexBuffer(const RHIBufferBinding& indexBuffer) override;
 
     virtual void Dispatch(const std::array<u32, 3>& groupCount) override;
+    virtual void DispatchIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
 
     virtual void TraceRays(const TraceRaysDesc& rayTracingArgs,
                            const RHIRayTracingPipelineState& rayTracingPipelineState) override;
@@ -68,11 +78,15 @@ public:
     virtual void EndTimestampQuery(QueryHandle handle) override;
     virtual void ResolveTimestampQueries(u32 firstQuery, u32 queryCount) override;
 
-    virtual void BuildBLAS(RHIAccelerationStructure& as, RHIBuffer& scratchBuffer) override;
+    virtual void BuildBLAS(Span<const RHIBLASBuild> builds, RHIBuffer& scratchBuffer) override;
     virtual void BuildTLAS(RHIAccelerationStructure& as,
                            RHIBuffer& scratchBuffer,
                            RHIBuffer& uploadBuffer,
-                           const RHITLASBuildDesc& desc) override;
+                           const RHITLASBuildDesc& desc,
+                           bool isUpdate) override;
+    virtual void WriteCompactedSizes(Span<const NonNullPtr<RHIAccelerationStructure>> accelerationStructures,
+                                     RHIBuffer& dstBuffer) override;
+    virtual void CompactAccelerationStructure(RHIAccelerationStructure& src, RHIAccelerationStructure& dst) override;
 
     ComPtr<ID3D12GraphicsCommandList10>& GetNativeCommandList()
     {
@@ -82,11 +96,28 @@ public:
     RHIScopedGPUEvent CreateScopedMarker(const char* label, std::array<float, 3> labelColor) override;
 
 private:
+    enum class BarrierSplit : u8
+    {
+        None,
+        Begin,
+        End,
+    };
+
+    void RecordBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                        Span<const RHITextureBarrier> textureBarriers,
+                        Span<const RHIGlobalBarrier> globalBarriers,
+                        BarrierSplit split);
+    void ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE argumentType, const RHIIndirectArgsBinding& indirectArgs);
+
     ComPtr<DX12Device> device;
     ComPtr<ID3D12GraphicsCommandList10> commandList;
 
     // Underlying memory of the command list.
     ComPtr<ID3D12CommandAllocator> commandAllocator;
+
+    // Command signatures used by ExecuteIndirect, keyed by argument type and stride. Kept per command list so that
+    // recording threads never share them.
+    std::unordered_map<u64, ComPtr<ID3D12CommandSignature>> commandSignatures;
 };
 
 } // namespace vex::dx12
\ No newline at end of file
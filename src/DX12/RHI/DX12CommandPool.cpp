@@ -18,37 +18,21 @@ DX12CommandPool::DX12CommandPool(RHI& rhi, const ComPtr<DX12Device>& device)
 {
 }
 
-NonNullPtr<RHICommandList> DX12CommandPool::GetOrCreateCommandList(QueueType queueType)
+std::unique_ptr<RHICommandList> DX12CommandPool::CreateCommandList(QueueType queueType)
 {
-    DX12CommandList* cmdListPtr = nullptr;
-
-    auto& pool = GetCommandLists(queueType);
-    if (auto res = std::find_if(pool.begin(),
-                                pool.end(),
-                                [](const std::unique_ptr<DX12CommandList>& cmdList)
-                                { return cmdList->GetState() == RHICommandListState::Available; });
-        res != pool.end())
-    {
-        // Reserve the available command list.
-        cmdListPtr = res->get();
-    }
-    else
-    {
-        // No more available command lists, create and return a new one.
-        pool.push_back(std::make_unique<DX12CommandList>(device, queueType));
-        cmdListPtr = pool.back().get();
+    // Each DX12 command list possesses its own allocator, so lists can be recorded in parallel regardless of the thread
+    // which created them.
+    auto cmdList = std::make_unique<DX12CommandList>(device, queueType);
 #if !VEX_SHIPPING
-        chk << cmdListPtr->GetNativeCommandList()->SetName(
-            StringToWString(std::format("CommandList: {}_{}", magic_enum::enum_name(queueType), pool.size() - 1))
-                .c_str());
+    chk << cmdList->GetNativeCommandList()->SetName(
+        StringToWString(
+            std::format("CommandList: {}_{}", magic_enum::enum_name(queueType), commandListCountPerQueue[queueType]))
+            .c_str());
 #endif
-        VEX_LOG(Verbose, "Created new commandlist for queue {}", magic_enum::enum_name(queueType));
-    }
+    ++commandListCountPerQueue[queueType];
+    VEX_LOG(Verbose, "Created new commandlist for queue {}", magic_enum::enum_name(queueType));
 
-    VEX_ASSERT(cmdListPtr != nullptr);
-    cmdListPtr->SetState(RHICommandListState::Recording);
-
-    return NonNullPtr(cmdListPtr);
+    return cmdList;
 }
 
 } // namespace vex::dx12
\ No newline at end of file
@@ -18,13 +18,16 @@ class DX12CommandPool final : public RHICommandPoolBase
 public:
     DX12CommandPool(RHI& rhi, const ComPtr<DX12Device>& device);
 
-    virtual NonNullPtr<RHICommandList> GetOrCreateCommandList(QueueType queueType) override;
-
     DX12CommandPool(DX12CommandPool&&) = default;
     DX12CommandPool& operator=(DX12CommandPool&&) = default;
 
+protected:
+    virtual std::unique_ptr<RHICommandList> CreateCommandList(QueueType queueType) override;
+
 private:
     ComPtr<DX12Device> device;
+
+    std::array<u32, QueueTypes::Count> commandListCountPerQueue{};
 };
 
 } // namespace vex::dx12
\ No newline at end of file
@@ -6,9 +6,11 @@ namespace vex::dx12
 {
 
 DX12DescriptorPool::DX12DescriptorPool(ComPtr<DX12Device>& device)
-    // TODO(https://trello.com/c/uGignSlW): allow resizing of the GPU heap, currently disallowed due to synchro issues.
-    // The sampler heap however cannot be larger than GMaxBindlessSamplerCount.
-    : device{ device }
+    // The resource heap grows when running out of descriptors, the sampler heap however cannot be larger than
+    // GMaxBindlessSamplerCount.
+    : RHIDescriptorPoolBase(GMaxDescriptorPoolSize)
+    , device{ device }
+    , cpuHeap(device, GDefaultDescriptorPoolSize, "ResourceDescriptorHeap")
     , gpuHeap(device, GDefaultDescriptorPoolSize, "ResourceDescriptorHeap")
     , samplerHeap(device, GMaxBindlessSamplerCount, "SamplerDescriptorHeap")
     , nullHeap(device, 1, "NullResourceDescriptorHeap")
@@ -43,6 +45,10 @@ void DX12DescriptorPool::CopyNullDescriptor(DescriptorType descriptorType, u32 s
 {
     if (descriptorType == DescriptorType::Resource)
     {
+        device->CopyDescriptorsSimple(1,
+                                      cpuHeap.GetCPUDescriptorHandle(slotIndex),
+                                      GetNullResourceDescriptor(),
+                                      D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
         device->CopyDescriptorsSimple(1,
                                       gpuHeap.GetCPUDescriptorHandle(slotIndex),
                                       GetNullResourceDescriptor(),
@@ -70,16 +76,48 @@ void DX12DescriptorPool::FreeBindlessSampler(BindlessHandle handle)
     FreeStaticDescriptor(DescriptorType::Sampler, handle);
 }
 
+void DX12DescriptorPool::ReleaseRetiredHeaps(u32 oldestUsedHeapVersion)
+{
+    std::erase_if(retiredHeaps,
+                  [oldestUsedHeapVersion](const RetiredHeap& retiredHeap)
+                  { return retiredHeap.heapVersion <= oldestUsedHeapVersion; });
+}
+
+void DX12DescriptorPool::GrowResourceHeap(u32 newSize)
+{
+    const u32 size = static_cast<u32>(allocator.generations.size());
+    cpuHeap.Resize(newSize);
+
+    retiredHeaps.push_back({ .heapVersion = GetHeapVersion(), .heap = gpuHeap.GetNativeDescriptorHeap() });
+    gpuHeap = DX12DescriptorHeap<DX12HeapType::CBV_SRV_UAV, HeapFlags::SHADER_VISIBLE>(device,
+                                                                                       newSize,
+                                                                                       "ResourceDescriptorHeap");
+    device->CopyDescriptorsSimple(size,
+                                  gpuHeap.GetCPUDescriptorHandle(0),
+                                  cpuHeap.GetCPUDescriptorHandle(0),
+                                  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
 void DX12DescriptorPool::CopyDescriptor(BindlessHandle handle, CD3DX12_CPU_DESCRIPTOR_HANDLE descriptor)
 {
     VEX_ASSERT(IsValid(handle), "Invalid handle passed to DX12 Descriptor Pool.");
     device->CopyDescriptorsSimple(1, GetCPUDescriptor(handle), descriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    CommitDescriptor(handle);
 }
 
 CD3DX12_CPU_DESCRIPTOR_HANDLE DX12DescriptorPool::GetCPUDescriptor(BindlessHandle handle)
 {
     VEX_ASSERT(IsValid(handle), "Invalid handle passed to DX12 Descriptor Pool.");
-    return gpuHeap.GetCPUDescriptorHandle(handle.GetIndex());
+    return cpuHeap.GetCPUDescriptorHandle(handle.GetIndex());
+}
+
+void DX12DescriptorPool::CommitDescriptor(BindlessHandle handle)
+{
+    VEX_ASSERT(IsValid(handle), "Invalid handle passed to DX12 Descriptor Pool.");
+    device->CopyDescriptorsSimple(1,
+                                  gpuHeap.GetCPUDescriptorHandle(handle.GetIndex()),
+                                  cpuHeap.GetCPUDescriptorHandle(handle.GetIndex()),
+                                  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 }
 
 CD3DX12_CPU_DESCRIPTOR_HANDLE DX12DescriptorPool::GetNullResourceDescriptor()
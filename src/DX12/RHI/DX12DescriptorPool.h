@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <RHI/RHIDescriptorPool.h>
 
 #include <DX12/DX12DescriptorHeap.h>
@@ -18,8 +20,18 @@ public:
 
     virtual void CopyNullDescriptor(DescriptorType descriptorType, u32 slotIndex) override;
 
+    // Descriptors are copied to the shader visible heap as soon as they are written, copies are cheap CPU operations.
+    virtual void FlushPendingDescriptorWrites() override
+    {
+    }
+    virtual void DiscardPendingDescriptorWrites(u32, u32) override
+    {
+    }
+
     void CopyDescriptor(BindlessHandle handle, CD3DX12_CPU_DESCRIPTOR_HANDLE descriptor);
+    // Descriptors are written to the returned CPU descriptor, then made visible to shaders with CommitDescriptor.
     CD3DX12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptor(BindlessHandle handle);
+    void CommitDescriptor(BindlessHandle handle);
     CD3DX12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptor(BindlessHandle handle);
 
     ComPtr<ID3D12DescriptorHeap>& GetNativeDescriptorHeap()
@@ -32,15 +44,31 @@ public:
         return samplerHeap.GetNativeDescriptorHeap();
     }
 
+protected:
+    virtual void GrowResourceHeap(u32 newSize) override;
+    virtual void ReleaseRetiredHeaps(u32 oldestUsedHeapVersion) override;
+
 private:
+    struct RetiredHeap
+    {
+        u32 heapVersion;
+        ComPtr<ID3D12DescriptorHeap> heap;
+    };
+
     CD3DX12_CPU_DESCRIPTOR_HANDLE GetNullResourceDescriptor();
     CD3DX12_CPU_DESCRIPTOR_HANDLE GetNullSamplerDescriptor();
 
     ComPtr<DX12Device> device;
 
+    // Shader visible heaps cannot be the source of a descriptor copy, so resource descriptors are first written to the
+    // CPU heap, which is copied over to the new shader visible heap when the pool grows.
+    DX12DescriptorHeap<DX12HeapType::CBV_SRV_UAV, HeapFlags::NONE> cpuHeap;
     DX12DescriptorHeap<DX12HeapType::CBV_SRV_UAV, HeapFlags::SHADER_VISIBLE> gpuHeap;
     DX12DescriptorHeap<DX12HeapType::SAMPLER, HeapFlags::SHADER_VISIBLE> samplerHeap;
 
+    // Shader visible heaps replaced by a larger one, which command lists recorded before the growth might still use.
+    std::vector<RetiredHeap> retiredHeaps;
+
     // Used to store a single null descriptor, useful for avoiding invalid texture usage (and avoiding gpu hangs) if a shader
     // ever tries to access an invalid resource.
     DX12DescriptorHeap<DX12HeapType::CBV_SRV_UAV, HeapFlags::NONE> nullHeap;
@@ -41,6 +41,10 @@ bool DX12PhysicalDevice::IsFeatureSupported(Feature feature) const
         rayTracingSupported &= featureSupport.HighestShaderModel() >= D3D_SHADER_MODEL_6_3;
         return rayTracingSupported;
     }
+    case Feature::MultiDrawIndirect:
+    case Feature::DrawIndirectCount:
+        // ExecuteIndirect always supports multiple commands and count buffers.
+        return true;
     default:
         VEX_LOG(Fatal, "Unable to determine feature support for {}", feature);
         return false;
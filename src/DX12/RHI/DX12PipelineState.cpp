@@ -153,7 +153,8 @@ DX12GraphicsPipelineState::DX12GraphicsPipelineState(const ComPtr<DX12Device>& d
 
 void DX12GraphicsPipelineState::Compile(const ShaderView& vertexShader,
                                         const ShaderView& pixelShader,
-                                        RHIResourceLayout& resourceLayout)
+                                        RHIResourceLayout& resourceLayout,
+                                        bool /*allowFastLink*/)
 {
     using namespace GraphicsPipeline;
 
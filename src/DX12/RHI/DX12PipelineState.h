@@ -33,9 +33,11 @@ public:
 
     DX12GraphicsPipelineState(const ComPtr<DX12Device>& device, const Key& key);
 
+    // DX12 has no equivalent to pipeline libraries for graphics pipeline states, they are never fast-linked.
     virtual void Compile(const ShaderView& vertexShader,
                          const ShaderView& pixelShader,
-                         RHIResourceLayout& resourceLayout) override;
+                         RHIResourceLayout& resourceLayout,
+                         bool allowFastLink) override;
     virtual std::unique_ptr<RHIGraphicsPipelineState> Cleanup() override;
 
     // Verifies that the key does not contain fields with non-default values for features which DX12 does not support.
@@ -34,7 +34,11 @@ static std::array<DX12Fence, QueueTypes::Count> CreateFences(ComPtr<DX12Device>&
 
 } // namespace DX12RHI_Internal
 
-DX12RHI::DX12RHI(const PlatformWindowHandle& windowHandle, bool enableGPUDebugLayer, bool enableGPUBasedValidation)
+DX12RHI::DX12RHI(const PlatformWindowHandle& windowHandle,
+                 bool enableGPUDebugLayer,
+                 bool enableGPUBasedValidation,
+                 bool /*useDescriptorBuffer*/,
+                 bool /*enableGraphicsPipelineFastLinking*/)
     : enableGPUDebugLayer(enableGPUDebugLayer)
 {
     HMODULE d3d12Module = GetModuleHandleA("D3D12Core.dll");
@@ -174,14 +178,21 @@ RHIResourceLayout DX12RHI::CreateResourceLayout(RHIDescriptorPool& descriptorPoo
     return DX12ResourceLayout(device);
 }
 
-RHITexture DX12RHI::CreateTexture(RHIAllocator& allocator, const TextureDesc& desc)
+RHITexture DX12RHI::CreateTexture(RHIAllocator& allocator, const TextureDesc& desc, ResourceLifetime lifetime)
 {
-    return DX12Texture(device, allocator, desc);
+    return DX12Texture(device, allocator, desc, lifetime);
 }
 
-RHIBuffer DX12RHI::CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc)
+RHIBuffer DX12RHI::CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime)
 {
-    return DX12Buffer(device, allocator, desc);
+    return DX12Buffer(device, allocator, desc, lifetime);
+}
+
+RHITexture DX12RHI::CreateTransientTexture(RHIAllocator& allocator,
+                                           const TextureDesc& desc,
+                                           TransientMemoryPool& transientPool)
+{
+    return DX12Texture(device, allocator, desc, ResourceLifetime::Transient, &transientPool);
 }
 
 RHIDescriptorPool DX12RHI::CreateDescriptorPool()
@@ -204,6 +215,17 @@ RHIAccelerationStructure DX12RHI::CreateAS(const AccelerationStructureDesc& desc
     return RHIAccelerationStructure(device, desc);
 }
 
+void DX12RHI::LoadPipelineCache(Span<const byte> cacheData)
+{
+    // DX12 drivers manage their own on-disk PSO cache, ID3D12PipelineLibrary would be required to control it manually.
+    VEX_LOG(Warning, "Loading a pipeline cache is not supported with DX12, the driver's own PSO cache will be used.");
+}
+
+std::vector<byte> DX12RHI::GetPipelineCacheData()
+{
+    return {};
+}
+
 void DX12RHI::WaitForTokenOnCPU(const SyncToken& syncToken)
 {
     auto& fence = (*fences)[syncToken.queueType];
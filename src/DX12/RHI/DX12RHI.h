@@ -23,7 +23,11 @@ namespace vex::dx12
 class DX12RHI final : public RHIBase
 {
 public:
-    DX12RHI(const PlatformWindowHandle& windowHandle, bool enableGPUDebugLayer, bool enableGPUBasedValidation);
+    DX12RHI(const PlatformWindowHandle& windowHandle,
+            bool enableGPUDebugLayer,
+            bool enableGPUBasedValidation,
+            bool useDescriptorBuffer,
+            bool enableGraphicsPipelineFastLinking);
     ~DX12RHI();
 
     static std::vector<std::unique_ptr<RHIPhysicalDevice>> EnumeratePhysicalDevices();
@@ -39,8 +43,13 @@ public:
     virtual RHIRayTracingPipelineState CreateRayTracingPipelineState(const RayTracingPSOKey& key) override;
     virtual RHIResourceLayout CreateResourceLayout(RHIDescriptorPool& descriptorPool) override;
 
-    virtual RHITexture CreateTexture(RHIAllocator& allocator, const TextureDesc& desc) override;
-    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc) override;
+    virtual RHITexture CreateTexture(RHIAllocator& allocator,
+                                     const TextureDesc& desc,
+                                     ResourceLifetime lifetime) override;
+    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime) override;
+    virtual RHITexture CreateTransientTexture(RHIAllocator& allocator,
+                                              const TextureDesc& desc,
+                                              TransientMemoryPool& transientPool) override;
 
     virtual RHIDescriptorPool CreateDescriptorPool() override;
 
@@ -50,6 +59,9 @@ public:
 
     virtual RHIAccelerationStructure CreateAS(const AccelerationStructureDesc& desc) override;
 
+    virtual void LoadPipelineCache(Span<const byte> cacheData) override;
+    virtual std::vector<byte> GetPipelineCacheData() override;
+
     virtual void WaitForTokenOnCPU(const SyncToken& syncToken) override;
     virtual bool IsTokenComplete(const SyncToken& syncToken) const override;
     virtual void WaitForTokenOnGPU(QueueType waitingQueue, const SyncToken& waitFor) override;
@@ -19,14 +19,18 @@ DX12ResourceLayout::DX12ResourceLayout(ComPtr<DX12Device>& device)
 
 DX12ResourceLayout::~DX12ResourceLayout() = default;
 
-ComPtr<ID3D12RootSignature>& DX12ResourceLayout::GetRootSignature()
+void DX12ResourceLayout::UpdateLayout()
 {
     if (isDirty)
     {
         CompileRootSignature();
         isDirty = false;
     }
+}
 
+ComPtr<ID3D12RootSignature>& DX12ResourceLayout::GetRootSignature()
+{
+    UpdateLayout();
     return rootSignature;
 }
 
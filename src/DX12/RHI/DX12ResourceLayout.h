@@ -13,6 +13,9 @@ public:
     DX12ResourceLayout(ComPtr<DX12Device>& device);
     ~DX12ResourceLayout();
 
+    // Recompiles the root signature if it is dirty. Once updated, the layout can safely be read from multiple threads.
+    void UpdateLayout();
+
     ComPtr<ID3D12RootSignature>& GetRootSignature();
 
     DX12ResourceLayout(DX12ResourceLayout&&) = default;
@@ -179,8 +179,12 @@ static D3D12_UNORDERED_ACCESS_VIEW_DESC CreateUnorderedAccessViewDesc(const DX12
 
 } // namespace Texture_Internal
 
-DX12Texture::DX12Texture(ComPtr<DX12Device>& device, RHIAllocator& allocator, const TextureDesc& desc)
-    : RHITextureBase(allocator)
+DX12Texture::DX12Texture(ComPtr<DX12Device>& device,
+                         RHIAllocator& allocator,
+                         const TextureDesc& desc,
+                         ResourceLifetime lifetime,
+                         TransientMemoryPool* transientPool)
+    : RHITextureBase(allocator, lifetime)
     , texture(nullptr)
     , device(device)
 {
@@ -266,7 +270,9 @@ DX12Texture::DX12Texture(ComPtr<DX12Device>& device, RHIAllocator& allocator, co
                                    desc.memoryLocality,
                                    0,
                                    D3D12_BARRIER_LAYOUT_UNDEFINED,
-                                   useFastTextureClear ? std::optional<D3D12_CLEAR_VALUE>(clearValue) : std::nullopt);
+                                   useFastTextureClear ? std::optional<D3D12_CLEAR_VALUE>(clearValue) : std::nullopt,
+                                   lifetime,
+                                   transientPool);
 #else
     chk << device->CreateCommittedResource3(&heapProps,
                                             D3D12_HEAP_FLAG_NONE,
@@ -363,23 +369,47 @@ BindlessHandle DX12Texture::GetOrCreateBindlessView(const TextureBinding& bindin
         return it->second.bindlessHandle;
     }
 
-    BindlessHandle handle = descriptorPool.AllocateStaticDescriptor(DescriptorType::Resource);
+    BindlessHandle handle = descriptorPool.AllocateResourceDescriptor(lifetime);
+    WriteBindlessView(view, handle, descriptorPool);
 
-    if (isSRVView)
+    viewCache[view] = { .bindlessHandle = handle };
+    return handle;
+}
+
+void DX12Texture::TakeBindlessViews(RHITexture& source, RHIDescriptorPool& descriptorPool)
+{
+    for (auto& [view, entry] : source.viewCache)
     {
-        auto desc = CreateShaderResourceViewDesc(binding.texture.desc, view);
-        auto cpuDescriptorHandle = descriptorPool.GetCPUDescriptor(handle);
-        device->CreateShaderResourceView(texture.Get(), &desc, cpuDescriptorHandle);
+        if (entry.bindlessHandle == GInvalidBindlessHandle)
+        {
+            continue;
+        }
+
+        WriteBindlessView(view, entry.bindlessHandle, descriptorPool);
+        viewCache[view] = { .bindlessHandle = entry.bindlessHandle };
+        entry.bindlessHandle = GInvalidBindlessHandle;
     }
-    else // if (isUAVView)
+}
+
+void DX12Texture::WriteBindlessView(const DX12TextureView& view,
+                                    BindlessHandle handle,
+                                    RHIDescriptorPool& descriptorPool)
+{
+    using namespace Texture_Internal;
+
+    auto cpuDescriptorHandle = descriptorPool.GetCPUDescriptor(handle);
+    if (view.usage == TextureUsage::ShaderRead)
     {
-        auto desc = CreateUnorderedAccessViewDesc(view);
-        auto cpuDescriptorHandle = descriptorPool.GetCPUDescriptor(handle);
-        device->CreateUnorderedAccessView(texture.Get(), nullptr, &desc, cpuDescriptorHandle);
+        auto srvDesc = CreateShaderResourceViewDesc(desc, view);
+        device->CreateShaderResourceView(texture.Get(), &srvDesc, cpuDescriptorHandle);
+    }
+    else // if (view.usage == TextureUsage::ShaderReadWrite)
+    {
+        auto uavDesc = CreateUnorderedAccessViewDesc(view);
+        device->CreateUnorderedAccessView(texture.Get(), nullptr, &uavDesc, cpuDescriptorHandle);
     }
 
-    viewCache[view] = { .bindlessHandle = handle };
-    return handle;
+    descriptorPool.CommitDescriptor(handle);
 }
 
 void DX12Texture::FreeBindlessHandles(RHIDescriptorPool& descriptorPool)
@@ -396,9 +426,11 @@ void DX12Texture::FreeBindlessHandles(RHIDescriptorPool& descriptorPool)
 
 void DX12Texture::FreeAllocation(RHIAllocator& allocator)
 {
-    if (allocation.has_value())
+    // Swapchain backbuffers have no allocation, and transient memory is returned to its pool by the command context
+    // which created the texture.
+    if (allocation.pageHandle != GInvalidPageHandle && lifetime != ResourceLifetime::Transient)
     {
-        allocator.FreeResource(*allocation);
+        allocator.FreeResource(allocation);
     }
 }
 
@@ -62,13 +62,19 @@ namespace vex::dx12
 class DX12Texture final : public RHITextureBase
 {
 public:
-    DX12Texture(ComPtr<DX12Device>& device, RHIAllocator& allocator, const TextureDesc& desc);
+    // Transient textures are placed in the memory of the transient pool.
+    DX12Texture(ComPtr<DX12Device>& device,
+                RHIAllocator& allocator,
+                const TextureDesc& desc,
+                ResourceLifetime lifetime = ResourceLifetime::Static,
+                TransientMemoryPool* transientPool = nullptr);
     // Takes ownership of the passed in texture.
     DX12Texture(ComPtr<DX12Device>& device, std::string name, ComPtr<ID3D12Resource> rawTex);
 
     virtual BindlessHandle GetOrCreateBindlessView(const TextureBinding& binding,
                                                    RHIDescriptorPool& descriptorPool) override;
     virtual void FreeBindlessHandles(RHIDescriptorPool& descriptorPool) override;
+    virtual void TakeBindlessViews(RHITexture& source, RHIDescriptorPool& descriptorPool) override;
     virtual void FreeAllocation(RHIAllocator& allocator) override;
 
     ID3D12Resource* GetRawTexture()
@@ -79,6 +85,8 @@ public:
     CD3DX12_CPU_DESCRIPTOR_HANDLE GetOrCreateRTVDSVView(const DX12TextureView& view);
 
 private:
+    void WriteBindlessView(const DX12TextureView& view, BindlessHandle handle, RHIDescriptorPool& descriptorPool);
+
     ComPtr<ID3D12Resource> texture;
 
     ComPtr<DX12Device> device;
@@ -101,9 +109,6 @@ private:
 
     FreeListAllocator32 rtvHeapAllocator;
     FreeListAllocator32 dsvHeapAllocator;
-
-    // Can be nullopt in the case of swapchain backbuffers.
-    std::optional<Allocation> allocation;
 };
 
 } // namespace vex::dx12
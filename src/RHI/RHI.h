@@ -4,6 +4,7 @@
 
 #include <Vex/Containers/Span.h>
 #include <Vex/QueueType.h>
+#include <Vex/Types.h>
 #include <Vex/Utility/NonNullPtr.h>
 
 #include <RHI/RHIFwd.h>
@@ -20,6 +21,8 @@ struct SwapChainDesc;
 struct PlatformWindow;
 struct SyncToken;
 struct AccelerationStructureDesc;
+enum class ResourceLifetime : u8;
+struct TransientMemoryPool;
 
 struct RHIBase
 {
@@ -34,8 +37,12 @@ struct RHIBase
     virtual RHIRayTracingPipelineState CreateRayTracingPipelineState(const RayTracingPSOKey& key) = 0;
     virtual RHIResourceLayout CreateResourceLayout(RHIDescriptorPool& descriptorPool) = 0;
 
-    virtual RHITexture CreateTexture(RHIAllocator& allocator, const TextureDesc& desc) = 0;
-    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc) = 0;
+    virtual RHITexture CreateTexture(RHIAllocator& allocator, const TextureDesc& desc, ResourceLifetime lifetime) = 0;
+    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime) = 0;
+    // Transient textures are placed in the memory of the pool, where they can alias other transient textures.
+    virtual RHITexture CreateTransientTexture(RHIAllocator& allocator,
+                                              const TextureDesc& desc,
+                                              TransientMemoryPool& transientPool) = 0;
 
     virtual RHIDescriptorPool CreateDescriptorPool() = 0;
 
@@ -45,6 +52,12 @@ struct RHIBase
 
     virtual RHIAccelerationStructure CreateAS(const AccelerationStructureDesc& desc) = 0;
 
+    // Replaces the pipeline cache with one initialized from previously serialized data. Must be called before any
+    // pipeline state is created. Data produced by another device or driver version is ignored.
+    virtual void LoadPipelineCache(Span<const byte> cacheData) = 0;
+    // Returns the serialized contents of the pipeline cache, empty if the RHI does not expose its pipeline cache.
+    virtual std::vector<byte> GetPipelineCacheData() = 0;
+
     virtual void WaitForTokenOnCPU(const SyncToken& syncToken) = 0;
     virtual bool IsTokenComplete(const SyncToken& syncToken) const = 0;
     virtual void WaitForTokenOnGPU(QueueType waitingQueue, const SyncToken& waitFor) = 0;
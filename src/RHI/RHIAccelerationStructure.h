@@ -3,6 +3,7 @@
 #include <optional>
 
 #include <Vex/AccelerationStructure.h>
+#include <Vex/Buffer.h>
 #include <Vex/BuildAccelerationStructure.h>
 #include <Vex/RHIImpl/RHIBuffer.h>
 #include <Vex/Utility/MaybeUninitialized.h>
@@ -50,12 +51,22 @@ struct RHIAccelerationStructureBuildInfo
 {
     // Required size to store the acceleration structure.
     u64 asByteSize;
-    // Required size to build the acceleration structure.
+    // Required size to build the acceleration structure. Aligned to the scratch alignment of the API, so that the
+    // scratch memory of multiple builds can be packed back to back in a single buffer.
     u64 scratchByteSize;
-    // Required size to update the acceleration structure.
+    // Required size to update the acceleration structure, aligned like scratchByteSize.
     u64 updateScratchByteSize;
 };
 
+// BLAS to build along with the offset of its scratch memory, inside of the scratch buffer shared by the whole batch.
+struct RHIBLASBuild
+{
+    NonNullPtr<RHIAccelerationStructure> accelerationStructure;
+    u64 scratchOffset = 0;
+    // Refits the already built BLAS in place, instead of building it from scratch.
+    bool isUpdate = false;
+};
+
 class RHIAccelerationStructureBase
 {
 public:
@@ -89,9 +100,32 @@ public:
     virtual const RHIAccelerationStructureBuildInfo& SetupTLASBuild(RHIAllocator& allocator,
                                                                     const RHITLASBuildDesc& desc) = 0;
 
+    // Replaces the inputs of an acceleration structure which was already built, in order to update it in place. The
+    // inputs must have the same layout (geometry and primitive counts or instance count) as the ones it was built with.
+    virtual void SetupBLASUpdate(const RHIBLASBuildDesc& desc) = 0;
+    virtual void SetupTLASUpdate(const RHITLASBuildDesc& desc) = 0;
+
+    const RHIAccelerationStructureBuildInfo& GetBuildInfo() const
+    {
+        return prebuildInfo;
+    }
+
+    // Allocates the acceleration structure as the destination of a compacted copy, instead of building it.
+    virtual void SetupCompaction(RHIAllocator& allocator, u64 compactedByteSize) = 0;
+
     virtual std::vector<std::byte> GetInstanceBufferData(const RHITLASBuildDesc& desc) = 0;
     virtual u32 GetInstanceBufferStride() = 0;
 
+    // Instance buffer of a TLAS which allows updates, kept alive so that updates re-upload their instances into it.
+    const std::optional<Buffer>& GetPersistentInstanceBuffer() const
+    {
+        return persistentInstanceBuffer;
+    }
+    void SetPersistentInstanceBuffer(const Buffer& buffer)
+    {
+        persistentInstanceBuffer = buffer;
+    }
+
     void FreeBindlessHandles(RHIDescriptorPool& descriptorPool);
     void FreeAllocation(RHIAllocator& allocator);
 
@@ -99,6 +133,7 @@ protected:
     AccelerationStructureDesc desc;
     MaybeUninitialized<RHIBuffer> accelerationStructure;
     RHIAccelerationStructureBuildInfo prebuildInfo;
+    std::optional<Buffer> persistentInstanceBuffer;
 };
 
 } // namespace vex
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "RHIAllocator.h"
 
 #include <algorithm>
+#include <bit>
+#include <ranges>
 
 #include <Vex/Utility/ByteUtils.h>
 #include <Vex/Logger.h>
@@ -11,67 +13,303 @@ namespace vex
 MemoryPageInfo::MemoryPageInfo(u32 memoryTypeIndex, u64 pageByteSize)
     : memoryTypeIndex(memoryTypeIndex)
     , pageByteSize(pageByteSize)
+    , freeByteSize(pageByteSize)
 {
+    for (auto& heads : freeListHeads)
+    {
+        heads.fill(InvalidBlockIndex);
+    }
+    InsertFreeBlock(CreateBlock(0, pageByteSize));
 }
 
 std::optional<MemoryRange> MemoryPageInfo::Allocate(u64 size, u64 alignment)
 {
-    auto range = FindFreeSpace(size, alignment);
-    if (!range.has_value())
+    // Zero-sized allocations still occupy a byte, their offset has to be unique.
+    const u64 blockSize = std::max<u64>(size, 1);
+    if (blockSize > freeByteSize)
+    {
+        return std::nullopt;
+    }
+
+    // The first block of the right size class is usually already aligned, otherwise we look for a block which can
+    // contain the worst-case alignment padding.
+    u32 blockIndex = FindFreeBlock(blockSize);
+    if (blockIndex != InvalidBlockIndex &&
+        AlignUp(blocks[blockIndex].offset, alignment) + blockSize > blocks[blockIndex].offset + blocks[blockIndex].size)
+    {
+        blockIndex = InvalidBlockIndex;
+    }
+    if (blockIndex == InvalidBlockIndex && alignment > 1)
+    {
+        blockIndex = FindFreeBlock(blockSize + alignment - 1);
+    }
+    if (blockIndex == InvalidBlockIndex)
     {
         return std::nullopt;
     }
-    allocatedRanges.emplace_back(range.value());
 
-    // Keep allocated ranges sorted for easier traversal.
-    std::sort(allocatedRanges.begin(), allocatedRanges.end(), std::less<MemoryRange>{});
+    RemoveFreeBlock(blockIndex);
+
+    // The alignment padding is given back as a free block.
+    const u64 alignedOffset = AlignUp(blocks[blockIndex].offset, alignment);
+    if (alignedOffset > blocks[blockIndex].offset)
+    {
+        const u32 paddingIndex = blockIndex;
+        blockIndex = SplitBlock(paddingIndex, alignedOffset - blocks[paddingIndex].offset);
+        InsertFreeBlock(paddingIndex);
+    }
+
+    if (blocks[blockIndex].size > blockSize)
+    {
+        InsertFreeBlock(SplitBlock(blockIndex, blockSize));
+    }
+
+    allocatedBlocks.emplace(alignedOffset, blockIndex);
+    freeByteSize -= blockSize;
 
-    return range.value();
+    return MemoryRange{ .offset = alignedOffset, .size = size };
 }
 
 void MemoryPageInfo::Free(const MemoryRange& range)
 {
-    std::erase(allocatedRanges, range);
+    const auto it = allocatedBlocks.find(range.offset);
+    VEX_ASSERT(it != allocatedBlocks.end(), "Attempting to free a range which was not allocated in this page.");
+    u32 blockIndex = it->second;
+    allocatedBlocks.erase(it);
+
+    freeByteSize += blocks[blockIndex].size;
+
+    // Coalesce with the free neighbouring blocks.
+    const u32 nextIndex = blocks[blockIndex].nextPhysical;
+    if (nextIndex != InvalidBlockIndex && blocks[nextIndex].isFree)
+    {
+        RemoveFreeBlock(nextIndex);
+        MergeWithNextBlock(blockIndex);
+    }
+    const u32 prevIndex = blocks[blockIndex].prevPhysical;
+    if (prevIndex != InvalidBlockIndex && blocks[prevIndex].isFree)
+    {
+        RemoveFreeBlock(prevIndex);
+        MergeWithNextBlock(prevIndex);
+        blockIndex = prevIndex;
+    }
+
+    InsertFreeBlock(blockIndex);
+}
+
+std::pair<u32, u32> MemoryPageInfo::GetSizeClass(u64 size)
+{
+    const u32 firstLevel = static_cast<u32>(std::bit_width(size)) - 1;
+    // Drops the leading bit of the size, the next SecondLevelBits bits give the second level.
+    const u64 normalizedSize = firstLevel >= SecondLevelBits ? size >> (firstLevel - SecondLevelBits)
+                                                             : size << (SecondLevelBits - firstLevel);
+    return { firstLevel, static_cast<u32>(normalizedSize ^ SecondLevelCount) };
+}
+
+u32 MemoryPageInfo::FindFreeBlock(u64 size) const
+{
+    // Round the size up to the next size class, so that any block of the class we find is large enough.
+    const u32 sizeFirstLevel = static_cast<u32>(std::bit_width(size)) - 1;
+    if (sizeFirstLevel >= SecondLevelBits)
+    {
+        size += (u64{ 1 } << (sizeFirstLevel - SecondLevelBits)) - 1;
+    }
+
+    auto [firstLevel, secondLevel] = GetSizeClass(size);
+    u32 secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (secondLevelMap == 0)
+    {
+        const u64 firstLevelMap = firstLevel + 1 < FirstLevelCount ? firstLevelBitmap & (~u64{ 0 } << (firstLevel + 1))
+                                                                   : 0;
+        if (firstLevelMap == 0)
+        {
+            return InvalidBlockIndex;
+        }
+        firstLevel = static_cast<u32>(std::countr_zero(firstLevelMap));
+        secondLevelMap = secondLevelBitmaps[firstLevel];
+    }
+    secondLevel = static_cast<u32>(std::countr_zero(secondLevelMap));
+
+    return freeListHeads[firstLevel][secondLevel];
+}
+
+u32 MemoryPageInfo::CreateBlock(u64 offset, u64 size)
+{
+    u32 blockIndex;
+    if (!unusedBlockIndices.empty())
+    {
+        blockIndex = unusedBlockIndices.back();
+        unusedBlockIndices.pop_back();
+        blocks[blockIndex] = Block{};
+    }
+    else
+    {
+        blockIndex = static_cast<u32>(blocks.size());
+        blocks.emplace_back();
+    }
+
+    blocks[blockIndex].offset = offset;
+    blocks[blockIndex].size = size;
+    return blockIndex;
+}
+
+void MemoryPageInfo::DestroyBlock(u32 blockIndex)
+{
+    unusedBlockIndices.push_back(blockIndex);
 }
 
-// Searches for the first range that contains enough space to fit the requested data and, if found, returns the
-// memory range.
-std::optional<MemoryRange> MemoryPageInfo::FindFreeSpace(u64 size, u64 alignment)
+void MemoryPageInfo::InsertFreeBlock(u32 blockIndex)
 {
-    u64 searchOffset = 0;
+    const auto [firstLevel, secondLevel] = GetSizeClass(blocks[blockIndex].size);
+    u32& head = freeListHeads[firstLevel][secondLevel];
 
-    // Check in between currently allocated ranges.
-    for (auto& range : allocatedRanges)
+    Block& block = blocks[blockIndex];
+    block.isFree = true;
+    block.prevFree = InvalidBlockIndex;
+    block.nextFree = head;
+    if (head != InvalidBlockIndex)
     {
-        u64 alignedOffset = AlignUp(searchOffset, alignment);
+        blocks[head].prevFree = blockIndex;
+    }
+    head = blockIndex;
+
+    firstLevelBitmap |= u64{ 1 } << firstLevel;
+    secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void MemoryPageInfo::RemoveFreeBlock(u32 blockIndex)
+{
+    const auto [firstLevel, secondLevel] = GetSizeClass(blocks[blockIndex].size);
+    u32& head = freeListHeads[firstLevel][secondLevel];
 
-        if (alignedOffset + size <= range.offset)
+    Block& block = blocks[blockIndex];
+    if (block.prevFree != InvalidBlockIndex)
+    {
+        blocks[block.prevFree].nextFree = block.nextFree;
+    }
+    if (block.nextFree != InvalidBlockIndex)
+    {
+        blocks[block.nextFree].prevFree = block.prevFree;
+    }
+    if (head == blockIndex)
+    {
+        head = block.nextFree;
+        if (head == InvalidBlockIndex)
         {
-            return MemoryRange{ .offset = alignedOffset, .size = size };
+            secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (secondLevelBitmaps[firstLevel] == 0)
+            {
+                firstLevelBitmap &= ~(u64{ 1 } << firstLevel);
+            }
         }
+    }
+
+    block.isFree = false;
+    block.prevFree = InvalidBlockIndex;
+    block.nextFree = InvalidBlockIndex;
+}
 
-        // Move to searchOffset the end of this range, and check the next one!
-        searchOffset = range.end();
+u32 MemoryPageInfo::SplitBlock(u32 blockIndex, u64 size)
+{
+    // Creating the block can reallocate the block storage, so no reference is kept across it.
+    const u32 remainderIndex = CreateBlock(blocks[blockIndex].offset + size, blocks[blockIndex].size - size);
+
+    Block& block = blocks[blockIndex];
+    Block& remainder = blocks[remainderIndex];
+    remainder.prevPhysical = blockIndex;
+    remainder.nextPhysical = block.nextPhysical;
+    if (block.nextPhysical != InvalidBlockIndex)
+    {
+        blocks[block.nextPhysical].prevPhysical = remainderIndex;
     }
+    block.nextPhysical = remainderIndex;
+    block.size = size;
 
-    // Check after the last allocated range.
-    u64 alignedOffset = AlignUp(searchOffset, alignment);
-    if (alignedOffset + size <= pageByteSize)
+    return remainderIndex;
+}
+
+void MemoryPageInfo::MergeWithNextBlock(u32 blockIndex)
+{
+    Block& block = blocks[blockIndex];
+    const u32 nextIndex = block.nextPhysical;
+    const Block& next = blocks[nextIndex];
+
+    block.size += next.size;
+    block.nextPhysical = next.nextPhysical;
+    if (next.nextPhysical != InvalidBlockIndex)
     {
-        return MemoryRange{ .offset = alignedOffset, .size = size };
+        blocks[next.nextPhysical].prevPhysical = blockIndex;
     }
 
-    // No space found!
-    return std::nullopt;
+    DestroyBlock(nextIndex);
 }
 
 RHIAllocatorBase::RHIAllocatorBase(u32 memoryTypeCount)
 {
     pageInfos.resize(memoryTypeCount);
+    dynamicArenas.resize(memoryTypeCount);
 }
 
-Allocation RHIAllocatorBase::Allocate(u64 size, u64 alignment, u32 memoryTypeIndex)
+std::vector<DynamicArenaPage> RHIAllocatorBase::EndDynamicFrame()
 {
+    std::vector<DynamicArenaPage> pages;
+    for (u32 memoryTypeIndex = 0; memoryTypeIndex < dynamicArenas.size(); ++memoryTypeIndex)
+    {
+        DynamicArena& arena = dynamicArenas[memoryTypeIndex];
+        for (PageHandle pageHandle : arena.framePages)
+        {
+            pages.push_back({ .memoryTypeIndex = memoryTypeIndex, .pageHandle = pageHandle });
+        }
+        arena.framePages.clear();
+        arena.currentPageOffset = 0;
+    }
+    return pages;
+}
+
+void RHIAllocatorBase::RecycleDynamicArenaPages(Span<const DynamicArenaPage> pages)
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (const DynamicArenaPage& page : pages)
+    {
+        dynamicArenas[page.memoryTypeIndex].freePages.push_back({ .pageHandle = page.pageHandle, .freeSince = now });
+    }
+}
+
+void RHIAllocatorBase::FreeTransient(TransientMemoryPool& pool, const Allocation& allocation)
+{
+    const auto it = std::ranges::find_if(pool.pages,
+                                         [&](const TransientMemoryPool::Page& page)
+                                         {
+                                             return page.memoryTypeIndex == allocation.memoryTypeIndex &&
+                                                    page.pageHandle == allocation.pageHandle;
+                                         });
+    VEX_ASSERT(it != pool.pages.end(), "The transient allocation does not belong to this pool.");
+    it->ranges.Free(allocation.memoryRange);
+}
+
+void RHIAllocatorBase::RecycleTransientMemoryPool(TransientMemoryPool& pool)
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (const TransientMemoryPool::Page& page : pool.pages)
+    {
+        dynamicArenas[page.memoryTypeIndex].freePages.push_back({ .pageHandle = page.pageHandle, .freeSince = now });
+    }
+    pool.pages.clear();
+}
+
+Allocation RHIAllocatorBase::Allocate(
+    u64 size, u64 alignment, u32 memoryTypeIndex, ResourceLifetime lifetime, TransientMemoryPool* transientPool)
+{
+    if (lifetime == ResourceLifetime::Dynamic)
+    {
+        return AllocateDynamic(size, alignment, memoryTypeIndex);
+    }
+    if (lifetime == ResourceLifetime::Transient)
+    {
+        VEX_ASSERT(transientPool, "Transient allocations require a transient memory pool.");
+        return AllocateTransient(*transientPool, size, alignment, memoryTypeIndex);
+    }
+
     u64 alignedSize = AlignUp(size, alignment);
 
     auto& memoryPages = pageInfos[memoryTypeIndex];
@@ -83,11 +321,28 @@ Allocation RHIAllocatorBase::Allocate(u64 size, u64 alignment, u32 memoryTypeInd
             continue;
         }
 
+        // Resources are being moved out of this page.
+        const DefragmentationPage page{ .memoryTypeIndex = memoryTypeIndex, .pageHandle = it.GetHandle() };
+        if (std::ranges::find(defragmentationPages, page) != defragmentationPages.end())
+        {
+            continue;
+        }
+
+        const bool wasEmpty = it->GetFreeSpace() == it->GetByteSize();
         if (auto res = it->Allocate(size, alignment))
         {
 #if !VEX_SHIPPING
             VEX_LOG(Verbose, "Allocated subresource: size {} offset {}", res.value().size, res.value().offset);
 #endif
+            if (wasEmpty)
+            {
+                std::erase_if(emptyPages,
+                              [&](const EmptyPage& emptyPage)
+                              {
+                                  return emptyPage.memoryTypeIndex == memoryTypeIndex &&
+                                         emptyPage.pageHandle == it.GetHandle();
+                              });
+            }
 
             return Allocation{
                 .memoryTypeIndex = memoryTypeIndex,
@@ -129,6 +384,100 @@ Allocation RHIAllocatorBase::Allocate(u64 size, u64 alignment, u32 memoryTypeInd
     std::unreachable();
 }
 
+Allocation RHIAllocatorBase::AllocateDynamic(u64 size, u64 alignment, u32 memoryTypeIndex)
+{
+    DynamicArena& arena = dynamicArenas[memoryTypeIndex];
+
+    if (!arena.framePages.empty())
+    {
+        const u64 alignedOffset = AlignUp(arena.currentPageOffset, alignment);
+        if (alignedOffset + size <= pageInfos[memoryTypeIndex][arena.framePages.back()].GetByteSize())
+        {
+            arena.currentPageOffset = alignedOffset + size;
+            return Allocation{
+                .memoryTypeIndex = memoryTypeIndex,
+                .pageHandle = arena.framePages.back(),
+                .memoryRange = { .offset = alignedOffset, .size = size },
+            };
+        }
+    }
+
+    // Move on to another page, its start satisfies any alignment.
+    arena.framePages.push_back(AcquireDynamicArenaPage(memoryTypeIndex, AlignUp(size, alignment)));
+    arena.currentPageOffset = size;
+    return Allocation{
+        .memoryTypeIndex = memoryTypeIndex,
+        .pageHandle = arena.framePages.back(),
+        .memoryRange = { .offset = 0, .size = size },
+    };
+}
+
+Allocation RHIAllocatorBase::AllocateTransient(TransientMemoryPool& pool,
+                                               u64 size,
+                                               u64 alignment,
+                                               u32 memoryTypeIndex)
+{
+    // First-fit through the pool's pages, ranges freed earlier are reused which is what makes resources alias.
+    for (TransientMemoryPool::Page& page : pool.pages)
+    {
+        if (page.memoryTypeIndex != memoryTypeIndex)
+        {
+            continue;
+        }
+
+        if (auto range = page.ranges.Allocate(size, alignment))
+        {
+            return Allocation{
+                .memoryTypeIndex = memoryTypeIndex,
+                .pageHandle = page.pageHandle,
+                .memoryRange = *range,
+            };
+        }
+    }
+
+    const PageHandle pageHandle = AcquireDynamicArenaPage(memoryTypeIndex, AlignUp(size, alignment));
+    TransientMemoryPool::Page& page = pool.pages.emplace_back(TransientMemoryPool::Page{
+        .memoryTypeIndex = memoryTypeIndex,
+        .pageHandle = pageHandle,
+        .ranges = MemoryPageInfo(memoryTypeIndex, pageInfos[memoryTypeIndex][pageHandle].GetByteSize()),
+    });
+
+    // The page start satisfies any alignment.
+    return Allocation{
+        .memoryTypeIndex = memoryTypeIndex,
+        .pageHandle = pageHandle,
+        .memoryRange = *page.ranges.Allocate(size, alignment),
+    };
+}
+
+PageHandle RHIAllocatorBase::AcquireDynamicArenaPage(u32 memoryTypeIndex, u64 minByteSize)
+{
+    auto& memoryPages = pageInfos[memoryTypeIndex];
+    auto& freePages = dynamicArenas[memoryTypeIndex].freePages;
+
+    // The most recently freed pages are reused first, letting the others become idle so they can be released.
+    const auto it = std::ranges::find_if(freePages | std::views::reverse,
+                                         [&](const FreeArenaPage& freePage)
+                                         { return memoryPages[freePage.pageHandle].GetByteSize() >= minByteSize; });
+    if (it != freePages.rend())
+    {
+        const PageHandle pageHandle = it->pageHandle;
+        freePages.erase(std::next(it).base());
+        return pageHandle;
+    }
+
+    const u64 pageByteSize = std::max(minByteSize, DynamicArenaPageByteSize);
+    const PageHandle pageHandle = memoryPages.AllocateElement(MemoryPageInfo(memoryTypeIndex, pageByteSize));
+    // The arena owns the whole page, this prevents static allocations from being placed inside of it.
+    memoryPages[pageHandle].Allocate(pageByteSize, 1);
+#if !VEX_SHIPPING
+    VEX_LOG(Verbose, "Allocated new dynamic arena page: size {}!", pageByteSize);
+#endif
+
+    OnPageAllocated(pageHandle, memoryTypeIndex);
+    return pageHandle;
+}
+
 void RHIAllocatorBase::Free(const Allocation& allocation)
 {
     if (allocation.pageHandle == GInvalidPageHandle)
@@ -147,9 +496,14 @@ void RHIAllocatorBase::Free(const Allocation& allocation)
 #endif
     page.Free(allocation.memoryRange);
 
+    if (page.GetFreeSpace() != page.GetByteSize())
+    {
+        return;
+    }
+
     // If the page is a non-default sized page and was completely freed up (this was the last resource inside the
     // page), we can delete it.
-    if (page.GetByteSize() != page.DefaultPageByteSize && page.GetFreeSpace() == page.GetByteSize())
+    if (page.GetByteSize() != page.DefaultPageByteSize)
     {
 #if !VEX_SHIPPING
         VEX_LOG(Verbose, "Freed page: size {}", page.GetByteSize());
@@ -157,11 +511,132 @@ void RHIAllocatorBase::Free(const Allocation& allocation)
 
         OnPageFreed(allocation.pageHandle, allocation.memoryTypeIndex);
         memoryPages.FreeElement(allocation.pageHandle);
+        return;
     }
 
-    // Default sized pages persist, even when empty, as they will be the place where most memory gets stored.
-    // TBD if we want to have some tracking to also free those, right now its good enough to just keep expanding on
-    // demand.
+    // Default sized pages are where most memory gets stored, they persist while empty in case new resources are
+    // created soon after. ReleaseIdlePages releases them once they have been unused for long enough.
+    emptyPages.push_back({
+        .memoryTypeIndex = allocation.memoryTypeIndex,
+        .pageHandle = allocation.pageHandle,
+        .emptySince = std::chrono::steady_clock::now(),
+    });
+}
+
+void RHIAllocatorBase::ReleaseIdlePages(std::chrono::steady_clock::duration idleDuration, u64 keptByteSize)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    // The most recently emptied pages are the ones kept, as they are the least likely to be idle for long.
+    u64 keptPagesByteSize = 0;
+    for (std::size_t i = emptyPages.size(); i-- > 0;)
+    {
+        const EmptyPage& emptyPage = emptyPages[i];
+        auto& memoryPages = pageInfos[emptyPage.memoryTypeIndex];
+        const u64 pageByteSize = memoryPages[emptyPage.pageHandle].GetByteSize();
+
+        if (keptPagesByteSize + pageByteSize <= keptByteSize)
+        {
+            keptPagesByteSize += pageByteSize;
+            continue;
+        }
+
+        if (now - emptyPage.emptySince < idleDuration)
+        {
+            continue;
+        }
+
+#if !VEX_SHIPPING
+        VEX_LOG(Verbose, "Released idle page: size {} type {}", pageByteSize, emptyPage.memoryTypeIndex);
+#endif
+        OnPageFreed(emptyPage.pageHandle, emptyPage.memoryTypeIndex);
+        memoryPages.FreeElement(emptyPage.pageHandle);
+        emptyPages.erase(emptyPages.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Arena pages which were not needed by the recent frames and transient pools are released the same way.
+    for (u32 memoryTypeIndex = 0; memoryTypeIndex < dynamicArenas.size(); ++memoryTypeIndex)
+    {
+        auto& memoryPages = pageInfos[memoryTypeIndex];
+        auto& freePages = dynamicArenas[memoryTypeIndex].freePages;
+        for (std::size_t i = freePages.size(); i-- > 0;)
+        {
+            const FreeArenaPage& freePage = freePages[i];
+            const u64 pageByteSize = memoryPages[freePage.pageHandle].GetByteSize();
+
+            if (keptPagesByteSize + pageByteSize <= keptByteSize)
+            {
+                keptPagesByteSize += pageByteSize;
+                continue;
+            }
+
+            if (now - freePage.freeSince < idleDuration)
+            {
+                continue;
+            }
+
+#if !VEX_SHIPPING
+            VEX_LOG(Verbose, "Released idle dynamic arena page: size {} type {}", pageByteSize, memoryTypeIndex);
+#endif
+            OnPageFreed(freePage.pageHandle, memoryTypeIndex);
+            memoryPages.FreeElement(freePage.pageHandle);
+            freePages.erase(freePages.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+std::vector<DefragmentationPage> RHIAllocatorBase::BeginDefragmentation()
+{
+    VEX_ASSERT(defragmentationPages.empty(), "A defragmentation is already ongoing.");
+
+    for (u32 memoryTypeIndex = 0; memoryTypeIndex < pageInfos.size(); ++memoryTypeIndex)
+    {
+        auto& memoryPages = pageInfos[memoryTypeIndex];
+
+        struct Candidate
+        {
+            PageHandle pageHandle;
+            u64 usedByteSize;
+            u64 freeByteSize;
+        };
+        std::vector<Candidate> candidates;
+        u64 destinationFreeByteSize = 0;
+        for (auto it = memoryPages.begin(); it != memoryPages.end(); ++it)
+        {
+            // Arena pages are entirely reserved, so they are never candidates nor destinations.
+            destinationFreeByteSize += it->GetFreeSpace();
+
+            const u64 usedByteSize = it->GetByteSize() - it->GetFreeSpace();
+            if (it->GetByteSize() == MemoryPageInfo::DefaultPageByteSize && usedByteSize > 0 &&
+                usedByteSize <= static_cast<u64>(it->GetByteSize() * DefragmentationMaxPageOccupancy))
+            {
+                candidates.push_back({ it.GetHandle(), usedByteSize, it->GetFreeSpace() });
+            }
+        }
+
+        // Sparsest pages first, they are the cheapest to empty.
+        std::ranges::sort(candidates, {}, &Candidate::usedByteSize);
+
+        u64 movedByteSize = 0;
+        for (const Candidate& candidate : candidates)
+        {
+            // An evacuated page no longer receives allocations, its free space no longer counts.
+            if (movedByteSize + candidate.usedByteSize > destinationFreeByteSize - candidate.freeByteSize)
+            {
+                break;
+            }
+            movedByteSize += candidate.usedByteSize;
+            destinationFreeByteSize -= candidate.freeByteSize;
+            defragmentationPages.push_back({ .memoryTypeIndex = memoryTypeIndex, .pageHandle = candidate.pageHandle });
+        }
+    }
+
+    return defragmentationPages;
+}
+
+void RHIAllocatorBase::EndDefragmentation()
+{
+    defragmentationPages.clear();
 }
 
 } // namespace vex
\ No newline at end of file
@@ -1,22 +1,89 @@
 #pragma once
 
+#include <chrono>
 #include <vector>
 
 #include <Vex/Containers/FreeList.h>
+#include <Vex/Containers/Span.h>
 #include <Vex/MemoryAllocation.h>
+#include <Vex/Resource.h>
 #include <Vex/Types.h>
 
 namespace vex
 {
 
+struct DynamicArenaPage
+{
+    u32 memoryTypeIndex;
+    PageHandle pageHandle;
+};
+
+// Arena pages in which the transient resources of a command context are placed. Ranges freed from the pool are reused
+// by later transient allocations of the same pool, making their resources alias each other in memory.
+struct TransientMemoryPool
+{
+    struct Page
+    {
+        u32 memoryTypeIndex;
+        PageHandle pageHandle;
+        MemoryPageInfo ranges;
+    };
+    std::vector<Page> pages;
+};
+
+struct DefragmentationPage
+{
+    u32 memoryTypeIndex;
+    PageHandle pageHandle;
+
+    bool operator==(const DefragmentationPage&) const = default;
+};
+
 // Provides simple CPU-side tracking logic for allocating memory ranges inside memory pages (default size of 256MB per
 // page).
+// Dynamic resources are instead linearly allocated in per-frame arena pages, which are never freed individually: all
+// arena pages used by a frame are recycled at once when the GPU is done with that frame.
+// Transient resources are also placed in arena pages, owned by a TransientMemoryPool until it is recycled.
+// Empty default-sized pages and unused arena pages are kept around for future allocations, until they are released by
+// ReleaseIdlePages.
 class RHIAllocatorBase
 {
+public:
+    // Arena pages have a default size of 64MB.
+    static constexpr u64 DynamicArenaPageByteSize = 64 * 1024 * 1024;
+
+    // Returns the arena pages used by the dynamic allocations of the current frame, these must be passed to
+    // RecycleDynamicArenaPages once the GPU is done with the frame.
+    [[nodiscard]] std::vector<DynamicArenaPage> EndDynamicFrame();
+    void RecycleDynamicArenaPages(Span<const DynamicArenaPage> pages);
+
+    // Makes the range of a transient allocation available to the next transient allocations of the pool. The GPU
+    // accesses to the previous and next resources must be ordered by the caller.
+    void FreeTransient(TransientMemoryPool& pool, const Allocation& allocation);
+    // Returns the pages of the pool to the arena, must only be called once the GPU is done with all of its resources.
+    void RecycleTransientMemoryPool(TransientMemoryPool& pool);
+
+    // Releases the empty pages and unused arena pages which have been idle for longer than idleDuration. The most
+    // recently emptied pages are kept regardless of their idle time, up to keptByteSize bytes.
+    void ReleaseIdlePages(std::chrono::steady_clock::duration idleDuration, u64 keptByteSize);
+
+    // Pages whose occupancy is above this ratio are not worth moving resources out of.
+    static constexpr float DefragmentationMaxPageOccupancy = 0.5f;
+
+    // Selects the sparsest pages whose allocations fit in the free space of the other pages. Until EndDefragmentation
+    // is called, no new allocations are placed in the selected pages so that the caller can move resources out of them.
+    [[nodiscard]] std::vector<DefragmentationPage> BeginDefragmentation();
+    void EndDefragmentation();
+
 protected:
     RHIAllocatorBase(u32 memoryTypeCount);
 
-    Allocation Allocate(u64 size, u64 alignment, u32 memoryTypeIndex);
+    // Transient allocations require a pool.
+    Allocation Allocate(u64 size,
+                        u64 alignment,
+                        u32 memoryTypeIndex,
+                        ResourceLifetime lifetime = ResourceLifetime::Static,
+                        TransientMemoryPool* transientPool = nullptr);
     void Free(const Allocation& allocation);
 
     // Will perform the actual API calls to allocate/deallocate pages.
@@ -24,6 +91,37 @@ protected:
     virtual void OnPageFreed(PageHandle handle, u32 memoryTypeIndexs) = 0;
 
     std::vector<FreeList<MemoryPageInfo, PageHandle>> pageInfos;
+
+private:
+    Allocation AllocateDynamic(u64 size, u64 alignment, u32 memoryTypeIndex);
+    Allocation AllocateTransient(TransientMemoryPool& pool, u64 size, u64 alignment, u32 memoryTypeIndex);
+    PageHandle AcquireDynamicArenaPage(u32 memoryTypeIndex, u64 minByteSize);
+
+    struct FreeArenaPage
+    {
+        PageHandle pageHandle;
+        std::chrono::steady_clock::time_point freeSince;
+    };
+    struct DynamicArena
+    {
+        // Ordered from the least to the most recently freed page.
+        std::vector<FreeArenaPage> freePages;
+        // Pages used by the current frame, allocations are made in the last one.
+        std::vector<PageHandle> framePages;
+        u64 currentPageOffset = 0;
+    };
+    std::vector<DynamicArena> dynamicArenas;
+
+    struct EmptyPage
+    {
+        u32 memoryTypeIndex;
+        PageHandle pageHandle;
+        std::chrono::steady_clock::time_point emptySince;
+    };
+    // Ordered from the least to the most recently emptied page.
+    std::vector<EmptyPage> emptyPages;
+
+    std::vector<DefragmentationPage> defragmentationPages;
 };
 
 } // namespace vex
\ No newline at end of file
@@ -84,6 +84,8 @@ struct RHIGlobalBarrier
 
     RHIBarrierAccess srcAccess;
     RHIBarrierAccess dstAccess;
+
+    constexpr bool operator==(const RHIGlobalBarrier&) const = default;
 };
 
 struct RHITextureBarrier
@@ -24,6 +24,17 @@ struct RHIBufferBinding
     NonNullPtr<RHIBuffer> buffer;
 };
 
+struct RHIIndirectArgsBinding
+{
+    NonNullPtr<RHIBuffer> argsBuffer;
+    u64 argsOffsetByteSize = 0;
+    u32 argsStrideByteSize = 0;
+    u32 maxCommandCount = 1;
+    // Null when the command count is not read from the GPU.
+    RHIBuffer* countBuffer = nullptr;
+    u64 countOffsetByteSize = 0;
+};
+
 struct RHIDrawResources
 {
     std::vector<RHITextureBinding> renderTargets;
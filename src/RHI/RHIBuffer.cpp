@@ -28,7 +28,7 @@ BindlessHandle RHIBufferBase::GetOrCreateBindlessView(const BufferBinding& bindi
         return viewCache[bufferView];
     }
 
-    const BindlessHandle handle = descriptorPool.AllocateStaticDescriptor(DescriptorType::Resource);
+    const BindlessHandle handle = descriptorPool.AllocateResourceDescriptor(lifetime);
 
     AllocateBindlessHandle(descriptorPool, handle, bufferView);
 
@@ -45,8 +45,19 @@ void RHIBufferBase::FreeBindlessHandles(RHIDescriptorPool& descriptorPool)
     viewCache.clear();
 }
 
-RHIBufferBase::RHIBufferBase(RHIAllocator& allocator, const BufferDesc& desc)
+void RHIBufferBase::TakeBindlessViews(RHIBufferBase& source, RHIDescriptorPool& descriptorPool)
+{
+    for (const auto& [bufferView, handle] : source.viewCache)
+    {
+        AllocateBindlessHandle(descriptorPool, handle, bufferView);
+        viewCache[bufferView] = handle;
+    }
+    source.viewCache.clear();
+}
+
+RHIBufferBase::RHIBufferBase(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime)
     : desc{ desc }
+    , lifetime{ lifetime }
     , allocator{ allocator }
 {
 }
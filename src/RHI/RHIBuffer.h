@@ -43,6 +43,15 @@ VEX_MAKE_HASHABLE(vex::BufferViewDesc,
 namespace vex
 {
 
+// Buffers have no layout, their state is only used to determine which accesses must be synchronized.
+struct RHIBufferState
+{
+    RHIBarrierSync sync = RHIBarrierSync::None;
+    RHIBarrierAccess access = RHIBarrierAccess::NoAccess;
+
+    constexpr bool operator==(const RHIBufferState&) const = default;
+};
+
 class RHIBufferBase
 {
 public:
@@ -67,6 +76,10 @@ public:
     void FreeBindlessHandles(RHIDescriptorPool& descriptorPool);
     void FreeAllocation(RHIAllocator& allocator);
 
+    // Rewrites the bindless descriptors of the source buffer so that they point to this buffer, its bindless handles
+    // remain valid and are now owned by this buffer. The GPU must no longer be using the source's descriptors.
+    void TakeBindlessViews(RHIBufferBase& source, RHIDescriptorPool& descriptorPool);
+
     [[nodiscard]] const BufferDesc& GetDesc() const
     {
         return desc;
@@ -77,8 +90,15 @@ public:
         return allocation;
     }
 
+    [[nodiscard]] ResourceLifetime GetLifetime() const
+    {
+        return lifetime;
+    }
+
 protected:
-    explicit RHIBufferBase(RHIAllocator& allocator, const BufferDesc& desc);
+    explicit RHIBufferBase(RHIAllocator& allocator,
+                           const BufferDesc& desc,
+                           ResourceLifetime lifetime = ResourceLifetime::Static);
 
     virtual void AllocateBindlessHandle(RHIDescriptorPool& descriptorPool,
                                         BindlessHandle handle,
@@ -87,6 +107,7 @@ protected:
     BufferViewDesc GetViewDescFromBinding(const BufferBinding& binding);
 
     BufferDesc desc;
+    ResourceLifetime lifetime = ResourceLifetime::Static;
 
     NonNullPtr<RHIAllocator> allocator;
     Allocation allocation;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <optional>
 #include <vector>
 
 #include <Vex/Containers/Span.h>
@@ -21,9 +22,11 @@ namespace vex
 
 struct RHIDrawResources;
 struct RHIBufferBinding;
+struct RHIIndirectArgsBinding;
 struct RHITextureBinding;
 struct InputAssembly;
 struct RHIBLASBuildDesc;
+struct RHIBLASBuild;
 struct RHITLASBuildDesc;
 struct TraceRaysDesc;
 
@@ -53,7 +56,7 @@ public:
     virtual void SetPipelineState(const RHIComputePipelineState& computePipelineState) = 0;
     virtual void SetPipelineState(const RHIRayTracingPipelineState& rayTracingPipelineState) = 0;
 
-    virtual void SetLayout(RHIResourceLayout& layout) = 0;
+    virtual void SetLayout(RHIResourceLayout& layout, Span<const byte> localConstantsData) = 0;
     virtual void SetDescriptorPool(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout) = 0;
     virtual void SetInputAssembly(InputAssembly inputAssembly) = 0;
 
@@ -68,6 +71,14 @@ public:
     virtual void EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
                               Span<const RHITextureBarrier> textureBarriers,
                               Span<const RHIGlobalBarrier> globalBarriers) = 0;
+    // Split barriers allow the GPU to overlap the transitions with the work recorded between their begin and end. The
+    // returned index identifies the split barrier, which must be ended in the same command list with the exact same
+    // barriers. Cannot be called while rendering.
+    virtual u32 BeginSplitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                   Span<const RHITextureBarrier> textureBarriers) = 0;
+    virtual void EndSplitBarriers(u32 splitBarrierIndex,
+                                  Span<const RHIBufferBarrier> bufferBarriers,
+                                  Span<const RHITextureBarrier> textureBarriers) = 0;
 
     // Need to be called before and after all draw commands with the same DrawBinding
     virtual void BeginRendering(const RHIDrawResources& resources) = 0;
@@ -76,11 +87,15 @@ public:
     virtual void Draw(u32 vertexCount, u32 instanceCount = 1, u32 vertexOffset = 0, u32 instanceOffset = 0) = 0;
     virtual void DrawIndexed(
         u32 indexCount, u32 instanceCount = 1, u32 indexOffset = 0, u32 vertexOffset = 0, u32 instanceOffset = 0) = 0;
+    // Indirect variants, their arguments are read from the GPU (see DrawIndirectArgs and DrawIndexedIndirectArgs).
+    virtual void DrawIndirect(const RHIIndirectArgsBinding& indirectArgs) = 0;
+    virtual void DrawIndexedIndirect(const RHIIndirectArgsBinding& indirectArgs) = 0;
 
     virtual void SetVertexBuffers(u32 startSlot, Span<const RHIBufferBinding> vertexBuffers) = 0;
     virtual void SetIndexBuffer(const RHIBufferBinding& indexBuffer) = 0;
 
     virtual void Dispatch(const std::array<u32, 3>& groupCount) = 0;
+    virtual void DispatchIndirect(const RHIIndirectArgsBinding& indirectArgs) = 0;
 
     virtual void TraceRays(const TraceRaysDesc& rayTracingArgs,
                            const RHIRayTracingPipelineState& rayTracingPipelineState) = 0;
@@ -91,11 +106,19 @@ public:
     virtual void EndTimestampQuery(QueryHandle handle) = 0;
     virtual void ResolveTimestampQueries(u32 firstQuery, u32 queryCount) = 0;
 
-    virtual void BuildBLAS(RHIAccelerationStructure& as, RHIBuffer& scratchBuffer) = 0;
+    // Builds all the BLAS, each using its own range of the shared scratch buffer.
+    virtual void BuildBLAS(Span<const RHIBLASBuild> builds, RHIBuffer& scratchBuffer) = 0;
+    // Builds the TLAS, or updates it in place when isUpdate is set.
     virtual void BuildTLAS(RHIAccelerationStructure& as,
                            RHIBuffer& scratchBuffer,
                            RHIBuffer& uploadBuffer,
-                           const RHITLASBuildDesc& desc) = 0;
+                           const RHITLASBuildDesc& desc,
+                           bool isUpdate) = 0;
+    // Writes the compacted byte size of each acceleration structure into the buffer, as tightly packed u64s.
+    virtual void WriteCompactedSizes(Span<const NonNullPtr<RHIAccelerationStructure>> accelerationStructures,
+                                     RHIBuffer& dstBuffer) = 0;
+    // Copies src into dst, which must have been setup with src's compacted byte size.
+    virtual void CompactAccelerationStructure(RHIAccelerationStructure& src, RHIAccelerationStructure& dst) = 0;
 
     // Copies the whole texture data from src to dst. These textures should have the same size, mips, slice, type,
     // format, etc...
@@ -132,6 +155,25 @@ public:
     void SetState(RHICommandListState newState)
     {
         state = newState;
+        if (state == RHICommandListState::Available)
+        {
+            oldestBoundHeapVersion.reset();
+        }
+    }
+
+    // Oldest descriptor pool heap bound since the command list was acquired, which must be kept alive until the command
+    // list is done executing.
+    std::optional<u32> GetOldestBoundDescriptorHeapVersion() const
+    {
+        return oldestBoundHeapVersion;
+    }
+    void OnDescriptorHeapBound(u32 heapVersion)
+    {
+        // Heap versions only increase, the first heap bound is the oldest.
+        if (!oldestBoundHeapVersion.has_value())
+        {
+            oldestBoundHeapVersion = heapVersion;
+        }
     }
 
     Span<const SyncToken> GetSyncTokens() const
@@ -163,6 +205,8 @@ protected:
     std::vector<QueryHandle> queries;
 
     bool isOpen = false;
+
+    std::optional<u32> oldestBoundHeapVersion;
 };
 
 } // namespace vex
\ No newline at end of file
@@ -1,19 +1,70 @@
 #include "RHICommandPool.h"
 
+#include <algorithm>
+#include <ranges>
+
 #include <Vex/RHIImpl/RHI.h>
 #include <Vex/RHIImpl/RHICommandList.h>
 
 namespace vex
 {
 
+namespace RHICommandPool_Internal
+{
+
+std::weak_ptr<const void> GetThreadLifetime()
+{
+    // Destroyed when the calling thread exits.
+    thread_local const std::shared_ptr<const int> threadLifetime = std::make_shared<const int>();
+    return threadLifetime;
+}
+
+} // namespace RHICommandPool_Internal
+
 RHICommandPoolBase::RHICommandPoolBase(RHI& rhi)
     : rhi(rhi)
 {
 }
 
+NonNullPtr<RHICommandList> RHICommandPoolBase::GetOrCreateCommandList(QueueType queueType)
+{
+    std::scoped_lock lock(*mutex);
+
+    ThreadCommandLists& threadCommandLists = commandListsPerThread[std::this_thread::get_id()];
+    // Also covers a new thread reusing the id of an exited one, which can then take over its command lists.
+    if (threadCommandLists.threadLifetime.expired())
+    {
+        threadCommandLists.threadLifetime = RHICommandPool_Internal::GetThreadLifetime();
+    }
+
+    auto& commandLists = threadCommandLists.commandListsPerQueue[queueType];
+    RHICommandList* cmdListPtr = nullptr;
+    if (auto res = std::find_if(commandLists.begin(),
+                                commandLists.end(),
+                                [](const std::unique_ptr<RHICommandList>& cmdList)
+                                { return cmdList->GetState() == RHICommandListState::Available; });
+        res != commandLists.end())
+    {
+        // Reserve the available command list.
+        cmdListPtr = res->get();
+    }
+    else
+    {
+        // No more available command lists, create and return a new one.
+        cmdListPtr = commandLists.emplace_back(CreateCommandList(queueType)).get();
+    }
+
+    VEX_ASSERT(cmdListPtr != nullptr);
+    cmdListPtr->SetState(RHICommandListState::Recording);
+
+    return NonNullPtr(cmdListPtr);
+}
+
 void RHICommandPoolBase::OnCommandListsSubmitted(Span<const NonNullPtr<RHICommandList>> submits,
                                                  Span<const SyncToken> syncTokens)
 {
+    std::scoped_lock lock(*mutex);
+
     // Save the state of the newly submitted command lists
     for (u32 i = 0; i < submits.size(); ++i)
     {
@@ -23,38 +74,92 @@ void RHICommandPoolBase::OnCommandListsSubmitted(Span<const NonNullPtr<RHIComman
     }
 }
 
+bool RHICommandPoolBase::HasRecordingCommandLists()
+{
+    std::scoped_lock lock(*mutex);
+
+    return std::ranges::any_of(commandListsPerThread | std::views::values,
+                               [](const ThreadCommandLists& threadCommandLists)
+                               {
+                                   return std::ranges::any_of(
+                                       threadCommandLists.commandListsPerQueue | std::views::join,
+                                       [](const std::unique_ptr<RHICommandList>& cmdList)
+                                       { return cmdList->GetState() == RHICommandListState::Recording; });
+                               });
+}
+
+std::optional<u32> RHICommandPoolBase::GetOldestBoundDescriptorHeapVersion()
+{
+    std::scoped_lock lock(*mutex);
+
+    std::optional<u32> oldestHeapVersion;
+    for (const auto& threadCommandLists : commandListsPerThread | std::views::values)
+    {
+        for (const auto& cmdList : threadCommandLists.commandListsPerQueue | std::views::join)
+        {
+            const std::optional<u32> heapVersion = cmdList->GetOldestBoundDescriptorHeapVersion();
+            if (cmdList->GetState() != RHICommandListState::Available && heapVersion.has_value())
+            {
+                oldestHeapVersion = std::min(oldestHeapVersion.value_or(*heapVersion), *heapVersion);
+            }
+        }
+    }
+    return oldestHeapVersion;
+}
+
 void RHICommandPoolBase::ReclaimCommandLists()
 {
-    for (u32 i = 0; i < QueueTypes::Count; ++i)
+    std::scoped_lock lock(*mutex);
+
+    for (auto& threadCommandLists : commandListsPerThread | std::views::values)
     {
-        for (auto& pool = GetCommandLists(static_cast<QueueType>(i)); auto& cmdList : pool)
+        for (auto& pool : threadCommandLists.commandListsPerQueue)
         {
-            // We can only reclaim submitted command lists.
-            if (cmdList->GetState() == RHICommandListState::Submitted)
+            for (auto& cmdList : pool)
             {
-                bool areAllTokensComplete = true;
-                for (auto tokens = cmdList->GetSyncTokens(); auto& token : tokens)
+                // We can only reclaim submitted command lists.
+                if (cmdList->GetState() == RHICommandListState::Submitted)
                 {
-                    if (!rhi->IsTokenComplete(token))
+                    bool areAllTokensComplete = true;
+                    for (auto tokens = cmdList->GetSyncTokens(); auto& token : tokens)
                     {
-                        areAllTokensComplete = false;
-                        break;
+                        if (!rhi->IsTokenComplete(token))
+                        {
+                            areAllTokensComplete = false;
+                            break;
+                        }
                     }
-                }
 
-                if (areAllTokensComplete)
-                {
-                    // Work is done, can now mark as available (and thus reclaim the command list for future CPU use).
-                    cmdList->SetState(RHICommandListState::Available);
+                    if (areAllTokensComplete)
+                    {
+                        // Work is done, can now mark as available (and thus reclaim the command list for future CPU
+                        // use).
+                        cmdList->SetState(RHICommandListState::Available);
+                    }
                 }
             }
         }
     }
-}
 
-std::vector<std::unique_ptr<RHICommandList>>& RHICommandPoolBase::GetCommandLists(QueueType queueType)
-{
-    return commandListsPerQueue[queueType];
+    // Release the command lists of exited threads, once none of them is still recording or executing.
+    for (auto it = commandListsPerThread.begin(); it != commandListsPerThread.end();)
+    {
+        const auto& [threadId, threadCommandLists] = *it;
+        const bool isReleasable =
+            threadCommandLists.threadLifetime.expired() &&
+            std::ranges::all_of(threadCommandLists.commandListsPerQueue | std::views::join,
+                                [](const std::unique_ptr<RHICommandList>& cmdList)
+                                { return cmdList->GetState() == RHICommandListState::Available; });
+        if (!isReleasable)
+        {
+            ++it;
+            continue;
+        }
+
+        const std::thread::id releasedThreadId = threadId;
+        it = commandListsPerThread.erase(it);
+        ReleaseThreadResources(releasedThreadId);
+    }
 }
 
-} // namespace vex
\ No newline at end of file
+} // namespace vex
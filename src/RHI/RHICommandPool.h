@@ -1,35 +1,62 @@
 #pragma once
 
 #include <array>
-#include <Vex/Containers/Span.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include <Vex/Utility/NonNullPtr.h>
+#include <Vex/Containers/Span.h>
 #include <Vex/Synchronization.h>
-
+#include <Vex/Utility/NonNullPtr.h>
 
 #include <RHI/RHIFwd.h>
 
 namespace vex
 {
 
+// Command lists are owned by the thread which created them and are only ever handed back out to that thread, this
+// allows backends to use per-thread native command pools and lets command contexts be recorded in parallel. The command
+// lists of a thread which exited are released once the GPU is done executing them.
 class RHICommandPoolBase
 {
 public:
     RHICommandPoolBase(RHI& rhi);
     // Available -> Recording
-    virtual NonNullPtr<RHICommandList> GetOrCreateCommandList(QueueType queueType) = 0;
+    NonNullPtr<RHICommandList> GetOrCreateCommandList(QueueType queueType);
     // Recording -> Submitted
     void OnCommandListsSubmitted(Span<const NonNullPtr<RHICommandList>> submits, Span<const SyncToken> syncTokens);
     // Submitted -> Available
     void ReclaimCommandLists();
 
+    // Whether a command list was handed out and not yet submitted, its command context can still record commands.
+    bool HasRecordingCommandLists();
+    // Oldest descriptor pool heap bound to a command list which is recording or executing, if any.
+    std::optional<u32> GetOldestBoundDescriptorHeapVersion();
+
 protected:
-    std::vector<std::unique_ptr<RHICommandList>>& GetCommandLists(QueueType queueType);
+    // Called from the thread which will record the command list, with the pool's lock held.
+    virtual std::unique_ptr<RHICommandList> CreateCommandList(QueueType queueType) = 0;
+    // Called once the command lists of an exited thread were destroyed, with the pool's lock held.
+    virtual void ReleaseThreadResources(std::thread::id /*threadId*/)
+    {
+    }
+
+    using CommandListsPerQueue = std::array<std::vector<std::unique_ptr<RHICommandList>>, QueueTypes::Count>;
+    struct ThreadCommandLists
+    {
+        // Expires when the thread exits.
+        std::weak_ptr<const void> threadLifetime;
+        CommandListsPerQueue commandListsPerQueue;
+    };
 
     NonNullPtr<RHI> rhi;
-    std::array<std::vector<std::unique_ptr<RHICommandList>>, QueueTypes::Count> commandListsPerQueue;
+    std::unordered_map<std::thread::id, ThreadCommandLists> commandListsPerThread;
+    // Held behind a pointer to keep the pool movable.
+    std::unique_ptr<std::mutex> mutex = std::make_unique<std::mutex>();
 };
 
-} // namespace vex
\ No newline at end of file
+} // namespace vex
@@ -1,44 +1,138 @@
 #include "RHIDescriptorPool.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include <Vex/Logger.h>
+#include <Vex/RHIImpl/RHICommandList.h>
+#include <Vex/RHIImpl/RHICommandPool.h>
+#include <Vex/RHIImpl/RHIDescriptorPool.h>
 
 namespace vex
 {
 
-RHIDescriptorPoolBase::RHIDescriptorPoolBase()
+RHIDescriptorPoolBase::RHIDescriptorPoolBase(u32 maxResourceDescriptorCount)
     : allocator({
           .generations = std::vector<u8>(GDefaultDescriptorPoolSize),
-          .handles = FreeListAllocator(GDefaultDescriptorPoolSize),
+          // The start of the pool is reserved for dynamic descriptors, growing the pool only appends static ones.
+          .handles = FreeListAllocator(GDefaultDescriptorPoolSize - GDynamicDescriptorCount),
+          .firstIndex = GDynamicDescriptorCount,
       })
+    , maxResourceDescriptorCount(maxResourceDescriptorCount)
 {
 }
 
 BindlessHandle RHIDescriptorPoolBase::AllocateStaticDescriptor(DescriptorType descriptorType)
 {
-    auto& [generations, handles] = descriptorType == DescriptorType::Resource ? allocator : samplerAllocator;
-    if (handles.freeIndices.empty())
+    BindlessAllocation& allocation = descriptorType == DescriptorType::Resource ? allocator : samplerAllocator;
+    if (allocation.handles.freeIndices.empty())
     {
-        // TODO(https://trello.com/c/uGignSlW): Add resizing, would require copying previous descriptors into the new heap AND making sure the heap
-        // survives for atleast FrameBuffering frames. Resize(gpuHeap.size() * 2);
-        VEX_LOG(Fatal, "Ran out of static descriptors...");
+        if (descriptorType == DescriptorType::Sampler)
+        {
+            VEX_LOG(Fatal,
+                    "Ran out of sampler descriptors, at most {} bindless samplers can exist...",
+                    GMaxBindlessSamplerCount);
+        }
+        GrowResourceDescriptors();
     }
 
-    const u32 index = handles.Allocate();
-    return BindlessHandle::CreateHandle(index, generations[index]);
+    const u32 index = allocation.firstIndex + allocation.handles.Allocate();
+    return BindlessHandle::CreateHandle(index, allocation.generations[index]);
 }
 
 void RHIDescriptorPoolBase::FreeStaticDescriptor(DescriptorType descriptorType, BindlessHandle handle)
 {
-    auto& [generations, handles] = descriptorType == DescriptorType::Resource ? allocator : samplerAllocator;
+    BindlessAllocation& allocation = descriptorType == DescriptorType::Resource ? allocator : samplerAllocator;
     const u32 index = handle.GetIndex();
-    generations[index]++;
-    handles.Deallocate(index);
+    allocation.generations[index]++;
+    allocation.handles.Deallocate(index - allocation.firstIndex);
     // Clear out the resource from the slot to ensure that the GPU crashes if attempting to access this.
     CopyNullDescriptor(descriptorType, index);
 }
 
+BindlessHandle RHIDescriptorPoolBase::AllocateDynamicDescriptor()
+{
+    if (dynamicDescriptorHead - dynamicDescriptorTail == GDynamicDescriptorCount)
+    {
+        VEX_LOG(Fatal,
+                "Ran out of dynamic descriptors, the frames in flight use more than {} dynamic resource views...",
+                GDynamicDescriptorCount);
+    }
+
+    const u32 index = static_cast<u32>(dynamicDescriptorHead % GDynamicDescriptorCount);
+    dynamicDescriptorHead++;
+    return BindlessHandle::CreateHandle(index, allocator.generations[index]);
+}
+
+void RHIDescriptorPoolBase::FreeDynamicDescriptors(u64 frameEndMarker)
+{
+    VEX_ASSERT(frameEndMarker >= dynamicDescriptorTail && frameEndMarker <= dynamicDescriptorHead,
+               "Dynamic descriptor frames must be freed in order.");
+
+    // The views of the freed descriptors can be destroyed before any submission flushed their writes, which must then
+    // never be flushed. The freed range wraps around the ring at most once.
+    while (dynamicDescriptorTail < frameEndMarker)
+    {
+        const u32 firstSlot = static_cast<u32>(dynamicDescriptorTail % GDynamicDescriptorCount);
+        const u32 slotCount = static_cast<u32>(
+            std::min<u64>(frameEndMarker - dynamicDescriptorTail, GDynamicDescriptorCount - firstSlot));
+        DiscardPendingDescriptorWrites(firstSlot, slotCount);
+        // Like static descriptors, invalidates the handles of the freed descriptors before their slots are reused.
+        for (u32 slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+        {
+            allocator.generations[slot]++;
+        }
+        dynamicDescriptorTail += slotCount;
+    }
+}
+
+BindlessHandle RHIDescriptorPoolBase::AllocateResourceDescriptor(ResourceLifetime lifetime)
+{
+    return lifetime == ResourceLifetime::Dynamic ? AllocateDynamicDescriptor()
+                                                 : AllocateStaticDescriptor(DescriptorType::Resource);
+}
+
 bool RHIDescriptorPoolBase::IsValid(BindlessHandle handle)
 {
     return handle.GetGeneration() == allocator.generations[handle.GetIndex()];
 }
+
+u32 RHIDescriptorPoolBase::BindHeap(RHICommandList& cmdList,
+                                    RHIResourceLayout& resourceLayout,
+                                    std::optional<u32> boundHeapVersion)
+{
+    std::shared_lock lock(*heapMutex);
+    if (boundHeapVersion != heapVersion)
+    {
+        cmdList.SetDescriptorPool(static_cast<RHIDescriptorPool&>(*this), resourceLayout);
+        cmdList.OnDescriptorHeapBound(heapVersion);
+    }
+    return heapVersion;
+}
+
+void RHIDescriptorPoolBase::ReleaseUnusedHeaps(RHICommandPool& commandPool)
+{
+    // Held exclusively so that no command list binds a heap while the bound heaps are gathered.
+    std::unique_lock lock(*heapMutex);
+    ReleaseRetiredHeaps(commandPool.GetOldestBoundDescriptorHeapVersion().value_or(heapVersion));
+}
+
+void RHIDescriptorPoolBase::GrowResourceDescriptors()
+{
+    const u32 size = static_cast<u32>(allocator.generations.size());
+    VEX_CHECK(size < maxResourceDescriptorCount,
+              "Ran out of static descriptors, the descriptor pool cannot grow past {} descriptors...",
+              maxResourceDescriptorCount);
+
+    const u32 newSize = std::min(size * 2, maxResourceDescriptorCount);
+    VEX_LOG(Info, "Growing the descriptor pool from {} to {} descriptors.", size, newSize);
+
+    {
+        std::unique_lock lock(*heapMutex);
+        heapVersion++;
+        GrowResourceHeap(newSize);
+    }
+    allocator.generations.resize(newSize);
+    allocator.handles.Resize(newSize - allocator.firstIndex);
+}
 } // namespace vex
\ No newline at end of file
@@ -1,13 +1,24 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+
 #include <Vex/Containers/FreeList.h>
 #include <Vex/Resource.h>
 #include <Vex/TextureSampler.h>
 
+#include <RHI/RHIFwd.h>
+
 namespace vex
 {
 
 static constexpr u32 GDefaultDescriptorPoolSize = 65536;
+// Upper bound of the resource descriptor pool, which doubles in size whenever it runs out of static descriptors.
+// Matches the size of the shader visible heaps supported by DX12's resource binding tiers 1 and 2.
+static constexpr u32 GMaxDescriptorPoolSize = 1000000;
+// Number of descriptors (at the start of the pool) reserved for the views of dynamic resources.
+static constexpr u32 GDynamicDescriptorCount = 8192;
 
 enum class DescriptorType : u8
 {
@@ -18,7 +29,7 @@ enum class DescriptorType : u8
 class RHIDescriptorPoolBase
 {
 public:
-    RHIDescriptorPoolBase();
+    RHIDescriptorPoolBase(u32 maxResourceDescriptorCount);
 
     virtual BindlessHandle CreateBindlessSampler(const BindlessTextureSampler& textureSampler) = 0;
     virtual void FreeBindlessSampler(BindlessHandle handle) = 0;
@@ -27,19 +38,73 @@ public:
     // We don't use BindlessHandle, as it is technically no longer valid.
     virtual void CopyNullDescriptor(DescriptorType descriptorType, u32 slotIndex) = 0;
 
+    // Backends can defer descriptor writes to batch them, they must be flushed before submitting work using them.
+    virtual void FlushPendingDescriptorWrites() = 0;
+    // Drops the deferred writes of slotCount descriptors starting at firstSlot, whose views were destroyed.
+    virtual void DiscardPendingDescriptorWrites(u32 firstSlot, u32 slotCount) = 0;
+
     BindlessHandle AllocateStaticDescriptor(DescriptorType descriptorType);
     void FreeStaticDescriptor(DescriptorType descriptorType, BindlessHandle handle);
 
+    // Dynamic descriptors are linearly allocated in a ring, and are never freed individually. Instead, all the
+    // descriptors of a frame are freed at once when the GPU is done with that frame.
+    BindlessHandle AllocateDynamicDescriptor();
+    // Returns the marker to pass to FreeDynamicDescriptors once the GPU is done with the current frame.
+    [[nodiscard]] u64 EndDynamicDescriptorFrame() const
+    {
+        return dynamicDescriptorHead;
+    }
+    void FreeDynamicDescriptors(u64 frameEndMarker);
+
+    // Allocates a resource descriptor with the same lifetime as its resource.
+    BindlessHandle AllocateResourceDescriptor(ResourceLifetime lifetime);
+
     bool IsValid(BindlessHandle handle);
 
+    // The heap holding the resource descriptors is replaced by a larger one when the pool grows. Command lists must
+    // bind the pool again when its heap version changes, before using any bindless handle allocated after the growth.
+    // Binds the pool to the command list unless the heap of boundHeapVersion is the current one, returns the version of
+    // the current heap. Safe to call while another thread grows the pool.
+    u32 BindHeap(RHICommandList& cmdList, RHIResourceLayout& resourceLayout, std::optional<u32> boundHeapVersion);
+    // Destroys the replaced heaps which are no longer bound to a command list recording or executing on the GPU.
+    void ReleaseUnusedHeaps(RHICommandPool& commandPool);
+
 protected:
+    [[nodiscard]] u32 GetHeapVersion() const
+    {
+        return heapVersion;
+    }
+
+    // Replaces the resource descriptor heap by one holding newSize descriptors, copying the existing descriptors over
+    // to the same indices. The previous heap is retired with the new heap version, it must be kept alive until it is
+    // released by ReleaseRetiredHeaps.
+    virtual void GrowResourceHeap(u32 newSize) = 0;
+    // Destroys the heaps retired up to the passed in heap version, which is the oldest version still in use.
+    virtual void ReleaseRetiredHeaps(u32 oldestUsedHeapVersion) = 0;
+
     struct BindlessAllocation
     {
         std::vector<u8> generations;
         FreeListAllocator32 handles;
+        // Index of the descriptor corresponding to the first index of handles.
+        u32 firstIndex = 0;
     };
     BindlessAllocation allocator;
     BindlessAllocation samplerAllocator;
+
+    // Monotonic counters, the ring slot of a dynamic descriptor is its counter modulo GDynamicDescriptorCount.
+    u64 dynamicDescriptorHead = 0;
+    u64 dynamicDescriptorTail = 0;
+
+    u32 maxResourceDescriptorCount;
+
+private:
+    void GrowResourceDescriptors();
+
+    u32 heapVersion = 0;
+    // Taken exclusively to replace or release heaps, command lists bind the current heap with it held shared. Held
+    // behind a pointer to keep the pool movable.
+    std::unique_ptr<std::shared_mutex> heapMutex = std::make_unique<std::shared_mutex>();
 };
 
 } // namespace vex
@@ -13,6 +13,10 @@ enum class Feature : u8
 {
     MeshShader,
     RayTracing,
+    // Indirect draws executing more than one draw.
+    MultiDrawIndirect,
+    // Indirect draws reading their draw count from a GPU buffer.
+    DrawIndirectCount,
 };
 
 // Graphics API implementation differences, depends on what the API allows for.
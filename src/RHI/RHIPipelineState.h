@@ -23,13 +23,18 @@ public:
         : key{ std::move(key) }
     {
     }
+    // Backends which support it can fast-link the pipeline state from separately compiled parts when allowFastLink is
+    // set, which is much quicker to compile but can be slower to execute.
     virtual void Compile(const ShaderView& vertexShader,
                          const ShaderView& pixelShader,
-                         RHIResourceLayout& resourceLayout) = 0;
+                         RHIResourceLayout& resourceLayout,
+                         bool allowFastLink) = 0;
     virtual std::unique_ptr<RHIGraphicsPipelineState> Cleanup() = 0;
 
     Key key;
     u32 rootSignatureVersion = 0;
+    // Set by Compile when the pipeline state was fast-linked, it should then be replaced by an optimized one.
+    bool isFastLinked = false;
 };
 
 class RHIComputePipelineStateBase
@@ -11,30 +11,10 @@ namespace vex
 RHIResourceLayoutBase::RHIResourceLayoutBase()
     : maxLocalConstantsByteSize(GPhysicalDevice->GetMaxLocalConstantsByteSize())
 {
-    localConstantsData.reserve(maxLocalConstantsByteSize);
 }
 
 RHIResourceLayoutBase::~RHIResourceLayoutBase() = default;
 
-void RHIResourceLayoutBase::SetLayoutResources(const ConstantBinding& constants)
-{
-    if (constants.IsValid())
-    {
-        if (constants.data.size_bytes() > maxLocalConstantsByteSize)
-        {
-            VEX_LOG(Fatal,
-                    "Cannot pass in more bytes as local constants versus what your platform allows. You passed in {} "
-                    "bytes, your graphics API allows for {} bytes.",
-                    constants.data.size_bytes(),
-                    maxLocalConstantsByteSize)
-            return;
-        }
-
-        localConstantsData.resize(constants.data.size_bytes());
-        std::memcpy(localConstantsData.data(), constants.data.data(), constants.data.size_bytes());
-    }
-}
-
 void RHIResourceLayoutBase::SetStaticSamplers(Span<const StaticTextureSampler> newSamplers)
 {
     staticSamplers = { newSamplers.begin(), newSamplers.end() };
@@ -46,9 +26,24 @@ Span<const StaticTextureSampler> RHIResourceLayoutBase::GetStaticSamplers() cons
     return staticSamplers;
 }
 
-Span<const byte> RHIResourceLayoutBase::GetLocalConstantsData() const
+Span<const byte> RHIResourceLayoutBase::GetLocalConstantsData(const ConstantBinding& constants) const
 {
-    return localConstantsData;
+    if (!constants.IsValid())
+    {
+        return {};
+    }
+
+    if (constants.data.size_bytes() > maxLocalConstantsByteSize)
+    {
+        VEX_LOG(Fatal,
+                "Cannot pass in more bytes as local constants versus what your platform allows. You passed in {} "
+                "bytes, your graphics API allows for {} bytes.",
+                constants.data.size_bytes(),
+                maxLocalConstantsByteSize);
+        return {};
+    }
+
+    return constants.data;
 }
 
 } // namespace vex
\ No newline at end of file
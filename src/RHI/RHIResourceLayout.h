@@ -15,12 +15,13 @@ class RHIResourceLayoutBase
 public:
     RHIResourceLayoutBase();
     ~RHIResourceLayoutBase();
-    void SetLayoutResources(const ConstantBinding& constants);
 
     void SetStaticSamplers(Span<const StaticTextureSampler> newSamplers);
     Span<const StaticTextureSampler> GetStaticSamplers() const;
 
-    Span<const byte> GetLocalConstantsData() const;
+    // Validates the constants against the platform's limits. The layout keeps no copy of the constants, so that command
+    // lists can be recorded with it in parallel.
+    Span<const byte> GetLocalConstantsData(const ConstantBinding& constants) const;
 
     u32 version = 0;
 
@@ -32,9 +33,6 @@ protected:
 
     u32 maxLocalConstantsByteSize;
 
-    // Constant data remains always allocated, avoiding reallocations on successive draw calls.
-    std::vector<byte> localConstantsData;
-
     std::vector<StaticTextureSampler> staticSamplers;
 };
 
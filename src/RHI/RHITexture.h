@@ -16,8 +16,9 @@ class RHITextureBase
 {
 public:
     RHITextureBase() = default;
-    RHITextureBase(RHIAllocator& allocator)
-        : allocator{ &allocator } {};
+    RHITextureBase(RHIAllocator& allocator, ResourceLifetime lifetime = ResourceLifetime::Static)
+        : lifetime{ lifetime }
+        , allocator{ &allocator } {};
     RHITextureBase(const RHITextureBase&) = delete;
     RHITextureBase& operator=(const RHITextureBase&) = delete;
     RHITextureBase(RHITextureBase&&) = default;
@@ -27,6 +28,9 @@ public:
     virtual BindlessHandle GetOrCreateBindlessView(const TextureBinding& binding,
                                                    RHIDescriptorPool& descriptorPool) = 0;
     virtual void FreeBindlessHandles(RHIDescriptorPool& descriptorPool) = 0;
+    // Rewrites the bindless descriptors of the source texture so that they point to this texture, its bindless handles
+    // remain valid and are now owned by this texture. The GPU must no longer be using the source's descriptors.
+    virtual void TakeBindlessViews(RHITexture& source, RHIDescriptorPool& descriptorPool) = 0;
     virtual void FreeAllocation(RHIAllocator& allocator) = 0;
 
     [[nodiscard]] const TextureDesc& GetDesc() const
@@ -39,8 +43,14 @@ public:
         return allocation;
     }
 
+    [[nodiscard]] ResourceLifetime GetLifetime() const
+    {
+        return lifetime;
+    }
+
 protected:
     TextureDesc desc;
+    ResourceLifetime lifetime = ResourceLifetime::Static;
     RHIAllocator* allocator{};
     Allocation allocation;
 };
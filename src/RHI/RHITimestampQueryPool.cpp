@@ -9,6 +9,7 @@ namespace vex
 
 QueryHandle RHITimestampQueryPoolBase::AllocateQuery(QueueType queueType)
 {
+    std::scoped_lock lock(*mutex);
     if (inFlightQueries.ElementCount() == MaxInFlightQueriesCount)
     {
         ResolveQueries();
@@ -22,6 +23,7 @@ QueryHandle RHITimestampQueryPoolBase::AllocateQuery(QueueType queueType)
 
 std::expected<Query, QueryStatus> RHITimestampQueryPoolBase::GetQueryData(QueryHandle handle)
 {
+    std::scoped_lock lock(*mutex);
     ResolveQueries();
 
     if (const auto it = resolvedQueries.find(handle); it != resolvedQueries.end())
@@ -72,7 +74,8 @@ RHITimestampQueryPoolBase::RHITimestampQueryPoolBase(RHI& rhi, RHIAllocator& all
                                         { .name = "TimestampQueryReadback",
                                           .byteSize = sizeof(u64) * MaxInFlightTimestampCount,
                                           .usage = BufferUsage::ShaderRead,
-                                          .memoryLocality = ResourceMemoryLocality::CPURead }) }
+                                          .memoryLocality = ResourceMemoryLocality::CPURead },
+                                        ResourceLifetime::Static) }
     , rhi{ rhi }
 {
     inFlightQueries.Resize(MaxInFlightQueriesCount);
@@ -132,6 +135,7 @@ void RHITimestampQueryPoolBase::FetchQueriesTimestamps(RHICommandList& cmdList,
 
 void RHITimestampQueryPoolBase::UpdateSyncTokens(SyncToken token, Span<const QueryHandle> queries)
 {
+    std::scoped_lock lock(*mutex);
     for (QueryHandle query : queries)
     {
         inFlightQueries[query].token = token;
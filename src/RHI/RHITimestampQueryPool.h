@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include <expected>
+#include <memory>
+#include <mutex>
 
 #include <Vex/Containers/FreeList.h>
 #include <Vex/RHIImpl/RHIBuffer.h>
@@ -54,6 +56,9 @@ protected:
     RHIBuffer timestampBuffer;
     u32 generation;
 
+    // Queries are allocated by command lists recorded on multiple threads.
+    std::unique_ptr<std::mutex> mutex = std::make_unique<std::mutex>();
+
     NonNullPtr<RHI> rhi;
 
     // Returns the tick rate in ticks/seconds
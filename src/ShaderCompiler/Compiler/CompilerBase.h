@@ -2,6 +2,7 @@
 
 #include <expected>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -9,6 +10,8 @@
 #include <Vex/Formats.h>
 #include <Vex/Types.h>
 
+#include <ShaderCompiler/ShaderDiskCache.h>
+
 namespace vex::sc
 {
 
@@ -63,8 +66,19 @@ struct CompilerBase
         const ShaderEnvironment& environment,
         const ShaderCompilerSettings& compilerSettings) = 0;
 
+    // Returns a string uniquely identifying the version of the underlying compiler, used to invalidate cached shaders
+    // when the compiler changes.
+    virtual std::string GetCompilerVersion() const = 0;
+
+    // Compiled shaders will be looked up in (and stored to) the on-disk cache located in the passed-in directory.
+    void EnableDiskCache(const std::filesystem::path& directory)
+    {
+        diskCache.emplace(directory, GetCompilerVersion());
+    }
+
 protected:
     std::vector<std::filesystem::path> includeDirectories;
+    std::optional<ShaderDiskCache> diskCache;
 };
 
 } // namespace vex::sc
\ No newline at end of file
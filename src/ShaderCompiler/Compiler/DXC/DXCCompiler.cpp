@@ -243,6 +243,32 @@ std::expected<ShaderCompilationResult, std::string> DXCCompiler::CompileShader(
                   { return CompileShaderFromBlob(shader, blob, environment, compilerSettings); });
 }
 
+std::string DXCCompiler::GetCompilerVersion() const
+{
+    u32 major = 0, minor = 0;
+    ComPtr<IDxcVersionInfo> versionInfo;
+    if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+    {
+        versionInfo->GetVersion(&major, &minor);
+    }
+
+    // The commit info allows us to differentiate between development builds of DXC which share the same version.
+    std::string commitHash;
+    ComPtr<IDxcVersionInfo2> versionInfo2;
+    if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo2))))
+    {
+        u32 commitCount = 0;
+        char* commitHashStr = nullptr;
+        if (SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHashStr)) && commitHashStr)
+        {
+            commitHash = commitHashStr;
+            CoTaskMemFree(commitHashStr);
+        }
+    }
+
+    return std::format("DXC_{}.{}_{}", major, minor, commitHash);
+}
+
 std::expected<SHA1HashDigest, std::string> DXCCompiler::GetShaderCodeHash(
     const Shader& shader,
     const DxcBuffer& shaderSource,
@@ -287,6 +313,15 @@ std::expected<ShaderCompilationResult, std::string> DXCCompiler::CompileShaderFr
                                         *shader.GetReflection() };
     }
 
+    if (diskCache)
+    {
+        if (std::optional<ShaderCompilationResult> cachedResult =
+                diskCache->Load(shader.GetKey(), shaderHash.value(), compilerSettings))
+        {
+            return std::move(cachedResult.value());
+        }
+    }
+
     const std::vector<std::wstring> args =
         DXCCompiler_Internal::BuildDefaultArgumentList(compilerSettings, includeDirectories);
     const std::vector<std::pair<std::wstring, std::wstring>> dxcDefines =
@@ -334,7 +369,12 @@ std::expected<ShaderCompilationResult, std::string> DXCCompiler::CompileShaderFr
         }
     }
 
-    return ShaderCompilationResult{ shaderHash.value(), finalShaderBlob, reflection };
+    ShaderCompilationResult result{ shaderHash.value(), std::move(finalShaderBlob), std::move(reflection) };
+    if (diskCache)
+    {
+        diskCache->Store(shader.GetKey(), result, compilerSettings);
+    }
+    return result;
 }
 
 std::expected<ComPtr<IDxcResult>, std::string> DXCCompiler::CompileShaderFromBuffer(
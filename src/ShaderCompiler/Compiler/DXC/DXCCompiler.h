@@ -50,6 +50,8 @@ struct DXCCompiler : public CompilerBase
         const ShaderEnvironment& environment,
         const ShaderCompilerSettings& compilerSettings) override;
 
+    virtual std::string GetCompilerVersion() const override;
+
 private:
     std::expected<SHA1HashDigest, std::string> GetShaderCodeHash(const Shader& shader,
                                                                  const DxcBuffer& shaderSource,
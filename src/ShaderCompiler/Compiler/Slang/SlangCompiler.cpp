@@ -370,7 +370,7 @@ std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileShader
         return std::unexpected(moduleRes.error());
     }
 
-    return CompileFromModule(shader, sessionRes.value(), moduleRes.value());
+    return CompileFromModule(shader, sessionRes.value(), moduleRes.value(), compilerSettings);
 }
 
 std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileShader(
@@ -391,7 +391,7 @@ std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileShader
         return std::unexpected(moduleRes.error());
     }
 
-    return CompileFromModule(shader, sessionRes.value(), moduleRes.value());
+    return CompileFromModule(shader, sessionRes.value(), moduleRes.value(), compilerSettings);
 }
 
 SHA1HashDigest SlangCompiler::GetShaderCodeHash(const Slang::ComPtr<slang::IComponentType>& linkedShaderProgram)
@@ -403,8 +403,16 @@ SHA1HashDigest SlangCompiler::GetShaderCodeHash(const Slang::ComPtr<slang::IComp
     return hash;
 }
 
+std::string SlangCompiler::GetCompilerVersion() const
+{
+    return std::format("Slang_{}", globalSession->getBuildTagString());
+}
+
 std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileFromModule(
-    const Shader& shader, const Slang::ComPtr<slang::ISession>& session, const NonNullPtr<slang::IModule> module)
+    const Shader& shader,
+    const Slang::ComPtr<slang::ISession>& session,
+    const NonNullPtr<slang::IModule> module,
+    const ShaderCompilerSettings& compilerSettings) const
 {
     auto linkedShaderProgramRes = SlangImpl_Internal::GetLinkedShaderProgram(shader.GetKey(), session, module);
     if (!linkedShaderProgramRes)
@@ -421,6 +429,15 @@ std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileFromMo
                                         *shader.GetReflection() };
     }
 
+    if (diskCache)
+    {
+        if (std::optional<ShaderCompilationResult> cachedResult =
+                diskCache->Load(shader.GetKey(), programHash, compilerSettings))
+        {
+            return std::move(cachedResult.value());
+        }
+    }
+
     auto bytecodeBlobRes = SlangImpl_Internal::GetByteCode(linkedShaderProgramRes.value());
     if (!bytecodeBlobRes)
     {
@@ -438,7 +455,13 @@ std::expected<ShaderCompilationResult, std::string> SlangCompiler::CompileFromMo
     {
         reflection = SlangImpl_Internal::GetSlangReflection(linkedShaderProgramRes.value());
     }
-    return ShaderCompilationResult{ programHash, finalShaderBlob, reflection };
+
+    ShaderCompilationResult result{ programHash, std::move(finalShaderBlob), std::move(reflection) };
+    if (diskCache)
+    {
+        diskCache->Store(shader.GetKey(), result, compilerSettings);
+    }
+    return result;
 }
 
 void SlangCompiler::FillInIncludeDirectories(std::vector<std::string>& includeDirStrings,
@@ -28,10 +28,15 @@ struct SlangCompiler : public CompilerBase
         const ShaderEnvironment& environment,
         const ShaderCompilerSettings& compilerSettings) override;
 
+    virtual std::string GetCompilerVersion() const override;
+
 private:
     static SHA1HashDigest GetShaderCodeHash(const Slang::ComPtr<slang::IComponentType>& linkedShaderProgram);
-    static std::expected<ShaderCompilationResult, std::string> CompileFromModule(
-        const Shader& shader, const Slang::ComPtr<slang::ISession>& session, NonNullPtr<slang::IModule> module);
+    std::expected<ShaderCompilationResult, std::string> CompileFromModule(
+        const Shader& shader,
+        const Slang::ComPtr<slang::ISession>& session,
+        NonNullPtr<slang::IModule> module,
+        const ShaderCompilerSettings& compilerSettings) const;
 
     void FillInIncludeDirectories(std::vector<std::string>& includeDirStrings,
                                   std::vector<const char*>& includeDirCStr,
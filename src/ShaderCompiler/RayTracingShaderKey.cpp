@@ -13,6 +13,27 @@
 namespace vex::sc
 {
 
+std::vector<ShaderKey> RayTracingShaderKey::GetAllShaderKeys() const
+{
+    std::vector<ShaderKey> keys;
+    keys.insert(keys.end(), rayGenerationShaders.begin(), rayGenerationShaders.end());
+    keys.insert(keys.end(), rayMissShaders.begin(), rayMissShaders.end());
+    for (const auto& [name, rayClosestHitKey, rayAnyHitKey, rayIntersectionKey] : hitGroups)
+    {
+        keys.push_back(rayClosestHitKey);
+        if (rayAnyHitKey)
+        {
+            keys.push_back(*rayAnyHitKey);
+        }
+        if (rayIntersectionKey)
+        {
+            keys.push_back(*rayIntersectionKey);
+        }
+    }
+    keys.insert(keys.end(), rayCallableShaders.begin(), rayCallableShaders.end());
+    return keys;
+}
+
 void RayTracingShaderKey::ValidateShaderTypes(const RayTracingShaderKey& desc)
 {
     for (const auto& rayGen : desc.rayGenerationShaders)
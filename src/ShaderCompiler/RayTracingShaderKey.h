@@ -37,6 +37,9 @@ struct RayTracingShaderKey
 
     constexpr bool operator==(const RayTracingShaderKey& other) const = default;
 
+    // Returns the keys of all shaders contained in the ray tracing shader key.
+    std::vector<ShaderKey> GetAllShaderKeys() const;
+
     static void ValidateShaderTypes(const RayTracingShaderKey& desc);
 };
 
@@ -1,7 +1,10 @@
 #include "ShaderCompiler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <ranges>
 #include <string>
+#include <unordered_set>
 
 #include <magic_enum/magic_enum.hpp>
 
@@ -45,8 +48,19 @@ ShaderCompiler::ShaderCompiler(const ShaderCompilerSettings& compilerSettings)
 #if VEX_SLANG
     , slangCompiler(compilerSettings.shaderIncludeDirectories)
 #endif
+    , workerCompilers(std::make_unique<WorkerCompilers>())
 {
     globalShaderEnv = CreateShaderEnvironment(compilerSettings);
+
+    if (compilerSettings.enableShaderDiskCache)
+    {
+#if VEX_DXC
+        dxcCompiler.EnableDiskCache(GetShaderDiskCacheDirectory());
+#endif
+#if VEX_SLANG
+        slangCompiler.EnableDiskCache(GetShaderDiskCacheDirectory());
+#endif
+    }
 }
 
 ShaderCompiler::~ShaderCompiler() = default;
@@ -69,6 +83,17 @@ RayTracingShaderCollection ShaderCompiler::GetRayTracingShaderCollection(const R
         .maxAttributeByteSize = rtShaderKey.maxAttributeByteSize,
     };
 
+    if (compilerSettings.enableShaderHotReload && VEX_HAS_AT_LEAST_ONE_COMPILER)
+    {
+        // Compile the shaders which do not yet exist in parallel, instead of one after another in GetShaderView.
+        std::vector<ShaderKey> newShaderKeys = rtShaderKey.GetAllShaderKeys();
+        std::erase_if(newShaderKeys, [this](const ShaderKey& key) { return shaderCache.contains(key); });
+        if (!newShaderKeys.empty())
+        {
+            std::ignore = HotReloadShaders(newShaderKeys);
+        }
+    }
+
     for (auto& rayGenKey : rtShaderKey.rayGenerationShaders)
     {
         shaderCollection.rayGenerationShaders.push_back(GetShaderView(rayGenKey));
@@ -126,6 +151,98 @@ std::optional<std::string> ShaderCompiler::CompileShaderFromSourceCode(const Sha
     return HandleCompiledShader(shader, compiler.CompileShader(shader, sourceCode, globalShaderEnv, compilerSettings));
 }
 
+std::future<std::vector<std::pair<ShaderKey, std::string>>> ShaderCompiler::CompileShadersFromFilepathAsync(
+    const Span<const ShaderKey> keys)
+{
+    VEX_ASSERT(
+        VEX_HAS_AT_LEAST_ONE_COMPILER,
+        "Can only compile a shader from filepath if the shader compiler has atleast once valid compiler backend.");
+
+    struct CompilationBatch
+    {
+        std::mutex mutex;
+        std::vector<std::pair<ShaderKey, std::string>> errors;
+        std::atomic<u32> remainingShaders = 0;
+        std::promise<std::vector<std::pair<ShaderKey, std::string>>> promise;
+    };
+    const std::shared_ptr<CompilationBatch> batch = std::make_shared<CompilationBatch>();
+    std::future<std::vector<std::pair<ShaderKey, std::string>>> future = batch->promise.get_future();
+
+    // Shaders are registered on the calling thread, worker threads only ever access the shader they are compiling.
+    std::vector<std::pair<NonNullPtr<Shader>, std::filesystem::path>> shadersToCompile;
+    std::unordered_set<ShaderKey> uniqueKeys;
+    for (const ShaderKey& key : keys)
+    {
+        if (!uniqueKeys.insert(key).second)
+        {
+            continue;
+        }
+        VEX_CHECK(!key.filepath.empty(),
+                  "Error compiling shader {} from filepath: Cannot compile from an empty filepath.",
+                  key);
+        std::optional<std::filesystem::path> filepath = TryGetFilepathFromVirtualFilepath(key);
+        VEX_CHECK(filepath.has_value(), "Unable to find shader at filepath: {}", key.filepath);
+        shadersToCompile.emplace_back(GetShader(key, false), std::move(*filepath));
+    }
+
+    if (shadersToCompile.empty())
+    {
+        batch->promise.set_value({});
+        return future;
+    }
+
+    if (!compilationThreadPool)
+    {
+        compilationThreadPool = std::make_unique<ThreadPool>(compilerSettings.numShaderCompilationThreads
+                                                                 ? compilerSettings.numShaderCompilationThreads
+                                                                 : ThreadPool::GetDefaultThreadCount());
+    }
+
+    batch->remainingShaders = static_cast<u32>(shadersToCompile.size());
+    for (auto& [shader, filepath] : shadersToCompile)
+    {
+        compilationThreadPool->Enqueue(
+            [this, shader, filepath = std::move(filepath), batch]
+            {
+                const ShaderCompilerBackend backend = GetCompilerBackend(shader->GetKey());
+                std::unique_ptr<CompilerBase> compiler = AcquireWorkerCompiler(backend);
+                std::optional<std::string> error = HandleCompiledShader(
+                    *shader, compiler->CompileShader(*shader, filepath, globalShaderEnv, compilerSettings));
+                ReleaseWorkerCompiler(backend, std::move(compiler));
+
+                if (error.has_value())
+                {
+                    std::scoped_lock lock(batch->mutex);
+                    batch->errors.emplace_back(shader->GetKey(), std::move(*error));
+                }
+
+                // The last shader of the batch to finish compiling fulfills the promise.
+                if (--batch->remainingShaders == 0)
+                {
+                    batch->promise.set_value(std::move(batch->errors));
+                }
+            });
+    }
+
+    return future;
+}
+
+std::vector<std::pair<ShaderKey, std::string>> ShaderCompiler::CompileShadersFromFilepath(
+    const Span<const ShaderKey> keys)
+{
+    // A single shader is compiled on the calling thread, avoiding the creation of a worker compiler.
+    if (keys.size() == 1)
+    {
+        if (std::optional<std::string> error = CompileShaderFromFilepath(keys[0]); error.has_value())
+        {
+            return { { keys[0], std::move(*error) } };
+        }
+        return {};
+    }
+
+    return CompileShadersFromFilepathAsync(keys).get();
+}
+
 void ShaderCompiler::SetShaderCompilationErrorsCallback(ShaderHotReloadErrorsCallback&& callback)
 {
     if (!compilerSettings.enableShaderHotReload)
@@ -180,7 +297,7 @@ ShaderEnvironment ShaderCompiler::CreateShaderEnvironment(const ShaderCompilerSe
     return env;
 }
 
-CompilerBase& ShaderCompiler::GetCompiler(const ShaderKey& key)
+ShaderCompilerBackend ShaderCompiler::GetCompilerBackend(const ShaderKey& key)
 {
     const std::optional<std::filesystem::path> filepath = TryGetFilepathFromVirtualFilepath(key);
     const std::string extension = filepath.has_value() ? filepath->extension().string() : "NONE";
@@ -190,16 +307,16 @@ CompilerBase& ShaderCompiler::GetCompiler(const ShaderKey& key)
 #if VEX_SLANG
         // Default is DXC, unless VEX_SLANG and the shader file has .slang extension.
         if (extension == ".slang")
-            return slangCompiler;
+            return ShaderCompilerBackend::Slang;
         // Intentional fallthrough...
 #endif
 #if VEX_DXC
     case ShaderCompilerBackend::DXC:
-        return dxcCompiler;
+        return ShaderCompilerBackend::DXC;
 #endif
 #if VEX_SLANG
     case ShaderCompilerBackend::Slang:
-        return slangCompiler;
+        return ShaderCompilerBackend::Slang;
 #endif
     default:
         VEX_LOG(Fatal,
@@ -210,6 +327,79 @@ CompilerBase& ShaderCompiler::GetCompiler(const ShaderKey& key)
     }
 }
 
+CompilerBase& ShaderCompiler::GetCompiler(const ShaderKey& key)
+{
+    switch (GetCompilerBackend(key))
+    {
+#if VEX_DXC
+    case ShaderCompilerBackend::DXC:
+        return dxcCompiler;
+#endif
+#if VEX_SLANG
+    case ShaderCompilerBackend::Slang:
+        return slangCompiler;
+#endif
+    default:
+        std::unreachable();
+    }
+}
+
+std::unique_ptr<CompilerBase> ShaderCompiler::CreateCompiler(const ShaderCompilerBackend backend) const
+{
+    std::unique_ptr<CompilerBase> compiler;
+    switch (backend)
+    {
+#if VEX_DXC
+    case ShaderCompilerBackend::DXC:
+        compiler = std::make_unique<DXCCompiler>(compilerSettings.shaderIncludeDirectories);
+        break;
+#endif
+#if VEX_SLANG
+    case ShaderCompilerBackend::Slang:
+        compiler = std::make_unique<SlangCompiler>(compilerSettings.shaderIncludeDirectories);
+        break;
+#endif
+    default:
+        VEX_LOG(Fatal, "Unable to create a compiler for the backend: {}.", backend);
+        std::unreachable();
+    }
+
+    if (compilerSettings.enableShaderDiskCache)
+    {
+        compiler->EnableDiskCache(GetShaderDiskCacheDirectory());
+    }
+    return compiler;
+}
+
+std::filesystem::path ShaderCompiler::GetShaderDiskCacheDirectory() const
+{
+    return std::filesystem::current_path() / compilerSettings.shaderDiskCacheDirectory;
+}
+
+std::unique_ptr<CompilerBase> ShaderCompiler::AcquireWorkerCompiler(const ShaderCompilerBackend backend)
+{
+    {
+        std::scoped_lock lock(workerCompilers->mutex);
+        std::vector<std::unique_ptr<CompilerBase>>& idleCompilers = workerCompilers->idleCompilers[backend];
+        if (!idleCompilers.empty())
+        {
+            std::unique_ptr<CompilerBase> compiler = std::move(idleCompilers.back());
+            idleCompilers.pop_back();
+            return compiler;
+        }
+    }
+
+    // Creating a compiler is costly, so it is done outside of the lock. At most one compiler per worker thread will be
+    // created for each backend.
+    return CreateCompiler(backend);
+}
+
+void ShaderCompiler::ReleaseWorkerCompiler(const ShaderCompilerBackend backend, std::unique_ptr<CompilerBase> compiler)
+{
+    std::scoped_lock lock(workerCompilers->mutex);
+    workerCompilers->idleCompilers[backend].push_back(std::move(compiler));
+}
+
 NonNullPtr<Shader> ShaderCompiler::GetShader(const ShaderKey& key, bool allowHotReload)
 {
     if (const auto shader = shaderCache.find(key); shader != shaderCache.end())
@@ -353,21 +543,17 @@ u32 ShaderCompiler::HotReloadShaders(TRange&& shaderKeys)
 
     do
     {
-        numRecompiledShaders = 0;
-        errors.clear();
+        // Attempt to recompile the shaders in parallel, only the ones which failed are kept for the next attempt.
+        errors = CompileShadersFromFilepath(shadersLeftToCompile);
+        const std::size_t numShadersToCompile = shadersLeftToCompile.size();
         std::erase_if(shadersLeftToCompile,
-                      [&](const ShaderKey& key) -> bool
+                      [&errors](const ShaderKey& key) -> bool
                       {
-                          // Attempt to recompile the shader.
-                          if (std::optional<std::string> res = CompileShaderFromFilepath(key); res.has_value())
-                          {
-                              errors.emplace_back(key, res.value());
-                              return false;
-                          }
-
-                          ++numRecompiledShaders;
-                          return true;
+                          return std::ranges::none_of(errors,
+                                                      [&key](const std::pair<ShaderKey, std::string>& error)
+                                                      { return error.first == key; });
                       });
+        numRecompiledShaders = static_cast<u32>(numShadersToCompile - shadersLeftToCompile.size());
     }
     while (HandleCompilationErrors(errors));
 
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <utility>
 
 #include <Vex/Containers/Span.h>
 #include <Vex/ShaderView.h>
 #include <Vex/Utility/MoveOnlyFunction.h>
 #include <Vex/Utility/NonNullPtr.h>
+#include <Vex/Utility/ThreadPool.h>
 
 #include <ShaderCompiler/Compiler/CompilerBase.h>
 #include <ShaderCompiler/ShaderCompilerSettings.h>
@@ -73,6 +77,16 @@ struct ShaderCompiler
     // Will register and compile a shader from filesystem path.
     std::optional<std::string> CompileShaderFromFilepath(const ShaderKey& key);
 
+    // Will register and compile the passed-in filepath-based shaders in parallel on the shader compiler's worker
+    // threads. The returned future becomes ready once all shaders are compiled and contains the errors of the shaders
+    // which failed to compile. These shaders must not be accessed until the future is ready.
+    std::future<std::vector<std::pair<ShaderKey, std::string>>> CompileShadersFromFilepathAsync(
+        Span<const ShaderKey> keys);
+
+    // Will register and compile the passed-in filepath-based shaders in parallel, blocking until all shaders are
+    // compiled. Returns the errors of the shaders which failed to compile.
+    std::vector<std::pair<ShaderKey, std::string>> CompileShadersFromFilepath(Span<const ShaderKey> keys);
+
     // Will register and compile a shader directly from source code. You must provide a virtual filepath in the key
     // which will be used to get the compiled shader.
     std::optional<std::string> CompileShaderFromSourceCode(const ShaderKey& key, std::string_view sourceCode);
@@ -96,7 +110,12 @@ private:
     static std::optional<std::filesystem::path> TryGetFilepathFromVirtualFilepath(const ShaderKey& key);
     static ShaderEnvironment CreateShaderEnvironment(const ShaderCompilerSettings& compilerSettings);
 
+    static ShaderCompilerBackend GetCompilerBackend(const ShaderKey& key);
     CompilerBase& GetCompiler(const ShaderKey& key);
+    std::unique_ptr<CompilerBase> CreateCompiler(ShaderCompilerBackend backend) const;
+    std::filesystem::path GetShaderDiskCacheDirectory() const;
+    std::unique_ptr<CompilerBase> AcquireWorkerCompiler(ShaderCompilerBackend backend);
+    void ReleaseWorkerCompiler(ShaderCompilerBackend backend, std::unique_ptr<CompilerBase> compiler);
     NonNullPtr<Shader> GetShader(const ShaderKey& key, bool allowHotReload);
     std::optional<std::string> HandleCompiledShader(
         Shader& shader, std::expected<ShaderCompilationResult, std::string>&& compilationResult) const;
@@ -118,6 +137,19 @@ private:
     std::unordered_map<ShaderKey, Shader> shaderCache;
 
     ShaderHotReloadErrorsCallback errorsCallback;
+
+    // DXC and Slang compilers are not thread-safe, each compilation task running on a worker thread acquires its own
+    // compiler instance which is then returned here to be reused by subsequent tasks.
+    struct WorkerCompilers
+    {
+        std::mutex mutex;
+        std::unordered_map<ShaderCompilerBackend, std::vector<std::unique_ptr<CompilerBase>>> idleCompilers;
+    };
+    std::unique_ptr<WorkerCompilers> workerCompilers;
+
+    // Lazily created on the first batched compilation. Declared last so that in-flight tasks are completed before the
+    // rest of the shader compiler is destroyed.
+    std::unique_ptr<ThreadPool> compilationThreadPool;
 };
 
 } // namespace vex::sc
\ No newline at end of file
@@ -45,6 +45,14 @@ struct ShaderCompilerSettings
     bool enableShaderDebugSymbols = !VEX_SHIPPING;
     // Determines if shaders should allow for allow shader hot-reload. Defaults to true in debug and development builds.
     bool enableShaderHotReload = !VEX_SHIPPING;
+    // Number of worker threads used for batched shader compilation, 0 uses all hardware threads except one.
+    u32 numShaderCompilationThreads = 0;
+
+    // Stores compiled shaders (bytecode and reflection) on disk, allowing for unchanged shaders to skip compilation
+    // across application runs. Entries are keyed by the preprocessed shader source, the settings and compiler version.
+    bool enableShaderDiskCache = false;
+    // Directory in which the shader disk cache is stored, relative to the current working directory.
+    std::filesystem::path shaderDiskCacheDirectory = "VexOutput_SHADER_CACHE";
 
     // Outputs the shader bytecode (spirv or DXIL) to a directory when a shader is compiled, warning: this will fill up
     // your drive will lots of small files if left on for too long!
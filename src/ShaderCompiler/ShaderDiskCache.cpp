@@ -0,0 +1,226 @@
+#include "ShaderDiskCache.h"
+
+#include <format>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+#include <Vex/Logger.h>
+#include <Vex/Utility/SHA1.h>
+
+#include <ShaderCompiler/Compiler/CompilerBase.h>
+#include <ShaderCompiler/ShaderCompilerSettings.h>
+#include <ShaderCompiler/ShaderKey.h>
+
+namespace vex::sc
+{
+
+namespace ShaderDiskCache_Internal
+{
+
+// Identifies a Vex shader cache entry ("VXSC").
+static constexpr u32 EntryMagic = 0x43535856;
+// Must be incremented whenever the layout of a cache entry changes.
+static constexpr u32 EntryVersion = 1;
+
+template <class T>
+    requires std::is_trivially_copyable_v<T>
+void Write(std::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+    requires std::is_trivially_copyable_v<T>
+bool Read(std::ifstream& stream, T& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.good();
+}
+
+// Sizes stored in an entry are checked against the bytes left in the file before allocating anything, so that a
+// corrupted entry cannot cause a huge allocation.
+u64 GetRemainingByteSize(std::ifstream& stream, u64 fileByteSize)
+{
+    return fileByteSize - static_cast<u64>(static_cast<std::streamoff>(stream.tellg()));
+}
+
+bool ReadBytes(std::ifstream& stream, char* data, u64 byteSize)
+{
+    stream.read(data, static_cast<std::streamsize>(byteSize));
+    return stream.good() && static_cast<u64>(stream.gcount()) == byteSize;
+}
+
+void WriteReflection(std::ofstream& stream, const ShaderReflection& reflection)
+{
+    Write(stream, static_cast<u32>(reflection.inputs.size()));
+    for (const ShaderReflection::Input& input : reflection.inputs)
+    {
+        Write(stream, static_cast<u32>(input.semanticName.size()));
+        stream.write(input.semanticName.data(), static_cast<std::streamsize>(input.semanticName.size()));
+        Write(stream, input.semanticIndex);
+        Write(stream, input.format);
+    }
+}
+
+bool ReadReflection(std::ifstream& stream, u64 fileByteSize, ShaderReflection& reflection)
+{
+    u32 inputCount;
+    if (!Read(stream, inputCount))
+    {
+        return false;
+    }
+    // Each input takes at least its name length, semantic index and format.
+    static constexpr u64 MinInputByteSize =
+        sizeof(u32) + sizeof(ShaderReflection::Input::semanticIndex) + sizeof(ShaderReflection::Input::format);
+    if (inputCount > GetRemainingByteSize(stream, fileByteSize) / MinInputByteSize)
+    {
+        return false;
+    }
+
+    reflection.inputs.resize(inputCount);
+    for (ShaderReflection::Input& input : reflection.inputs)
+    {
+        u32 nameLength;
+        if (!Read(stream, nameLength) || nameLength > GetRemainingByteSize(stream, fileByteSize))
+        {
+            return false;
+        }
+        input.semanticName.resize(nameLength);
+        if (!ReadBytes(stream, input.semanticName.data(), nameLength) ||
+            !Read(stream, input.semanticIndex) || !Read(stream, input.format))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ShaderDiskCache_Internal
+
+ShaderDiskCache::ShaderDiskCache(std::filesystem::path directory, std::string compilerVersion)
+    : directory(std::move(directory))
+    , compilerVersion(std::move(compilerVersion))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(this->directory, ec);
+    if (ec)
+    {
+        VEX_LOG(Warning,
+                "Unable to create the shader disk cache directory {}: {}.",
+                this->directory.string(),
+                ec.message());
+    }
+}
+
+std::optional<ShaderCompilationResult> ShaderDiskCache::Load(const ShaderKey& key,
+                                                             const SHA1HashDigest& sourceHash,
+                                                             const ShaderCompilerSettings& compilerSettings) const
+{
+    using namespace ShaderDiskCache_Internal;
+
+    std::ifstream stream(GetEntryPath(key, sourceHash, compilerSettings), std::ios::binary | std::ios::ate);
+    if (!stream.is_open())
+    {
+        return std::nullopt;
+    }
+    const u64 fileByteSize = static_cast<u64>(static_cast<std::streamoff>(stream.tellg()));
+    stream.seekg(0);
+
+    u32 magic, version;
+    SHA1HashDigest storedHash;
+    if (!Read(stream, magic) || !Read(stream, version) || !Read(stream, storedHash) || magic != EntryMagic ||
+        version != EntryVersion || storedHash != sourceHash)
+    {
+        return std::nullopt;
+    }
+
+    ShaderCompilationResult result{ .sourceHash = sourceHash };
+
+    u64 bytecodeSize;
+    if (!Read(stream, bytecodeSize) || bytecodeSize > GetRemainingByteSize(stream, fileByteSize))
+    {
+        return std::nullopt;
+    }
+    result.compiledCode.resize(bytecodeSize);
+    if (!ReadBytes(stream, reinterpret_cast<char*>(result.compiledCode.data()), bytecodeSize))
+    {
+        return std::nullopt;
+    }
+
+    bool hasReflection;
+    if (!Read(stream, hasReflection))
+    {
+        return std::nullopt;
+    }
+    if (hasReflection && !ReadReflection(stream, fileByteSize, result.reflection.emplace()))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+void ShaderDiskCache::Store(const ShaderKey& key,
+                            const ShaderCompilationResult& result,
+                            const ShaderCompilerSettings& compilerSettings) const
+{
+    using namespace ShaderDiskCache_Internal;
+
+    const std::filesystem::path entryPath = GetEntryPath(key, result.sourceHash, compilerSettings);
+
+    // Write to a temporary file first and then rename it, this avoids other processes (or threads) ever reading a
+    // partially written entry.
+    std::filesystem::path tempPath = entryPath;
+    tempPath += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            VEX_LOG(Warning, "Unable to write shader disk cache entry: {}.", entryPath.string());
+            return;
+        }
+
+        Write(stream, EntryMagic);
+        Write(stream, EntryVersion);
+        Write(stream, result.sourceHash);
+        Write(stream, static_cast<u64>(result.compiledCode.size()));
+        stream.write(reinterpret_cast<const char*>(result.compiledCode.data()),
+                     static_cast<std::streamsize>(result.compiledCode.size()));
+        Write(stream, result.reflection.has_value());
+        if (result.reflection.has_value())
+        {
+            WriteReflection(stream, *result.reflection);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, entryPath, ec);
+    if (ec)
+    {
+        VEX_LOG(Warning, "Unable to write shader disk cache entry {}: {}.", entryPath.string(), ec.message());
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+std::filesystem::path ShaderDiskCache::GetEntryPath(const ShaderKey& key,
+                                                    const SHA1HashDigest& sourceHash,
+                                                    const ShaderCompilerSettings& compilerSettings) const
+{
+    // The preprocessed source hash already accounts for the shader's defines and includes, the remaining inputs to the
+    // compiler are the entry point, the shader type and the compiler settings/version.
+    SHA1 sha1;
+    sha1.update(std::format("{}|{}|{}|{}|{}|{}|{}|{}|{}",
+                            HashToString(sourceHash),
+                            key.entryPoint,
+                            key.type,
+                            compilerSettings.target,
+                            compilerSettings.shaderModel,
+                            compilerSettings.spirvVersion,
+                            compilerSettings.enableShaderOptimizations,
+                            compilerSettings.enableShaderDebugSymbols,
+                            compilerVersion));
+    return directory / std::format("{}.vexshader", HashToString(sha1.final()));
+}
+
+} // namespace vex::sc
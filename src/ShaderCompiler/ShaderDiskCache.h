@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include <Vex/Types.h>
+#include <Vex/Utility/Hash.h>
+
+namespace vex::sc
+{
+
+struct ShaderKey;
+struct ShaderCompilerSettings;
+struct ShaderCompilationResult;
+
+// Content-addressed on-disk cache of compiled shaders (bytecode and reflection).
+// Entries are keyed by the preprocessed source hash of the shader, the compiler settings and the compiler version,
+// meaning a cache entry can never be used for a shader whose inputs differ from the ones that produced it.
+class ShaderDiskCache
+{
+public:
+    ShaderDiskCache(std::filesystem::path directory, std::string compilerVersion);
+
+    // Returns the cached compilation result for the shader if one exists and is valid.
+    std::optional<ShaderCompilationResult> Load(const ShaderKey& key,
+                                                const SHA1HashDigest& sourceHash,
+                                                const ShaderCompilerSettings& compilerSettings) const;
+    // Writes the compilation result to the cache, overwriting any existing entry.
+    void Store(const ShaderKey& key,
+               const ShaderCompilationResult& result,
+               const ShaderCompilerSettings& compilerSettings) const;
+
+private:
+    std::filesystem::path GetEntryPath(const ShaderKey& key,
+                                       const SHA1HashDigest& sourceHash,
+                                       const ShaderCompilerSettings& compilerSettings) const;
+
+    std::filesystem::path directory;
+    std::string compilerVersion;
+};
+
+} // namespace vex::sc
@@ -10,6 +10,8 @@
 #include <Vex/RHIImpl/RHIBuffer.h>
 #include <Vex/RHIImpl/RHITexture.h>
 #include <Vex/RayTracing.h>
+#include <Vex/RenderGraph.h>
+#include <Vex/StreamingUploader.h>
 #include <Vex/TextureSampler.h>
 #include <Vex/Utility/ByteUtils.h>
 #include <Vex/Utility/Formattable.h>
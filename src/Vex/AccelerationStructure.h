@@ -32,8 +32,8 @@ BEGIN_VEX_ENUM_FLAGS(ASBuild, u8)
 	PreferFastTrace = 1 << 2,	// Optimizes building for raytracing performance. Incompatible with PreferFastBuild.
 	PreferFastBuild = 1 << 3,	// Optimizes building for build-speed. Incompatible with PreferFastTrace.
 	MinimizeMemory	= 1 << 4,	// Minimizes memory usage.
-    // TODO(https://trello.com/c/LIEtASpP): Updating AS is not currently supported.
-    PerformUpdate   = 1 << 5,   // Allows for updating the AS.
+    // Set internally by CommandContext::RefitBLAS and UpdateTLAS, not meant to be part of a desc.
+    PerformUpdate   = 1 << 5,   // Updates the AS in place.
 END_VEX_ENUM_FLAGS();
 
 // clang-format on
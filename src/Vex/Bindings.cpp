@@ -172,6 +172,51 @@ void ValidateDrawResource(const DrawResourceBinding& binding)
     }
 }
 
+void ValidateIndirectArgsBinding(const IndirectArgsBinding& binding, u32 argsByteSize)
+{
+    static constexpr u32 IndirectArgsAlignment = 4;
+
+    const Buffer& argsBuffer = binding.argsBuffer;
+    VEX_CHECK(argsBuffer.desc.usage & BufferUsage::IndirectArgs,
+              "Invalid indirect arguments buffer \"{}\": The buffer must have the IndirectArgs usage.",
+              argsBuffer.desc.name);
+    VEX_CHECK(binding.maxCommandCount > 0,
+              "Invalid indirect arguments buffer \"{}\": The max command count must not be 0.",
+              argsBuffer.desc.name);
+
+    const u32 strideByteSize = binding.argsStrideByteSize.value_or(argsByteSize);
+    VEX_CHECK(strideByteSize >= argsByteSize && strideByteSize % IndirectArgsAlignment == 0,
+              "Invalid indirect arguments buffer \"{}\": The stride must be a multiple of {} bytes and at least as "
+              "large as the arguments ({} bytes).",
+              argsBuffer.desc.name,
+              IndirectArgsAlignment,
+              argsByteSize);
+    VEX_CHECK(binding.argsOffsetByteSize % IndirectArgsAlignment == 0,
+              "Invalid indirect arguments buffer \"{}\": The offset must be a multiple of {} bytes.",
+              argsBuffer.desc.name,
+              IndirectArgsAlignment);
+    VEX_CHECK(binding.argsOffsetByteSize + static_cast<u64>(strideByteSize) * (binding.maxCommandCount - 1) +
+                      argsByteSize <=
+                  argsBuffer.desc.byteSize,
+              "Invalid indirect arguments buffer \"{}\": The arguments of {} commands do not fit in the buffer.",
+              argsBuffer.desc.name,
+              binding.maxCommandCount);
+
+    if (binding.countBuffer)
+    {
+        const Buffer& countBuffer = *binding.countBuffer;
+        VEX_CHECK(countBuffer.desc.usage & BufferUsage::IndirectArgs,
+                  "Invalid indirect count buffer \"{}\": The buffer must have the IndirectArgs usage.",
+                  countBuffer.desc.name);
+        VEX_CHECK(binding.countOffsetByteSize % IndirectArgsAlignment == 0 &&
+                      binding.countOffsetByteSize + sizeof(u32) <= countBuffer.desc.byteSize,
+                  "Invalid indirect count buffer \"{}\": The offset must be a multiple of {} bytes and be within the "
+                  "buffer.",
+                  countBuffer.desc.name,
+                  IndirectArgsAlignment);
+    }
+}
+
 } // namespace BindingUtil
 
 BufferBinding BufferBinding::CreateStructuredBuffer(const Buffer& buffer,
@@ -189,12 +189,35 @@ struct DrawResourceBinding
     std::optional<BufferBinding> indexBuffer;
 };
 
+// Location of the arguments of indirect draws and dispatches (see DrawIndirectArgs, DrawIndexedIndirectArgs and
+// DispatchIndirectArgs). Both buffers must have the IndirectArgs usage, their barriers are inferred automatically.
+struct IndirectArgsBinding
+{
+    // Buffer containing the arguments of each command.
+    Buffer argsBuffer;
+    // Offset of the first command's arguments (in bytes), must be a multiple of 4.
+    u64 argsOffsetByteSize = 0;
+    // Optional: Distance between the arguments of consecutive commands (in bytes), must be a multiple of 4.
+    // Defaults to the size of the arguments, meaning they are tightly packed.
+    std::optional<u32> argsStrideByteSize;
+
+    // Number of commands to execute. When a count buffer is used, this is the maximum number of commands instead.
+    u32 maxCommandCount = 1;
+
+    // Optional: Buffer containing the number of commands to execute as a u32, typically written by the GPU (eg: by a
+    // culling pass). The number of executed commands is the minimum between this count and maxCommandCount.
+    std::optional<Buffer> countBuffer;
+    // Offset of the count in the count buffer (in bytes), must be a multiple of 4.
+    u64 countOffsetByteSize = 0;
+};
+
 namespace BindingUtil
 {
 
 void ValidateBufferBinding(const BufferBinding& binding, BufferUsage::Flags validBufferUsageFlags);
 void ValidateTextureBinding(const TextureBinding& binding, TextureUsage::Flags validTextureUsageFlags);
 void ValidateDrawResource(const DrawResourceBinding& binding);
+void ValidateIndirectArgsBinding(const IndirectArgsBinding& binding, u32 argsByteSize);
 
 } // namespace BindingUtil
 
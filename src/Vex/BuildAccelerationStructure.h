@@ -74,8 +74,13 @@ struct BLASBuildDesc
     // Typically you'd have only one geometry per BLAS (one mesh or a mesh and its connected parts, eg: a car with its
     // wheels).
     Span<const BLASGeometryDesc> geometry;
+};
 
-    // TODO(https://trello.com/c/LIEtASpP): handle BLAS update.
+// A BLAS along with its geometry, used to build multiple BLAS at once.
+struct BLASBuild
+{
+    AccelerationStructure accelerationStructure;
+    BLASBuildDesc desc;
 };
 
 struct TLASInstanceDesc
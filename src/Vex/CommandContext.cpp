@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <functional>
+#include <mutex>
 
 #include <Vex/AccelerationStructure.h>
 #include <Vex/DrawHelpers.h>
@@ -32,6 +33,9 @@ namespace vex
 namespace CommandContext_Internal
 {
 
+// Buffer copies have no alignment requirements, this only keeps the staging data naturally aligned.
+static constexpr u64 BufferUploadAlignment = 16;
+
 static std::vector<BufferTextureCopyDesc> GetBufferTextureCopyDescFromTextureRegions(
     const TextureDesc& desc, const Span<const TextureRegion> regions)
 {
@@ -110,6 +114,61 @@ static std::pair<DrawDesc, RenderTargetState> CreateRenderTargetStateFromBinding
     return { newDrawDesc, rtState };
 }
 
+static RHIBarrierSync MergeSyncs(RHIBarrierSync lhs, RHIBarrierSync rhs)
+{
+    return lhs == rhs ? lhs : RHIBarrierSync::AllCommands;
+}
+
+static RHIBarrierAccess MergeAccesses(RHIBarrierAccess lhs, RHIBarrierAccess rhs)
+{
+    return lhs == rhs                                 ? lhs
+           : IsWriteAccess(lhs) || IsWriteAccess(rhs) ? RHIBarrierAccess::MemoryWrite
+                                                      : RHIBarrierAccess::MemoryRead;
+}
+
+// Conservatively merges two texture states into one which covers the synchronization of both.
+static RHITextureState MergeTextureStates(const RHITextureState& lhs, const RHITextureState& rhs)
+{
+    if (lhs == rhs)
+    {
+        return lhs;
+    }
+
+    return {
+        .sync = MergeSyncs(lhs.sync, rhs.sync),
+        .access = MergeAccesses(lhs.access, rhs.access),
+        .layout = RHITextureLayout::Undefined,
+    };
+}
+
+static bool AreAllocationsOverlapping(const Allocation& lhs, const Allocation& rhs)
+{
+    return lhs.memoryTypeIndex == rhs.memoryTypeIndex && lhs.pageHandle == rhs.pageHandle &&
+           lhs.memoryRange.offset < rhs.memoryRange.end() && rhs.memoryRange.offset < lhs.memoryRange.end();
+}
+
+// Returns the layout the texture is handed off in.
+static RHITextureLayout ValidateQueueHandoff(const Texture& texture,
+                                             QueueType srcQueue,
+                                             QueueType dstQueue,
+                                             RHIBarrierAccess access)
+{
+    VEX_CHECK(srcQueue != dstQueue,
+              "Texture \"{}\" cannot be handed off to the queue it is used on.",
+              texture.desc.name);
+    VEX_CHECK(srcQueue != QueueType::Copy && dstQueue != QueueType::Copy,
+              "Texture \"{}\" can only be handed off between the graphics and compute queues.",
+              texture.desc.name);
+
+    // Both queues must support the layout.
+    const RHITextureLayout layout = RHIAccessToRHILayout(access);
+    VEX_CHECK(layout != RHITextureLayout::RenderTarget && layout != RHITextureLayout::DepthStencilRead &&
+                  layout != RHITextureLayout::DepthStencilWrite,
+              "Texture \"{}\" cannot be handed off in a layout which the compute queue does not support.",
+              texture.desc.name);
+    return layout;
+}
+
 } // namespace CommandContext_Internal
 
 CommandContext::CommandContext(NonNullPtr<Graphics> graphics,
@@ -117,13 +176,11 @@ CommandContext::CommandContext(NonNullPtr<Graphics> graphics,
                                NonNullPtr<RHITimestampQueryPool> queryPool)
     : graphics(graphics)
     , cmdList(cmdList)
+    , stagingAllocator(graphics)
 {
     cmdList->Open();
     cmdList->SetTimestampQueryPool(queryPool);
-    if (cmdList->GetQueue() != QueueType::Copy)
-    {
-        cmdList->SetDescriptorPool(*graphics->descriptorPool, graphics->psCache->resourceLayout.value());
-    }
+    BindDescriptorPool();
 }
 
 CommandContext::~CommandContext()
@@ -135,6 +192,18 @@ CommandContext::~CommandContext()
               "A command context was destroyed while still being open for commands, remember to submit your command "
               "context to the GPU using vex::Graphics::Submit()!");
 #endif
+
+    // Transient textures are handed over to Graphics on submission, the remaining ones were never used by the GPU.
+    if (!transientTextures.empty() || !releasedTransientTextures.empty() || !transientMemoryPool.pages.empty())
+    {
+        std::vector<TextureHandle> textures;
+        textures.reserve(transientTextures.size() + releasedTransientTextures.size());
+        std::ranges::transform(transientTextures, std::back_inserter(textures), &Texture::handle);
+        std::ranges::transform(releasedTransientTextures,
+                               std::back_inserter(textures),
+                               &ReleasedTransientTexture::handle);
+        graphics->DiscardTransientTextures(textures, transientMemoryPool);
+    }
 }
 
 QueueType CommandContext::GetQueue() const
@@ -142,6 +211,22 @@ QueueType CommandContext::GetQueue() const
     return cmdList->GetQueue();
 }
 
+void CommandContext::Close()
+{
+    VEX_ASSERT(cmdList->IsOpen(), "Attempting to close an already closed command context...");
+    VEX_ASSERT(recordingThread == std::this_thread::get_id(),
+               "A command context must be closed on the thread which recorded it.");
+
+    // Split barriers must be ended in the command list which began them.
+    EndAllSplitBarriers();
+
+    // Flush barriers before submitting.
+    FlushBarriers();
+
+    // We want to close a command list asap, to allow for driver optimizations.
+    cmdList->Close();
+}
+
 void CommandContext::SetViewport(float x, float y, float width, float height, float minDepth, float maxDepth)
 {
     cmdList->SetViewport(x, y, width, height, minDepth, maxDepth);
@@ -171,6 +256,8 @@ void CommandContext::ClearTexture(const Texture& texture,
     FlushBarriers();
 
     TextureClearValue clearValue = textureClearValue.value_or(texture.desc.clearValue);
+    // Texture views are created lazily and cached in the texture, which other threads could be recording with.
+    std::scoped_lock lock(*graphics->resourceMutex);
     cmdList->ClearTexture(
         rhiTexture,
         subresource,
@@ -180,7 +267,7 @@ void CommandContext::ClearTexture(const Texture& texture,
         clearRects);
 }
 
-void CommandContext::Draw(const DrawDesc& drawDesc,
+bool CommandContext::Draw(const DrawDesc& drawDesc,
                           const DrawResourceBinding& drawBindings,
                           ConstantBinding constants,
                           Span<const ResourceBinding> trackedResources,
@@ -203,17 +290,21 @@ void CommandContext::Draw(const DrawDesc& drawDesc,
     FlushBarriers();
     if (!drawResources.has_value())
     {
-        return;
+        return false;
     }
 
-    cmdList->BeginRendering(*drawResources);
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        cmdList->BeginRendering(*drawResources);
+    }
     // TODO(https://trello.com/c/IGxuLci9): Validate draw vertex count (eg: versus the currently used vertex buffer
     // size)
     cmdList->Draw(vertexCount, instanceCount, vertexOffset, instanceOffset);
     cmdList->EndRendering();
+    return true;
 }
 
-void CommandContext::DrawIndexed(const DrawDesc& drawDesc,
+bool CommandContext::DrawIndexed(const DrawDesc& drawDesc,
                                  const DrawResourceBinding& drawBindings,
                                  ConstantBinding constants,
                                  Span<const ResourceBinding> trackedResources,
@@ -228,45 +319,117 @@ void CommandContext::DrawIndexed(const DrawDesc& drawDesc,
     FlushBarriers();
     if (!drawResources.has_value())
     {
-        return;
+        return false;
     }
 
-    cmdList->BeginRendering(*drawResources);
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        cmdList->BeginRendering(*drawResources);
+    }
     // TODO(https://trello.com/c/IGxuLci9): Validate draw index count (eg: versus the currently used index buffer size)
     cmdList->DrawIndexed(indexCount, instanceCount, indexOffset, vertexOffset, instanceOffset);
     cmdList->EndRendering();
+    return true;
 }
 
-void CommandContext::DrawIndirect()
+bool CommandContext::DrawIndirect(const DrawDesc& drawDesc,
+                                  const DrawResourceBinding& drawBindings,
+                                  ConstantBinding constants,
+                                  Span<const ResourceBinding> trackedResources,
+                                  const IndirectArgsBinding& indirectArgs)
 {
     CheckViewportAndScissor();
 
+    const RHIIndirectArgsBinding rhiIndirectArgs = PrepareIndirectArgs(indirectArgs, sizeof(DrawIndirectArgs));
+    auto drawResources = PrepareDrawCall(drawDesc, drawBindings, constants, trackedResources);
     FlushBarriers();
-    VEX_NOT_YET_IMPLEMENTED();
+    if (!drawResources.has_value())
+    {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        cmdList->BeginRendering(*drawResources);
+    }
+    cmdList->DrawIndirect(rhiIndirectArgs);
+    cmdList->EndRendering();
+    return true;
 }
 
-void CommandContext::DrawIndexedIndirect()
+bool CommandContext::DrawIndexedIndirect(const DrawDesc& drawDesc,
+                                         const DrawResourceBinding& drawBindings,
+                                         ConstantBinding constants,
+                                         Span<const ResourceBinding> trackedResources,
+                                         const IndirectArgsBinding& indirectArgs)
 {
     CheckViewportAndScissor();
 
+    const RHIIndirectArgsBinding rhiIndirectArgs = PrepareIndirectArgs(indirectArgs, sizeof(DrawIndexedIndirectArgs));
+    auto drawResources = PrepareDrawCall(drawDesc, drawBindings, constants, trackedResources);
     FlushBarriers();
-    VEX_NOT_YET_IMPLEMENTED();
+    if (!drawResources.has_value())
+    {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        cmdList->BeginRendering(*drawResources);
+    }
+    cmdList->DrawIndexedIndirect(rhiIndirectArgs);
+    cmdList->EndRendering();
+    return true;
 }
 
-void CommandContext::Dispatch(const ShaderView& computeShader,
+bool CommandContext::Dispatch(const ShaderView& computeShader,
                               const ConstantBinding constants,
                               const Span<const ResourceBinding> trackedResources,
                               const std::array<u32, 3> groupCount)
 {
-    using namespace CommandContext_Internal;
+    if (!PrepareDispatch(computeShader, constants, trackedResources))
+    {
+        return false;
+    }
+
+    // Validate dispatch (vs platform/api constraints)
+    // graphics->ValidateDispatch(groupCount);
+
+    // Perform dispatch
+    cmdList->Dispatch(groupCount);
+    return true;
+}
+
+bool CommandContext::DispatchIndirect(const ShaderView& computeShader,
+                                      ConstantBinding constants,
+                                      Span<const ResourceBinding> trackedResources,
+                                      const IndirectArgsBinding& indirectArgs)
+{
+    VEX_CHECK(indirectArgs.maxCommandCount == 1 && !indirectArgs.countBuffer.has_value(),
+              "Indirect dispatches only support a single dispatch without count buffer.");
+
+    const RHIIndirectArgsBinding rhiIndirectArgs = PrepareIndirectArgs(indirectArgs, sizeof(DispatchIndirectArgs));
+    if (!PrepareDispatch(computeShader, constants, trackedResources))
+    {
+        return false;
+    }
+
+    cmdList->DispatchIndirect(rhiIndirectArgs);
+    return true;
+}
 
+bool CommandContext::PrepareDispatch(const ShaderView& computeShader,
+                                     const ConstantBinding constants,
+                                     const Span<const ResourceBinding> trackedResources)
+{
     InferResourceBarriers(RHIBarrierSync::ComputeShader, trackedResources);
     FlushBarriers();
 
+    BindDescriptorPool();
+
     // Setup the layout for our pass (must be done before PSO handling).
     RHIResourceLayout& resourceLayout = *graphics->psCache->resourceLayout;
-    resourceLayout.SetLayoutResources(constants);
-    cmdList->SetLayout(resourceLayout);
+    cmdList->SetLayout(resourceLayout, resourceLayout.GetLocalConstantsData(constants));
 
     std::unique_ptr<RHIComputePipelineState> oldPSO;
     // Register shader and get Pipeline if exists (if not create it).
@@ -277,7 +440,7 @@ void CommandContext::Dispatch(const ShaderView& computeShader,
     }
     if (!pipelineState)
     {
-        return;
+        return false;
     }
 
     if (!cachedComputePSO || pipelineState != cachedComputePSO)
@@ -285,17 +448,7 @@ void CommandContext::Dispatch(const ShaderView& computeShader,
         cmdList->SetPipelineState(*pipelineState);
         cachedComputePSO = pipelineState;
     }
-
-    // Validate dispatch (vs platform/api constraints)
-    // graphics->ValidateDispatch(groupCount);
-
-    // Perform dispatch
-    cmdList->Dispatch(groupCount);
-}
-
-void CommandContext::DispatchIndirect()
-{
-    VEX_NOT_YET_IMPLEMENTED();
+    return true;
 }
 
 void CommandContext::TraceRays(const RayTracingShaderCollection& rayTracingShaderCollection,
@@ -309,19 +462,24 @@ void CommandContext::TraceRays(const RayTracingShaderCollection& rayTracingShade
     InferResourceBarriers(RHIBarrierSync::RayTracing, trackedResources);
     FlushBarriers();
 
+    BindDescriptorPool();
+
     // Setup the layout for our pass (must be done before PSO handling).
     RHIResourceLayout& resourceLayout = graphics->psCache->resourceLayout.value();
-    resourceLayout.SetLayoutResources(constants);
-    cmdList->SetLayout(resourceLayout);
+    cmdList->SetLayout(resourceLayout, resourceLayout.GetLocalConstantsData(constants));
 
     std::unique_ptr<RHIRayTracingPipelineState> oldPSO;
     std::vector<MaybeUninitialized<RHIBuffer>> oldSBTs;
 
-    RHIRayTracingPipelineState* pipelineState =
-        graphics->psCache->GetRayTracingPipelineState(rayTracingShaderCollection,
-                                                      *graphics->allocator,
-                                                      oldPSO,
-                                                      oldSBTs);
+    RHIRayTracingPipelineState* pipelineState;
+    {
+        // Shader tables are allocated from the shared allocator.
+        std::scoped_lock lock(*graphics->resourceMutex);
+        pipelineState = graphics->psCache->GetRayTracingPipelineState(rayTracingShaderCollection,
+                                                                      *graphics->allocator,
+                                                                      oldPSO,
+                                                                      oldSBTs);
+    }
     if (oldPSO)
     {
         temporaryResources.emplace_back(std::move(oldPSO));
@@ -420,6 +578,14 @@ void CommandContext::GenerateMips(const TextureBinding& textureBinding)
         spirv::GetMipGenerationShader(GetTextureDimension(texture.desc.type));
 #endif
 
+    // Mip generation cannot be skipped, its pipeline state must be ready even when compiling pipelines asynchronously.
+    std::unique_ptr<RHIComputePipelineState> oldPSO;
+    graphics->psCache->GetComputePipelineState(shaderKey, oldPSO, true);
+    if (oldPSO)
+    {
+        temporaryResources.emplace_back(std::move(oldPSO));
+    }
+
     static auto ComputeNPOTFlag = [](u32 srcWidth, u32 srcHeight, u32 srcDepth, bool is3D) -> u32
     {
         if (!is3D)
@@ -596,19 +762,9 @@ void CommandContext::Copy(const Buffer& source, const Buffer& destination)
     BufferUtil::ValidateSimpleBufferCopy(source.desc, destination.desc);
 
     // Makes sure writes to the source are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = RHIBarrierAccess::CopySource,
-    });
-    // Makes sure reads of the destination are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryRead,
-        .dstAccess = RHIBarrierAccess::CopyDest,
-    });
+    EnqueueBufferBarrier(source, RHIBarrierSync::Copy, RHIBarrierAccess::CopySource);
+    // Makes sure accesses to the destination are done.
+    EnqueueBufferBarrier(destination, RHIBarrierSync::Copy, RHIBarrierAccess::CopyDest);
     FlushBarriers();
 
     RHIBuffer& sourceRHI = graphics->GetRHIBuffer(source.handle);
@@ -621,19 +777,9 @@ void CommandContext::Copy(const Buffer& source, const Buffer& destination, const
     BufferUtil::ValidateBufferCopyDesc(source.desc, destination.desc, bufferCopyDesc);
 
     // Makes sure writes to the source are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = RHIBarrierAccess::CopySource,
-    });
-    // Makes sure reads of the destination are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryRead,
-        .dstAccess = RHIBarrierAccess::CopyDest,
-    });
+    EnqueueBufferBarrier(source, RHIBarrierSync::Copy, RHIBarrierAccess::CopySource);
+    // Makes sure accesses to the destination are done.
+    EnqueueBufferBarrier(destination, RHIBarrierSync::Copy, RHIBarrierAccess::CopyDest);
     FlushBarriers();
 
     RHIBuffer& sourceRHI = graphics->GetRHIBuffer(source.handle);
@@ -644,12 +790,7 @@ void CommandContext::Copy(const Buffer& source, const Buffer& destination, const
 void CommandContext::Copy(const Buffer& source, const Texture& destination)
 {
     // Makes sure writes to the source buffer are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = RHIBarrierAccess::CopySource,
-    });
+    EnqueueBufferBarrier(source, RHIBarrierSync::Copy, RHIBarrierAccess::CopySource);
     // Makes sure that reads of the dst texture are finished.
     EnqueueTextureBarrier(destination,
                           TextureSubresource{},
@@ -676,12 +817,7 @@ void CommandContext::Copy(const Buffer& source, const Texture& destination, Span
     }
 
     // Makes sure writes to the source buffer are done.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = RHIBarrierAccess::CopySource,
-    });
+    EnqueueBufferBarrier(source, RHIBarrierSync::Copy, RHIBarrierAccess::CopySource);
     for (const auto& cd : copyDescs)
     {
         // Makes sure that reads of the dest texture subresources are finished.
@@ -726,13 +862,8 @@ void CommandContext::Copy(const Texture& source,
                               RHITextureLayout::CopySource);
     }
 
-    // Make sure that reads of the dest buffer are finished.
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::Copy,
-        .srcAccess = RHIBarrierAccess::MemoryRead,
-        .dstAccess = RHIBarrierAccess::CopyDest,
-    });
+    // Make sure that accesses to the dest buffer are finished.
+    EnqueueBufferBarrier(destination, RHIBarrierSync::Copy, RHIBarrierAccess::CopyDest);
     FlushBarriers();
 
     RHITexture& sourceRHI = graphics->GetRHITexture(source.handle);
@@ -760,17 +891,17 @@ void CommandContext::EnqueueDataUpload(const Buffer& buffer, Span<const byte> da
 
     BufferUtil::ValidateBufferRegion(buffer.desc, region);
 
-    Buffer stagingBuffer = CreateTemporaryStagingBuffer(buffer.desc.name, region.GetByteSize(buffer.desc));
-
-    RHIBuffer& rhiStagingBuffer = graphics->GetRHIBuffer(stagingBuffer.handle);
-    MappedMemory(rhiStagingBuffer).WriteData({ data.begin(), data.begin() + region.GetByteSize(buffer.desc) });
+    const u64 byteSize = region.GetByteSize(buffer.desc);
+    StagingAllocation staging =
+        AllocateStagingMemory(buffer.desc.name, byteSize, CommandContext_Internal::BufferUploadAlignment);
+    std::copy_n(data.begin(), byteSize, staging.mappedData.begin());
 
-    Copy(stagingBuffer,
+    Copy(staging.buffer,
          buffer,
          BufferCopyDesc{
-             .srcOffset = 0,
+             .srcOffset = staging.offset,
              .dstOffset = region.offset,
-             .byteSize = region.GetByteSize(buffer.desc),
+             .byteSize = byteSize,
          });
 }
 
@@ -814,26 +945,24 @@ void CommandContext::EnqueueDataUpload(const Texture& texture,
               packedData.size_bytes(),
               packedDataByteSize);
 
-    // Create aligned staging buffer.
-    u64 stagingBufferByteSize = TextureUtil::ComputeAlignedUploadBufferByteSize(texture.desc, textureRegions);
-    Buffer stagingBuffer = CreateTemporaryStagingBuffer(texture.desc.name, stagingBufferByteSize);
-    RHIBuffer& rhiStagingBuffer = graphics->GetRHIBuffer(stagingBuffer.handle);
+    // Allocate aligned staging memory, the placement of texture data in a buffer must respect the mip alignment.
+    u64 stagingByteSize = TextureUtil::ComputeAlignedUploadBufferByteSize(texture.desc, textureRegions);
+    StagingAllocation staging = AllocateStagingMemory(texture.desc.name, stagingByteSize, TextureUtil::MipAlignment);
 
-    // The staging buffer has to respect the alignment that which Vex uses for uploads.
+    // The staging memory has to respect the alignment that which Vex uses for uploads.
     // We suppose however that user data is tightly packed.
-    Span<byte> stagingBufferData = rhiStagingBuffer.GetMappedData();
-    TextureCopyUtil::WriteTextureDataAligned(texture.desc, textureRegions, packedData, stagingBufferData);
-
-    if (textureRegions.empty())
-    {
-        Copy(stagingBuffer, texture);
-    }
-    else
+    TextureCopyUtil::WriteTextureDataAligned(texture.desc, textureRegions, packedData, staging.mappedData);
+
+    std::vector<BufferTextureCopyDesc> bufferToTexDescs =
+        textureRegions.empty()
+            ? BufferTextureCopyDesc::AllMips(texture.desc)
+            : CommandContext_Internal::GetBufferTextureCopyDescFromTextureRegions(texture.desc, textureRegions);
+    // Copy descs are relative to the start of the staging memory.
+    for (BufferTextureCopyDesc& copyDesc : bufferToTexDescs)
     {
-        std::vector<BufferTextureCopyDesc> bufferToTexDescs =
-            CommandContext_Internal::GetBufferTextureCopyDescFromTextureRegions(texture.desc, textureRegions);
-        Copy(stagingBuffer, texture, bufferToTexDescs);
+        copyDesc.bufferRegion.offset += staging.offset;
     }
+    Copy(staging.buffer, texture, bufferToTexDescs);
 }
 
 void CommandContext::EnqueueDataUpload(const Texture& texture,
@@ -877,71 +1006,236 @@ TextureReadbackContext CommandContext::EnqueueDataReadback(const Texture& srcTex
     return EnqueueDataReadback(srcTexture, { &textureRegion, 1 });
 }
 
+Texture CommandContext::CreateTransientTexture(const TextureDesc& desc)
+{
+    Texture texture = graphics->CreateTransientTexture(desc, transientMemoryPool);
+    transientTextures.push_back(texture);
+
+    // The texture starts in the undefined layout. If its memory was used by released transient textures, its first
+    // barrier must also wait on their last accesses.
+    const Allocation& allocation = graphics->GetRHITexture(texture.handle).GetAllocation();
+    std::optional<RHITextureState> aliasedState;
+    for (const ReleasedTransientTexture& released : releasedTransientTextures)
+    {
+        if (CommandContext_Internal::AreAllocationsOverlapping(allocation, released.allocation))
+        {
+            aliasedState = aliasedState
+                               ? CommandContext_Internal::MergeTextureStates(*aliasedState, released.lastState)
+                               : released.lastState;
+        }
+    }
+
+    GetOrFetchTextureState(texture.handle).SetUniform({
+        .sync = aliasedState ? aliasedState->sync : RHIBarrierSync::None,
+        .access = aliasedState ? aliasedState->access : RHIBarrierAccess::NoAccess,
+        .layout = RHITextureLayout::Undefined,
+    });
+
+    return texture;
+}
+
+void CommandContext::ReleaseTransientTexture(const Texture& texture)
+{
+    const auto it =
+        std::ranges::find_if(transientTextures, [&](const Texture& tex) { return tex.handle == texture.handle; });
+    VEX_CHECK(it != transientTextures.end(),
+              "Texture \"{}\" is not a transient texture of this command context, or was already released.",
+              texture.desc.name);
+    transientTextures.erase(it);
+
+    // Barriers targeting the texture must be emitted before its memory is reused.
+    FlushBarriers();
+    EndSplitBarrier(texture.handle);
+
+    std::optional<RHITextureState> lastState;
+    GetOrFetchTextureState(texture.handle)
+        .ForEachStateSection(texture.desc,
+                             {},
+                             [&](const TextureSubresource&, RHITextureState state)
+                             {
+                                 lastState =
+                                     lastState ? CommandContext_Internal::MergeTextureStates(*lastState, state) : state;
+                             });
+
+    const Allocation& allocation = graphics->GetRHITexture(texture.handle).GetAllocation();
+    releasedTransientTextures.push_back({
+        .handle = texture.handle,
+        .allocation = allocation,
+        // A texture without any state section was never accessed, so there is nothing to wait on.
+        .lastState = lastState.value_or(RHITextureState{}),
+    });
+#if VEX_USE_CUSTOM_RESOURCE_ALLOCATOR
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        graphics->allocator->FreeTransient(transientMemoryPool, allocation);
+    }
+#endif
+
+    // The texture is no longer tracked, its state does not outlive this context.
+    textureStates.erase(texture.handle);
+}
+
 void CommandContext::BuildBLAS(const AccelerationStructure& accelerationStructure, const BLASBuildDesc& desc)
+{
+    BuildBLAS({ BLASBuild{ .accelerationStructure = accelerationStructure, .desc = desc } });
+}
+
+void CommandContext::BuildBLAS(Span<const BLASBuild> blasToBuild)
+{
+    RecordBLASBuilds(blasToBuild, false);
+}
+
+void CommandContext::RefitBLAS(const AccelerationStructure& accelerationStructure, const BLASBuildDesc& desc)
+{
+    RefitBLAS({ BLASBuild{ .accelerationStructure = accelerationStructure, .desc = desc } });
+}
+
+void CommandContext::RefitBLAS(Span<const BLASBuild> blasToRefit)
+{
+    RecordBLASBuilds(blasToRefit, true);
+}
+
+void CommandContext::RecordBLASBuilds(Span<const BLASBuild> blasToBuild, bool isUpdate)
 {
     VEX_CHECK(GPhysicalDevice->IsFeatureSupported(Feature::RayTracing),
               "Your GPU does not support ray tracing, unable to build BLAS!");
-    VEX_CHECK(accelerationStructure.handle.IsValid(), "Provided acceleration structure must be valid!");
-    VEX_CHECK(accelerationStructure.desc.type == ASType::BottomLevel,
-              "BuildBLAS only accepts bottom level acceleration structures...");
-    VEX_CHECK(!desc.geometry.empty(), "Cannot build an empty BLAS...");
+    VEX_CHECK(!blasToBuild.empty(), "Cannot build an empty batch of BLAS...");
 
-    std::vector<RHIBLASGeometryDesc> rhiBLASGeometryDescs;
-    rhiBLASGeometryDescs.reserve(desc.geometry.size());
-
-    if (desc.type == ASGeometryType::Triangles)
+    for (const auto& [accelerationStructure, desc] : blasToBuild)
     {
-        for (const BLASGeometryDesc& desc : desc.geometry)
+        VEX_CHECK(accelerationStructure.handle.IsValid(), "Provided acceleration structure must be valid!");
+        VEX_CHECK(accelerationStructure.desc.type == ASType::BottomLevel,
+                  "BuildBLAS only accepts bottom level acceleration structures...");
+        VEX_CHECK(!isUpdate || accelerationStructure.desc.buildFlags & ASBuild::AllowUpdate,
+                  "Acceleration structure {} must be built with the AllowUpdate flag to be refit.",
+                  accelerationStructure.desc.name);
+        VEX_CHECK(!desc.geometry.empty(), "Cannot build an empty BLAS...");
+        VEX_CHECK(desc.type == ASGeometryType::Triangles || desc.type == ASGeometryType::AABBs,
+                  "Invalid geometry type passed for BLAS building...You must use either AABB or triangles.");
+
+        if (desc.type == ASGeometryType::Triangles)
         {
-            if (desc.indexBufferBinding)
+            for (const BLASGeometryDesc& geometry : desc.geometry)
             {
-                VEX_CHECK(desc.indexBufferBinding->buffer.desc.usage & BufferUsage::BuildAccelerationStructure,
-                          "Index buffer binding must have the BuildAccelerationStructure usage to be used as source "
+                if (geometry.indexBufferBinding)
+                {
+                    VEX_CHECK(geometry.indexBufferBinding->buffer.desc.usage & BufferUsage::BuildAccelerationStructure,
+                              "Index buffer binding must have the BuildAccelerationStructure usage to be used as "
+                              "source for building a BLAS");
+                }
+                VEX_CHECK(geometry.vertexBufferBinding.buffer.desc.usage & BufferUsage::BuildAccelerationStructure,
+                          "Vertex buffer binding must have the BuildAccelerationStructure usage to be used as source "
                           "for building a BLAS");
             }
-            VEX_CHECK(desc.vertexBufferBinding.buffer.desc.usage & BufferUsage::BuildAccelerationStructure,
-                      "Vertex buffer binding must have the BuildAccelerationStructure usage to be used as source for "
-                      "building a BLAS");
         }
+    }
 
-        // Upload all the transforms into one GPU/ staging buffer.
-        std::vector<std::array<float, 3 * 4>> transformsToUpload;
-        // Conservative allocation.
-        transformsToUpload.reserve(desc.geometry.size());
+    // Upload the transforms and the AABBs of all the BLAS into one GPU/ staging buffer each.
+    std::vector<std::array<float, 3 * 4>> transformsToUpload;
+    std::vector<AABB> aabbsToUpload;
+    for (const auto& [accelerationStructure, desc] : blasToBuild)
+    {
         for (const BLASGeometryDesc& blasGeometry : desc.geometry)
         {
-            if (blasGeometry.transform.has_value())
+            if (desc.type == ASGeometryType::Triangles && blasGeometry.transform.has_value())
             {
                 transformsToUpload.push_back(*blasGeometry.transform);
             }
+            else if (desc.type == ASGeometryType::AABBs)
+            {
+                aabbsToUpload.insert(aabbsToUpload.end(), blasGeometry.aabbs.begin(), blasGeometry.aabbs.end());
+            }
         }
+    }
 
-        static constexpr u64 TransformMatrixSize = sizeof(float) * 3 * 4;
+    const std::string& buildName =
+        graphics->GetRHIAccelerationStructure(blasToBuild.front().accelerationStructure.handle).GetDesc().name;
 
-        // Upload transform data.
-        Buffer transformBuffer;
-        if (!transformsToUpload.empty())
-        {
-            transformBuffer = CreateTemporaryStagingBuffer(
-                graphics->GetRHIAccelerationStructure(accelerationStructure.handle).GetDesc().name +
-                    "_build_blas_transforms",
-                transformsToUpload.size() * TransformMatrixSize, BufferUsage::BuildAccelerationStructure);
+    static constexpr u64 TransformMatrixSize = sizeof(float) * 3 * 4;
 
-            MappedMemory mappedMemory = graphics->MapResource(transformBuffer);
-            mappedMemory.WriteData(std::as_bytes(std::span<std::array<float, 3 * 4>>(transformsToUpload)));
-        }
+    // Upload transform data.
+    Buffer transformBuffer;
+    if (!transformsToUpload.empty())
+    {
+        transformBuffer = CreateTemporaryStagingBuffer(buildName + "_build_blas_transforms",
+                                                       transformsToUpload.size() * TransformMatrixSize,
+                                                       BufferUsage::BuildAccelerationStructure);
 
-        // Ensure that vertex/index buffers have had time to be written-to correctly.
-        EnqueueGlobalBarrier({
+        MappedMemory mappedMemory = graphics->MapResource(transformBuffer);
+        mappedMemory.WriteData(std::as_bytes(std::span<std::array<float, 3 * 4>>(transformsToUpload)));
+    }
+
+    // Upload AABB data.
+    Buffer aabbBuffer;
+    if (!aabbsToUpload.empty())
+    {
+        aabbBuffer = CreateTemporaryStagingBuffer(buildName + "_build_blas_aabb",
+                                                  aabbsToUpload.size() * sizeof(AABB),
+                                                  BufferUsage::BuildAccelerationStructure);
+
+        MappedMemory mappedMemory = graphics->MapResource(aabbBuffer);
+        mappedMemory.WriteData(std::as_bytes(std::span(aabbsToUpload)));
+
+        // Ensure that AABB upload is finished.
+        EnqueueGlobalBarrier(RHIGlobalBarrier{
             .srcSync = RHIBarrierSync::AllCommands,
             .dstSync = RHIBarrierSync::BuildAccelerationStructure,
             .srcAccess = RHIBarrierAccess::MemoryWrite,
             .dstAccess = RHIBarrierAccess::ShaderRead,
         });
+    }
+
+    if (isUpdate)
+    {
+        // Refits read and write the BLAS in place, they must wait for the previous builds and traces using them.
+        EnqueueGlobalBarrier(RHIGlobalBarrier{
+            .srcSync = RHIBarrierSync::AllCommands,
+            .dstSync = RHIBarrierSync::BuildAccelerationStructure,
+            .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
+            .dstAccess = RHIBarrierAccess::AccelerationStructureWrite,
+        });
+    }
+
+    std::vector<std::vector<RHIBLASGeometryDesc>> rhiBLASGeometryDescs(blasToBuild.size());
+
+    u32 transformIndex = 0;
+    u32 aabbIndex = 0;
+    for (u32 buildIndex = 0; buildIndex < blasToBuild.size(); ++buildIndex)
+    {
+        const BLASBuildDesc& desc = blasToBuild[buildIndex].desc;
+        std::vector<RHIBLASGeometryDesc>& rhiGeometryDescs = rhiBLASGeometryDescs[buildIndex];
+        rhiGeometryDescs.reserve(desc.geometry.size());
 
-        u32 transformIndex = 0;
         for (const BLASGeometryDesc& blasGeometry : desc.geometry)
         {
+            if (desc.type == ASGeometryType::AABBs)
+            {
+                rhiGeometryDescs.push_back(RHIBLASGeometryDesc{
+                    .aabbBufferBinding =
+                        RHIBufferBinding{
+                            .binding = { .buffer = aabbBuffer,
+                                         .strideByteSize = static_cast<u32>(sizeof(AABB)),
+                                         .offsetByteSize = sizeof(AABB) * aabbIndex,
+                                         .rangeByteSize = sizeof(AABB) * blasGeometry.aabbs.size() },
+                            .buffer = graphics->GetRHIBuffer(aabbBuffer.handle),
+                        },
+                    .flags = blasGeometry.flags,
+                });
+                aabbIndex += blasGeometry.aabbs.size();
+                continue;
+            }
+
+            // Ensure that vertex/index buffers have had time to be written-to correctly.
+            EnqueueBufferBarrier(blasGeometry.vertexBufferBinding.buffer,
+                                 RHIBarrierSync::BuildAccelerationStructure,
+                                 RHIBarrierAccess::ShaderRead);
+            if (blasGeometry.indexBufferBinding.has_value())
+            {
+                EnqueueBufferBarrier(blasGeometry.indexBufferBinding->buffer,
+                                     RHIBarrierSync::BuildAccelerationStructure,
+                                     RHIBarrierAccess::ShaderRead);
+            }
+
             // TODO(https://trello.com/c/srGndUSP): Handle other vertex formats, this should be cross-referenced
             // with Vulkan to make sure only formats supported by both APIs are accepted.
             if (*blasGeometry.vertexBufferBinding.strideByteSize > sizeof(float) * 3)
@@ -984,85 +1278,62 @@ void CommandContext::BuildBLAS(const AccelerationStructure& accelerationStructur
                 ++transformIndex;
             }
 
-            rhiBLASGeometryDescs.push_back(std::move(rhiBLASGeometry));
+            rhiGeometryDescs.push_back(std::move(rhiBLASGeometry));
         }
     }
-    else if (desc.type == ASGeometryType::AABBs)
+
+    // The scratch memory of every BLAS is packed into a single buffer, the scratch sizes are already aligned.
+    std::vector<RHIBLASBuild> rhiBLASBuilds;
+    rhiBLASBuilds.reserve(blasToBuild.size());
+    u64 scratchByteSize = 0;
     {
-        // Upload all the AABBs into one GPU/ staging buffer.
-        std::vector<AABB> aabbsToUpload;
-        // Conservative allocation.
-        aabbsToUpload.reserve(desc.geometry.size());
-        for (const BLASGeometryDesc& blasGeometry : desc.geometry)
+        std::scoped_lock allocatorLock(*graphics->resourceMutex);
+        for (u32 buildIndex = 0; buildIndex < blasToBuild.size(); ++buildIndex)
         {
-            for (const AABB& aabb : blasGeometry.aabbs)
+            RHIAccelerationStructure& accelStruct =
+                graphics->GetRHIAccelerationStructure(blasToBuild[buildIndex].accelerationStructure.handle);
+            const RHIBLASBuildDesc rhiBLASBuildDesc{ .type = blasToBuild[buildIndex].desc.type,
+                                                     .geometries = rhiBLASGeometryDescs[buildIndex] };
+
+            rhiBLASBuilds.push_back(
+                { .accelerationStructure = accelStruct, .scratchOffset = scratchByteSize, .isUpdate = isUpdate });
+            if (isUpdate)
             {
-                aabbsToUpload.push_back(aabb);
+                accelStruct.SetupBLASUpdate(rhiBLASBuildDesc);
+                scratchByteSize += accelStruct.GetBuildInfo().updateScratchByteSize;
+            }
+            else
+            {
+                scratchByteSize +=
+                    accelStruct.SetupBLASBuild(*graphics->allocator, rhiBLASBuildDesc).scratchByteSize;
             }
         }
-
-        // Upload AABB data.
-        Buffer aabbBuffer;
-        if (!aabbsToUpload.empty())
-        {
-            aabbBuffer = CreateTemporaryStagingBuffer(
-                graphics->GetRHIAccelerationStructure(accelerationStructure.handle).GetDesc().name + "_build_blas_aabb",
-                aabbsToUpload.size() * sizeof(AABB), BufferUsage::BuildAccelerationStructure);
-
-            MappedMemory mappedMemory = graphics->MapResource(aabbBuffer);
-            mappedMemory.WriteData(std::as_bytes(std::span(aabbsToUpload)));
-        }
-
-        // Ensure that AABB upload is finished.
-        EnqueueGlobalBarrier(RHIGlobalBarrier{
-            .srcSync = RHIBarrierSync::AllCommands,
-            .dstSync = RHIBarrierSync::BuildAccelerationStructure,
-            .srcAccess = RHIBarrierAccess::MemoryWrite,
-            .dstAccess = RHIBarrierAccess::ShaderRead,
-        });
-
-        u32 aabbIndex = 0;
-        for (const BLASGeometryDesc& blasGeometry : desc.geometry)
-        {
-            RHIBLASGeometryDesc rhiBLASGeometry{
-                .aabbBufferBinding =
-                    RHIBufferBinding{
-                        .binding = { .buffer = aabbBuffer,
-                                     .strideByteSize = static_cast<u32>(sizeof(AABB)),
-                                     .offsetByteSize = sizeof(AABB) * aabbIndex,
-                                     .rangeByteSize = sizeof(AABB) * blasGeometry.aabbs.size() },
-                        .buffer = graphics->GetRHIBuffer(aabbBuffer.handle),
-                    },
-                .flags = blasGeometry.flags,
-            };
-            aabbIndex += blasGeometry.aabbs.size();
-            rhiBLASGeometryDescs.push_back(std::move(rhiBLASGeometry));
-        }
-    }
-    else
-    {
-        VEX_CHECK(false, "Invalid geometry type passed for BLAS building...You must use either AABB or triangles.");
     }
 
-    const RHIAccelerationStructureBuildInfo& buildInfo =
-        graphics->GetRHIAccelerationStructure(accelerationStructure.handle)
-            .SetupBLASBuild(*graphics->allocator,
-                            RHIBLASBuildDesc{ .type = desc.type, .geometries = rhiBLASGeometryDescs });
-
     BufferDesc scratchBufferDesc{
-        .name =
-            graphics->GetRHIAccelerationStructure(accelerationStructure.handle).GetDesc().name + "_build_blas_scratch",
-        .byteSize = buildInfo.scratchByteSize,
+        .name = buildName + "_build_blas_scratch",
+        .byteSize = scratchByteSize,
         .usage = BufferUsage::Scratch,
     };
     Buffer scratchBuffer = CreateTemporaryBuffer(scratchBufferDesc);
 
     FlushBarriers();
-    cmdList->BuildBLAS(graphics->GetRHIAccelerationStructure(accelerationStructure.handle),
-                       graphics->GetRHIBuffer(scratchBuffer.handle));
+    cmdList->BuildBLAS(rhiBLASBuilds, graphics->GetRHIBuffer(scratchBuffer.handle));
 }
 
 void CommandContext::BuildTLAS(const AccelerationStructure& accelerationStructure, const TLASBuildDesc& desc)
+{
+    RecordTLASBuild(accelerationStructure, desc, false);
+}
+
+void CommandContext::UpdateTLAS(const AccelerationStructure& accelerationStructure, const TLASBuildDesc& desc)
+{
+    RecordTLASBuild(accelerationStructure, desc, true);
+}
+
+void CommandContext::RecordTLASBuild(const AccelerationStructure& accelerationStructure,
+                                     const TLASBuildDesc& desc,
+                                     bool isUpdate)
 {
     VEX_CHECK(GPhysicalDevice->IsFeatureSupported(Feature::RayTracing),
               "Your GPU does not support ray tracing, unable to build TLAS!");
@@ -1070,6 +1341,9 @@ void CommandContext::BuildTLAS(const AccelerationStructure& accelerationStructur
     VEX_CHECK(accelerationStructure.desc.type == ASType::TopLevel,
               "BuildTLAS only accepts top level acceleration structures...");
     VEX_CHECK(!desc.instances.empty(), "Cannot build an empty TLAS...");
+    VEX_CHECK(!isUpdate || accelerationStructure.desc.buildFlags & ASBuild::AllowUpdate,
+              "Acceleration structure {} must be built with the AllowUpdate flag to be updated.",
+              accelerationStructure.desc.name);
 
     std::unordered_set<AccelerationStructure> uniqueBLAS;
     std::vector<NonNullPtr<RHIAccelerationStructure>> perInstanceBLAS;
@@ -1086,6 +1360,16 @@ void CommandContext::BuildTLAS(const AccelerationStructure& accelerationStructur
         .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
         .dstAccess = RHIBarrierAccess::AccelerationStructureRead,
     });
+    if (isUpdate)
+    {
+        // Updates read and write the TLAS in place, they must wait for the previous builds and traces using it.
+        EnqueueGlobalBarrier(RHIGlobalBarrier{
+            .srcSync = RHIBarrierSync::AllCommands,
+            .dstSync = RHIBarrierSync::BuildAccelerationStructure,
+            .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
+            .dstAccess = RHIBarrierAccess::AccelerationStructureWrite,
+        });
+    }
 
     RHITLASBuildDesc rhiTLASDesc{
         .instances = desc.instances,
@@ -1095,35 +1379,147 @@ void CommandContext::BuildTLAS(const AccelerationStructure& accelerationStructur
     RHIAccelerationStructure& accelStruct = graphics->GetRHIAccelerationStructure(accelerationStructure.handle);
     std::vector<std::byte> instanceData = accelStruct.GetInstanceBufferData(rhiTLASDesc);
 
-    Buffer instanceBuffer = CreateTemporaryBuffer({
-        .name = accelStruct.GetDesc().name + "_build_tlas_instances",
-        .byteSize = instanceData.size(),
-        .usage = BufferUsage::BuildAccelerationStructure,
-    });
-    RHIBuffer& rhiInstanceBuffer = graphics->GetRHIBuffer(instanceBuffer.handle);
+    // A TLAS which allows updates keeps its instance buffer, updates upload their instances into it.
+    Buffer instanceBuffer;
+    if (isUpdate)
+    {
+        VEX_CHECK(accelStruct.GetPersistentInstanceBuffer().has_value(),
+                  "Cannot update TLAS {} which was never built.",
+                  accelerationStructure.desc.name);
+        instanceBuffer = *accelStruct.GetPersistentInstanceBuffer();
+        VEX_CHECK(instanceBuffer.desc.byteSize == instanceData.size(),
+                  "Cannot update a TLAS with a different instance count than the one it was built with.");
+    }
+    else
+    {
+        const BufferDesc instanceBufferDesc{
+            .name = accelStruct.GetDesc().name + "_build_tlas_instances",
+            .byteSize = instanceData.size(),
+            .usage = BufferUsage::BuildAccelerationStructure,
+        };
+        if (accelerationStructure.desc.buildFlags & ASBuild::AllowUpdate)
+        {
+            instanceBuffer = graphics->CreateBuffer(instanceBufferDesc);
+            accelStruct.SetPersistentInstanceBuffer(instanceBuffer);
+        }
+        else
+        {
+            instanceBuffer = CreateTemporaryBuffer(instanceBufferDesc);
+        }
+    }
     EnqueueDataUpload(instanceBuffer, instanceData);
+    RHIBuffer& rhiInstanceBuffer = graphics->GetRHIBuffer(instanceBuffer.handle);
 
     BufferBinding binding =
         BufferBinding::CreateStructuredBuffer(instanceBuffer, accelStruct.GetInstanceBufferStride());
     rhiTLASDesc.instancesBinding = RHIBufferBinding{ binding, rhiInstanceBuffer };
 
-    const RHIAccelerationStructureBuildInfo& buildInfo = accelStruct.SetupTLASBuild(*graphics->allocator, rhiTLASDesc);
+    u64 scratchByteSize;
+    if (isUpdate)
+    {
+        accelStruct.SetupTLASUpdate(rhiTLASDesc);
+        scratchByteSize = accelStruct.GetBuildInfo().updateScratchByteSize;
+    }
+    else
+    {
+        std::scoped_lock allocatorLock(*graphics->resourceMutex);
+        scratchByteSize = accelStruct.SetupTLASBuild(*graphics->allocator, rhiTLASDesc).scratchByteSize;
+    }
     Buffer scratchBuffer = CreateTemporaryBuffer({
         .name = accelStruct.GetDesc().name + "_build_tlas_scratch",
-        .byteSize = buildInfo.scratchByteSize,
+        .byteSize = scratchByteSize,
         .usage = BufferUsage::Scratch,
     });
 
-    EnqueueGlobalBarrier({ .srcSync = RHIBarrierSync::Copy,
-                           .dstSync = RHIBarrierSync::BuildAccelerationStructure,
-                           .srcAccess = RHIBarrierAccess::CopyDest,
-                           .dstAccess = RHIBarrierAccess::MemoryRead });
+    // Tracking the read of the instances makes the upload of the next update wait for this build.
+    EnqueueBufferBarrier(instanceBuffer, RHIBarrierSync::BuildAccelerationStructure, RHIBarrierAccess::ShaderRead);
 
     FlushBarriers();
     cmdList->BuildTLAS(accelStruct,
                        graphics->GetRHIBuffer(scratchBuffer.handle),
                        graphics->GetRHIBuffer(instanceBuffer.handle),
-                       rhiTLASDesc);
+                       rhiTLASDesc,
+                       isUpdate);
+}
+
+BufferReadbackContext CommandContext::EnqueueCompactedSizeReadback(
+    Span<const AccelerationStructure> accelerationStructures)
+{
+    VEX_CHECK(GPhysicalDevice->IsFeatureSupported(Feature::RayTracing),
+              "Your GPU does not support ray tracing, unable to query compacted sizes!");
+    VEX_CHECK(!accelerationStructures.empty(), "Cannot query the compacted size of zero acceleration structures...");
+
+    std::vector<NonNullPtr<RHIAccelerationStructure>> rhiAccelerationStructures;
+    rhiAccelerationStructures.reserve(accelerationStructures.size());
+    for (const AccelerationStructure& accelerationStructure : accelerationStructures)
+    {
+        VEX_CHECK(accelerationStructure.handle.IsValid(), "Provided acceleration structure must be valid!");
+        VEX_CHECK(accelerationStructure.desc.buildFlags & ASBuild::AllowCompaction,
+                  "Acceleration structure {} must be built with the AllowCompaction flag to query its compacted size.",
+                  accelerationStructure.desc.name);
+        rhiAccelerationStructures.push_back(graphics->GetRHIAccelerationStructure(accelerationStructure.handle));
+    }
+
+    // The sizes are written to a GPU buffer, which is then read back.
+    Buffer sizeBuffer = CreateTemporaryBuffer({
+        .name = accelerationStructures.front().desc.name + "_compacted_sizes",
+        .byteSize = accelerationStructures.size() * sizeof(u64),
+        .usage = BufferUsage::ShaderReadWrite,
+    });
+
+    // Ensure the acceleration structures are done building.
+    EnqueueGlobalBarrier(RHIGlobalBarrier{
+        .srcSync = RHIBarrierSync::BuildAccelerationStructure,
+        .dstSync = RHIBarrierSync::AllCommands,
+        .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
+        .dstAccess = RHIBarrierAccess::AccelerationStructureRead,
+    });
+    EnqueueBufferBarrier(sizeBuffer, RHIBarrierSync::AllCommands, RHIBarrierAccess::MemoryWrite);
+
+    FlushBarriers();
+    cmdList->WriteCompactedSizes(rhiAccelerationStructures, graphics->GetRHIBuffer(sizeBuffer.handle));
+
+    return EnqueueDataReadback(sizeBuffer);
+}
+
+void CommandContext::CompactAccelerationStructure(const AccelerationStructure& source,
+                                                  const AccelerationStructure& destination,
+                                                  u64 compactedByteSize)
+{
+    VEX_CHECK(GPhysicalDevice->IsFeatureSupported(Feature::RayTracing),
+              "Your GPU does not support ray tracing, unable to compact acceleration structures!");
+    VEX_CHECK(source.handle.IsValid() && destination.handle.IsValid(),
+              "Provided acceleration structures must be valid!");
+    VEX_CHECK(source.desc.type == destination.desc.type,
+              "Cannot compact an acceleration structure into one of a different type...");
+    VEX_CHECK(source.desc.buildFlags & ASBuild::AllowCompaction,
+              "Acceleration structure {} must be built with the AllowCompaction flag to be compacted.",
+              source.desc.name);
+    VEX_CHECK(compactedByteSize > 0, "Cannot compact an acceleration structure into an empty one...");
+
+    RHIAccelerationStructure& rhiDestination = graphics->GetRHIAccelerationStructure(destination.handle);
+    {
+        std::scoped_lock allocatorLock(*graphics->resourceMutex);
+        rhiDestination.SetupCompaction(*graphics->allocator, compactedByteSize);
+    }
+
+    EnqueueGlobalBarrier(RHIGlobalBarrier{
+        .srcSync = RHIBarrierSync::BuildAccelerationStructure,
+        .dstSync = RHIBarrierSync::AllCommands,
+        .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
+        .dstAccess = RHIBarrierAccess::AccelerationStructureRead,
+    });
+
+    FlushBarriers();
+    cmdList->CompactAccelerationStructure(graphics->GetRHIAccelerationStructure(source.handle), rhiDestination);
+
+    // The copy is not part of the build stage, later uses of the destination must wait for all commands.
+    EnqueueGlobalBarrier(RHIGlobalBarrier{
+        .srcSync = RHIBarrierSync::AllCommands,
+        .dstSync = RHIBarrierSync::AllCommands,
+        .srcAccess = RHIBarrierAccess::AccelerationStructureWrite,
+        .dstAccess = RHIBarrierAccess::AccelerationStructureRead,
+    });
 }
 
 void CommandContext::ExecuteInDrawContext(Span<const TextureBinding> renderTargets,
@@ -1156,7 +1552,10 @@ void CommandContext::ExecuteInDrawContext(Span<const TextureBinding> renderTarge
     InferResourceBarriers(RHIBarrierSync::AllGraphics, trackedResources);
 
     FlushBarriers();
-    cmdList->BeginRendering(drawResources);
+    {
+        std::scoped_lock lock(*graphics->resourceMutex);
+        cmdList->BeginRendering(drawResources);
+    }
     callback();
     cmdList->EndRendering();
 }
@@ -1179,12 +1578,10 @@ ScopedGPUEvent CommandContext::CreateScopedGPUEvent(const char* markerLabel, std
 
 void CommandContext::Barrier(const Buffer& buffer, RHIBarrierAccess access)
 {
-    EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::AllCommands,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = access,
-    });
+    EnqueueBufferBarrier(buffer, RHIBarrierSync::AllCommands, access);
+    // Explicit barriers are emitted even when the tracked state deems them unnecessary, the user might have accessed
+    // the buffer in ways we do not track (eg: through its bindless handle).
+    std::ranges::find(pendingBufferBarriers, buffer.handle, &PendingBufferBarrier::handle)->isExplicit = true;
 }
 
 void CommandContext::Barrier(const Texture& texture, RHIBarrierAccess access, const TextureSubresource& subresource)
@@ -1205,17 +1602,145 @@ void CommandContext::Barrier(const AccelerationStructure& as, RHIBarrierAccess a
     });
 }
 
+void CommandContext::BeginSplitBarrier(const Buffer& buffer, RHIBarrierSync dstSync, RHIBarrierAccess dstAccess)
+{
+    // Barriers enqueued before must not be ordered after the split barrier.
+    FlushBarriers();
+    EndSplitBarrier(buffer.handle);
+
+    RHIBufferState& state = bufferStates[buffer.handle];
+    const RHIBufferState srcState = state;
+    const RHIBufferState dstState{ dstSync, dstAccess };
+    // Nothing to transition, the first access or a read in the same way requires no synchronization.
+    if (srcState.access == RHIBarrierAccess::NoAccess || (srcState == dstState && !IsWriteAccess(dstAccess)))
+    {
+        return;
+    }
+    state = dstState;
+    if (IsWriteAccess(dstAccess))
+    {
+        writtenBuffers.insert(buffer.handle);
+    }
+
+    const RHIBufferBarrier barrier{
+        .buffer = graphics->GetRHIBuffer(buffer.handle),
+        .srcSync = srcState.sync,
+        .dstSync = dstSync,
+        .srcAccess = srcState.access,
+        .dstAccess = dstAccess,
+    };
+    splitBufferBarriers.push_back({
+        .splitBarrierIndex = cmdList->BeginSplitBarriers({ &barrier, 1 }, {}),
+        .handle = buffer.handle,
+        .srcState = srcState,
+        .dstState = dstState,
+    });
+}
+
+void CommandContext::BeginSplitBarrier(const Texture& texture,
+                                       RHIBarrierSync dstSync,
+                                       RHIBarrierAccess dstAccess,
+                                       const TextureSubresource& subresource)
+{
+    // Barriers enqueued before must not be ordered after the split barrier.
+    FlushBarriers();
+    EndSplitBarrier(texture.handle);
+
+    TextureStateMap& textureStateMap = GetOrFetchTextureState(texture.handle);
+    const RHITextureState dstState{ dstSync, dstAccess, RHIAccessToRHILayout(dstAccess) };
+
+    SplitTextureBarrier splitBarrier{ .handle = texture.handle, .dstState = dstState };
+    bool canSplit = true;
+    textureStateMap.ForEachStateSection(texture.desc,
+                                        subresource,
+                                        [&](const TextureSubresource& section, RHITextureState srcState)
+                                        {
+                                            // Textures which were not accessed yet (or whose contents are undefined)
+                                            // are transitioned upon their next access.
+                                            if (srcState.access == RHIBarrierAccess::NoAccess ||
+                                                srcState.layout == RHITextureLayout::Undefined)
+                                            {
+                                                canSplit = false;
+                                            }
+                                            else if (srcState != dstState || IsWriteAccess(dstAccess))
+                                            {
+                                                splitBarrier.srcStates.emplace_back(section, srcState);
+                                            }
+                                        });
+    if (!canSplit || splitBarrier.srcStates.empty())
+    {
+        return;
+    }
+
+    std::vector<RHITextureBarrier> barriers;
+    barriers.reserve(splitBarrier.srcStates.size());
+    for (const auto& [section, srcState] : splitBarrier.srcStates)
+    {
+        barriers.push_back({
+            .texture = graphics->GetRHITexture(texture.handle),
+            .subresource = section,
+            .srcSync = srcState.sync,
+            .dstSync = dstState.sync,
+            .srcAccess = srcState.access,
+            .dstAccess = dstState.access,
+            .srcLayout = srcState.layout,
+            .dstLayout = dstState.layout,
+        });
+        textureStateMap.Set(texture.desc, section, dstState);
+    }
+    if (IsWriteAccess(dstAccess))
+    {
+        writtenTextures.insert(texture.handle);
+    }
+
+    splitBarrier.splitBarrierIndex = cmdList->BeginSplitBarriers({}, barriers);
+    splitTextureBarriers.push_back(std::move(splitBarrier));
+}
+
+void CommandContext::ReleaseToQueue(const Texture& texture, QueueType dstQueue, RHIBarrierAccess dstAccess)
+{
+    const RHITextureLayout layout =
+        CommandContext_Internal::ValidateQueueHandoff(texture, GetQueue(), dstQueue, dstAccess);
+
+    // Only the layout transition is required, the end of the submission makes the writes visible to the other queue.
+    EnqueueTextureBarrier(texture, {}, RHIBarrierSync::None, RHIBarrierAccess::NoAccess, layout);
+}
+
+void CommandContext::AcquireFromQueue(const Texture& texture, QueueType srcQueue, RHIBarrierAccess dstAccess)
+{
+    const RHITextureLayout layout =
+        CommandContext_Internal::ValidateQueueHandoff(texture, srcQueue, GetQueue(), dstAccess);
+    VEX_CHECK(!textureStates.contains(texture.handle),
+              "Texture \"{}\" must be acquired before being used by the command context.",
+              texture.desc.name);
+
+    // The releasing context already transitioned the texture, there is nothing to resolve upon submission.
+    GetOrFetchTextureState(texture.handle).SetUniform({ RHIBarrierSync::None, RHIBarrierAccess::NoAccess, layout });
+}
+
 RHICommandList& CommandContext::GetRHICommandList()
 {
     return *cmdList;
 }
 
+void CommandContext::BindDescriptorPool()
+{
+    if (cmdList->GetQueue() == QueueType::Copy)
+    {
+        return;
+    }
+
+    // Another thread can grow the pool meanwhile, the pool reads its current heap under its own lock.
+    boundDescriptorHeapVersion = graphics->descriptorPool->BindHeap(
+        *cmdList, graphics->psCache->resourceLayout.value(), boundDescriptorHeapVersion);
+}
+
 TextureStateMap& CommandContext::GetOrFetchTextureState(TextureHandle handle)
 {
     auto [it, inserted] = textureStates.try_emplace(handle, TextureStateMap{});
     if (inserted)
     {
-        it->second.SetUniform({ RHIBarrierSync::None, RHIBarrierAccess::NoAccess, RHITextureLayout::Common });
+        it->second.SetUniform(UnresolvedTextureState);
     }
     return it->second;
 }
@@ -1227,7 +1752,53 @@ void CommandContext::FlushBarriers()
         return;
     }
 
-    cmdList->EmitBarriers(pendingBufferBarriers, pendingTextureBarriers, pendingGlobalBarriers);
+    std::vector<RHIBufferBarrier> bufferBarriers;
+    bufferBarriers.reserve(pendingBufferBarriers.size());
+    for (const PendingBufferBarrier& barrier : pendingBufferBarriers)
+    {
+        if (barrier.isExplicit)
+        {
+            // Nothing is known about previous accesses, synchronize with any prior write.
+            const bool isTracked = barrier.srcState.access != RHIBarrierAccess::NoAccess;
+            bufferBarriers.push_back({
+                .buffer = graphics->GetRHIBuffer(barrier.handle),
+                .srcSync = isTracked ? barrier.srcState.sync : RHIBarrierSync::AllCommands,
+                .dstSync = barrier.dstState.sync,
+                .srcAccess = isTracked ? barrier.srcState.access : RHIBarrierAccess::MemoryWrite,
+                .dstAccess = barrier.dstState.access,
+            });
+            continue;
+        }
+
+        // First access in this context, resolved against previous submissions upon submission.
+        if (barrier.srcState.access == RHIBarrierAccess::NoAccess)
+        {
+            continue;
+        }
+
+        // Reading again in the same way requires no synchronization. If the dest is a write, we still have to add the
+        // barrier to avoid Write-After-Write hazards.
+        if (barrier.srcState == barrier.dstState && !IsWriteAccess(barrier.dstState.access))
+        {
+            continue;
+        }
+
+        bufferBarriers.push_back({
+            .buffer = graphics->GetRHIBuffer(barrier.handle),
+            .srcSync = barrier.srcState.sync,
+            .dstSync = barrier.dstState.sync,
+            .srcAccess = barrier.srcState.access,
+            .dstAccess = barrier.dstState.access,
+        });
+    }
+
+    if (!bufferBarriers.empty() || !pendingTextureBarriers.empty() || !pendingGlobalBarriers.empty())
+    {
+        cmdList->EmitBarriers(bufferBarriers, pendingTextureBarriers, pendingGlobalBarriers);
+    }
+#ifdef VEX_TESTS
+    emittedBufferBarrierCount += static_cast<u32>(bufferBarriers.size());
+#endif
 
     pendingBufferBarriers.clear();
     pendingTextureBarriers.clear();
@@ -1240,6 +1811,8 @@ void CommandContext::EnqueueTextureBarrier(const Texture& texture,
                                            RHIBarrierAccess dstAccess,
                                            RHITextureLayout dstLayout)
 {
+    EndSplitBarrier(texture.handle);
+
     TextureStateMap& textureStateMap = GetOrFetchTextureState(texture.handle);
 
     // Iterate on subresource sections which have the same source state.
@@ -1247,6 +1820,18 @@ void CommandContext::EnqueueTextureBarrier(const Texture& texture,
                                         subresource,
                                         [&](const TextureSubresource& section, RHITextureState srcState)
                                         {
+                                            // First access in this context, the transition from the state left by
+                                            // previous submissions is only known upon submission.
+                                            if (srcState == UnresolvedTextureState)
+                                            {
+                                                initialTextureAccesses.push_back({
+                                                    .handle = texture.handle,
+                                                    .subresource = section,
+                                                    .state = { dstSync, dstAccess, dstLayout },
+                                                });
+                                                return;
+                                            }
+
                                             RHITextureBarrier barrier{
                                                 .texture = graphics->GetRHITexture(texture.handle),
                                                 .subresource = section,
@@ -1271,22 +1856,127 @@ void CommandContext::EnqueueTextureBarrier(const Texture& texture,
                                                 return;
                                             }
 
-                                            // Have to add all resources to the touched textures list, as DX12 could
-                                            // require a resource layout transition (even when read<->read is
-                                            // occurring).
-                                            touchedTextures.insert(texture);
-
                                             pendingTextureBarriers.push_back(std::move(barrier));
                                         });
 
     // Set the new state in the texture state map, no matter the previous codepath we end up with the entire passed in
     // subresource in a uniform state.
     textureStateMap.Set(texture.desc, subresource, { dstSync, dstAccess, dstLayout });
+    if (IsWriteAccess(dstAccess))
+    {
+        writtenTextures.insert(texture.handle);
+    }
+}
+
+void CommandContext::EnqueueBufferBarrier(const Buffer& buffer, RHIBarrierSync dstSync, RHIBarrierAccess dstAccess)
+{
+    using namespace CommandContext_Internal;
+
+    EndSplitBarrier(buffer.handle);
+
+    RHIBufferState& state = bufferStates[buffer.handle];
+    const RHIBufferState dstState{ dstSync, dstAccess };
+
+    // The buffer can be accessed in multiple ways by the same operation, merge them into its pending barrier.
+    auto pendingBarrier = std::ranges::find(pendingBufferBarriers, buffer.handle, &PendingBufferBarrier::handle);
+    if (pendingBarrier != pendingBufferBarriers.end())
+    {
+        pendingBarrier->dstState = {
+            .sync = MergeSyncs(pendingBarrier->dstState.sync, dstSync),
+            .access = MergeAccesses(pendingBarrier->dstState.access, dstAccess),
+        };
+        state = pendingBarrier->dstState;
+        if (pendingBarrier->srcState.access == RHIBarrierAccess::NoAccess)
+        {
+            initialBufferStates[buffer.handle] = state;
+        }
+        if (IsWriteAccess(dstAccess))
+        {
+            writtenBuffers.insert(buffer.handle);
+        }
+        return;
+    }
+
+    // First access in this context, resolved against previous submissions upon submission.
+    if (state.access == RHIBarrierAccess::NoAccess)
+    {
+        initialBufferStates.try_emplace(buffer.handle, dstState);
+    }
+    if (IsWriteAccess(dstAccess))
+    {
+        writtenBuffers.insert(buffer.handle);
+    }
+
+    // Whether the barrier is actually required is only determined upon flushing, once all accesses are known.
+    pendingBufferBarriers.push_back({ .handle = buffer.handle, .srcState = state, .dstState = dstState });
+    state = dstState;
 }
 
 void CommandContext::EnqueueGlobalBarrier(const RHIGlobalBarrier& globalBarrier)
 {
-    pendingGlobalBarriers.push_back(globalBarrier);
+    // Coalesce identical global barriers, they are commonly enqueued by consecutive operations before a flush.
+    if (std::ranges::find(pendingGlobalBarriers, globalBarrier) == pendingGlobalBarriers.end())
+    {
+        pendingGlobalBarriers.push_back(globalBarrier);
+    }
+}
+
+void CommandContext::EndSplitBarrier(BufferHandle handle)
+{
+    const auto it = std::ranges::find(splitBufferBarriers, handle, &SplitBufferBarrier::handle);
+    if (it == splitBufferBarriers.end())
+    {
+        return;
+    }
+
+    const RHIBufferBarrier barrier{
+        .buffer = graphics->GetRHIBuffer(it->handle),
+        .srcSync = it->srcState.sync,
+        .dstSync = it->dstState.sync,
+        .srcAccess = it->srcState.access,
+        .dstAccess = it->dstState.access,
+    };
+    cmdList->EndSplitBarriers(it->splitBarrierIndex, { &barrier, 1 }, {});
+    splitBufferBarriers.erase(it);
+}
+
+void CommandContext::EndSplitBarrier(TextureHandle handle)
+{
+    const auto it = std::ranges::find(splitTextureBarriers, handle, &SplitTextureBarrier::handle);
+    if (it == splitTextureBarriers.end())
+    {
+        return;
+    }
+
+    std::vector<RHITextureBarrier> barriers;
+    barriers.reserve(it->srcStates.size());
+    for (const auto& [section, srcState] : it->srcStates)
+    {
+        barriers.push_back({
+            .texture = graphics->GetRHITexture(it->handle),
+            .subresource = section,
+            .srcSync = srcState.sync,
+            .dstSync = it->dstState.sync,
+            .srcAccess = srcState.access,
+            .dstAccess = it->dstState.access,
+            .srcLayout = srcState.layout,
+            .dstLayout = it->dstState.layout,
+        });
+    }
+    cmdList->EndSplitBarriers(it->splitBarrierIndex, {}, barriers);
+    splitTextureBarriers.erase(it);
+}
+
+void CommandContext::EndAllSplitBarriers()
+{
+    while (!splitBufferBarriers.empty())
+    {
+        EndSplitBarrier(splitBufferBarriers.back().handle);
+    }
+    while (!splitTextureBarriers.empty())
+    {
+        EndSplitBarrier(splitTextureBarriers.back().handle);
+    }
 }
 
 void CommandContext::InferResourceBarriers(RHIBarrierSync syncStage, Span<const ResourceBinding> resources)
@@ -1316,13 +2006,7 @@ void CommandContext::InferResourceBarriers(RHIBarrierSync syncStage, Span<const
                              std::unreachable();
                          }
 
-                         // In Vex buffers just use global barriers.
-                         EnqueueGlobalBarrier(RHIGlobalBarrier{
-                             .srcSync = RHIBarrierSync::AllCommands,
-                             .dstSync = syncStage,
-                             .srcAccess = RHIBarrierAccess::MemoryWrite,
-                             .dstAccess = dstAccess,
-                         });
+                         EnqueueBufferBarrier(bufferBinding.buffer, syncStage, dstAccess);
                      },
                      [this, syncStage](const TextureBinding& texBinding)
                      {
@@ -1379,6 +2063,22 @@ Buffer CommandContext::CreateTemporaryBuffer(const BufferDesc& desc)
     return buf;
 }
 
+StagingAllocation CommandContext::AllocateStagingMemory(const std::string& name, u64 byteSize, u64 alignment)
+{
+    if (std::optional<StagingAllocation> allocation = stagingAllocator.Allocate(byteSize, alignment))
+    {
+        return *allocation;
+    }
+
+    // Too large for a staging page.
+    const Buffer stagingBuffer = CreateTemporaryStagingBuffer(name, byteSize);
+    return StagingAllocation{
+        .buffer = stagingBuffer,
+        .offset = 0,
+        .mappedData = graphics->GetRHIBuffer(stagingBuffer.handle).GetMappedData(),
+    };
+}
+
 std::optional<RHIDrawResources> CommandContext::PrepareDrawCall(const DrawDesc& drawDesc,
                                                                 const DrawResourceBinding& drawBindings,
                                                                 const ConstantBinding constants,
@@ -1424,10 +2124,11 @@ std::optional<RHIDrawResources> CommandContext::PrepareDrawCall(const DrawDesc&
     auto [newDrawDesc, renderTargetState] =
         CommandContext_Internal::CreateRenderTargetStateFromBindings(drawDesc, drawResources);
 
+    BindDescriptorPool();
+
     // Setup the layout for our pass (must be done before PSO handling).
     RHIResourceLayout& resourceLayout = graphics->psCache->resourceLayout.value();
-    resourceLayout.SetLayoutResources(constants);
-    cmdList->SetLayout(resourceLayout);
+    cmdList->SetLayout(resourceLayout, resourceLayout.GetLocalConstantsData(constants));
 
     std::unique_ptr<RHIGraphicsPipelineState> oldPSO;
     RHIGraphicsPipelineState* pipelineState =
@@ -1453,10 +2154,16 @@ std::optional<RHIDrawResources> CommandContext::PrepareDrawCall(const DrawDesc&
         cachedInputAssembly = drawDesc.inputAssembly;
     }
 
-    EnqueueGlobalBarrier({ .srcSync = RHIBarrierSync::AllCommands,
-                           .dstSync = RHIBarrierSync::AllGraphics,
-                           .srcAccess = RHIBarrierAccess::MemoryWrite,
-                           .dstAccess = RHIBarrierAccess::VertexInputRead });
+    for (const BufferBinding& vertexBuffer : drawBindings.vertexBuffers)
+    {
+        EnqueueBufferBarrier(vertexBuffer.buffer, RHIBarrierSync::VertexInput, RHIBarrierAccess::VertexInputRead);
+    }
+    if (drawBindings.indexBuffer.has_value())
+    {
+        EnqueueBufferBarrier(drawBindings.indexBuffer->buffer,
+                             RHIBarrierSync::VertexInput,
+                             RHIBarrierAccess::VertexInputRead);
+    }
 
     // Bind Vertex Buffer(s)
     SetVertexBuffers(drawBindings.vertexBuffersFirstSlot, drawBindings.vertexBuffers);
@@ -1470,6 +2177,33 @@ std::optional<RHIDrawResources> CommandContext::PrepareDrawCall(const DrawDesc&
     return drawResources;
 }
 
+RHIIndirectArgsBinding CommandContext::PrepareIndirectArgs(const IndirectArgsBinding& indirectArgs, u32 argsByteSize)
+{
+    BindingUtil::ValidateIndirectArgsBinding(indirectArgs, argsByteSize);
+    VEX_CHECK(indirectArgs.maxCommandCount == 1 || GPhysicalDevice->IsFeatureSupported(Feature::MultiDrawIndirect),
+              "The device does not support indirect draws of more than one command.");
+    VEX_CHECK(!indirectArgs.countBuffer.has_value() ||
+                  GPhysicalDevice->IsFeatureSupported(Feature::DrawIndirectCount),
+              "The device does not support indirect draws reading their draw count from a count buffer.");
+
+    EnqueueBufferBarrier(indirectArgs.argsBuffer, RHIBarrierSync::DrawIndirect, RHIBarrierAccess::IndirectCommandRead);
+    if (indirectArgs.countBuffer.has_value())
+    {
+        EnqueueBufferBarrier(*indirectArgs.countBuffer,
+                             RHIBarrierSync::DrawIndirect,
+                             RHIBarrierAccess::IndirectCommandRead);
+    }
+
+    return {
+        .argsBuffer = graphics->GetRHIBuffer(indirectArgs.argsBuffer.handle),
+        .argsOffsetByteSize = indirectArgs.argsOffsetByteSize,
+        .argsStrideByteSize = indirectArgs.argsStrideByteSize.value_or(argsByteSize),
+        .maxCommandCount = indirectArgs.maxCommandCount,
+        .countBuffer = indirectArgs.countBuffer ? &graphics->GetRHIBuffer(indirectArgs.countBuffer->handle) : nullptr,
+        .countOffsetByteSize = indirectArgs.countOffsetByteSize,
+    };
+}
+
 void CommandContext::CheckViewportAndScissor() const
 {
     // Graphics APIs require the viewport and scissor rect to be initialized before performing Graphics-Queue related
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <optional>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <Vex/BuildAccelerationStructure.h>
@@ -12,13 +14,16 @@
 #include <Vex/ResourceReadbackContext.h>
 #include <Vex/ScopedGPUEvent.h>
 #include <Vex/ShaderView.h>
+#include <Vex/StagingAllocator.h>
 #include <Vex/TextureStateMap.h>
 #include <Vex/Types.h>
 #include <Vex/Utility/NonNullPtr.h>
 
 
+#include <RHI/RHIAllocator.h>
 #include <RHI/RHIBarrier.h>
 #include <RHI/RHIBindings.h>
+#include <RHI/RHIBuffer.h>
 #include <RHI/RHIFwd.h>
 #include <RHI/RHIPipelineState.h>
 #include <RHI/RHITimestampQueryPool.h>
@@ -62,8 +67,10 @@ public:
                       const TextureSubresource& subresource = {},
                       Span<const TextureClearRect> clearRects = {});
 
-    // Performs a draw call.
-    void Draw(const DrawDesc& drawDesc,
+    // Performs a draw call. Returns false if the draw was skipped, either because one of its shaders is errored or
+    // because its pipeline state is still being compiled in the background (see
+    // GraphicsCreateDesc::enableAsyncPipelineCompilation), allowing the caller to issue a fallback draw instead.
+    bool Draw(const DrawDesc& drawDesc,
               const DrawResourceBinding& drawBindings,
               ConstantBinding constants,
               Span<const ResourceBinding> trackedResources,
@@ -72,8 +79,8 @@ public:
               u32 vertexOffset = 0,
               u32 instanceOffset = 0);
 
-    // Performs an indexed draw call.
-    void DrawIndexed(const DrawDesc& drawDesc,
+    // Performs an indexed draw call. Returns false if the draw was skipped (see Draw).
+    bool DrawIndexed(const DrawDesc& drawDesc,
                      const DrawResourceBinding& drawBindings,
                      ConstantBinding constants,
                      Span<const ResourceBinding> trackedResources,
@@ -83,20 +90,37 @@ public:
                      u32 vertexOffset = 0,
                      u32 instanceOffset = 0);
 
-    // Not yet implemented
-    void DrawIndirect();
-
-    // Not yet implemented
-    void DrawIndexedIndirect();
-
-    // Dispatches a compute shader.
-    void Dispatch(const ShaderView& computeShader,
+    // Performs draws whose arguments (see DrawIndirectArgs) are read from a GPU buffer, for instance written by a GPU
+    // culling pass. Multiple draws can be issued at once (Feature::MultiDrawIndirect), optionally with their count also
+    // read from a GPU buffer (Feature::DrawIndirectCount). Returns false if the draws were skipped (see Draw).
+    bool DrawIndirect(const DrawDesc& drawDesc,
+                      const DrawResourceBinding& drawBindings,
+                      ConstantBinding constants,
+                      Span<const ResourceBinding> trackedResources,
+                      const IndirectArgsBinding& indirectArgs);
+
+    // Performs indexed draws whose arguments (see DrawIndexedIndirectArgs) are read from a GPU buffer. Returns false if
+    // the draws were skipped (see Draw).
+    bool DrawIndexedIndirect(const DrawDesc& drawDesc,
+                             const DrawResourceBinding& drawBindings,
+                             ConstantBinding constants,
+                             Span<const ResourceBinding> trackedResources,
+                             const IndirectArgsBinding& indirectArgs);
+
+    // Dispatches a compute shader. Returns false if the dispatch was skipped, either because the shader is errored or
+    // because its pipeline state is still being compiled in the background.
+    bool Dispatch(const ShaderView& computeShader,
                   ConstantBinding constants,
                   Span<const ResourceBinding> trackedResources,
                   std::array<u32, 3> groupCount);
 
-    // Not yet implemented
-    void DispatchIndirect();
+    // Dispatches a compute shader with its group count (see DispatchIndirectArgs) read from a GPU buffer. Only a single
+    // dispatch without count buffer is supported, as Vulkan has no equivalent to multi-dispatch indirect. Returns false
+    // if the dispatch was skipped (see Dispatch).
+    bool DispatchIndirect(const ShaderView& computeShader,
+                          ConstantBinding constants,
+                          Span<const ResourceBinding> trackedResources,
+                          const IndirectArgsBinding& indirectArgs);
 
     // Dispatches a ray tracing pass.
     void TraceRays(const RayTracingShaderCollection& rayTracingShaderCollection,
@@ -176,20 +200,59 @@ public:
     TextureReadbackContext EnqueueDataReadback(const Texture& srcTexture,
                                                const TextureRegion& textureRegion = TextureRegion::AllMips());
 
+    // ---------------------------------------------------------------------------------------------------------------
+    // Transient Textures
+    // ---------------------------------------------------------------------------------------------------------------
+
+    // Creates a texture which is only valid inside of this command context. Its memory can alias the memory of the
+    // transient textures released earlier in this context, so its initial contents are undefined. The barriers
+    // required by the aliasing are emitted automatically upon its first use.
+    [[nodiscard]] Texture CreateTransientTexture(const TextureDesc& desc);
+    // Ends the lifetime of a transient texture, which must no longer be used afterwards. Its memory is reused by the
+    // transient textures created after this call. Transient textures which are never released keep their memory until
+    // the command context is done executing. Lifetimes are explicit here, RenderGraph derives them from the first and
+    // last use of its transient resources instead.
+    void ReleaseTransientTexture(const Texture& texture);
+
     // ---------------------------------------------------------------------------------------------------------------
     // Acceleration Structure Operations
     // ---------------------------------------------------------------------------------------------------------------
 
     // Builds a Bottom Level Acceleration Structure for Hardware Ray Tracing, by uploading the passed in Geometry.
     void BuildBLAS(const AccelerationStructure& accelerationStructure, const BLASBuildDesc& desc);
-    // TODO(https://trello.com/c/LUYWkd2L): add batched tlas / blas build
-    // void BuildBLAS(Span<std::pair<const AccelerationStructure&, const BLASBuildDesc&>> blasToBuild);
+    // Builds multiple Bottom Level Acceleration Structures at once. Their geometry is uploaded to a single staging
+    // buffer and they share a single scratch buffer, allowing the GPU to build them in parallel.
+    void BuildBLAS(Span<const BLASBuild> blasToBuild);
+
+    // Refits a Bottom Level Acceleration Structure built with the AllowUpdate flag to its moved geometry, which is
+    // much cheaper than rebuilding it. The geometry must have the same layout as when the BLAS was built, only the
+    // vertex positions and transforms can change. Trace quality degrades as the geometry deforms further away from
+    // the one it was built with, rebuild it once in a while when it changes a lot.
+    void RefitBLAS(const AccelerationStructure& accelerationStructure, const BLASBuildDesc& desc);
+    // Refits multiple Bottom Level Acceleration Structures at once, sharing a single scratch buffer.
+    void RefitBLAS(Span<const BLASBuild> blasToRefit);
 
     // Builds a Top Level Acceleration Structure for Hardware Ray Tracing, by uploading the passed in Instances.
+    // A TLAS built with the AllowUpdate flag keeps its instance buffer for the following updates.
     void BuildTLAS(const AccelerationStructure& accelerationStructure, const TLASBuildDesc& desc);
+    // Updates a Top Level Acceleration Structure built with the AllowUpdate flag in place, by uploading the passed in
+    // Instances into its instance buffer. The instance count must be the same as when the TLAS was built.
+    void UpdateTLAS(const AccelerationStructure& accelerationStructure, const TLASBuildDesc& desc);
     // TODO(https://trello.com/c/LUYWkd2L): add batched tlas / blas build
     // void BuildTLAS(Span<std::pair<const AccelerationStructure&, const TLASBuildDesc&>> tlasToBuild);
 
+    // Enqueues the readback of the compacted byte size of each acceleration structure, as one u64 per acceleration
+    // structure. They must have been built with the AllowCompaction flag, earlier in this context or in a previous
+    // submission.
+    [[nodiscard]] BufferReadbackContext EnqueueCompactedSizeReadback(
+        Span<const AccelerationStructure> accelerationStructures);
+    // Copies the source acceleration structure into the destination, an acceleration structure of the same type which
+    // was never built, allocated with the compacted byte size read back for the source. The source can be destroyed
+    // once the copy was submitted. The compacted acceleration structure cannot be refit or updated.
+    void CompactAccelerationStructure(const AccelerationStructure& source,
+                                      const AccelerationStructure& destination,
+                                      u64 compactedByteSize);
+
     // ---------------------------------------------------------------------------------------------------------------
 
     // Useful for calling native API draws when wanting to render to a specific Render Target. Allows the passed in
@@ -206,6 +269,12 @@ public:
     // Pix.
     ScopedGPUEvent CreateScopedGPUEvent(const char* markerLabel, std::array<float, 3> color = { 1, 1, 1 });
 
+    // Ends the recording of the context, no more commands can be recorded afterwards. A context recorded on another
+    // thread than the one submitting it must be closed on its recording thread before being submitted, as all the
+    // command lists of a thread share a native command pool which cannot be used by two threads at once. Submit closes
+    // the contexts which are still open.
+    void Close();
+
     // ---------------------------------------------------------------------------------------------------------------
     // Advanced Operations, should be used with care!
     // ---------------------------------------------------------------------------------------------------------------
@@ -213,30 +282,72 @@ public:
     // ---------------------------------------------------------------------------------------------------------------
     // Manual synchronization is typically unnecessary as long as you use the "tracked resources" provided by
     // Draw/Dispatch/TraceRays. In the cases it is necessary we still expose it here.
+    // Resources keep their state across submissions, a resource accessed through its bindless handle must still be
+    // tracked (or transitioned manually) as it can be left in any state by a previous submission.
 
     void Barrier(const Buffer& buffer, RHIBarrierAccess access);
     void Barrier(const Texture& texture, RHIBarrierAccess access, const TextureSubresource& subresource = {});
     void Barrier(const AccelerationStructure& as, RHIBarrierAccess access);
 
+    // Begins the transition of the resource to the passed in state, to be called right after its last write. The GPU
+    // can then overlap the transition with the work recorded until the next use of the resource, which ends it.
+    void BeginSplitBarrier(const Buffer& buffer, RHIBarrierSync dstSync, RHIBarrierAccess dstAccess);
+    void BeginSplitBarrier(const Texture& texture,
+                           RHIBarrierSync dstSync,
+                           RHIBarrierAccess dstAccess,
+                           const TextureSubresource& subresource = {});
+
+    // Hands the texture off to the other queue, which must acquire it with AcquireFromQueue using the same access. The
+    // texture is left in the layout of that access, so that the destination queue can use it without transitioning it.
+    // The texture must no longer be used by this context afterwards.
+    // Textures can only be exchanged between the graphics and compute queues. Buffers have no layout, waiting on the
+    // submission which wrote to them is enough to use them on another queue.
+    void ReleaseToQueue(const Texture& texture, QueueType dstQueue, RHIBarrierAccess dstAccess);
+    // Must be called before any other use of the texture in this context, which must wait on the submission which
+    // released the texture.
+    void AcquireFromQueue(const Texture& texture, QueueType srcQueue, RHIBarrierAccess dstAccess);
+
     // ---------------------------------------------------------------------------------------------------------------
 
     // Returns the RHI command list associated with this context allowing for access to the native
     // CommandList/CommandContext (you should avoid using this unless you know what you are doing).
     RHICommandList& GetRHICommandList();
 
+#ifdef VEX_TESTS
+    // Number of buffer barriers emitted by this context so far, allows tests to check which barriers are skipped.
+    [[nodiscard]] u32 GetEmittedBufferBarrierCount() const
+    {
+        return emittedBufferBarrierCount;
+    }
+#endif
+
 private:
     TextureStateMap& GetOrFetchTextureState(TextureHandle handle);
 
+    // Binds the descriptor pool, unless its current heap is already bound. The pool's heap is replaced when it grows,
+    // which requires binding it again before using the bindless handles allocated since then.
+    void BindDescriptorPool();
+
     void FlushBarriers();
     void EnqueueTextureBarrier(const Texture& texture,
                                const TextureSubresource& subresource,
                                RHIBarrierSync dstSync,
                                RHIBarrierAccess dstAccess,
                                RHITextureLayout dstLayout);
+    // Only emits a barrier when the access causes a hazard with the previous access to the buffer in this context.
+    void EnqueueBufferBarrier(const Buffer& buffer, RHIBarrierSync dstSync, RHIBarrierAccess dstAccess);
     void EnqueueGlobalBarrier(const RHIGlobalBarrier& globalBarrier);
+    // Ends the split barrier begun on the resource, if any.
+    void EndSplitBarrier(BufferHandle handle);
+    void EndSplitBarrier(TextureHandle handle);
+    void EndAllSplitBarriers();
 
     void InferResourceBarriers(RHIBarrierSync syncStage, Span<const ResourceBinding> resources);
 
+    // Records the build of the acceleration structures, or their update in place when isUpdate is set.
+    void RecordBLASBuilds(Span<const BLASBuild> blasToBuild, bool isUpdate);
+    void RecordTLASBuild(const AccelerationStructure& accelerationStructure, const TLASBuildDesc& desc, bool isUpdate);
+
     // Creates a temporary staging buffer that will be destroyed once the command context is done executing.
     // Buffer creation invalidates pointers to existing RHI buffers.
     Buffer CreateTemporaryStagingBuffer(const std::string& name,
@@ -247,25 +358,78 @@ private:
     // Buffer creation invalidates pointers to existing RHI buffers.
     Buffer CreateTemporaryBuffer(const BufferDesc& desc);
 
+    // Allocates upload memory that remains valid until the command context is done executing. Sub-allocated from the
+    // staging pages when possible, otherwise falls back to a temporary staging buffer.
+    // Can create a buffer, which invalidates pointers to existing RHI buffers.
+    StagingAllocation AllocateStagingMemory(const std::string& name, u64 byteSize, u64 alignment);
+
     std::optional<RHIDrawResources> PrepareDrawCall(const DrawDesc& drawDesc,
                                                     const DrawResourceBinding& drawBindings,
                                                     ConstantBinding constants,
                                                     Span<const ResourceBinding> trackedResources);
     void CheckViewportAndScissor() const;
+    // Returns false if the dispatch must be skipped.
+    bool PrepareDispatch(const ShaderView& computeShader,
+                         ConstantBinding constants,
+                         Span<const ResourceBinding> trackedResources);
+    // Validates the indirect arguments and enqueues the barrier for reading them.
+    RHIIndirectArgsBinding PrepareIndirectArgs(const IndirectArgsBinding& indirectArgs, u32 argsByteSize);
 
     void SetVertexBuffers(u32 vertexBuffersFirstSlot, Span<const BufferBinding> vertexBuffers);
     void SetIndexBuffer(const BufferBinding& indexBuffer);
 
     NonNullPtr<Graphics> graphics;
     NonNullPtr<RHICommandList> cmdList;
+    // State of each texture used in this context. Textures start in the unresolved state, their first access is then
+    // recorded as an initial access instead of a barrier.
     std::unordered_map<TextureHandle, TextureStateMap> textureStates;
-    std::unordered_set<Texture, TextureHandleHash> touchedTextures;
+    // Last access of each buffer used in this context. Buffers start with no access, their first access is then
+    // recorded as their initial state instead of a barrier.
+    std::unordered_map<BufferHandle, RHIBufferState> bufferStates;
+
+    // The state resources are left in by previous submissions is only known once this context is submitted, Graphics
+    // then transitions them to the state of their first access in this context before executing it.
+    static constexpr RHITextureState UnresolvedTextureState{
+        .sync = RHIBarrierSync::AllCommands,
+        .access = RHIBarrierAccess::NoAccess,
+        .layout = RHITextureLayout::Undefined,
+    };
+    struct InitialTextureAccess
+    {
+        TextureHandle handle;
+        TextureSubresource subresource;
+        RHITextureState state;
+    };
+    std::vector<InitialTextureAccess> initialTextureAccesses;
+    std::unordered_map<BufferHandle, RHIBufferState> initialBufferStates;
+    // Resources written to by this context, whose writes must be made visible to later submissions of this queue once
+    // other queues used them.
+    std::unordered_set<TextureHandle> writtenTextures;
+    std::unordered_set<BufferHandle> writtenBuffers;
 
     // Temporary resources (eg: staging resources) that will be marked for destruction once this command list is
     // submitted.
     std::vector<Buffer> temporaryBuffers;
     std::vector<CleanupVariant> temporaryResources;
 
+    // Sub-allocates the staging memory of uploads, its pages are recycled once this command context is done executing.
+    StagingAllocator stagingAllocator;
+
+    // Memory of the transient textures, its pages are recycled once this command context is done executing (or right
+    // away if it is destroyed without being submitted).
+    TransientMemoryPool transientMemoryPool;
+    // Transient textures are destroyed once this command context is done executing (or right away if it is destroyed
+    // without being submitted).
+    std::vector<Texture> transientTextures;
+    struct ReleasedTransientTexture
+    {
+        TextureHandle handle;
+        Allocation allocation;
+        // Last GPU access to the texture, which must complete before its memory is reused.
+        RHITextureState lastState;
+    };
+    std::vector<ReleasedTransientTexture> releasedTransientTextures;
+
     // Used to avoid resetting the same state multiple times which can be costly on certain hardware.
     // In general draws and dispatches are recommended to be grouped by PSO, so this caching can be very efficient
     // versus binding everything each time.
@@ -276,14 +440,54 @@ private:
 
     // Pending barriers, which are emitted only when the user performs a GPU operation (ie. draw call, dispatch, ...) or
     // submits the command context.
-    std::vector<RHIBufferBarrier> pendingBufferBarriers;
+    // Buffer barriers are only resolved to their RHI buffer upon flushing, as buffer creation invalidates pointers to
+    // existing RHI buffers.
+    struct PendingBufferBarrier
+    {
+        BufferHandle handle;
+        RHIBufferState srcState;
+        RHIBufferState dstState;
+        // Requested through Barrier(), always emitted.
+        bool isExplicit = false;
+    };
+    std::vector<PendingBufferBarrier> pendingBufferBarriers;
     std::vector<RHITextureBarrier> pendingTextureBarriers;
     std::vector<RHIGlobalBarrier> pendingGlobalBarriers;
 
+    // Split barriers which were begun but not yet ended, RHI resources are resolved again when ending them.
+    struct SplitBufferBarrier
+    {
+        u32 splitBarrierIndex;
+        BufferHandle handle;
+        RHIBufferState srcState;
+        RHIBufferState dstState;
+    };
+    struct SplitTextureBarrier
+    {
+        u32 splitBarrierIndex;
+        TextureHandle handle;
+        // Texture sections being transitioned, along with their state before the barrier.
+        std::vector<std::pair<TextureSubresource, RHITextureState>> srcStates;
+        RHITextureState dstState;
+    };
+    std::vector<SplitBufferBarrier> splitBufferBarriers;
+    std::vector<SplitTextureBarrier> splitTextureBarriers;
+
     bool hasInitializedViewport = false;
     bool hasInitializedScissor = false;
 
+    // Heap version of the descriptor pool when it was last bound.
+    std::optional<u32> boundDescriptorHeapVersion;
+
+    // Thread which created the context, the only one allowed to record into it.
+    std::thread::id recordingThread = std::this_thread::get_id();
+
+#ifdef VEX_TESTS
+    u32 emittedBufferBarrierCount = 0;
+#endif
+
     friend class Graphics;
+    friend class RenderGraph;
 };
 
 } // namespace vex
\ No newline at end of file
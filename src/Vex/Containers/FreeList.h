@@ -14,7 +14,8 @@
 namespace vex
 {
 
-// Simple free-list index allocator
+// Free-list index allocator, always handing out the smallest free index so that allocated indices stay compact.
+// The free indices are kept in a min-heap, making both allocation and deallocation O(log n).
 template <class IndexT = u32>
     requires std::is_integral_v<IndexT>
 struct FreeListAllocator
@@ -22,10 +23,11 @@ struct FreeListAllocator
     FreeListAllocator(IndexT size = 0)
         : size{ size }
     {
+        // Indices in increasing order already form a valid min-heap.
         freeIndices.reserve(size);
         for (IndexT i = 0; i < size; ++i)
         {
-            freeIndices.push_back(size - 1 - i);
+            freeIndices.push_back(i);
         }
     }
 
@@ -36,6 +38,7 @@ struct FreeListAllocator
             Resize(std::max<IndexT>(size * 2, 1));
         }
 
+        std::ranges::pop_heap(freeIndices, std::greater{});
         IndexT idx = freeIndices.back();
         freeIndices.pop_back();
         return idx;
@@ -43,17 +46,16 @@ struct FreeListAllocator
 
     void DeallocateBatch(Span<IndexT> indices)
     {
-        if (!indices.empty())
+        for (IndexT index : indices)
         {
-            freeIndices.insert(freeIndices.end(), indices.begin(), indices.end());
-            std::sort(freeIndices.begin(), freeIndices.end(), std::greater{});
+            Deallocate(index);
         }
     }
 
     void Deallocate(IndexT index)
     {
         freeIndices.push_back(index);
-        std::sort(freeIndices.begin(), freeIndices.end(), std::greater{});
+        std::ranges::push_heap(freeIndices, std::greater{});
     }
 
     void Resize(IndexT newSize)
@@ -66,19 +68,18 @@ struct FreeListAllocator
         IndexT numNewIndices = newSize - size;
         freeIndices.reserve(freeIndices.size() + numNewIndices);
 
-        // Add new indices
+        // New indices are larger than all existing ones, pushing them onto the heap never has to move them.
         for (IndexT i = size; i < newSize; ++i)
         {
             freeIndices.push_back(i);
+            std::ranges::push_heap(freeIndices, std::greater{});
         }
 
-        // Re-sort to maintain largest-to-smallest order.
-        std::sort(freeIndices.begin(), freeIndices.end(), std::greater{});
-
         size = newSize;
     }
 
     IndexT size;
+    // Min-heap of the free indices.
     std::vector<IndexT> freeIndices;
 };
 
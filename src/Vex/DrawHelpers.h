@@ -17,4 +17,30 @@ struct DrawDesc
     ColorBlendState colorBlendState;
 };
 
+// Layouts of the arguments read from the GPU by indirect draws and dispatches, identical across graphics APIs.
+
+struct DrawIndirectArgs
+{
+    u32 vertexCount;
+    u32 instanceCount;
+    u32 vertexOffset;
+    u32 instanceOffset;
+};
+
+struct DrawIndexedIndirectArgs
+{
+    u32 indexCount;
+    u32 instanceCount;
+    u32 indexOffset;
+    i32 vertexOffset;
+    u32 instanceOffset;
+};
+
+struct DispatchIndirectArgs
+{
+    u32 groupCountX;
+    u32 groupCountY;
+    u32 groupCountZ;
+};
+
 } // namespace vex
\ No newline at end of file
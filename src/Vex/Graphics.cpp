@@ -1,7 +1,12 @@
 #include "Graphics.h"
 
+#include <algorithm>
 #include <array>
+#include <fstream>
 #include <functional>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
 
@@ -16,6 +21,7 @@
 #include <Vex/RHIImpl/RHIResourceLayout.h>
 #include <Vex/RHIImpl/RHITexture.h>
 #include <Vex/ResourceCleanup.h>
+#include <Vex/StagingAllocator.h>
 #include <Vex/Utility/ByteUtils.h>
 #include <Vex/Utility/Validation.h>
 #include <Vex/Utility/Visitor.h>
@@ -29,9 +35,44 @@
 namespace vex
 {
 
+namespace Graphics_Internal
+{
+
+// The copy queue only supports the common layout, the compute queue cannot use the graphics-specific layouts.
+static bool IsLayoutSupportedOnQueue(RHITextureLayout layout, QueueType queue)
+{
+    switch (queue)
+    {
+    case QueueType::Copy:
+        return layout == RHITextureLayout::Common || layout == RHITextureLayout::Undefined;
+    case QueueType::Compute:
+        return layout != RHITextureLayout::RenderTarget && layout != RHITextureLayout::DepthStencilRead &&
+               layout != RHITextureLayout::DepthStencilWrite && layout != RHITextureLayout::Present;
+    default:
+        return true;
+    }
+}
+
+// Returns the state to transition a texture from at the start of a submission to the queue. Accesses of another queue
+// are synchronized by waiting on its submission, only the layout they left the texture in remains.
+static RHITextureState GetSubmissionSrcState(RHITextureState submittedState, QueueType submittedQueue, QueueType queue)
+{
+    if (submittedQueue == queue)
+    {
+        return submittedState;
+    }
+    return { RHIBarrierSync::None, RHIBarrierAccess::NoAccess, submittedState.layout };
+}
+
+} // namespace Graphics_Internal
+
 Graphics::Graphics(const GraphicsCreateDesc& desc)
     : desc(desc)
-    , rhi(desc.platformWindow.windowHandle, desc.enableGPUDebugLayer, desc.enableGPUBasedValidation)
+    , rhi(desc.platformWindow.windowHandle,
+          desc.enableGPUDebugLayer,
+          desc.enableGPUBasedValidation,
+          desc.useDescriptorBuffer,
+          desc.enableGraphicsPipelineFastLinking)
     , textureRegistry(DefaultRegistrySize)
     , bufferRegistry(DefaultRegistrySize)
 {
@@ -99,6 +140,11 @@ Graphics::Graphics(const GraphicsCreateDesc& desc)
     // Initializes RHI which includes creating logical device and swapchain (if applicable).
     rhi.Init();
 
+    if (desc.pipelineCacheFilepath)
+    {
+        LoadPipelineCache(*desc.pipelineCacheFilepath);
+    }
+
     if (desc.useSwapChain)
     {
         VEX_LOG(Info,
@@ -115,7 +161,14 @@ Graphics::Graphics(const GraphicsCreateDesc& desc)
 
     descriptorPool = rhi.CreateDescriptorPool();
 
-    psCache.emplace(rhi, *descriptorPool);
+    VEX_CHECK(!desc.enableGraphicsPipelineFastLinking || desc.enableAsyncPipelineCompilation,
+              "Graphics pipeline fast linking requires async pipeline compilation, which compiles the optimized "
+              "pipeline states in the background.");
+    psCache.emplace(rhi,
+                    *descriptorPool,
+                    desc.enableAsyncPipelineCompilation,
+                    desc.recordPipelineStateManifest,
+                    desc.enableGraphicsPipelineFastLinking);
 
     allocator = rhi.CreateAllocator();
 
@@ -133,9 +186,24 @@ Graphics::Graphics(const GraphicsCreateDesc& desc)
 
 Graphics::~Graphics()
 {
+    // Release the dynamic resources of the ongoing frame along with the rest.
+    EndFrame();
+
     // Wait for work to be done before starting the deletion of resources.
     FlushGPU();
 
+    // The flush recycled all staging pages, they can now safely be destroyed.
+    for (const Buffer& page : freeStagingPages)
+    {
+        CleanupResource(UnregisterElement(bufferRegistry, page.handle), *descriptorPool, *allocator);
+    }
+    freeStagingPages.clear();
+
+    if (desc.pipelineCacheFilepath)
+    {
+        SavePipelineCache(*desc.pipelineCacheFilepath);
+    }
+
     allocator.reset();
 
     // Clear the global physical device.
@@ -158,7 +226,8 @@ void Graphics::Present()
     if (std::optional<RHITexture> backBuffer = swapChain->AcquireBackBuffer(currentFrameIndex))
     {
         // Open a new command list that will be used to copy the presentTexture to the backbuffer, and presenting.
-        RHITexture& presentTexture = GetRHITexture(GetCurrentPresentTexture().handle);
+        const TextureHandle presentTextureHandle = GetCurrentPresentTexture().handle;
+        RHITexture& presentTexture = GetRHITexture(presentTextureHandle);
 
         // Validate backbuffer/present texture dimensions, a copy won't work if the textures don't have the same size.
         VEX_ASSERT(backBuffer->GetDesc().width == presentTexture.GetDesc().width &&
@@ -175,9 +244,31 @@ void Graphics::Present()
         NonNullPtr<RHICommandList> cmdList = commandPool->GetOrCreateCommandList(QueueType::Graphics);
         cmdList->Open();
 
-        RHIBarrierSync srcSync = RHIBarrierSync::None;
-        RHIBarrierAccess srcAccess = RHIBarrierAccess::NoAccess;
-        RHITextureLayout srcLayout = RHITextureLayout::Common;
+        // The present texture is left in the state of its last submission.
+        RHITextureState presentTextureState{ RHIBarrierSync::None,
+                                             RHIBarrierAccess::NoAccess,
+                                             RHITextureLayout::Common };
+        std::vector<RHIGlobalBarrier> globalBarriers;
+        {
+            std::scoped_lock lock(*resourceMutex);
+            if (const auto submitted = submittedTextureStates.find(presentTextureHandle);
+                submitted != submittedTextureStates.end())
+            {
+                const auto& [states, submittedQueue, writeQueue] = submitted->second;
+                presentTextureState = Graphics_Internal::GetSubmissionSrcState(
+                    states.Get(presentTexture.GetDesc(), TextureSubresource{}), submittedQueue, QueueType::Graphics);
+                if (submittedQueue != QueueType::Graphics && writeQueue == QueueType::Graphics)
+                {
+                    globalBarriers.push_back({
+                        .srcSync = RHIBarrierSync::AllCommands,
+                        .dstSync = RHIBarrierSync::AllCommands,
+                        .srcAccess = RHIBarrierAccess::MemoryWrite,
+                        .dstAccess = RHIBarrierAccess::MemoryRead,
+                    });
+                }
+            }
+        }
+        const auto [srcSync, srcAccess, srcLayout] = presentTextureState;
         const auto [bbSrcSync, bbSrcAccess, bbSrcLayout] =
             backBufferState.Get(backBuffer->GetDesc(), TextureSubresource{});
 
@@ -203,7 +294,7 @@ void Graphics::Present()
                 .dstLayout = RHITextureLayout::CopyDest,
             },
         };
-        cmdList->EmitBarriers({}, barriers, {});
+        cmdList->EmitBarriers({}, barriers, globalBarriers);
         cmdList->Copy(presentTexture, *backBuffer);
         RHITextureBarrier backBufferBarrier{
             .texture = *backBuffer,
@@ -231,6 +322,12 @@ void Graphics::Present()
         presentTokens[currentFrameIndex] = swapChain->Present(currentFrameIndex, rhi, cmdList);
         commandPool->OnCommandListsSubmitted({ &cmdList, 1 }, { &presentTokens[currentFrameIndex], 1 });
 
+        // The present texture is back in the common layout.
+        {
+            std::scoped_lock lock(*resourceMutex);
+            submittedTextureStates.erase(presentTextureHandle);
+        }
+
         // Certain swapchains reset the state of the backbuffer to Undefined after presenting.
         if (GPhysicalDevice->HasCapability(Capability::PresentResetsBackBufferToUndefined))
         {
@@ -246,6 +343,8 @@ void Graphics::Present()
 
     currentFrameIndex = (currentFrameIndex + 1) % std::to_underlying(desc.swapChainDesc.frameBuffering);
 
+    EndFrame();
+
     // If our swapchain is stale, we must recreate it.
     if (swapChain->NeedsRecreation() && swapChain->CanRecreate())
     {
@@ -263,6 +362,51 @@ void Graphics::Present()
     }
 }
 
+void Graphics::EndFrame()
+{
+    std::scoped_lock lock(*resourceMutex);
+    if (dynamicTextures.empty() && dynamicBuffers.empty())
+    {
+        return;
+    }
+
+    // The frame's dynamic resources are retired against the most recent submissions, a command context submitted later
+    // could still use them once freed.
+    VEX_CHECK(!commandPool->HasRecordingCommandLists(),
+              "A command context is still open at the end of the frame, submit all command contexts before ending the "
+              "frame as it could be using the frame's dynamic resources.");
+
+    // Dynamic resources can no longer be submitted.
+    for (TextureHandle handle : dynamicTextures)
+    {
+        submittedTextureStates.erase(handle);
+    }
+    for (BufferHandle handle : dynamicBuffers)
+    {
+        submittedBufferStates.erase(handle);
+    }
+
+    // Dynamic resources are released in bulk once the GPU is done with the frame. Their memory is recycled with the
+    // allocator's arena pages and their bindless descriptors with the dynamic descriptor ring, so no resource has to be
+    // freed individually.
+    EnqueueCPUWork(
+        [this,
+         textures = std::exchange(dynamicTextures, {}),
+         buffers = std::exchange(dynamicBuffers, {}),
+         arenaPages = allocator->EndDynamicFrame(),
+         descriptorFrameEndMarker = descriptorPool->EndDynamicDescriptorFrame()]() mutable
+        {
+            {
+                std::scoped_lock registryLock(*registryMutex);
+                textureRegistry.FreeElementBatch(textures);
+                bufferRegistry.FreeElementBatch(buffers);
+            }
+            allocator->RecycleDynamicArenaPages(arenaPages);
+            descriptorPool->FreeDynamicDescriptors(descriptorFrameEndMarker);
+        },
+        rhi.GetMostRecentSyncTokenPerQueue());
+}
+
 CommandContext Graphics::CreateCommandContext(QueueType queueType)
 {
     return CommandContext{ *this, commandPool->GetOrCreateCommandList(queueType), *queryPool };
@@ -270,6 +414,10 @@ CommandContext Graphics::CreateCommandContext(QueueType queueType)
 
 Texture Graphics::CreateTexture(const TextureDesc& textureDesc, ResourceLifetime lifetime)
 {
+    VEX_CHECK(lifetime != ResourceLifetime::Transient,
+              "Cannot create transient texture \"{}\", transient textures must be created using "
+              "CommandContext::CreateTransientTexture.",
+              textureDesc.name);
     TextureUtil::ValidateTextureDescription(textureDesc);
     TextureDesc texDesc = textureDesc;
 
@@ -278,21 +426,38 @@ Texture Graphics::CreateTexture(const TextureDesc& textureDesc, ResourceLifetime
         texDesc.mips = ComputeMipCount(std::make_tuple(textureDesc.width, textureDesc.height, textureDesc.GetDepth()));
     }
 
+    std::scoped_lock lock(*resourceMutex);
+    Texture texture{
+        .handle = RegisterElement(textureRegistry,
+                                  std::make_unique<RHITexture>(rhi.CreateTexture(*allocator, texDesc, lifetime))),
+        .desc = std::move(texDesc),
+    };
     if (lifetime == ResourceLifetime::Dynamic)
     {
-        // TODO(https://trello.com/c/K2jgp9ax): handle dynamic resources, includes specifying that the resource when
-        // bound should use dynamic bindless indices and self-cleanup of the RHITexture should occur after the current
-        // frame ends, would be used for transient resources inside our memory allocation strategy (avoids constant
-        // reallocations).
-        VEX_NOT_YET_IMPLEMENTED();
+        dynamicTextures.push_back(texture.handle);
     }
+    pendingInitializations.push_back(texture);
+    return texture;
+}
 
-    Texture texture{
-        .handle = textureRegistry.AllocateElement(std::make_unique<RHITexture>(rhi.CreateTexture(*allocator, texDesc))),
+Texture Graphics::CreateTransientTexture(const TextureDesc& textureDesc, TransientMemoryPool& transientPool)
+{
+    TextureUtil::ValidateTextureDescription(textureDesc);
+    TextureDesc texDesc = textureDesc;
+
+    if (textureDesc.mips == 0)
+    {
+        texDesc.mips = ComputeMipCount(std::make_tuple(textureDesc.width, textureDesc.height, textureDesc.GetDepth()));
+    }
+
+    // Not added to the pending initializations, the command context starts the texture in the undefined layout.
+    std::scoped_lock lock(*resourceMutex);
+    return Texture{
+        .handle = RegisterElement(
+            textureRegistry,
+            std::make_unique<RHITexture>(rhi.CreateTransientTexture(*allocator, texDesc, transientPool))),
         .desc = std::move(texDesc),
     };
-    pendingInitializations.push_back(texture);
-    return texture;
 }
 
 void Graphics::DestroyTexture(const Texture& texture)
@@ -301,8 +466,17 @@ void Graphics::DestroyTexture(const Texture& texture)
     {
         return;
     }
+    VEX_CHECK(GetRHITexture(texture.handle).GetLifetime() != ResourceLifetime::Dynamic,
+              "Cannot destroy dynamic texture \"{}\", dynamic resources are destroyed automatically at the end of the "
+              "frame.",
+              texture.desc.name);
+    VEX_CHECK(GetRHITexture(texture.handle).GetLifetime() != ResourceLifetime::Transient,
+              "Cannot destroy transient texture \"{}\", use CommandContext::ReleaseTransientTexture instead.",
+              texture.desc.name);
+    std::scoped_lock lock(*resourceMutex);
+    submittedTextureStates.erase(texture.handle);
     // TODO(https://trello.com/c/lEZ7PhTc): MostRecentSyncToken is error prone.
-    EnqueueCPUWork([&, rhiTexture = *textureRegistry.ExtractElement(texture.handle)]() mutable
+    EnqueueCPUWork([&, rhiTexture = UnregisterElement(textureRegistry, texture.handle)]() mutable
                    { CleanupResource(std::move(rhiTexture), *descriptorPool, *allocator); },
                    rhi.GetMostRecentSyncTokenPerQueue());
 }
@@ -311,18 +485,15 @@ Buffer Graphics::CreateBuffer(const BufferDesc& bufferDesc, ResourceLifetime lif
 {
     BufferUtil::ValidateBufferDesc(bufferDesc);
 
+    std::scoped_lock lock(*resourceMutex);
+    Buffer buffer{ .handle = RegisterElement(
+                       bufferRegistry, std::make_unique<RHIBuffer>(rhi.CreateBuffer(*allocator, bufferDesc, lifetime))),
+                   .desc = std::move(bufferDesc) };
     if (lifetime == ResourceLifetime::Dynamic)
     {
-        // TODO(https://trello.com/c/K2jgp9ax): handle dynamic resources, includes specifying that the resource when
-        // bound should use dynamic bindless indices and self-cleanup of the RHITexture should occur after the current
-        // frame ends, would be used for transient resources inside our memory allocation strategy (avoids constant
-        // reallocations).
-        VEX_NOT_YET_IMPLEMENTED();
+        dynamicBuffers.push_back(buffer.handle);
     }
-
-    return Buffer{ .handle = bufferRegistry.AllocateElement(
-                       std::make_unique<RHIBuffer>(rhi.CreateBuffer(*allocator, bufferDesc))),
-                   .desc = std::move(bufferDesc) };
+    return buffer;
 }
 
 void Graphics::DestroyBuffer(const Buffer& buffer)
@@ -331,8 +502,14 @@ void Graphics::DestroyBuffer(const Buffer& buffer)
     {
         return;
     }
+    VEX_CHECK(GetRHIBuffer(buffer.handle).GetLifetime() == ResourceLifetime::Static,
+              "Cannot destroy dynamic buffer \"{}\", dynamic resources are destroyed automatically at the end of the "
+              "frame.",
+              buffer.desc.name);
+    std::scoped_lock lock(*resourceMutex);
+    submittedBufferStates.erase(buffer.handle);
     // TODO(https://trello.com/c/lEZ7PhTc): MostRecentSyncToken is error prone.
-    EnqueueCPUWork([&, rhiBuffer = *bufferRegistry.ExtractElement(buffer.handle)]() mutable
+    EnqueueCPUWork([&, rhiBuffer = UnregisterElement(bufferRegistry, buffer.handle)]() mutable
                    { CleanupResource(std::move(rhiBuffer), *descriptorPool, *allocator); },
                    rhi.GetMostRecentSyncTokenPerQueue());
 }
@@ -341,9 +518,10 @@ AccelerationStructure Graphics::CreateAccelerationStructure(const AccelerationSt
 {
     VEX_CHECK(GPhysicalDevice->IsFeatureSupported(Feature::RayTracing),
               "Your GPU does not support ray tracing, unable to create an acceleration structure!");
+    std::scoped_lock lock(*resourceMutex);
     return {
-        .handle = accelerationStructureRegistry.AllocateElement(
-            std::make_unique<RHIAccelerationStructure>(rhi.CreateAS(asDesc))),
+        .handle = RegisterElement(accelerationStructureRegistry,
+                                  std::make_unique<RHIAccelerationStructure>(rhi.CreateAS(asDesc))),
         .desc = asDesc,
     };
 }
@@ -354,8 +532,14 @@ void Graphics::DestroyAccelerationStructure(const AccelerationStructure& acceler
     {
         return;
     }
+    std::scoped_lock lock(*resourceMutex);
+    if (const std::optional<Buffer>& instanceBuffer =
+            GetRHIAccelerationStructure(accelerationStructure.handle).GetPersistentInstanceBuffer())
+    {
+        DestroyBuffer(*instanceBuffer);
+    }
     // TODO(https://trello.com/c/lEZ7PhTc): MostRecentSyncToken is error prone.
-    EnqueueCPUWork([&, rhiAS = *accelerationStructureRegistry.ExtractElement(accelerationStructure.handle)]() mutable
+    EnqueueCPUWork([&, rhiAS = UnregisterElement(accelerationStructureRegistry, accelerationStructure.handle)]() mutable
                    { CleanupResource(std::move(rhiAS), *descriptorPool, *allocator); },
                    rhi.GetMostRecentSyncTokenPerQueue());
 }
@@ -377,6 +561,7 @@ BindlessHandle Graphics::GetBindlessHandle(const TextureBinding& bindlessResourc
 {
     BindingUtil::ValidateTextureBinding(bindlessResource, bindlessResource.texture.desc.usage);
 
+    std::scoped_lock lock(*resourceMutex);
     auto& texture = GetRHITexture(bindlessResource.texture.handle);
     return texture.GetOrCreateBindlessView(bindlessResource, *descriptorPool);
 }
@@ -385,12 +570,14 @@ BindlessHandle Graphics::GetBindlessHandle(const BufferBinding& bindlessResource
 {
     BindingUtil::ValidateBufferBinding(bindlessResource, bindlessResource.buffer.desc.usage);
 
+    std::scoped_lock lock(*resourceMutex);
     auto& buffer = GetRHIBuffer(bindlessResource.buffer.handle);
     return buffer.GetOrCreateBindlessView(bindlessResource, *descriptorPool);
 }
 
 BindlessHandle Graphics::GetBindlessHandle(const AccelerationStructure& accelerationStructure)
 {
+    std::scoped_lock lock(*resourceMutex);
     return GetRHIAccelerationStructure(accelerationStructure.handle)
         .GetRHIBuffer()
         .GetOrCreateBindlessView({}, *descriptorPool);
@@ -398,6 +585,8 @@ BindlessHandle Graphics::GetBindlessHandle(const AccelerationStructure& accelera
 
 std::vector<BindlessHandle> Graphics::GetBindlessHandles(Span<const ResourceBinding> bindlessResources)
 {
+    // Locked once for the whole batch, the per-binding overloads lock again recursively.
+    std::scoped_lock lock(*resourceMutex);
     std::vector<BindlessHandle> handles;
     handles.reserve(bindlessResources.size());
     for (const auto& binding : bindlessResources)
@@ -410,11 +599,14 @@ std::vector<BindlessHandle> Graphics::GetBindlessHandles(Span<const ResourceBind
                             { handles.emplace_back(GetBindlessHandle(asBinding)); } },
                    binding.binding);
     }
+    // The descriptors of the whole batch are written at once.
+    descriptorPool->FlushPendingDescriptorWrites();
     return handles;
 }
 
 BindlessHandle Graphics::GetBindlessSampler(const BindlessTextureSampler& sampler)
 {
+    std::scoped_lock lock(*resourceMutex);
     auto& handle = bindlessSamplers[sampler];
     if (handle.IsValid())
     {
@@ -434,14 +626,16 @@ BindlessHandle Graphics::GetBindlessSampler(const BindlessTextureSampler& sample
 
 void Graphics::SetStaticSamplers(Span<const StaticTextureSampler> staticSamplers)
 {
-    psCache->resourceLayout->SetStaticSamplers(staticSamplers);
+    psCache->SetStaticSamplers(staticSamplers);
 }
 
 SyncToken Graphics::Submit(CommandContext& ctx, Span<const SyncToken> dependencies)
 {
     auto tokens = Submit(std::span(&ctx, 1), dependencies);
-    VEX_ASSERT(tokens.size() == 1);
-    return tokens[0];
+    // The context's submission waits on the transitions recorded on the graphics queue, if any.
+    const auto token = std::ranges::find(tokens, ctx.GetQueue(), &SyncToken::queueType);
+    VEX_ASSERT(token != tokens.end());
+    return *token;
 }
 
 std::vector<SyncToken> Graphics::Submit(Span<CommandContext> commandContexts, Span<const SyncToken> dependencies)
@@ -449,24 +643,75 @@ std::vector<SyncToken> Graphics::Submit(Span<CommandContext> commandContexts, Sp
     // Process any pending textures.
     std::optional<SyncToken> pendingInitializationToken = FlushPendingInitializations();
 
-    // Collect and prepare all command contexts for submission.
-    std::vector<NonNullPtr<RHICommandList>> cmdLists;
-    for (auto& ctx : commandContexts)
     {
-        PrepareCommandContextForSubmission(ctx);
-        cmdLists.push_back(ctx.cmdList);
+        // The submitted work might use descriptors which were not written yet.
+        std::scoped_lock lock(*resourceMutex);
+        descriptorPool->FlushPendingDescriptorWrites();
     }
 
-    std::vector<SyncToken> tokens;
+    std::vector<SyncToken> submissionDependencies{ dependencies.begin(), dependencies.end() };
     if (pendingInitializationToken.has_value())
     {
-        std::vector<SyncToken> finalDependencies{ dependencies.begin(), dependencies.end() };
-        finalDependencies.push_back(pendingInitializationToken.value());
-        tokens = rhi.Submit(cmdLists, finalDependencies);
+        submissionDependencies.push_back(pendingInitializationToken.value());
     }
-    else
+
+    // Command lists are submitted together, unless textures must first be transitioned on the graphics queue after the
+    // previous command lists. Each group then waits on the ones before it.
+    std::vector<NonNullPtr<RHICommandList>> cmdLists;
+    std::array<std::optional<SyncToken>, QueueTypes::Count> latestTokens;
+    const auto SubmitCommandLists = [&]()
     {
-        tokens = rhi.Submit(cmdLists, dependencies);
+        if (cmdLists.empty())
+        {
+            return;
+        }
+        std::vector<SyncToken> groupTokens = rhi.Submit(cmdLists, submissionDependencies);
+        commandPool->OnCommandListsSubmitted(cmdLists, groupTokens);
+        for (const SyncToken& token : groupTokens)
+        {
+            latestTokens[token.queueType] = token;
+        }
+        std::ranges::copy(groupTokens, std::back_inserter(submissionDependencies));
+        cmdLists.clear();
+    };
+
+    {
+        std::scoped_lock lock(*resourceMutex);
+        for (auto& ctx : commandContexts)
+        {
+            PrepareCommandContextForSubmission(ctx);
+
+            // Contexts are resolved in submission order, each one starting from the states the previous ones left.
+            const SubmissionBarriers barriers = ResolveSubmissionBarriers(ctx);
+            if (!barriers.graphicsTextureBarriers.empty())
+            {
+                SubmitCommandLists();
+                cmdLists.push_back(
+                    RecordBarrierCommandList(QueueType::Graphics, {}, barriers.graphicsTextureBarriers, {}));
+                SubmitCommandLists();
+            }
+            if (!barriers.bufferBarriers.empty() || !barriers.textureBarriers.empty() ||
+                !barriers.globalBarriers.empty())
+            {
+                cmdLists.push_back(RecordBarrierCommandList(ctx.GetQueue(),
+                                                            barriers.bufferBarriers,
+                                                            barriers.textureBarriers,
+                                                            barriers.globalBarriers));
+            }
+            cmdLists.push_back(ctx.cmdList);
+
+            UpdateSubmittedStates(ctx);
+        }
+        SubmitCommandLists();
+    }
+
+    std::vector<SyncToken> tokens;
+    for (const std::optional<SyncToken>& token : latestTokens)
+    {
+        if (token.has_value())
+        {
+            tokens.push_back(*token);
+        }
     }
 
     // Collect the temporary resources of all command contexts in this phase.
@@ -475,12 +720,21 @@ std::vector<SyncToken> Graphics::Submit(Span<CommandContext> commandContexts, Sp
     {
         for (auto& buffer : ctx.temporaryBuffers)
         {
-            phaseTemporaryResources.push_back(*bufferRegistry.ExtractElement(buffer.handle));
+            phaseTemporaryResources.push_back(UnregisterElement(bufferRegistry, buffer.handle));
         }
         for (auto& resource : ctx.temporaryResources)
         {
             phaseTemporaryResources.push_back(std::move(resource));
         }
+        // Taken from the context, so that it does not destroy them again.
+        for (auto& texture : std::exchange(ctx.transientTextures, {}))
+        {
+            phaseTemporaryResources.push_back(UnregisterElement(textureRegistry, texture.handle));
+        }
+        for (auto& released : std::exchange(ctx.releasedTransientTextures, {}))
+        {
+            phaseTemporaryResources.push_back(UnregisterElement(textureRegistry, released.handle));
+        }
     }
 
     // Send them to be cleaned-up once the GPU has done executing.
@@ -497,7 +751,30 @@ std::vector<SyncToken> Graphics::Submit(Span<CommandContext> commandContexts, Sp
             tokens);
     }
 
-    commandPool->OnCommandListsSubmitted(cmdLists, tokens);
+    // Staging pages are recycled instead, once the GPU has done executing.
+    std::vector<Buffer> phaseStagingPages;
+    for (auto& ctx : commandContexts)
+    {
+        std::ranges::move(ctx.stagingAllocator.ExtractPages(), std::back_inserter(phaseStagingPages));
+    }
+    if (!phaseStagingPages.empty())
+    {
+        EnqueueCPUWork([this, pages = std::move(phaseStagingPages)]() mutable
+                       { std::ranges::move(pages, std::back_inserter(freeStagingPages)); },
+                       tokens);
+    }
+
+    // Same goes for the memory of transient textures.
+    for (auto& ctx : commandContexts)
+    {
+        if (ctx.transientMemoryPool.pages.empty())
+        {
+            continue;
+        }
+        EnqueueCPUWork([this, pool = std::exchange(ctx.transientMemoryPool, {})]() mutable
+                       { allocator->RecycleTransientMemoryPool(pool); },
+                       tokens);
+    }
 
     Cleanup();
 
@@ -539,6 +816,237 @@ void Graphics::FlushGPU()
     VEX_ASSERT(pendingCPUWork.empty(), "Should never have remaining CPU work after a flush and cleanup...");
 }
 
+u64 Graphics::DefragmentMemory(u64 maxByteSizeToMove)
+{
+    std::scoped_lock lock(*resourceMutex);
+    const std::vector<DefragmentationPage> pages = allocator->BeginDefragmentation();
+    u64 movedByteSize = 0;
+    const auto ShouldMove = [&](ResourceLifetime lifetime, const Allocation& allocation)
+    {
+        const DefragmentationPage page{ .memoryTypeIndex = allocation.memoryTypeIndex,
+                                        .pageHandle = allocation.pageHandle };
+        if (lifetime != ResourceLifetime::Static || allocation.pageHandle == GInvalidPageHandle ||
+            movedByteSize + allocation.memoryRange.size > maxByteSizeToMove ||
+            std::ranges::find(pages, page) == pages.end())
+        {
+            return false;
+        }
+        movedByteSize += allocation.memoryRange.size;
+        return true;
+    };
+
+    std::shared_lock registryLock(*registryMutex);
+    std::vector<Texture> texturesToMove;
+    for (auto it = textureRegistry.begin(); it != textureRegistry.end(); ++it)
+    {
+        const RHITexture& rhiTexture = **it;
+        if (ShouldMove(rhiTexture.GetLifetime(), rhiTexture.GetAllocation()))
+        {
+            texturesToMove.push_back({ .handle = it.GetHandle(), .desc = rhiTexture.GetDesc() });
+        }
+    }
+
+    std::vector<Buffer> buffersToMove;
+    for (auto it = bufferRegistry.begin(); it != bufferRegistry.end(); ++it)
+    {
+        const RHIBuffer& rhiBuffer = **it;
+        const BufferDesc& bufferDesc = rhiBuffer.GetDesc();
+        // Ray tracing structures reference buffers by their GPU address, which moving would change.
+        const bool isUsedForRayTracing =
+            (bufferDesc.usage & BufferUsage::AccelerationStructure) == BufferUsage::AccelerationStructure ||
+            (bufferDesc.usage & (BufferUsage::BuildAccelerationStructure | BufferUsage::ShaderTable));
+        if (bufferDesc.memoryLocality == ResourceMemoryLocality::GPUOnly && !isUsedForRayTracing &&
+            ShouldMove(rhiBuffer.GetLifetime(), rhiBuffer.GetAllocation()))
+        {
+            buffersToMove.push_back({ .handle = it.GetHandle(), .desc = bufferDesc });
+        }
+    }
+    registryLock.unlock();
+
+    if (texturesToMove.empty() && buffersToMove.empty())
+    {
+        allocator->EndDefragmentation();
+        return 0;
+    }
+
+    // The new resources are created while the evacuated pages are excluded from allocations.
+    CommandContext ctx = CreateCommandContext(QueueType::Graphics);
+    std::vector<std::pair<Texture, Texture>> movedTextures;
+    for (const Texture& source : texturesToMove)
+    {
+        Texture destination = CreateTexture(source.desc);
+        ctx.Copy(source, destination);
+        movedTextures.emplace_back(source, std::move(destination));
+    }
+    std::vector<std::pair<Buffer, Buffer>> movedBuffers;
+    for (const Buffer& source : buffersToMove)
+    {
+        Buffer destination = CreateBuffer(source.desc);
+        ctx.Copy(source, destination);
+        movedBuffers.emplace_back(source, std::move(destination));
+    }
+    allocator->EndDefragmentation();
+
+    // Waiting on a submission which depends on all queues guarantees that the GPU no longer uses the old resources nor
+    // their descriptors.
+    WaitForTokenOnCPU(Submit(ctx, rhi.GetMostRecentSyncTokenPerQueue()));
+
+    // The new resources take over the handles of the old ones, which are destroyed right away.
+    for (auto& [source, destination] : movedTextures)
+    {
+        GetRHITexture(destination.handle).TakeBindlessViews(GetRHITexture(source.handle), *descriptorPool);
+        {
+            std::scoped_lock swapLock(*registryMutex);
+            std::swap(textureRegistry[source.handle], textureRegistry[destination.handle]);
+        }
+        // The handle of the old texture now refers to the new one, in the state the copy left it in.
+        submittedTextureStates.erase(source.handle);
+        if (auto node = submittedTextureStates.extract(destination.handle))
+        {
+            node.key() = source.handle;
+            submittedTextureStates.insert(std::move(node));
+        }
+        CleanupResource(UnregisterElement(textureRegistry, destination.handle), *descriptorPool, *allocator);
+    }
+    for (auto& [source, destination] : movedBuffers)
+    {
+        GetRHIBuffer(destination.handle).TakeBindlessViews(GetRHIBuffer(source.handle), *descriptorPool);
+        {
+            std::scoped_lock swapLock(*registryMutex);
+            std::swap(bufferRegistry[source.handle], bufferRegistry[destination.handle]);
+        }
+        submittedBufferStates.erase(source.handle);
+        if (auto node = submittedBufferStates.extract(destination.handle))
+        {
+            node.key() = source.handle;
+            submittedBufferStates.insert(std::move(node));
+        }
+        CleanupResource(UnregisterElement(bufferRegistry, destination.handle), *descriptorPool, *allocator);
+    }
+
+    VEX_LOG(Verbose,
+            "Defragmentation moved {} textures and {} buffers ({} bytes).",
+            movedTextures.size(),
+            movedBuffers.size(),
+            movedByteSize);
+
+    return movedByteSize;
+}
+
+void Graphics::SavePipelineCache(const std::filesystem::path& filepath)
+{
+    // Background compilations also populate the pipeline cache.
+    psCache->WaitForPendingCompilations();
+
+    const std::vector<byte> cacheData = rhi.GetPipelineCacheData();
+    if (cacheData.empty())
+    {
+        return;
+    }
+
+    if (filepath.has_parent_path())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+        if (ec)
+        {
+            VEX_LOG(Error,
+                    "Unable to create the pipeline cache directory {}: {}.",
+                    filepath.parent_path().string(),
+                    ec.message());
+            return;
+        }
+    }
+    if (std::ofstream ofstream(filepath, std::ios::binary | std::ios::trunc); ofstream.is_open())
+    {
+        ofstream.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+        VEX_LOG(Info, "Pipeline cache ({} bytes) written to: {}", cacheData.size(), filepath.string());
+    }
+    else
+    {
+        VEX_LOG(Error, "Failed to write pipeline cache to: {}", filepath.string());
+    }
+}
+
+void Graphics::PrecompilePipelines(Span<const GraphicsPipelineStateDesc> graphicsPipelines)
+{
+    psCache->PrecompileGraphicsPipelineStates(graphicsPipelines);
+}
+
+void Graphics::PrecompilePipelines(Span<const ShaderView> computeShaders)
+{
+    psCache->PrecompileComputePipelineStates(computeShaders);
+}
+
+void Graphics::PrecompilePipelines(Span<const RayTracingShaderCollection> rayTracingPipelines)
+{
+    // Shader tables are allocated from the shared allocator.
+    std::scoped_lock lock(*resourceMutex);
+    psCache->PrecompileRayTracingPipelineStates(rayTracingPipelines, *allocator);
+}
+
+void Graphics::SavePipelineStateManifest(const std::filesystem::path& filepath)
+{
+    const PipelineStateManifest* manifest = psCache->GetManifest();
+    if (!manifest)
+    {
+        VEX_LOG(Error,
+                "Cannot save the pipeline state manifest, pipeline states are only recorded when "
+                "GraphicsCreateDesc::recordPipelineStateManifest is enabled.");
+        return;
+    }
+
+    if (manifest->Save(filepath))
+    {
+        VEX_LOG(Info,
+                "Pipeline state manifest ({} graphics, {} compute, {} ray tracing) written to: {}",
+                manifest->GetGraphicsPipelineStates().size(),
+                manifest->GetComputePipelineStates().size(),
+                manifest->GetRayTracingPipelineStates().size(),
+                filepath.string());
+    }
+    else
+    {
+        VEX_LOG(Error, "Failed to write pipeline state manifest to: {}", filepath.string());
+    }
+}
+
+void Graphics::ReplayPipelineStateManifest(const std::filesystem::path& filepath, Span<const ShaderView> shaders)
+{
+    std::optional<PipelineStateManifest> manifest = PipelineStateManifest::Load(filepath);
+    if (!manifest)
+    {
+        return;
+    }
+
+    if (const u32 skippedCount = manifest->ResolveShaders(shaders); skippedCount > 0)
+    {
+        VEX_LOG(Info,
+                "Skipping {} pipeline states of the manifest {}, their shaders were not provided.",
+                skippedCount,
+                filepath.string());
+    }
+
+    // Background compilations hold their own copy of the shaders, the manifest does not need to outlive this call.
+    psCache->PrecompileGraphicsPipelineStates(manifest->GetGraphicsPipelineStates());
+    psCache->PrecompileComputePipelineStates(manifest->GetComputePipelineStates());
+    if (IsRayTracingSupported())
+    {
+        std::scoped_lock lock(*resourceMutex);
+        psCache->PrecompileRayTracingPipelineStates(manifest->GetRayTracingPipelineStates(), *allocator);
+    }
+}
+
+void Graphics::WaitForPipelineCompilations()
+{
+    psCache->WaitForPendingCompilations();
+}
+
+bool Graphics::HasPendingPipelineCompilations() const
+{
+    return psCache->HasPendingCompilations();
+}
+
 void Graphics::SetUseVSync(bool useVSync)
 {
     desc.swapChainDesc.useVSync = useVSync;
@@ -630,11 +1138,14 @@ std::vector<PhysicalDeviceInfo> Graphics::GetSupportedDevices()
 
 void Graphics::EnqueueCPUWork(CPUCallback&& callback, Span<const SyncToken> tokens)
 {
+    std::scoped_lock lock(*resourceMutex);
     pendingCPUWork.emplace_back(std::move(callback), std::vector<SyncToken>{ tokens.begin(), tokens.end() });
 }
 
 void Graphics::ExecuteCPUWork()
 {
+    // Callbacks run with the lock held, they are free to release resources.
+    std::scoped_lock lock(*resourceMutex);
     std::erase_if(pendingCPUWork,
                   [this](PendingCPUWork& work)
                   {
@@ -647,18 +1158,49 @@ void Graphics::ExecuteCPUWork()
                   });
 }
 
+void Graphics::LoadPipelineCache(const std::filesystem::path& filepath)
+{
+    std::ifstream ifstream(filepath, std::ios::binary | std::ios::ate);
+    if (!ifstream.is_open())
+    {
+        // No cache exists yet (eg: first run), it will be created on shutdown.
+        return;
+    }
+
+    std::vector<byte> cacheData(static_cast<std::size_t>(ifstream.tellg()));
+    ifstream.seekg(0);
+    ifstream.read(reinterpret_cast<char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+    if (!ifstream)
+    {
+        VEX_LOG(Warning, "Failed to read pipeline cache from: {}", filepath.string());
+        return;
+    }
+
+    rhi.LoadPipelineCache(cacheData);
+}
+
 std::optional<SyncToken> Graphics::FlushPendingInitializations()
 {
+    std::vector<Texture> texturesToInitialize;
+    {
+        std::scoped_lock lock(*resourceMutex);
+        texturesToInitialize = std::exchange(pendingInitializations, {});
+    }
+
     // Remove all stale textures, eg: if a texture is created then deleted without having been used.
-    std::erase_if(pendingInitializations, [this](const Texture& tex) { return !textureRegistry.IsValid(tex.handle); });
-    if (pendingInitializations.empty())
+    {
+        std::shared_lock registryLock(*registryMutex);
+        std::erase_if(texturesToInitialize,
+                      [this](const Texture& tex) { return !textureRegistry.IsValid(tex.handle); });
+    }
+    if (texturesToInitialize.empty())
     {
         return std::nullopt;
     }
 
     // Transition all newly created textures to the default layout.
     CommandContext ctx = CreateCommandContext(QueueType::Graphics);
-    for (auto& texture : pendingInitializations)
+    for (auto& texture : texturesToInitialize)
     {
 
         RHITextureBarrier barrier{
@@ -701,8 +1243,6 @@ std::optional<SyncToken> Graphics::FlushPendingInitializations()
     ctx.FlushBarriers();
     ctx.cmdList->Close();
 
-    pendingInitializations.clear();
-
     auto token = rhi.Submit({ ctx.cmdList }, {})[0];
     commandPool->OnCommandListsSubmitted({ ctx.cmdList }, { token });
 
@@ -711,44 +1251,279 @@ std::optional<SyncToken> Graphics::FlushPendingInitializations()
 
 void Graphics::PrepareCommandContextForSubmission(CommandContext& ctx)
 {
-    VEX_ASSERT(ctx.cmdList->IsOpen(), "Error on submit: attempting to submit an already closed command context...");
+    VEX_ASSERT(ctx.cmdList->GetState() == RHICommandListState::Recording,
+               "Error on submit: attempting to submit an already submitted command context...");
+
+    // Contexts recorded on other threads were closed by them, closing them here would use their thread's command pool.
+    if (ctx.cmdList->IsOpen())
+    {
+        ctx.Close();
+    }
+}
+
+struct Graphics::SubmissionBarriers
+{
+    std::vector<RHIBufferBarrier> bufferBarriers;
+    std::vector<RHITextureBarrier> textureBarriers;
+    std::vector<RHIGlobalBarrier> globalBarriers;
+    // Transitions out of layouts the queue of the command context cannot use, recorded on the graphics queue.
+    std::vector<RHITextureBarrier> graphicsTextureBarriers;
+};
+
+Graphics::SubmissionBarriers Graphics::ResolveSubmissionBarriers(const CommandContext& ctx)
+{
+    using namespace Graphics_Internal;
+
+    const QueueType queue = ctx.GetQueue();
+    SubmissionBarriers barriers;
+    // Writes of this queue which were followed by accesses of another queue are not covered by any barrier of this
+    // queue yet, only a global barrier makes them visible again.
+    bool requiresGlobalBarrier = false;
+
+    for (const auto& [handle, dstState] : ctx.initialBufferStates)
+    {
+        const auto submitted = submittedBufferStates.find(handle);
+        if (submitted == submittedBufferStates.end())
+        {
+            continue;
+        }
+
+        const auto& [srcState, submittedQueue, writeQueue] = submitted->second;
+        if (submittedQueue != queue)
+        {
+            requiresGlobalBarrier |= writeQueue == queue;
+            continue;
+        }
+
+        // Reading again in the same way requires no synchronization.
+        if (srcState.access == RHIBarrierAccess::NoAccess || (srcState == dstState && !IsWriteAccess(dstState.access)))
+        {
+            continue;
+        }
+
+        barriers.bufferBarriers.push_back({
+            .buffer = GetRHIBuffer(handle),
+            .srcSync = srcState.sync,
+            .dstSync = dstState.sync,
+            .srcAccess = srcState.access,
+            .dstAccess = dstState.access,
+        });
+    }
+
+    // Textures which were never submitted are in the common layout, as left by their initialization.
+    SubmittedTextureState initialState{ .queue = queue };
+    initialState.states.SetUniform({ RHIBarrierSync::None, RHIBarrierAccess::NoAccess, RHITextureLayout::Common });
+
+    for (const CommandContext::InitialTextureAccess& access : ctx.initialTextureAccesses)
+    {
+        {
+            std::shared_lock registryLock(*registryMutex);
+            if (!textureRegistry.IsValid(access.handle))
+            {
+                continue;
+            }
+        }
+        RHITexture& rhiTexture = GetRHITexture(access.handle);
+
+        const auto submitted = submittedTextureStates.find(access.handle);
+        const SubmittedTextureState& submittedState =
+            submitted != submittedTextureStates.end() ? submitted->second : initialState;
+        requiresGlobalBarrier |= submittedState.queue != queue && submittedState.writeQueue == queue;
+
+        const RHITextureState& dstState = access.state;
+        submittedState.states.ForEachStateSection(
+            rhiTexture.GetDesc(),
+            access.subresource,
+            [&](const TextureSubresource& section, RHITextureState state)
+            {
+                RHITextureState srcState = GetSubmissionSrcState(state, submittedState.queue, queue);
+
+                if (!IsLayoutSupportedOnQueue(srcState.layout, queue))
+                {
+                    // The graphics queue transitions the texture to a layout this queue can transition from.
+                    const RHITextureLayout supportedLayout =
+                        queue == QueueType::Copy ? RHITextureLayout::Common : dstState.layout;
+                    const RHITextureState graphicsSrcState =
+                        GetSubmissionSrcState(state, submittedState.queue, QueueType::Graphics);
+                    barriers.graphicsTextureBarriers.push_back({
+                        .texture = rhiTexture,
+                        .subresource = section,
+                        .srcSync = graphicsSrcState.sync,
+                        .dstSync = RHIBarrierSync::None,
+                        .srcAccess = graphicsSrcState.access,
+                        .dstAccess = RHIBarrierAccess::NoAccess,
+                        .srcLayout = graphicsSrcState.layout,
+                        .dstLayout = supportedLayout,
+                    });
+                    srcState = { RHIBarrierSync::None, RHIBarrierAccess::NoAccess, supportedLayout };
+                }
+
+                // Nothing was accessed yet in this layout, or the texture is read again in the same way.
+                const bool hasNoPreviousAccess =
+                    srcState.access == RHIBarrierAccess::NoAccess && srcState.layout == dstState.layout;
+                if (hasNoPreviousAccess || (srcState == dstState && !IsWriteAccess(dstState.access)))
+                {
+                    return;
+                }
+
+                barriers.textureBarriers.push_back({
+                    .texture = rhiTexture,
+                    .subresource = section,
+                    .srcSync = srcState.sync,
+                    .dstSync = dstState.sync,
+                    .srcAccess = srcState.access,
+                    .dstAccess = dstState.access,
+                    .srcLayout = srcState.layout,
+                    .dstLayout = dstState.layout,
+                });
+            });
+    }
+
+    if (requiresGlobalBarrier)
+    {
+        barriers.globalBarriers.push_back({
+            .srcSync = RHIBarrierSync::AllCommands,
+            .dstSync = RHIBarrierSync::AllCommands,
+            .srcAccess = RHIBarrierAccess::MemoryWrite,
+            .dstAccess = RHIBarrierAccess::MemoryRead,
+        });
+    }
+
+    return barriers;
+}
+
+void Graphics::UpdateSubmittedStates(const CommandContext& ctx)
+{
+    const QueueType queue = ctx.GetQueue();
 
-    // Reset all touched textures to the universal default texture layout.
-    for (auto& touchedTex : ctx.touchedTextures)
+    for (const auto& [handle, state] : ctx.bufferStates)
     {
-        if (!textureRegistry.IsValid(touchedTex.handle))
+        // Temporary buffers are destroyed along with the context.
+        if (state.access == RHIBarrierAccess::NoAccess ||
+            std::ranges::find(ctx.temporaryBuffers, handle, &Buffer::handle) != ctx.temporaryBuffers.end())
         {
             continue;
         }
 
-        ctx.EnqueueTextureBarrier(touchedTex,
-                                  TextureSubresource{},
-                                  RHIBarrierSync::None,
-                                  RHIBarrierAccess::NoAccess,
-                                  RHITextureLayout::Common);
+        auto [it, inserted] = submittedBufferStates.try_emplace(handle);
+        it->second.state = state;
+        it->second.queue = queue;
+        if (ctx.writtenBuffers.contains(handle))
+        {
+            it->second.writeQueue = queue;
+        }
     }
 
-    // Flush all resource writes using a global barrier.
-    ctx.EnqueueGlobalBarrier({
-        .srcSync = RHIBarrierSync::AllCommands,
-        .dstSync = RHIBarrierSync::AllCommands,
-        .srcAccess = RHIBarrierAccess::MemoryWrite,
-        .dstAccess = RHIBarrierAccess::MemoryRead,
-    });
+    for (const auto& [handle, stateMap] : ctx.textureStates)
+    {
+        // Transient textures are destroyed along with the context, their state does not matter anymore.
+        const RHITexture* rhiTexture;
+        {
+            std::shared_lock registryLock(*registryMutex);
+            rhiTexture = textureRegistry.IsValid(handle) ? textureRegistry[handle].get() : nullptr;
+        }
+        if (!rhiTexture || rhiTexture->GetLifetime() == ResourceLifetime::Transient)
+        {
+            continue;
+        }
+
+        // Sections this context did not access keep their previous state.
+        std::vector<std::pair<TextureSubresource, RHITextureState>> accessedSections;
+        const TextureDesc& textureDesc = rhiTexture->GetDesc();
+        stateMap.ForEachStateSection(textureDesc,
+                                     {},
+                                     [&](const TextureSubresource& section, RHITextureState state)
+                                     {
+                                         if (state != CommandContext::UnresolvedTextureState)
+                                         {
+                                             accessedSections.emplace_back(section, state);
+                                         }
+                                     });
+        if (accessedSections.empty())
+        {
+            continue;
+        }
 
-    // Flush barriers before submitting.
-    ctx.FlushBarriers();
+        auto [it, inserted] = submittedTextureStates.try_emplace(handle);
+        SubmittedTextureState& submittedState = it->second;
+        if (inserted)
+        {
+            submittedState.states.SetUniform(
+                { RHIBarrierSync::None, RHIBarrierAccess::NoAccess, RHITextureLayout::Common });
+        }
+        for (auto& [section, state] : accessedSections)
+        {
+            // Layouts are ignored by the copy queue, which leaves textures in the common layout.
+            if (queue == QueueType::Copy)
+            {
+                state.layout = RHITextureLayout::Common;
+            }
+            submittedState.states.Set(textureDesc, section, state);
+        }
+        submittedState.queue = queue;
+        if (ctx.writtenTextures.contains(handle))
+        {
+            submittedState.writeQueue = queue;
+        }
+    }
+}
 
-    // We want to close a command list asap, to allow for driver optimizations.
-    ctx.cmdList->Close();
+NonNullPtr<RHICommandList> Graphics::RecordBarrierCommandList(QueueType queue,
+                                                              Span<const RHIBufferBarrier> bufferBarriers,
+                                                              Span<const RHITextureBarrier> textureBarriers,
+                                                              Span<const RHIGlobalBarrier> globalBarriers)
+{
+    NonNullPtr<RHICommandList> cmdList = commandPool->GetOrCreateCommandList(queue);
+    cmdList->Open();
+    cmdList->EmitBarriers(bufferBarriers, textureBarriers, globalBarriers);
+    cmdList->Close();
+    return cmdList;
 }
 
 void Graphics::Cleanup()
 {
+    std::scoped_lock lock(*resourceMutex);
     // Flush all potential CPU work that was enqueued to the GPU timeline, this can include RHI resource cleanup.
     ExecuteCPUWork();
     // Reclaim all finished command lists.
     commandPool->ReclaimCommandLists();
+    // The descriptor heaps replaced when the pool grew can be used by command lists opened before the growth, they are
+    // only released once these are done executing.
+    descriptorPool->ReleaseUnusedHeaps(*commandPool);
+    // Resource cleanup can leave memory pages empty.
+    allocator->ReleaseIdlePages(desc.emptyMemoryPageReleaseDelay, desc.emptyMemoryPageBudget);
+}
+
+Buffer Graphics::AcquireStagingPage()
+{
+    std::scoped_lock lock(*resourceMutex);
+    if (freeStagingPages.empty())
+    {
+        return CreateBuffer(BufferDesc::CreateStagingBufferDesc("StagingPage", StagingAllocator::PageByteSize));
+    }
+
+    Buffer page = std::move(freeStagingPages.back());
+    freeStagingPages.pop_back();
+    return page;
+}
+
+void Graphics::ReleaseStagingPages(std::vector<Buffer> pages)
+{
+    std::scoped_lock lock(*resourceMutex);
+    std::ranges::move(pages, std::back_inserter(freeStagingPages));
+}
+
+void Graphics::DiscardTransientTextures(Span<const TextureHandle> textures, TransientMemoryPool& transientPool)
+{
+    std::scoped_lock lock(*resourceMutex);
+    for (const TextureHandle handle : textures)
+    {
+        CleanupResource(UnregisterElement(textureRegistry, handle), *descriptorPool, *allocator);
+    }
+    if (!transientPool.pages.empty())
+    {
+        allocator->RecycleTransientMemoryPool(transientPool);
+    }
 }
 
 PipelineStateCache& Graphics::GetPipelineStateCache()
@@ -756,21 +1531,39 @@ PipelineStateCache& Graphics::GetPipelineStateCache()
     return *psCache;
 }
 
+// The registries only store pointers, the returned references remain valid after releasing the lock.
 RHITexture& Graphics::GetRHITexture(TextureHandle textureHandle)
 {
+    std::shared_lock lock(*registryMutex);
     return *textureRegistry[textureHandle];
 }
 
 RHIBuffer& Graphics::GetRHIBuffer(BufferHandle bufferHandle)
 {
+    std::shared_lock lock(*registryMutex);
     return *bufferRegistry[bufferHandle];
 }
 
 RHIAccelerationStructure& Graphics::GetRHIAccelerationStructure(AccelerationStructureHandle asHandle)
 {
+    std::shared_lock lock(*registryMutex);
     return *accelerationStructureRegistry[asHandle];
 }
 
+template <class T, class HandleT>
+HandleT Graphics::RegisterElement(FreeList<T, HandleT>& registry, T&& element)
+{
+    std::scoped_lock lock(*registryMutex);
+    return registry.AllocateElement(std::move(element));
+}
+
+template <class T, class HandleT>
+T Graphics::UnregisterElement(FreeList<T, HandleT>& registry, HandleT handle)
+{
+    std::scoped_lock lock(*registryMutex);
+    return std::move(*registry.ExtractElement(handle));
+}
+
 void Graphics::RecreatePresentTextures()
 {
     if (!presentTextures.empty())
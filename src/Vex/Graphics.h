@@ -1,8 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <filesystem>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <Vex/AccelerationStructure.h>
@@ -25,6 +30,8 @@
 #include <Vex/Utility/MaybeUninitialized.h>
 #include <Vex/Utility/MoveOnlyFunction.h>
 
+#include <RHI/RHIBarrier.h>
+#include <RHI/RHIBuffer.h>
 #include <RHI/RHIFwd.h>
 
 namespace vex
@@ -33,6 +40,7 @@ class TextureReadbackContext;
 class CommandContext;
 struct RHIPhysicalDeviceBase;
 struct Texture;
+struct TransientMemoryPool;
 struct TextureBinding;
 struct BufferBinding;
 struct ResourceBinding;
@@ -54,10 +62,42 @@ struct GraphicsCreateDesc
     // Enables GPU-based validation. Can be very costly in terms of performance.
     bool enableGPUBasedValidation = VEX_DEBUG;
 
+    // Vulkan only: bindless descriptors are written into a descriptor buffer (VK_EXT_descriptor_buffer) instead of a
+    // descriptor set, when the device supports it. Ignored in DX12, whose descriptor heaps already work this way.
+    bool useDescriptorBuffer = false;
+
     // This specifies the device to use when desired. If unset the "best" device according to Vex will be picked
     std::optional<PhysicalDeviceInfo> specifiedDevice;
+
+    // When set, the pipeline cache is loaded from this file on startup and written back to it on destruction, avoiding
+    // cold pipeline compilations on subsequent runs. Data produced by a different device or driver is ignored.
+    std::optional<std::filesystem::path> pipelineCacheFilepath;
+
+    // When enabled, pipeline states seen for the first time are compiled on worker threads instead of stalling the
+    // recording thread. Draws and dispatches using a pipeline state which is still being compiled are skipped (see
+    // CommandContext::Draw/Dispatch). Ray tracing pipeline states are always compiled synchronously.
+    bool enableAsyncPipelineCompilation = false;
+    // Requires enableAsyncPipelineCompilation, Vulkan only: graphics pipeline states seen for the first time are
+    // fast-linked from pipeline libraries (VK_EXT_graphics_pipeline_library) when the device supports it. Their
+    // optimized version is then compiled on a worker thread, and replaces them once done.
+    bool enableGraphicsPipelineFastLinking = false;
+
+    // Records every pipeline state used during this session, see SavePipelineStateManifest.
+    bool recordPipelineStateManifest = false;
+
+    // Empty memory pages (including the arena pages of dynamic and transient resources) are released back to the driver
+    // once they have been unused for this long.
+    std::chrono::milliseconds emptyMemoryPageReleaseDelay{ 5000 };
+    // Byte size of the most recently emptied memory pages which are kept regardless of how long they have been unused,
+    // avoiding page reallocations when memory usage oscillates.
+    u64 emptyMemoryPageBudget = 256 * 1024 * 1024;
 };
 
+// Thread-safety: command contexts can be created and recorded on multiple threads concurrently, as can resources be
+// created, destroyed and queried for their bindless handles. A command context must be recorded on the thread which
+// created it. Submitting, presenting and the other frame-level operations (Submit, Present, EndFrame, FlushGPU,
+// SetStaticSamplers, DefragmentMemory, OnWindowResized) must be called from a single thread, typically the main thread,
+// which can submit contexts recorded by other threads once these threads closed them (see CommandContext::Close).
 class Graphics
 {
 public:
@@ -76,23 +116,30 @@ public:
     void Present();
 
     // Create a CommandContext in which GPU commands can be recorded. The command context must later on be submitted to
-    // the GPU by calling vex::Graphics::Submit().
+    // the GPU by calling vex::Graphics::Submit(). Can be called from any thread, the context must then be recorded on
+    // that same thread.
     [[nodiscard]] CommandContext CreateCommandContext(QueueType queueType);
 
     // Creates a new texture with the specified description.
+    // Dynamic textures are only valid until the end of the current frame (see EndFrame), they are cheap to create as
+    // their memory and bindless descriptors are linearly allocated from per-frame storage.
     [[nodiscard]] Texture CreateTexture(const TextureDesc& textureDesc,
                                         ResourceLifetime lifetime = ResourceLifetime::Static);
 
     // Destroys a texture, the handle passed in must be the one obtained from calling CreateTexture earlier.
-    // Once destroyed, the handle passed in is invalid and should no longer be used.
+    // Once destroyed, the handle passed in is invalid and should no longer be used. Dynamic textures cannot be
+    // destroyed manually.
     void DestroyTexture(const Texture& texture);
 
     // Creates a new buffer with the specified description.
+    // Dynamic buffers are only valid until the end of the current frame (see EndFrame), they are cheap to create as
+    // their memory and bindless descriptors are linearly allocated from per-frame storage.
     [[nodiscard]] Buffer CreateBuffer(const BufferDesc& bufferDesc,
                                       ResourceLifetime lifetime = ResourceLifetime::Static);
 
     // Destroys a buffer, the handle passed in must be the one obtained from calling CreateBuffer earlier.
-    // Once destroyed, the handle passed in is invalid and should no longer be used.
+    // Once destroyed, the handle passed in is invalid and should no longer be used. Dynamic buffers cannot be destroyed
+    // manually.
     void DestroyBuffer(const Buffer& buffer);
 
     // Creates an acceleration structure. Invalid for use in shaders until it is built with a CommandContext.
@@ -134,7 +181,11 @@ public:
     SyncToken Submit(CommandContext& ctx, Span<const SyncToken> dependencies = {});
 
     // Allows you to submit the command contexts to the GPU, receiving a SyncToken which can be optionally used to track
-    // work completion.
+    // work completion. The contexts can have been recorded in parallel on other threads, as long as they are done
+    // recording.
+    // Resources keep their state across submissions, each context is transitioned from the state the previous
+    // submissions left its resources in. Textures a queue cannot transition (eg: a render target used on the copy
+    // queue) are first transitioned on the graphics queue, whose token is then also returned.
     std::vector<SyncToken> Submit(Span<CommandContext> commandContexts, Span<const SyncToken> dependencies = {});
 
     // Has the passed-in sync token been executed on the GPU yet?
@@ -149,6 +200,45 @@ public:
     // Flushes all currently submitted GPU commands.
     void FlushGPU();
 
+    // Ends the current frame: the dynamic resources created during it are released once the GPU is done with all work
+    // submitted so far, they must no longer be used afterwards. Called automatically by Present, applications without a
+    // swapchain should call it at their own frame boundaries. All command contexts must be submitted beforehand.
+    void EndFrame();
+
+    // Moves resources out of sparsely used memory pages using GPU copies, so that these pages can be released once
+    // empty (see GraphicsCreateDesc::emptyMemoryPageReleaseDelay). Meant to be called periodically, each call moves at
+    // most maxByteSizeToMove bytes and returns the byte size actually moved.
+    // Handles and bindless handles of moved resources remain valid. Only static GPU-only textures and buffers are
+    // moved, excluding buffers involved in ray tracing. Blocks until the GPU is done with all previously submitted
+    // work, and must not be called while other command contexts are being recorded.
+    u64 DefragmentMemory(u64 maxByteSizeToMove);
+
+    // Writes the current contents of the pipeline cache to the passed-in file, which can then be loaded by a future run
+    // using GraphicsCreateDesc::pipelineCacheFilepath.
+    void SavePipelineCache(const std::filesystem::path& filepath);
+
+    // Compiles the passed-in pipeline states ahead of their first use (eg: during a loading screen), avoiding
+    // compilation hitches when they are first drawn/dispatched. Compilation is spread across worker threads, with async
+    // pipeline compilation this call does not block.
+    void PrecompilePipelines(Span<const GraphicsPipelineStateDesc> graphicsPipelines);
+    void PrecompilePipelines(Span<const ShaderView> computeShaders);
+    // Ray tracing pipeline states are always compiled on the calling thread.
+    void PrecompilePipelines(Span<const RayTracingShaderCollection> rayTracingPipelines);
+
+    // Writes the pipeline states recorded during this session (requires
+    // GraphicsCreateDesc::recordPipelineStateManifest) to the passed-in file. Shaders are only referenced by their hash.
+    void SavePipelineStateManifest(const std::filesystem::path& filepath);
+
+    // Compiles all pipeline states contained in a manifest written by SavePipelineStateManifest, typically at startup
+    // so that the first frames do not pay for pipeline state creation. The manifest's shaders are looked up by hash in
+    // the passed-in shaders, pipeline states using other shaders are skipped. Graphics and compute pipeline states are
+    // compiled on worker threads, this call only blocks on them when async pipeline compilation is disabled.
+    void ReplayPipelineStateManifest(const std::filesystem::path& filepath, Span<const ShaderView> shaders);
+
+    // Blocks until all pipeline states currently being compiled in the background are ready.
+    void WaitForPipelineCompilations();
+    [[nodiscard]] bool HasPendingPipelineCompilations() const;
+
     // Enables or disables vertical sync when presenting. Could lead to having to recreate the swapchain after the next
     // present.
     void SetUseVSync(bool useVSync);
@@ -191,16 +281,45 @@ private:
     void EnqueueCPUWork(CPUCallback&& callback, Span<const SyncToken> tokens);
     void ExecuteCPUWork();
 
+    void LoadPipelineCache(const std::filesystem::path& filepath);
+
     std::optional<SyncToken> FlushPendingInitializations();
     void PrepareCommandContextForSubmission(CommandContext& ctx);
+
+    // Barriers transitioning resources from the state previous submissions left them in, to their first access in a
+    // command context.
+    struct SubmissionBarriers;
+    SubmissionBarriers ResolveSubmissionBarriers(const CommandContext& ctx);
+    // Records the state the command context leaves its resources in, for the next submissions to start from.
+    void UpdateSubmittedStates(const CommandContext& ctx);
+    NonNullPtr<RHICommandList> RecordBarrierCommandList(QueueType queue,
+                                                        Span<const RHIBufferBarrier> bufferBarriers,
+                                                        Span<const RHITextureBarrier> textureBarriers,
+                                                        Span<const RHIGlobalBarrier> globalBarriers);
+
+    // Transient textures are owned by the command context which created them.
+    Texture CreateTransientTexture(const TextureDesc& textureDesc, TransientMemoryPool& transientPool);
     void Cleanup();
 
+    // Returns a staging page which is no longer used by the GPU, creating a new one if none are available.
+    Buffer AcquireStagingPage();
+    // Makes pages which were never submitted to the GPU (eg: by a discarded command context) available again.
+    void ReleaseStagingPages(std::vector<Buffer> pages);
+    // Destroys the transient textures of a command context which was never submitted, along with their memory.
+    void DiscardTransientTextures(Span<const TextureHandle> textures, TransientMemoryPool& transientPool);
+
     PipelineStateCache& GetPipelineStateCache();
 
     RHITexture& GetRHITexture(TextureHandle textureHandle);
     RHIBuffer& GetRHIBuffer(BufferHandle bufferHandle);
     RHIAccelerationStructure& GetRHIAccelerationStructure(AccelerationStructureHandle asHandle);
 
+    // Registry modifications take the registry lock exclusively.
+    template <class T, class HandleT>
+    HandleT RegisterElement(FreeList<T, HandleT>& registry, T&& element);
+    template <class T, class HandleT>
+    T UnregisterElement(FreeList<T, HandleT>& registry, HandleT handle);
+
     void RecreatePresentTextures();
 
     // Index of the current frame, possible values depends on buffering:
@@ -232,6 +351,12 @@ private:
 
     MaybeUninitialized<RHITimestampQueryPool> queryPool;
 
+    // Guards the allocator, the descriptor pool and the bookkeeping of resources below against concurrent recording
+    // threads. Recursive, as internal resource creation and cleanup callbacks run while it is held.
+    std::unique_ptr<std::recursive_mutex> resourceMutex = std::make_unique<std::recursive_mutex>();
+    // Guards the registries, resource lookups only take it shared. Acquired after resourceMutex when both are needed.
+    std::unique_ptr<std::shared_mutex> registryMutex = std::make_unique<std::shared_mutex>();
+
     // Converts from the Handle to the actual underlying RHI resource.
     FreeList<std::unique_ptr<RHITexture>, TextureHandle> textureRegistry;
     FreeList<std::unique_ptr<RHIBuffer>, BufferHandle> bufferRegistry;
@@ -239,11 +364,38 @@ private:
 
     std::vector<Texture> pendingInitializations;
 
+    // Dynamic resources created during the current frame.
+    std::vector<TextureHandle> dynamicTextures;
+    std::vector<BufferHandle> dynamicBuffers;
+
+    // Staging pages of the StagingAllocator which are free for reuse. Pages used by a submission are added back once
+    // the GPU is done executing it.
+    std::vector<Buffer> freeStagingPages;
+
     std::vector<Texture> presentTextures;
     std::vector<SyncToken> presentTokens;
 
     TextureStateMap backBufferState;
 
+    // State of the resources at the end of the last submission which used them. Textures which are absent are in the
+    // common layout, buffers which are absent require no synchronization.
+    struct SubmittedTextureState
+    {
+        TextureStateMap states;
+        // Queue of the last submission which used the texture.
+        QueueType queue;
+        // Queue of the last submission which wrote to the texture.
+        std::optional<QueueType> writeQueue;
+    };
+    struct SubmittedBufferState
+    {
+        RHIBufferState state;
+        QueueType queue;
+        std::optional<QueueType> writeQueue;
+    };
+    std::unordered_map<TextureHandle, SubmittedTextureState> submittedTextureStates;
+    std::unordered_map<BufferHandle, SubmittedBufferState> submittedBufferStates;
+
     struct PendingCPUWork
     {
         CPUCallback callback;
@@ -259,6 +411,7 @@ private:
     friend struct ResourceBindingUtils;
     friend class TextureReadbackContext;
     friend class BufferReadbackContext;
+    friend class StagingAllocator;
 
     friend struct RHIAccessor;
 };
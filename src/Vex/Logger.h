@@ -4,6 +4,7 @@
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <print>
 #include <string>
@@ -70,6 +71,9 @@ struct Logger
                                                            LogLevelToString(level),
                                                            std::format(formatMessage, std::forward<Args>(args)...));
 
+        // Logging can occur from worker threads (eg: parallel shader compilation).
+        std::scoped_lock lock(logMutex);
+
         if (destinationFlags & LogDestination::Console)
         {
             std::println("{}", timeStampedFormatMessage);
@@ -114,6 +118,7 @@ private:
 
     std::filesystem::path filePath = std::filesystem::current_path() / "logs" / LogFileNameFormat;
     std::optional<std::ofstream> logOutput;
+    std::mutex logMutex;
 };
 
 inline Logger GLogger;
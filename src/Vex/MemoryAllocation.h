@@ -1,6 +1,9 @@
 ﻿#pragma once
 
+#include <array>
 #include <optional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <Vex/Utility/Handle.h>
@@ -34,6 +37,8 @@ struct MemoryRange
     }
 };
 
+// Sub-allocates memory ranges inside of a page using a two-level segregated fit (TLSF) allocator: free blocks are
+// bucketed by size so that allocating and freeing run in constant time, no matter how many ranges are allocated.
 struct MemoryPageInfo
 {
     // Vex allocates pages of a default size of 256MB.
@@ -42,6 +47,7 @@ struct MemoryPageInfo
     MemoryPageInfo(u32 memoryTypeIndex, u64 pageByteSize = DefaultPageByteSize);
 
     std::optional<MemoryRange> Allocate(u64 size, u64 alignment);
+    // The range must be one returned by Allocate.
     void Free(const MemoryRange& range);
 
     [[nodiscard]] u64 GetByteSize() const
@@ -51,22 +57,57 @@ struct MemoryPageInfo
 
     [[nodiscard]] u64 GetFreeSpace() const
     {
-        u64 totalAllocated = 0;
-        for (const auto& range : allocatedRanges)
-        {
-            totalAllocated += range.size;
-        }
-        return pageByteSize - totalAllocated;
+        return freeByteSize;
     }
 
 private:
-    // Searches for the first range that contains enough space to fit the requested data and, if found, returns the
-    // memory range.
-    std::optional<MemoryRange> FindFreeSpace(u64 size, u64 alignment);
+    // Each first level covers a power of two of sizes, subdivided linearly into second levels.
+    static constexpr u32 SecondLevelBits = 5;
+    static constexpr u32 SecondLevelCount = 1 << SecondLevelBits;
+    static constexpr u32 FirstLevelCount = 64;
+    static constexpr u32 InvalidBlockIndex = ~0u;
+
+    // A contiguous range of the page, either allocated or free.
+    struct Block
+    {
+        u64 offset = 0;
+        u64 size = 0;
+        // Neighbouring blocks in memory.
+        u32 prevPhysical = InvalidBlockIndex;
+        u32 nextPhysical = InvalidBlockIndex;
+        // Neighbouring blocks in the free list of the same size class, only used by free blocks.
+        u32 prevFree = InvalidBlockIndex;
+        u32 nextFree = InvalidBlockIndex;
+        bool isFree = false;
+    };
+
+    static std::pair<u32, u32> GetSizeClass(u64 size);
+    // Returns the index of a free block of at least size bytes, without removing it from its free list.
+    u32 FindFreeBlock(u64 size) const;
+
+    u32 CreateBlock(u64 offset, u64 size);
+    void DestroyBlock(u32 blockIndex);
+    void InsertFreeBlock(u32 blockIndex);
+    void RemoveFreeBlock(u32 blockIndex);
+    // Shrinks the block to size bytes, the rest of it is moved to a new block whose index is returned.
+    u32 SplitBlock(u32 blockIndex, u64 size);
+    // Merges the next physical block into the block.
+    void MergeWithNextBlock(u32 blockIndex);
 
     u32 memoryTypeIndex;
     u64 pageByteSize;
-    std::vector<MemoryRange> allocatedRanges;
+    u64 freeByteSize;
+
+    std::vector<Block> blocks;
+    std::vector<u32> unusedBlockIndices;
+    // Allocated blocks, indexed by their offset.
+    std::unordered_map<u64, u32> allocatedBlocks;
+
+    // Bit i of the first level bitmap is set when the second level bitmap i has any bit set, and each bit of a second
+    // level bitmap marks a non-empty free list.
+    u64 firstLevelBitmap = 0;
+    std::array<u32, FirstLevelCount> secondLevelBitmaps{};
+    std::array<std::array<u32, SecondLevelCount>, FirstLevelCount> freeListHeads;
 };
 
 struct PageHandle : public Handle64<PageHandle>
@@ -13,6 +13,13 @@ namespace vex
 
 struct RayTracingShaderCollection;
 
+// Describes a graphics pipeline state, used to compile pipeline states ahead of their first draw.
+struct GraphicsPipelineStateDesc
+{
+    DrawDesc drawDesc;
+    RenderTargetState renderTargetState;
+};
+
 struct GraphicsPSOKey
 {
     GraphicsPSOKey(const DrawDesc& drawDesc, const RenderTargetState& renderTargetState);
@@ -85,6 +92,17 @@ struct RayTracingPSOKey
 
 // clang-format off
 
+VEX_MAKE_HASHABLE(vex::GraphicsPSOKey,
+    VEX_HASH_COMBINE(seed, obj.vertexShader);
+    VEX_HASH_COMBINE(seed, obj.pixelShader);
+    VEX_HASH_COMBINE(seed, obj.vertexInputLayout);
+    VEX_HASH_COMBINE(seed, obj.inputAssembly);
+    VEX_HASH_COMBINE(seed, obj.rasterizerState);
+    VEX_HASH_COMBINE(seed, obj.depthStencilState);
+    VEX_HASH_COMBINE(seed, obj.colorBlendState);
+    VEX_HASH_COMBINE(seed, obj.renderTargetState);
+);
+
 VEX_MAKE_HASHABLE(vex::ComputePSOKey,
     VEX_HASH_COMBINE(seed, obj.computeShader);
 );
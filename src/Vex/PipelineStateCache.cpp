@@ -1,5 +1,12 @@
 #include "PipelineStateCache.h"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
 #include <Vex/RHIImpl/RHI.h>
 #include <Vex/RHIImpl/RHIBuffer.h>
 #include <Vex/RHIImpl/RHIResourceLayout.h>
@@ -43,12 +50,110 @@ namespace PipelineStateCache_Internal
 //     //    }
 // }
 
+// Owning copy of a shader view. Shaders can be recompiled (eg: hot reload) while a pipeline state using them is still
+// being compiled on a worker thread, so the worker cannot reference the shader's storage directly.
+struct ShaderCopy
+{
+    explicit ShaderCopy(const ShaderView& view)
+        : name(view.name)
+        , entryPoint(view.entryPoint)
+        , bytecode(view.bytecode.begin(), view.bytecode.end())
+        , hash(view.hash)
+        , type(view.type)
+    {
+    }
+
+    [[nodiscard]] ShaderView GetView() const
+    {
+        return ShaderView(name, entryPoint, bytecode, hash, type);
+    }
+
+    std::string name;
+    std::string entryPoint;
+    std::vector<byte> bytecode;
+    SHA1HashDigest hash;
+    ShaderType type;
+};
+
+template <class T>
+bool IsReady(const std::future<T>& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// Returns the cached pipeline state if it was compiled against the current layout version.
+template <class Cache>
+typename Cache::mapped_type* FindUpToDatePipelineState(Cache& cache,
+                                                       const typename Cache::key_type& key,
+                                                       u32 layoutVersion)
+{
+    const auto it = cache.find(key);
+    return it != cache.end() && layoutVersion <= it->second.rootSignatureVersion ? &it->second : nullptr;
+}
+
+// Moves the result of a finished compilation into the cache. Returns false if the compilation is still in progress.
+template <class PipelineState, class Cache, class PendingCache>
+bool RetrieveCompiledPipelineState(const typename PipelineState::Key& key,
+                                   Cache& cache,
+                                   PendingCache& pendingCache,
+                                   u32 layoutVersion,
+                                   bool waitForCompilation,
+                                   std::unique_ptr<PipelineState>& oldPSO)
+{
+    const auto pendingIt = pendingCache.find(key);
+    if (pendingIt == pendingCache.end())
+    {
+        return true;
+    }
+    if (waitForCompilation)
+    {
+        pendingIt->second.wait();
+    }
+    else if (!IsReady(pendingIt->second))
+    {
+        return false;
+    }
+
+    PipelineState compiledPSO = pendingIt->second.get();
+    pendingCache.erase(pendingIt);
+
+    // The layout changed during compilation, the result was never used so it can be discarded right away.
+    if (layoutVersion > compiledPSO.rootSignatureVersion)
+    {
+        return true;
+    }
+
+    if (const auto it = cache.find(key); it != cache.end())
+    {
+        // Avoid the previous PSO being destroyed while frame is in flight.
+        oldPSO = it->second.Cleanup();
+        it->second = std::move(compiledPSO);
+    }
+    else
+    {
+        cache.insert({ key, std::move(compiledPSO) });
+    }
+    return true;
+}
+
 } // namespace PipelineStateCache_Internal
 
-PipelineStateCache::PipelineStateCache(NonNullPtr<RHI> rhi, RHIDescriptorPool& descriptorPool)
+PipelineStateCache::PipelineStateCache(NonNullPtr<RHI> rhi,
+                                       RHIDescriptorPool& descriptorPool,
+                                       bool enableAsyncCompilation,
+                                       bool recordManifest,
+                                       bool enableGraphicsFastLinking)
     : resourceLayout(rhi->CreateResourceLayout(descriptorPool))
     , rhi(rhi)
+    , enableAsyncCompilation(enableAsyncCompilation)
+    , enableGraphicsFastLinking(enableAsyncCompilation && enableGraphicsFastLinking)
 {
+    if (recordManifest)
+    {
+        manifest = std::make_unique<PipelineStateManifest>();
+    }
+    // Command lists recorded on other threads only ever read the layout.
+    resourceLayout->UpdateLayout();
 }
 
 PipelineStateCache::~PipelineStateCache() = default;
@@ -64,7 +169,55 @@ RHIGraphicsPipelineState* PipelineStateCache::GetGraphicsPipelineState(
     }
 
     GraphicsPSOKey key{ drawDesc, renderTargetState };
+
+    {
+        // Most lookups hit an up-to-date pipeline state, only requiring a shared lock. A fast-linked pipeline state is
+        // used until its optimized version is done compiling.
+        std::shared_lock lock(*mutex);
+        const auto pendingIt = pendingGraphicsPSOs.find(key);
+        if (pendingIt == pendingGraphicsPSOs.end() || !PipelineStateCache_Internal::IsReady(pendingIt->second))
+        {
+            if (RHIGraphicsPipelineState* ps = PipelineStateCache_Internal::FindUpToDatePipelineState(
+                    graphicsPSCache, key, resourceLayout->version))
+            {
+                return ps;
+            }
+        }
+    }
+
+    std::scoped_lock lock(*mutex);
+    if (enableAsyncCompilation)
+    {
+        // Draws are never forced to wait on background compilations.
+        static constexpr bool WaitForCompilation = false;
+        resourceLayout->UpdateLayout();
+        if (!PipelineStateCache_Internal::RetrieveCompiledPipelineState(key,
+                                                                        graphicsPSCache,
+                                                                        pendingGraphicsPSOs,
+                                                                        resourceLayout->version,
+                                                                        WaitForCompilation,
+                                                                        oldPSO))
+        {
+            return PipelineStateCache_Internal::FindUpToDatePipelineState(graphicsPSCache,
+                                                                          key,
+                                                                          resourceLayout->version);
+        }
+
+        const auto it = graphicsPSCache.find(key);
+        if (it == graphicsPSCache.end() || resourceLayout->version > it->second.rootSignatureVersion)
+        {
+            LaunchGraphicsCompilation(key, drawDesc, enableGraphicsFastLinking);
+            return nullptr;
+        }
+        LaunchGraphicsOptimization(it->second, drawDesc);
+        return &it->second;
+    }
+
     const auto it = graphicsPSCache.find(key);
+    if (it == graphicsPSCache.end() && manifest)
+    {
+        manifest->RecordGraphicsPipelineState(drawDesc, renderTargetState);
+    }
     RHIGraphicsPipelineState& ps =
         it != graphicsPSCache.end()
             ? it->second
@@ -76,14 +229,17 @@ RHIGraphicsPipelineState* PipelineStateCache::GetGraphicsPipelineState(
     {
         // Avoid PSO being destroyed while frame is in flight.
         oldPSO = ps.Cleanup();
-        ps.Compile(drawDesc.vertexShader, drawDesc.pixelShader, *resourceLayout);
+        // Compiled with full optimizations, as nothing would replace a fast-linked pipeline state in synchronous mode.
+        static constexpr bool AllowFastLink = false;
+        ps.Compile(drawDesc.vertexShader, drawDesc.pixelShader, *resourceLayout, AllowFastLink);
     }
 
     return &ps;
 }
 
 RHIComputePipelineState* PipelineStateCache::GetComputePipelineState(const ShaderView& computeShader,
-                                                                     std::unique_ptr<RHIComputePipelineState>& oldPSO)
+                                                                     std::unique_ptr<RHIComputePipelineState>& oldPSO,
+                                                                     bool waitForCompilation)
 {
     if (computeShader.IsErrored())
     {
@@ -91,7 +247,54 @@ RHIComputePipelineState* PipelineStateCache::GetComputePipelineState(const Shade
     }
 
     ComputePSOKey key{ computeShader };
+
+    {
+        // Most lookups hit an up-to-date pipeline state, only requiring a shared lock.
+        std::shared_lock lock(*mutex);
+        if (!pendingComputePSOs.contains(key))
+        {
+            if (RHIComputePipelineState* ps = PipelineStateCache_Internal::FindUpToDatePipelineState(
+                    computePSCache, key, resourceLayout->version))
+            {
+                return ps;
+            }
+        }
+    }
+
+    std::scoped_lock lock(*mutex);
+    if (enableAsyncCompilation)
+    {
+        resourceLayout->UpdateLayout();
+        if (!PipelineStateCache_Internal::RetrieveCompiledPipelineState(key,
+                                                                        computePSCache,
+                                                                        pendingComputePSOs,
+                                                                        resourceLayout->version,
+                                                                        waitForCompilation,
+                                                                        oldPSO))
+        {
+            return nullptr;
+        }
+
+        const auto it = computePSCache.find(key);
+        const bool pipelineStateReady =
+            it != computePSCache.end() && resourceLayout->version <= it->second.rootSignatureVersion;
+        if (pipelineStateReady)
+        {
+            return &it->second;
+        }
+        if (!waitForCompilation)
+        {
+            LaunchComputeCompilation(key, computeShader);
+            return nullptr;
+        }
+        // Otherwise the pipeline state is compiled synchronously below.
+    }
+
     const auto it = computePSCache.find(key);
+    if (it == computePSCache.end() && manifest)
+    {
+        manifest->RecordComputePipelineState(computeShader);
+    }
     RHIComputePipelineState& ps =
         it != computePSCache.end() ? it->second
                                    : computePSCache.insert({ key, rhi->CreateComputePipelineState(key) }).first->second;
@@ -115,26 +318,28 @@ RHIRayTracingPipelineState* PipelineStateCache::GetRayTracingPipelineState(
     std::unique_ptr<RHIRayTracingPipelineState>& oldPSO,
     std::vector<MaybeUninitialized<RHIBuffer>>& oldBuffers)
 {
-    if (std::ranges::any_of(shaderCollection.rayGenerationShaders,
-                            [](const ShaderView& view) { return view.IsErrored(); }) ||
-        std::ranges::any_of(shaderCollection.rayMissShaders, [](const ShaderView& view) { return view.IsErrored(); }) ||
-        std::ranges::any_of(shaderCollection.hitGroups,
-                            [](const HitGroup& hg)
-                            {
-                                if (hg.rayIntersectionShader && hg.rayIntersectionShader->IsErrored())
-                                    return true;
-                                if (hg.rayAnyHitShader && hg.rayAnyHitShader->IsErrored())
-                                    return true;
-                                return hg.rayClosestHitShader.IsErrored();
-                            }) ||
-        std::ranges::any_of(shaderCollection.rayCallableShaders,
-                            [](const ShaderView& view) { return view.IsErrored(); }))
+    if (HasErroredShader(shaderCollection))
     {
         return nullptr;
     }
 
     RayTracingPSOKey key{ shaderCollection };
+
+    {
+        std::shared_lock lock(*mutex);
+        if (RHIRayTracingPipelineState* ps = PipelineStateCache_Internal::FindUpToDatePipelineState(
+                rayTracingPSCache, key, resourceLayout->version))
+        {
+            return ps;
+        }
+    }
+
+    std::scoped_lock lock(*mutex);
     const auto it = rayTracingPSCache.find(key);
+    if (it == rayTracingPSCache.end() && manifest)
+    {
+        manifest->RecordRayTracingPipelineState(shaderCollection);
+    }
     RHIRayTracingPipelineState& ps =
         it != rayTracingPSCache.end()
             ? it->second
@@ -153,4 +358,245 @@ RHIRayTracingPipelineState* PipelineStateCache::GetRayTracingPipelineState(
     return &ps;
 }
 
+void PipelineStateCache::PrecompileGraphicsPipelineStates(Span<const GraphicsPipelineStateDesc> pipelineDescs)
+{
+    std::scoped_lock lock(*mutex);
+    for (const GraphicsPipelineStateDesc& desc : pipelineDescs)
+    {
+        if (desc.drawDesc.vertexShader.IsErrored() || desc.drawDesc.pixelShader.IsErrored())
+        {
+            continue;
+        }
+
+        // Matches the DrawDesc used by the CommandContext, where each render target has at least a default color
+        // attachment.
+        DrawDesc drawDesc = desc.drawDesc;
+        drawDesc.colorBlendState.attachments.resize(desc.renderTargetState.colorFormats.size());
+
+        // Pipeline states already present are left untouched, as they could currently be in use by an in-flight frame.
+        GraphicsPSOKey key{ drawDesc, desc.renderTargetState };
+        if (graphicsPSCache.contains(key) || pendingGraphicsPSOs.contains(key))
+        {
+            continue;
+        }
+
+        // Precompiled pipeline states are not needed right away, they are directly compiled with full optimizations.
+        static constexpr bool AllowFastLink = false;
+        LaunchGraphicsCompilation(key, drawDesc, AllowFastLink);
+    }
+
+    if (!enableAsyncCompilation)
+    {
+        RetrieveAllCompiledPipelineStates();
+    }
+}
+
+void PipelineStateCache::PrecompileComputePipelineStates(Span<const ShaderView> computeShaders)
+{
+    std::scoped_lock lock(*mutex);
+    for (const ShaderView& computeShader : computeShaders)
+    {
+        if (computeShader.IsErrored())
+        {
+            continue;
+        }
+
+        // Pipeline states already present are left untouched, as they could currently be in use by an in-flight frame.
+        ComputePSOKey key{ computeShader };
+        if (computePSCache.contains(key) || pendingComputePSOs.contains(key))
+        {
+            continue;
+        }
+
+        LaunchComputeCompilation(key, computeShader);
+    }
+
+    if (!enableAsyncCompilation)
+    {
+        RetrieveAllCompiledPipelineStates();
+    }
+}
+
+void PipelineStateCache::PrecompileRayTracingPipelineStates(Span<const RayTracingShaderCollection> shaderCollections,
+                                                            RHIAllocator& allocator)
+{
+    for (const RayTracingShaderCollection& shaderCollection : shaderCollections)
+    {
+        // Pipeline states already present are left untouched, as they could currently be in use by an in-flight frame.
+        bool isCached;
+        {
+            std::shared_lock lock(*mutex);
+            isCached = rayTracingPSCache.contains(RayTracingPSOKey{ shaderCollection });
+        }
+        if (HasErroredShader(shaderCollection) || isCached)
+        {
+            continue;
+        }
+
+        // The pipeline state is new, so there are no previous resources to keep alive.
+        std::unique_ptr<RHIRayTracingPipelineState> oldPSO;
+        std::vector<MaybeUninitialized<RHIBuffer>> oldBuffers;
+        GetRayTracingPipelineState(shaderCollection, allocator, oldPSO, oldBuffers);
+    }
+}
+
+void PipelineStateCache::WaitForPendingCompilations()
+{
+    std::scoped_lock lock(*mutex);
+    for (const auto& [key, future] : pendingGraphicsPSOs)
+    {
+        future.wait();
+    }
+    for (const auto& [key, future] : pendingComputePSOs)
+    {
+        future.wait();
+    }
+}
+
+void PipelineStateCache::SetStaticSamplers(Span<const StaticTextureSampler> staticSamplers)
+{
+    std::scoped_lock lock(*mutex);
+    for (const auto& [key, future] : pendingGraphicsPSOs)
+    {
+        future.wait();
+    }
+    for (const auto& [key, future] : pendingComputePSOs)
+    {
+        future.wait();
+    }
+    resourceLayout->SetStaticSamplers(staticSamplers);
+    resourceLayout->UpdateLayout();
+}
+
+bool PipelineStateCache::HasPendingCompilations() const
+{
+    using namespace PipelineStateCache_Internal;
+
+    std::shared_lock lock(*mutex);
+    return std::ranges::any_of(pendingGraphicsPSOs, [](const auto& entry) { return !IsReady(entry.second); }) ||
+           std::ranges::any_of(pendingComputePSOs, [](const auto& entry) { return !IsReady(entry.second); });
+}
+
+void PipelineStateCache::LaunchGraphicsCompilation(const GraphicsPSOKey& key,
+                                                   const DrawDesc& drawDesc,
+                                                   bool allowFastLink)
+{
+    using namespace PipelineStateCache_Internal;
+
+    if (manifest && !graphicsPSCache.contains(key))
+    {
+        manifest->RecordGraphicsPipelineState(drawDesc, key.renderTargetState);
+    }
+
+    // The layout is read concurrently by the worker threads, it must not be modified while they compile.
+    resourceLayout->UpdateLayout();
+
+    pendingGraphicsPSOs.insert(
+        { key,
+          GetCompilationThreadPool().Submit(
+              [rhi = rhi,
+               layout = &*resourceLayout,
+               key,
+               vertexShader = ShaderCopy(drawDesc.vertexShader),
+               pixelShader = ShaderCopy(drawDesc.pixelShader),
+               allowFastLink]
+              {
+                  RHIGraphicsPipelineState ps = rhi->CreateGraphicsPipelineState(key);
+                  ps.Compile(vertexShader.GetView(), pixelShader.GetView(), *layout, allowFastLink);
+                  return ps;
+              }) });
+}
+
+void PipelineStateCache::LaunchGraphicsOptimization(const RHIGraphicsPipelineState& ps, const DrawDesc& drawDesc)
+{
+    if (ps.isFastLinked && !pendingGraphicsPSOs.contains(ps.key))
+    {
+        static constexpr bool AllowFastLink = false;
+        LaunchGraphicsCompilation(ps.key, drawDesc, AllowFastLink);
+    }
+}
+
+void PipelineStateCache::LaunchComputeCompilation(const ComputePSOKey& key, const ShaderView& computeShader)
+{
+    using namespace PipelineStateCache_Internal;
+
+    if (manifest && !computePSCache.contains(key))
+    {
+        manifest->RecordComputePipelineState(computeShader);
+    }
+
+    // The layout is read concurrently by the worker threads, it must not be modified while they compile.
+    resourceLayout->UpdateLayout();
+
+    pendingComputePSOs.insert(
+        { key,
+          GetCompilationThreadPool().Submit(
+              [rhi = rhi, layout = &*resourceLayout, key, computeShader = ShaderCopy(computeShader)]
+              {
+                  RHIComputePipelineState ps = rhi->CreateComputePipelineState(key);
+                  ps.Compile(computeShader.GetView(), *layout);
+                  return ps;
+              }) });
+}
+
+void PipelineStateCache::RetrieveAllCompiledPipelineStates()
+{
+    using namespace PipelineStateCache_Internal;
+
+    static constexpr bool WaitForCompilation = true;
+    // Only used for precompiled pipeline states in synchronous mode, which are never already present in the cache.
+    // Fast-linked pipeline states, whose optimized versions replace them, only exist with async compilation.
+    VEX_ASSERT(!enableAsyncCompilation, "Pipeline states compiled asynchronously are retrieved upon their use.");
+    std::unique_ptr<RHIGraphicsPipelineState> oldGraphicsPSO;
+    while (!pendingGraphicsPSOs.empty())
+    {
+        const GraphicsPSOKey key = pendingGraphicsPSOs.begin()->first;
+        RetrieveCompiledPipelineState(key,
+                                      graphicsPSCache,
+                                      pendingGraphicsPSOs,
+                                      resourceLayout->version,
+                                      WaitForCompilation,
+                                      oldGraphicsPSO);
+    }
+    std::unique_ptr<RHIComputePipelineState> oldComputePSO;
+    while (!pendingComputePSOs.empty())
+    {
+        const ComputePSOKey key = pendingComputePSOs.begin()->first;
+        RetrieveCompiledPipelineState(key,
+                                      computePSCache,
+                                      pendingComputePSOs,
+                                      resourceLayout->version,
+                                      WaitForCompilation,
+                                      oldComputePSO);
+    }
+}
+
+bool PipelineStateCache::HasErroredShader(const RayTracingShaderCollection& shaderCollection)
+{
+    return std::ranges::any_of(shaderCollection.rayGenerationShaders,
+                               [](const ShaderView& view) { return view.IsErrored(); }) ||
+           std::ranges::any_of(shaderCollection.rayMissShaders,
+                               [](const ShaderView& view) { return view.IsErrored(); }) ||
+           std::ranges::any_of(shaderCollection.hitGroups,
+                               [](const HitGroup& hg)
+                               {
+                                   if (hg.rayIntersectionShader && hg.rayIntersectionShader->IsErrored())
+                                       return true;
+                                   if (hg.rayAnyHitShader && hg.rayAnyHitShader->IsErrored())
+                                       return true;
+                                   return hg.rayClosestHitShader.IsErrored();
+                               }) ||
+           std::ranges::any_of(shaderCollection.rayCallableShaders,
+                               [](const ShaderView& view) { return view.IsErrored(); });
+}
+
+ThreadPool& PipelineStateCache::GetCompilationThreadPool()
+{
+    if (!compilationThreadPool)
+    {
+        compilationThreadPool = std::make_unique<ThreadPool>();
+    }
+    return *compilationThreadPool;
+}
+
 } // namespace vex
\ No newline at end of file
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <future>
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
 
+#include <Vex/Containers/Span.h>
+#include <Vex/DrawHelpers.h>
+#include <Vex/GraphicsPipeline.h>
+#include <Vex/PipelineStateManifest.h>
 #include <Vex/RHIImpl/RHIPipelineState.h>
 #include <Vex/RHIImpl/RHIResourceLayout.h>
+#include <Vex/Utility/ThreadPool.h>
 
 #include <RHI/RHIFwd.h>
 
@@ -12,34 +20,101 @@ namespace vex
 
 class Graphics;
 
+// Pipeline states can be looked up from multiple recording threads. Lookups of already compiled pipeline states only
+// take a shared lock, compilations and cache modifications are serialized.
 class PipelineStateCache
 {
 public:
-    PipelineStateCache(NonNullPtr<RHI> rhi, RHIDescriptorPool& descriptorPool);
+    PipelineStateCache(NonNullPtr<RHI> rhi,
+                       RHIDescriptorPool& descriptorPool,
+                       bool enableAsyncCompilation = false,
+                       bool recordManifest = false,
+                       bool enableGraphicsFastLinking = false);
     ~PipelineStateCache();
 
     PipelineStateCache(PipelineStateCache&&) = default;
     PipelineStateCache& operator=(PipelineStateCache&&) = default;
 
+    // When async compilation is enabled, these return nullptr while the pipeline state is being compiled on a worker
+    // thread. Passing waitForCompilation forces the pipeline state to be ready upon return.
+    // With async compilation and fast linking enabled, graphics pipeline states can be fast-linked on backends
+    // supporting it (see RHIGraphicsPipelineState::Compile). Their optimized version is then compiled on a worker
+    // thread, and replaces them once done. The replaced pipeline state is returned through oldPSO.
     RHIGraphicsPipelineState* GetGraphicsPipelineState(const DrawDesc& drawDesc,
                                                        const RenderTargetState& renderTargetState,
                                                        std::unique_ptr<RHIGraphicsPipelineState>& oldPSO);
     RHIComputePipelineState* GetComputePipelineState(const ShaderView& computeShader,
-                                                     std::unique_ptr<RHIComputePipelineState>& oldPSO);
+                                                     std::unique_ptr<RHIComputePipelineState>& oldPSO,
+                                                     bool waitForCompilation = false);
+    // Ray tracing pipeline states are always compiled synchronously, as they allocate their shader tables.
     RHIRayTracingPipelineState* GetRayTracingPipelineState(const RayTracingShaderCollection& shaderCollection,
                                                            RHIAllocator& allocator,
                                                            std::unique_ptr<RHIRayTracingPipelineState>& oldPSO,
                                                            std::vector<MaybeUninitialized<RHIBuffer>>& oldBuffers);
 
+    // Compiles pipeline states ahead of their first use on the worker threads. Blocks until they are compiled, unless
+    // async compilation is enabled.
+    void PrecompileGraphicsPipelineStates(Span<const GraphicsPipelineStateDesc> pipelineDescs);
+    void PrecompileComputePipelineStates(Span<const ShaderView> computeShaders);
+    // Ray tracing pipeline states are compiled synchronously on the calling thread.
+    void PrecompileRayTracingPipelineStates(Span<const RayTracingShaderCollection> shaderCollections,
+                                            RHIAllocator& allocator);
+
+    // Blocks until all in-flight pipeline state compilations are done.
+    void WaitForPendingCompilations();
+    [[nodiscard]] bool HasPendingCompilations() const;
+
+    // Replaces the static samplers of the resource layout. Waits for the in-flight compilations reading the layout,
+    // while preventing new ones from starting until the layout is rebuilt.
+    void SetStaticSamplers(Span<const StaticTextureSampler> staticSamplers);
+
+    // Only valid if the cache was created with manifest recording enabled.
+    [[nodiscard]] const PipelineStateManifest* GetManifest() const
+    {
+        return manifest.get();
+    }
+
     MaybeUninitialized<RHIResourceLayout> resourceLayout;
 
 private:
+    void LaunchGraphicsCompilation(const GraphicsPSOKey& key, const DrawDesc& drawDesc, bool allowFastLink);
+    // Compiles the optimized version of a fast-linked pipeline state, which replaces it once done.
+    void LaunchGraphicsOptimization(const RHIGraphicsPipelineState& ps, const DrawDesc& drawDesc);
+    void LaunchComputeCompilation(const ComputePSOKey& key, const ShaderView& computeShader);
+    // Waits for all in-flight compilations and moves their results into the cache.
+    void RetrieveAllCompiledPipelineStates();
+
+    ThreadPool& GetCompilationThreadPool();
+
+    static bool HasErroredShader(const RayTracingShaderCollection& shaderCollection);
+
     RHI* rhi;
 
+    bool enableAsyncCompilation;
+    // Only enabled along with async compilation, synchronous compilation never uses the worker threads for draws.
+    bool enableGraphicsFastLinking;
+
+    // Records every new pipeline state, when enabled.
+    std::unique_ptr<PipelineStateManifest> manifest;
+
     std::unordered_map<RHIGraphicsPipelineState::Key, RHIGraphicsPipelineState, RHIGraphicsPipelineState::Hasher>
         graphicsPSCache;
     std::unordered_map<RHIComputePipelineState::Key, RHIComputePipelineState> computePSCache;
     std::unordered_map<RayTracingPSOKey, RHIRayTracingPipelineState> rayTracingPSCache;
+
+    // Pipeline states currently being compiled on the worker threads.
+    std::unordered_map<RHIGraphicsPipelineState::Key,
+                       std::future<RHIGraphicsPipelineState>,
+                       RHIGraphicsPipelineState::Hasher>
+        pendingGraphicsPSOs;
+    std::unordered_map<RHIComputePipelineState::Key, std::future<RHIComputePipelineState>> pendingComputePSOs;
+
+    // Guards the caches above, along with the manifest.
+    std::unique_ptr<std::shared_mutex> mutex = std::make_unique<std::shared_mutex>();
+
+    // Created upon the first background compilation. Declared last so that in-flight compilations finish before the
+    // resource layout they reference is destroyed.
+    std::unique_ptr<ThreadPool> compilationThreadPool;
 };
 
 } // namespace vex
\ No newline at end of file
@@ -0,0 +1,506 @@
+#include "PipelineStateManifest.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <Vex/Logger.h>
+
+namespace vex
+{
+
+namespace PipelineStateManifest_Internal
+{
+
+// Identifies a Vex pipeline state manifest ("VXPM").
+static constexpr u32 ManifestMagic = 0x4D505856;
+// Must be incremented whenever the layout of the manifest changes.
+static constexpr u32 ManifestVersion = 2;
+
+template <class T, class U>
+concept SerializedAs = std::same_as<std::remove_const_t<T>, U>;
+
+// Structures are serialized field by field, never as raw memory which would also write their padding bytes. The same
+// field lists are used for writing and reading the manifest.
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<VertexInputLayout::VertexAttribute> auto& attribute)
+{
+    archive(attribute.semanticName, attribute.semanticIndex, attribute.binding, attribute.format, attribute.offset);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<VertexInputLayout::VertexBinding> auto& binding)
+{
+    archive(binding.binding, binding.strideByteSize, binding.inputRate);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<VertexInputLayout> auto& layout)
+{
+    archive(layout.attributes, layout.bindings);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<InputAssembly> auto& inputAssembly)
+{
+    archive(inputAssembly.topology, inputAssembly.primitiveRestartEnabled);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<RasterizerState> auto& state)
+{
+    archive(state.rasterizerDiscardEnabled,
+            state.depthClampEnabled,
+            state.polygonMode,
+            state.cullMode,
+            state.winding,
+            state.depthBiasEnabled,
+            state.depthBiasConstantFactor,
+            state.depthBiasClamp,
+            state.depthBiasSlopeFactor,
+            state.lineWidth);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<DepthStencilState::StencilOpState> auto& state)
+{
+    archive(state.failOp,
+            state.passOp,
+            state.depthFailOp,
+            state.compareOp,
+            state.readMask,
+            state.writeMask,
+            state.reference);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<DepthStencilState> auto& state)
+{
+    archive(state.depthTestEnabled,
+            state.depthWriteEnabled,
+            state.depthCompareOp,
+            state.depthBoundsTestEnabled,
+            state.stencilTestEnabled,
+            state.front,
+            state.back,
+            state.minDepthBounds,
+            state.maxDepthBounds);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<ColorBlendState::ColorBlendAttachment> auto& attachment)
+{
+    archive(attachment.blendEnabled,
+            attachment.srcColorBlendFactor,
+            attachment.dstColorBlendFactor,
+            attachment.colorBlendOp,
+            attachment.srcAlphaBlendFactor,
+            attachment.dstAlphaBlendFactor,
+            attachment.alphaBlendOp,
+            attachment.colorWriteMask);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<ColorBlendState> auto& state)
+{
+    archive(state.logicOpEnabled, state.logicOp, state.attachments, state.blendConstants);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<RenderTargetState::ColorFormat> auto& colorFormat)
+{
+    archive(colorFormat.format, colorFormat.isSRGB);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<RenderTargetState> auto& state)
+{
+    archive(state.colorFormats, state.depthStencilFormat);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<GraphicsPipelineStateDesc> auto& desc)
+{
+    auto& drawDesc = desc.drawDesc;
+    archive(drawDesc.vertexShader,
+            drawDesc.pixelShader,
+            drawDesc.vertexInputLayout,
+            drawDesc.inputAssembly,
+            drawDesc.rasterizerState,
+            drawDesc.depthStencilState,
+            drawDesc.colorBlendState,
+            desc.renderTargetState);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<HitGroup> auto& hitGroup)
+{
+    archive(hitGroup.name, hitGroup.rayClosestHitShader, hitGroup.rayAnyHitShader, hitGroup.rayIntersectionShader);
+}
+
+template <class Archive>
+void Serialize(Archive& archive, SerializedAs<RayTracingShaderCollection> auto& shaderCollection)
+{
+    archive(shaderCollection.maxRecursionDepth,
+            shaderCollection.maxPayloadByteSize,
+            shaderCollection.maxAttributeByteSize,
+            shaderCollection.rayGenerationShaders,
+            shaderCollection.rayMissShaders,
+            shaderCollection.hitGroups,
+            shaderCollection.rayCallableShaders);
+}
+
+class ManifestWriter
+{
+public:
+    explicit ManifestWriter(std::ofstream& stream)
+        : stream(stream)
+    {
+    }
+
+    template <class... Ts>
+    void operator()(const Ts&... values)
+    {
+        (Write(values), ...);
+    }
+
+private:
+    template <class T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void Write(T value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void Write(const std::string& string)
+    {
+        Write(static_cast<u32>(string.size()));
+        stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+    }
+
+    // Only the hash and type of shaders are stored.
+    void Write(const ShaderView& shader)
+    {
+        Write(shader.hash);
+        Write(shader.type);
+    }
+
+    template <class T, std::size_t N>
+    void Write(const std::array<T, N>& values)
+    {
+        for (const T& value : values)
+        {
+            Write(value);
+        }
+    }
+
+    template <class T>
+    void Write(const std::vector<T>& values)
+    {
+        Write(static_cast<u32>(values.size()));
+        for (const T& value : values)
+        {
+            Write(value);
+        }
+    }
+
+    template <class T>
+    void Write(const std::optional<T>& value)
+    {
+        Write(value.has_value());
+        if (value.has_value())
+        {
+            Write(*value);
+        }
+    }
+
+    template <class T>
+        requires std::is_class_v<T>
+    void Write(const T& value)
+    {
+        Serialize(*this, value);
+    }
+
+    std::ofstream& stream;
+};
+
+// Stops reading at the first error, all subsequent reads are then ignored.
+class ManifestReader
+{
+public:
+    explicit ManifestReader(std::ifstream& stream)
+        : stream(stream)
+    {
+        stream.seekg(0, std::ios::end);
+        fileByteSize = stream.tellg();
+        stream.seekg(0, std::ios::beg);
+        isValid = stream.good();
+    }
+
+    // Returns false if any value (including the previously read ones) could not be read.
+    template <class... Ts>
+    bool operator()(Ts&... values)
+    {
+        (Read(values), ...);
+        return isValid;
+    }
+
+private:
+    template <class T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void Read(T& value)
+    {
+        ReadBytes(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    void ReadBytes(char* data, std::streamsize byteSize)
+    {
+        if (!isValid)
+        {
+            return;
+        }
+        stream.read(data, byteSize);
+        isValid = stream.good() && stream.gcount() == byteSize;
+    }
+
+    // Every element takes up at least one byte, a count larger than the remaining byte size of the file can only come
+    // from a corrupted manifest (and must not be used to allocate memory).
+    void ReadCount(u32& count)
+    {
+        Read(count);
+        isValid = isValid && count <= static_cast<u64>(fileByteSize - static_cast<std::streamoff>(stream.tellg()));
+    }
+
+    void Read(std::string& string)
+    {
+        u32 size = 0;
+        ReadCount(size);
+        if (isValid)
+        {
+            string.resize(size);
+            ReadBytes(string.data(), size);
+        }
+    }
+
+    void Read(ShaderView& shader)
+    {
+        SHA1HashDigest hash{};
+        ShaderType type{};
+        Read(hash);
+        Read(type);
+        shader = ShaderView({}, {}, {}, hash, type);
+    }
+
+    template <class T, std::size_t N>
+    void Read(std::array<T, N>& values)
+    {
+        for (T& value : values)
+        {
+            Read(value);
+        }
+    }
+
+    template <class T>
+    void Read(std::vector<T>& values)
+    {
+        u32 size = 0;
+        ReadCount(size);
+        if (isValid)
+        {
+            values.resize(size);
+            for (T& value : values)
+            {
+                Read(value);
+            }
+        }
+    }
+
+    template <class T>
+    void Read(std::optional<T>& value)
+    {
+        bool hasValue = false;
+        Read(hasValue);
+        if (hasValue)
+        {
+            Read(value.emplace());
+        }
+        else
+        {
+            value.reset();
+        }
+    }
+
+    template <class T>
+        requires std::is_class_v<T>
+    void Read(T& value)
+    {
+        Serialize(*this, value);
+    }
+
+    std::ifstream& stream;
+    std::streamoff fileByteSize = 0;
+    bool isValid = false;
+};
+
+// Calls func on every shader of the collection, stopping at the first one for which it returns false.
+template <class Func>
+bool ForEachShader(RayTracingShaderCollection& shaderCollection, Func&& func)
+{
+    auto FuncOptional = [&func](std::optional<ShaderView>& shader) { return !shader || func(*shader); };
+    return std::ranges::all_of(shaderCollection.rayGenerationShaders, func) &&
+           std::ranges::all_of(shaderCollection.rayMissShaders, func) &&
+           std::ranges::all_of(shaderCollection.hitGroups,
+                               [&](HitGroup& hitGroup)
+                               {
+                                   return func(hitGroup.rayClosestHitShader) &&
+                                          FuncOptional(hitGroup.rayAnyHitShader) &&
+                                          FuncOptional(hitGroup.rayIntersectionShader);
+                               }) &&
+           std::ranges::all_of(shaderCollection.rayCallableShaders, func);
+}
+
+// Only keeps what identifies the shader, the manifest does not own the shader's name, entry point or bytecode.
+bool StripShader(ShaderView& shader)
+{
+    shader = ShaderView({}, {}, {}, shader.hash, shader.type);
+    return true;
+}
+
+} // namespace PipelineStateManifest_Internal
+
+void PipelineStateManifest::RecordGraphicsPipelineState(const DrawDesc& drawDesc,
+                                                        const RenderTargetState& renderTargetState)
+{
+    using namespace PipelineStateManifest_Internal;
+
+    if (!recordedGraphicsPSOs.emplace(drawDesc, renderTargetState).second)
+    {
+        return;
+    }
+
+    GraphicsPipelineStateDesc& desc =
+        graphicsPipelineStates.emplace_back(GraphicsPipelineStateDesc{ drawDesc, renderTargetState });
+    StripShader(desc.drawDesc.vertexShader);
+    StripShader(desc.drawDesc.pixelShader);
+}
+
+void PipelineStateManifest::RecordComputePipelineState(const ShaderView& computeShader)
+{
+    using namespace PipelineStateManifest_Internal;
+
+    if (!recordedComputePSOs.emplace(computeShader).second)
+    {
+        return;
+    }
+
+    StripShader(computePipelineStates.emplace_back(computeShader));
+}
+
+void PipelineStateManifest::RecordRayTracingPipelineState(const RayTracingShaderCollection& shaderCollection)
+{
+    using namespace PipelineStateManifest_Internal;
+
+    if (!recordedRayTracingPSOs.emplace(shaderCollection).second)
+    {
+        return;
+    }
+
+    ForEachShader(rayTracingPipelineStates.emplace_back(shaderCollection), StripShader);
+}
+
+bool PipelineStateManifest::Save(const std::filesystem::path& filepath) const
+{
+    using namespace PipelineStateManifest_Internal;
+
+    if (filepath.has_parent_path())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+        if (ec)
+        {
+            VEX_LOG(Error,
+                    "Unable to create the pipeline state manifest directory {}: {}.",
+                    filepath.parent_path().string(),
+                    ec.message());
+            return false;
+        }
+    }
+
+    std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    ManifestWriter writer(stream);
+    writer(ManifestMagic, ManifestVersion, graphicsPipelineStates, computePipelineStates, rayTracingPipelineStates);
+    return stream.good();
+}
+
+std::optional<PipelineStateManifest> PipelineStateManifest::Load(const std::filesystem::path& filepath)
+{
+    using namespace PipelineStateManifest_Internal;
+
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream.is_open())
+    {
+        return std::nullopt;
+    }
+
+    ManifestReader reader(stream);
+    u32 magic, version;
+    if (!reader(magic, version) || magic != ManifestMagic || version != ManifestVersion)
+    {
+        VEX_LOG(Warning, "Ignoring pipeline state manifest {}: unknown format.", filepath.string());
+        return std::nullopt;
+    }
+
+    PipelineStateManifest manifest;
+    if (!reader(manifest.graphicsPipelineStates, manifest.computePipelineStates, manifest.rayTracingPipelineStates))
+    {
+        VEX_LOG(Warning, "Ignoring pipeline state manifest {}: the file is truncated or corrupted.", filepath.string());
+        return std::nullopt;
+    }
+
+    return manifest;
+}
+
+u32 PipelineStateManifest::ResolveShaders(Span<const ShaderView> shaders)
+{
+    using namespace PipelineStateManifest_Internal;
+
+    std::unordered_map<SHA1HashDigest, const ShaderView*> shadersByHash;
+    for (const ShaderView& shader : shaders)
+    {
+        shadersByHash.emplace(shader.hash, &shader);
+    }
+
+    auto ResolveShader = [&shadersByHash](ShaderView& shader)
+    {
+        const auto it = shadersByHash.find(shader.hash);
+        if (it == shadersByHash.end() || it->second->type != shader.type)
+        {
+            return false;
+        }
+        shader = *it->second;
+        return true;
+    };
+
+    const std::size_t removedCount =
+        std::erase_if(graphicsPipelineStates,
+                      [&](GraphicsPipelineStateDesc& desc)
+                      {
+                          return !ResolveShader(desc.drawDesc.vertexShader) ||
+                                 !ResolveShader(desc.drawDesc.pixelShader);
+                      }) +
+        std::erase_if(computePipelineStates, [&](ShaderView& shader) { return !ResolveShader(shader); }) +
+        std::erase_if(rayTracingPipelineStates,
+                      [&](RayTracingShaderCollection& shaderCollection)
+                      { return !ForEachShader(shaderCollection, ResolveShader); });
+    return static_cast<u32>(removedCount);
+}
+
+} // namespace vex
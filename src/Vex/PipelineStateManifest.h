@@ -0,0 +1,72 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include <Vex/Containers/Span.h>
+#include <Vex/DrawHelpers.h>
+#include <Vex/GraphicsPipeline.h>
+#include <Vex/PipelineState.h>
+#include <Vex/RayTracing.h>
+#include <Vex/ShaderView.h>
+#include <Vex/Types.h>
+#include <Vex/Utility/Hash.h>
+
+namespace vex
+{
+
+// List of the pipeline states used by a session. Shaders are identified by their hash, the manifest does not store
+// their bytecode. Saved to disk, it allows later runs to compile all of these pipeline states at startup, using the
+// shaders they compiled themselves (eg: from the shader compiler's disk cache).
+class PipelineStateManifest
+{
+public:
+    // Pipeline states which were already recorded are ignored.
+    void RecordGraphicsPipelineState(const DrawDesc& drawDesc, const RenderTargetState& renderTargetState);
+    void RecordComputePipelineState(const ShaderView& computeShader);
+    void RecordRayTracingPipelineState(const RayTracingShaderCollection& shaderCollection);
+
+    // Returns false if the manifest could not be written.
+    bool Save(const std::filesystem::path& filepath) const;
+    // Returns std::nullopt if the file does not exist or is not a valid manifest.
+    static std::optional<PipelineStateManifest> Load(const std::filesystem::path& filepath);
+
+    // Replaces the shaders of the pipeline states with the passed-in shaders of the same hash, which must outlive the
+    // manifest. Pipeline states using a shader which is not passed in (eg: a shader whose source changed since the
+    // manifest was recorded) are removed. Returns the number of removed pipeline states.
+    u32 ResolveShaders(Span<const ShaderView> shaders);
+
+    // Until ResolveShaders is called, the shader views of the pipeline states only contain the shader hash and type.
+    [[nodiscard]] const std::vector<GraphicsPipelineStateDesc>& GetGraphicsPipelineStates() const
+    {
+        return graphicsPipelineStates;
+    }
+    [[nodiscard]] const std::vector<ShaderView>& GetComputePipelineStates() const
+    {
+        return computePipelineStates;
+    }
+    [[nodiscard]] const std::vector<RayTracingShaderCollection>& GetRayTracingPipelineStates() const
+    {
+        return rayTracingPipelineStates;
+    }
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return graphicsPipelineStates.empty() && computePipelineStates.empty() && rayTracingPipelineStates.empty();
+    }
+
+private:
+    std::vector<GraphicsPipelineStateDesc> graphicsPipelineStates;
+    std::vector<ShaderView> computePipelineStates;
+    std::vector<RayTracingShaderCollection> rayTracingPipelineStates;
+
+    // Keys of the recorded pipeline states, a pipeline state is only recorded once even if it is compiled again (eg:
+    // when precompiling a loaded manifest or after a resource layout change).
+    std::unordered_set<GraphicsPSOKey> recordedGraphicsPSOs;
+    std::unordered_set<ComputePSOKey> recordedComputePSOs;
+    std::unordered_set<RayTracingPSOKey> recordedRayTracingPSOs;
+};
+
+} // namespace vex
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include <Vex/CommandContext.h>
+#include <Vex/Graphics.h>
+#include <Vex/Logger.h>
+#include <Vex/ScopedGPUEvent.h>
+#include <Vex/Utility/Validation.h>
+
+#include <RHI/RHIBarrier.h>
+
+namespace vex
+{
+
+namespace RenderGraph_Internal
+{
+
+// The type of the pass is used rather than the queue it is scheduled onto, compute passes keep synchronizing with the
+// compute stage when they run on the graphics queue.
+static RHIBarrierSync GetAccessSync(RHIBarrierAccess access, QueueType passType)
+{
+    switch (access)
+    {
+    case RHIBarrierAccess::IndirectCommandRead:
+        return RHIBarrierSync::DrawIndirect;
+    case RHIBarrierAccess::VertexInputRead:
+        return RHIBarrierSync::VertexInput;
+    case RHIBarrierAccess::RenderTarget:
+        return RHIBarrierSync::RenderTarget;
+    case RHIBarrierAccess::DepthStencilRead:
+    case RHIBarrierAccess::DepthStencilWrite:
+    case RHIBarrierAccess::DepthStencilReadWrite:
+        return RHIBarrierSync::DepthStencil;
+    case RHIBarrierAccess::CopySource:
+    case RHIBarrierAccess::CopyDest:
+        return RHIBarrierSync::Copy;
+    case RHIBarrierAccess::AccelerationStructureRead:
+    case RHIBarrierAccess::AccelerationStructureWrite:
+    case RHIBarrierAccess::MemoryRead:
+    case RHIBarrierAccess::MemoryWrite:
+        return RHIBarrierSync::AllCommands;
+    default:
+        break;
+    }
+
+    switch (passType)
+    {
+    case QueueType::Graphics:
+        return RHIBarrierSync::AllGraphics;
+    case QueueType::Compute:
+        return RHIBarrierSync::ComputeShader;
+    case QueueType::Copy:
+        return RHIBarrierSync::Copy;
+    default:
+        std::unreachable();
+    }
+}
+
+} // namespace RenderGraph_Internal
+
+RenderGraph::RenderGraph(NonNullPtr<Graphics> graphics, bool enableAsyncCompute)
+    : graphics(graphics)
+    , enableAsyncCompute(enableAsyncCompute)
+{
+}
+
+RenderGraphResource RenderGraph::ImportTexture(const Texture& texture)
+{
+    resources.push_back({ .desc = texture.desc, .resource = texture, .isImported = true });
+    return { static_cast<u32>(resources.size() - 1) };
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(const Buffer& buffer)
+{
+    resources.push_back({ .desc = buffer.desc, .resource = buffer, .isImported = true });
+    return { static_cast<u32>(resources.size() - 1) };
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const TextureDesc& desc)
+{
+    resources.push_back({ .desc = desc });
+    return { static_cast<u32>(resources.size() - 1) };
+}
+
+RenderGraphResource RenderGraph::CreateBuffer(const BufferDesc& desc)
+{
+    resources.push_back({ .desc = desc });
+    return { static_cast<u32>(resources.size() - 1) };
+}
+
+void RenderGraph::AddPass(RenderGraphPassDesc desc, ExecuteFunction execute)
+{
+    for (const RenderGraphAccess& access : desc.reads)
+    {
+        VEX_CHECK(access.resource.index < resources.size(),
+                  "Pass \"{}\" reads from a resource which was not declared to the render graph.",
+                  desc.name);
+        VEX_CHECK(!IsWriteAccess(access.access),
+                  "Pass \"{}\" declares a write access as a read, declare it as a write instead.",
+                  desc.name);
+    }
+    for (const RenderGraphAccess& access : desc.writes)
+    {
+        VEX_CHECK(access.resource.index < resources.size(),
+                  "Pass \"{}\" writes to a resource which was not declared to the render graph.",
+                  desc.name);
+    }
+
+    // The copy queue cannot execute compute work, so only compute passes can be moved onto another queue.
+    const QueueType queue = desc.queue == QueueType::Compute && !enableAsyncCompute ? QueueType::Graphics : desc.queue;
+    passes.push_back({ .desc = std::move(desc), .execute = std::move(execute), .queue = queue });
+}
+
+const Texture& RenderGraph::GetTexture(RenderGraphResource resource) const
+{
+    VEX_CHECK(resource.index < resources.size() && resources[resource.index].resource &&
+                  std::holds_alternative<Texture>(*resources[resource.index].resource),
+              "The render graph resource is not a texture which is currently valid.");
+    return std::get<Texture>(*resources[resource.index].resource);
+}
+
+const Buffer& RenderGraph::GetBuffer(RenderGraphResource resource) const
+{
+    VEX_CHECK(resource.index < resources.size() && resources[resource.index].resource &&
+                  std::holds_alternative<Buffer>(*resources[resource.index].resource),
+              "The render graph resource is not a buffer which is currently valid.");
+    return std::get<Buffer>(*resources[resource.index].resource);
+}
+
+std::vector<SyncToken> RenderGraph::Execute(Span<const SyncToken> dependencies)
+{
+    CullPasses();
+    ComputeDependencies();
+    const std::vector<Batch> batches = ScheduleBatches();
+
+    std::vector<std::vector<ResourceUsage>> usages(resources.size());
+    for (u32 passIndex = 0; passIndex < passes.size(); ++passIndex)
+    {
+        const Pass& pass = passes[passIndex];
+        if (pass.isCulled)
+        {
+            continue;
+        }
+
+        for (const std::vector<RenderGraphAccess>* accesses : { &pass.desc.reads, &pass.desc.writes })
+        {
+            for (const RenderGraphAccess& access : *accesses)
+            {
+                std::vector<ResourceUsage>& resourceUsages = usages[access.resource.index];
+                const RHIBarrierSync sync = RenderGraph_Internal::GetAccessSync(access.access, pass.desc.queue);
+                // A pass accessing the same resource in multiple ways requires a single state for all of them, writes
+                // are declared after reads and take precedence.
+                if (!resourceUsages.empty() && resourceUsages.back().passIndex == passIndex)
+                {
+                    ResourceUsage& usage = resourceUsages.back();
+                    usage.sync = usage.sync == sync ? sync : RHIBarrierSync::AllCommands;
+                    usage.access = access.access;
+                    continue;
+                }
+                resourceUsages.push_back({ .passIndex = passIndex, .sync = sync, .access = access.access });
+            }
+        }
+    }
+
+    // Resources spanning multiple command contexts cannot be transient, create them upfront.
+    for (u32 resourceIndex = 0; resourceIndex < resources.size(); ++resourceIndex)
+    {
+        ResourceEntry& entry = resources[resourceIndex];
+        if (entry.isImported || usages[resourceIndex].empty() || IsContextTransient(resourceIndex, usages))
+        {
+            continue;
+        }
+
+        if (const TextureDesc* textureDesc = std::get_if<TextureDesc>(&entry.desc))
+        {
+            entry.resource = graphics->CreateTexture(*textureDesc, ResourceLifetime::Dynamic);
+        }
+        else
+        {
+            entry.resource = graphics->CreateBuffer(std::get<BufferDesc>(entry.desc), ResourceLifetime::Dynamic);
+        }
+    }
+
+    // Batches are scheduled in submission order, the batches they depend on are always submitted before them.
+    std::vector<SyncToken> syncTokens;
+    syncTokens.reserve(batches.size());
+    for (const Batch& batch : batches)
+    {
+        CommandContext ctx = graphics->CreateCommandContext(batch.queue);
+        ExecuteBatch(ctx, batch, usages);
+
+        std::vector<SyncToken> batchDependencies(dependencies.begin(), dependencies.end());
+        for (u32 dependentBatch : batch.dependentBatches)
+        {
+            batchDependencies.push_back(syncTokens[dependentBatch]);
+        }
+        syncTokens.push_back(graphics->Submit(ctx, batchDependencies));
+    }
+
+    Reset();
+    return syncTokens;
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walks the passes backwards, a pass is kept if it writes to a resource which is read by a later kept pass.
+    // Writes are conservatively considered partial: earlier writers of a needed resource are also kept.
+    std::vector<bool> isResourceNeeded(resources.size(), false);
+    for (u32 i = 0; i < resources.size(); ++i)
+    {
+        isResourceNeeded[i] = resources[i].isImported;
+    }
+
+    for (auto pass = passes.rbegin(); pass != passes.rend(); ++pass)
+    {
+        pass->isCulled = !pass->desc.neverCull &&
+                         std::ranges::none_of(pass->desc.writes,
+                                              [&](const RenderGraphAccess& write)
+                                              { return isResourceNeeded[write.resource.index]; });
+        if (pass->isCulled)
+        {
+            continue;
+        }
+
+        for (const RenderGraphAccess& read : pass->desc.reads)
+        {
+            isResourceNeeded[read.resource.index] = true;
+        }
+    }
+}
+
+void RenderGraph::ComputeDependencies()
+{
+    struct ResourceHazards
+    {
+        std::optional<u32> lastWriter;
+        std::vector<std::pair<u32, RHIBarrierAccess>> readersSinceLastWrite;
+    };
+    std::vector<ResourceHazards> hazards(resources.size());
+
+    for (u32 passIndex = 0; passIndex < passes.size(); ++passIndex)
+    {
+        Pass& pass = passes[passIndex];
+        if (pass.isCulled)
+        {
+            continue;
+        }
+
+        auto addDependency = [&](u32 dependency)
+        {
+            if (dependency != passIndex && std::ranges::find(pass.dependencies, dependency) == pass.dependencies.end())
+            {
+                pass.dependencies.push_back(dependency);
+            }
+        };
+
+        // Read after write.
+        for (const RenderGraphAccess& read : pass.desc.reads)
+        {
+            const ResourceHazards& resourceHazards = hazards[read.resource.index];
+            if (resourceHazards.lastWriter)
+            {
+                addDependency(*resourceHazards.lastWriter);
+            }
+
+            // Texture reads can transition the layout of the texture, which must not happen while other queues or
+            // accesses are reading it. This also orders all uses of a texture across queues, allowing hand-offs.
+            if (std::holds_alternative<TextureDesc>(resources[read.resource.index].desc))
+            {
+                for (const auto& [reader, readerAccess] : resourceHazards.readersSinceLastWrite)
+                {
+                    if (passes[reader].queue != pass.queue || readerAccess != read.access)
+                    {
+                        addDependency(reader);
+                    }
+                }
+            }
+        }
+        // Write after write and write after read.
+        for (const RenderGraphAccess& write : pass.desc.writes)
+        {
+            const ResourceHazards& resourceHazards = hazards[write.resource.index];
+            if (resourceHazards.lastWriter)
+            {
+                addDependency(*resourceHazards.lastWriter);
+            }
+            for (const auto& [reader, readerAccess] : resourceHazards.readersSinceLastWrite)
+            {
+                addDependency(reader);
+            }
+        }
+
+        for (const RenderGraphAccess& read : pass.desc.reads)
+        {
+            hazards[read.resource.index].readersSinceLastWrite.emplace_back(passIndex, read.access);
+        }
+        for (const RenderGraphAccess& write : pass.desc.writes)
+        {
+            hazards[write.resource.index] = { .lastWriter = passIndex };
+        }
+    }
+}
+
+std::vector<RenderGraph::Batch> RenderGraph::ScheduleBatches()
+{
+    // Batches in submission order, along with the batch currently being filled for each queue.
+    std::vector<Batch> batches;
+    std::array<std::optional<Batch>, QueueTypes::Count> openBatches;
+    std::vector<std::optional<u32>> passToOpenBatch(passes.size());
+
+    auto closeBatch = [&](QueueType queue)
+    {
+        std::optional<Batch>& openBatch = openBatches[queue];
+        const u32 batchIndex = static_cast<u32>(batches.size());
+        for (u32 passIndex : openBatch->passes)
+        {
+            passes[passIndex].batchIndex = batchIndex;
+        }
+        batches.push_back(std::move(*openBatch));
+        openBatch.reset();
+    };
+
+    for (u32 passIndex = 0; passIndex < passes.size(); ++passIndex)
+    {
+        const Pass& pass = passes[passIndex];
+        if (pass.isCulled)
+        {
+            continue;
+        }
+
+        // Work of other queues this pass depends on must be submitted first, so that this pass' batch can wait on it.
+        std::vector<u32> crossQueueDependencies;
+        for (u32 dependency : pass.dependencies)
+        {
+            const QueueType dependencyQueue = passes[dependency].queue;
+            if (dependencyQueue == pass.queue)
+            {
+                continue;
+            }
+
+            const std::optional<Batch>& dependencyBatch = openBatches[dependencyQueue];
+            if (dependencyBatch &&
+                std::ranges::find(dependencyBatch->passes, dependency) != dependencyBatch->passes.end())
+            {
+                closeBatch(dependencyQueue);
+            }
+            crossQueueDependencies.push_back(passes[dependency].batchIndex);
+        }
+
+        // Waits happen at the start of a submission, the passes already in this queue's batch must not wait.
+        std::optional<Batch>& openBatch = openBatches[pass.queue];
+        if (openBatch && std::ranges::any_of(crossQueueDependencies,
+                                             [&](u32 batch)
+                                             { return std::ranges::find(openBatch->dependentBatches, batch) ==
+                                                      openBatch->dependentBatches.end(); }))
+        {
+            closeBatch(pass.queue);
+        }
+        if (!openBatch)
+        {
+            openBatch = Batch{ .queue = pass.queue };
+        }
+
+        for (u32 batch : crossQueueDependencies)
+        {
+            if (std::ranges::find(openBatch->dependentBatches, batch) == openBatch->dependentBatches.end())
+            {
+                openBatch->dependentBatches.push_back(batch);
+            }
+        }
+        openBatch->passes.push_back(passIndex);
+    }
+
+    for (u8 queue = 0; queue < QueueTypes::Count; ++queue)
+    {
+        if (openBatches[queue])
+        {
+            closeBatch(static_cast<QueueType>(queue));
+        }
+    }
+
+    return batches;
+}
+
+void RenderGraph::ExecuteBatch(CommandContext& ctx,
+                               const Batch& batch,
+                               const std::vector<std::vector<ResourceUsage>>& usages)
+{
+    auto getUsage = [&](u32 resourceIndex, u32 passIndex)
+    { return std::ranges::find(usages[resourceIndex], passIndex, &ResourceUsage::passIndex); };
+
+    for (u32 passIndex : batch.passes)
+    {
+        Pass& pass = passes[passIndex];
+
+        std::vector<u32> accessedResources;
+        for (const std::vector<RenderGraphAccess>* accesses : { &pass.desc.reads, &pass.desc.writes })
+        {
+            for (const RenderGraphAccess& access : *accesses)
+            {
+                if (std::ranges::find(accessedResources, access.resource.index) == accessedResources.end())
+                {
+                    accessedResources.push_back(access.resource.index);
+                }
+            }
+        }
+
+        for (u32 resourceIndex : accessedResources)
+        {
+            ResourceEntry& entry = resources[resourceIndex];
+            const bool isFirstUsage = usages[resourceIndex].front().passIndex == passIndex;
+            if (isFirstUsage && !entry.isImported && IsContextTransient(resourceIndex, usages))
+            {
+                entry.resource = ctx.CreateTransientTexture(std::get<TextureDesc>(entry.desc));
+            }
+
+            // Ends the split barrier begun after the previous access, if any.
+            const auto usage = getUsage(resourceIndex, passIndex);
+            if (const Texture* texture = std::get_if<Texture>(&*entry.resource))
+            {
+                if (!isFirstUsage && IsQueueHandoff(resourceIndex, *std::prev(usage), *usage))
+                {
+                    ctx.AcquireFromQueue(*texture, passes[std::prev(usage)->passIndex].queue, usage->access);
+                }
+                ctx.EnqueueTextureBarrier(*texture,
+                                          {},
+                                          usage->sync,
+                                          usage->access,
+                                          RHIAccessToRHILayout(usage->access));
+            }
+            else
+            {
+                ctx.EnqueueBufferBarrier(std::get<Buffer>(*entry.resource), usage->sync, usage->access);
+            }
+        }
+
+        {
+            ScopedGPUEvent passEvent = ctx.CreateScopedGPUEvent(pass.desc.name.c_str());
+            pass.execute(ctx, *this);
+        }
+
+        for (u32 resourceIndex : accessedResources)
+        {
+            ResourceEntry& entry = resources[resourceIndex];
+            const auto usage = getUsage(resourceIndex, passIndex);
+            const auto nextUsage = std::next(usage);
+
+            if (nextUsage == usages[resourceIndex].end())
+            {
+                if (!entry.isImported && IsContextTransient(resourceIndex, usages))
+                {
+                    ctx.ReleaseTransientTexture(std::get<Texture>(*entry.resource));
+                    entry.resource.reset();
+                }
+                continue;
+            }
+
+            if (IsQueueHandoff(resourceIndex, *usage, *nextUsage))
+            {
+                ctx.ReleaseToQueue(std::get<Texture>(*entry.resource),
+                                   passes[nextUsage->passIndex].queue,
+                                   nextUsage->access);
+                continue;
+            }
+
+            // Only worth splitting when other passes are recorded between both accesses of this context. Accesses in
+            // other contexts are synchronized by their submission.
+            if (passes[nextUsage->passIndex].batchIndex != pass.batchIndex ||
+                nextUsage->passIndex == *std::next(std::ranges::find(batch.passes, passIndex)))
+            {
+                continue;
+            }
+
+            if (const Texture* texture = std::get_if<Texture>(&*entry.resource))
+            {
+                ctx.BeginSplitBarrier(*texture, nextUsage->sync, nextUsage->access);
+            }
+            else
+            {
+                ctx.BeginSplitBarrier(std::get<Buffer>(*entry.resource), nextUsage->sync, nextUsage->access);
+            }
+        }
+    }
+}
+
+bool RenderGraph::IsContextTransient(u32 resourceIndex, const std::vector<std::vector<ResourceUsage>>& usages) const
+{
+    // Only textures can be transient to a command context.
+    if (!std::holds_alternative<TextureDesc>(resources[resourceIndex].desc))
+    {
+        return false;
+    }
+
+    const u32 batchIndex = passes[usages[resourceIndex].front().passIndex].batchIndex;
+    return std::ranges::all_of(usages[resourceIndex],
+                               [&](const ResourceUsage& usage)
+                               { return passes[usage.passIndex].batchIndex == batchIndex; });
+}
+
+bool RenderGraph::IsQueueHandoff(u32 resourceIndex, const ResourceUsage& usage, const ResourceUsage& nextUsage) const
+{
+    const QueueType queue = passes[usage.passIndex].queue;
+    const QueueType nextQueue = passes[nextUsage.passIndex].queue;
+    if (!std::holds_alternative<TextureDesc>(resources[resourceIndex].desc) || queue == nextQueue ||
+        queue == QueueType::Copy || nextQueue == QueueType::Copy)
+    {
+        return false;
+    }
+
+    // Only layouts supported by both the graphics and compute queues can be handed off.
+    switch (nextUsage.access)
+    {
+    case RHIBarrierAccess::ShaderRead:
+    case RHIBarrierAccess::ShaderReadWrite:
+    case RHIBarrierAccess::CopySource:
+    case RHIBarrierAccess::CopyDest:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void RenderGraph::Reset()
+{
+    resources.clear();
+    passes.clear();
+}
+
+} // namespace vex
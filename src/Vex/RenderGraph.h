@@ -0,0 +1,153 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <Vex/Buffer.h>
+#include <Vex/Containers/Span.h>
+#include <Vex/QueueType.h>
+#include <Vex/Synchronization.h>
+#include <Vex/Texture.h>
+#include <Vex/Types.h>
+#include <Vex/Utility/NonNullPtr.h>
+
+#include <RHI/RHIBarrier.h>
+
+namespace vex
+{
+
+class Graphics;
+class CommandContext;
+
+// Handle to a texture or buffer declared to a render graph, only valid for the graph which returned it.
+struct RenderGraphResource
+{
+    u32 index = std::numeric_limits<u32>::max();
+
+    [[nodiscard]] bool IsValid() const
+    {
+        return index != std::numeric_limits<u32>::max();
+    }
+
+    constexpr bool operator==(const RenderGraphResource&) const = default;
+};
+
+struct RenderGraphAccess
+{
+    RenderGraphResource resource;
+    // The synchronization scope of the access is deduced from the access and from the type of the pass.
+    RHIBarrierAccess access;
+};
+
+struct RenderGraphPassDesc
+{
+    std::string name;
+    // Type of work recorded by the pass. Compute passes are scheduled onto the async compute queue when it is enabled
+    // (see RenderGraph's constructor), otherwise they run on the graphics queue.
+    QueueType queue = QueueType::Graphics;
+    std::vector<RenderGraphAccess> reads;
+    std::vector<RenderGraphAccess> writes;
+    // Prevents the pass from being culled, for passes with side effects that are not declared to the graph.
+    bool neverCull = false;
+};
+
+// Records a frame as a list of passes which declare the resources they read and write. Upon execution the graph:
+// - culls the passes which do not contribute to an imported resource,
+// - groups the remaining passes into one command context per run of passes on the same queue, submitted with the
+//   dependencies required by the passes of the other queues,
+// - places the barriers between passes, beginning them as split barriers right after the previous access when
+//   other passes are recorded in between,
+// - hands the textures used by both the graphics and compute queues off between them,
+// - allocates the graph's textures as transient textures, aliasing their memory with the textures no longer used.
+// The graph must be recorded and executed from the thread which owns Graphics.
+class RenderGraph
+{
+public:
+    using ExecuteFunction = std::function<void(CommandContext& ctx, const RenderGraph& graph)>;
+
+    RenderGraph(NonNullPtr<Graphics> graphics, bool enableAsyncCompute = true);
+
+    // Imported resources outlive the graph, the passes writing to them are never culled.
+    RenderGraphResource ImportTexture(const Texture& texture);
+    RenderGraphResource ImportBuffer(const Buffer& buffer);
+
+    // Declares a resource owned by the graph, only created if a pass which is not culled uses it.
+    // Textures used by a single command context alias the memory of the other textures of that context, other resources
+    // are dynamic resources, valid until the end of the current frame.
+    RenderGraphResource CreateTexture(const TextureDesc& desc);
+    RenderGraphResource CreateBuffer(const BufferDesc& desc);
+
+    // Passes must be added in an order in which executing them sequentially is valid.
+    void AddPass(RenderGraphPassDesc desc, ExecuteFunction execute);
+
+    // Only valid during the execution of a pass using the resource.
+    [[nodiscard]] const Texture& GetTexture(RenderGraphResource resource) const;
+    [[nodiscard]] const Buffer& GetBuffer(RenderGraphResource resource) const;
+
+    // Records and submits the passes of the graph, the first submissions wait for the passed in dependencies.
+    // Returns the sync tokens of all submissions. The graph is empty afterwards and can be reused.
+    std::vector<SyncToken> Execute(Span<const SyncToken> dependencies = {});
+
+private:
+    struct ResourceEntry
+    {
+        std::variant<TextureDesc, BufferDesc> desc;
+        // Set upon import, or once the graph created the resource during execution.
+        std::optional<std::variant<Texture, Buffer>> resource;
+        bool isImported = false;
+    };
+
+    struct Pass
+    {
+        RenderGraphPassDesc desc;
+        ExecuteFunction execute;
+        // Queue the pass is scheduled onto.
+        QueueType queue = QueueType::Graphics;
+        bool isCulled = false;
+        // Index of the command context recording the pass.
+        u32 batchIndex = 0;
+        // Passes which must be done executing before this pass starts.
+        std::vector<u32> dependencies;
+    };
+
+    // Passes recorded into a single command context.
+    struct Batch
+    {
+        QueueType queue;
+        std::vector<u32> passes;
+        std::vector<u32> dependentBatches;
+    };
+
+    // Every access to a resource by the passes which are not culled, in execution order.
+    struct ResourceUsage
+    {
+        u32 passIndex;
+        RHIBarrierSync sync;
+        RHIBarrierAccess access;
+    };
+
+    void CullPasses();
+    void ComputeDependencies();
+    std::vector<Batch> ScheduleBatches();
+    void ExecuteBatch(CommandContext& ctx, const Batch& batch, const std::vector<std::vector<ResourceUsage>>& usages);
+
+    // Whether the resource is created by the graph in the command context using it, as opposed to a dynamic resource.
+    bool IsContextTransient(u32 resourceIndex, const std::vector<std::vector<ResourceUsage>>& usages) const;
+    // Whether the texture is handed off between the graphics and compute queues between both accesses, rather than
+    // being transitioned by the command context of the second access once it is submitted.
+    bool IsQueueHandoff(u32 resourceIndex, const ResourceUsage& usage, const ResourceUsage& nextUsage) const;
+
+    void Reset();
+
+    NonNullPtr<Graphics> graphics;
+    bool enableAsyncCompute;
+
+    std::vector<ResourceEntry> resources;
+    std::vector<Pass> passes;
+};
+
+} // namespace vex
@@ -20,6 +20,9 @@ enum class ResourceLifetime : u8
 {
     Static,  // Lives for many frames.
     Dynamic, // Is valid only for the current frame.
+    // Is valid only inside of the command context which created it, its memory aliases the memory of other transient
+    // resources (see CommandContext::CreateTransientTexture).
+    Transient,
 };
 
 enum class ResourceMemoryLocality : u8
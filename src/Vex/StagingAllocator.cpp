@@ -0,0 +1,79 @@
+#include "StagingAllocator.h"
+
+#include <utility>
+
+#include <Vex/Graphics.h>
+#include <Vex/RHIImpl/RHIBuffer.h>
+#include <Vex/Utility/ByteUtils.h>
+
+namespace vex
+{
+
+StagingAllocator::StagingAllocator(NonNullPtr<Graphics> graphics)
+    : graphics(graphics)
+{
+}
+
+StagingAllocator::~StagingAllocator()
+{
+    ReleasePages();
+}
+
+StagingAllocator::StagingAllocator(StagingAllocator&& other)
+    : graphics(other.graphics)
+    , pages(std::exchange(other.pages, {}))
+    , currentPageOffset(std::exchange(other.currentPageOffset, 0))
+{
+}
+
+StagingAllocator& StagingAllocator::operator=(StagingAllocator&& other)
+{
+    if (this != &other)
+    {
+        ReleasePages();
+        graphics = other.graphics;
+        pages = std::exchange(other.pages, {});
+        currentPageOffset = std::exchange(other.currentPageOffset, 0);
+    }
+    return *this;
+}
+
+std::optional<StagingAllocation> StagingAllocator::Allocate(u64 byteSize, u64 alignment)
+{
+    if (byteSize > PageByteSize)
+    {
+        return std::nullopt;
+    }
+
+    u64 offset = AlignUp<u64>(currentPageOffset, alignment);
+    if (pages.empty() || offset + byteSize > PageByteSize)
+    {
+        pages.push_back(graphics->AcquireStagingPage());
+        offset = 0;
+    }
+    currentPageOffset = offset + byteSize;
+
+    const Buffer& page = pages.back();
+    return StagingAllocation{
+        .buffer = page,
+        .offset = offset,
+        .mappedData = graphics->GetRHIBuffer(page.handle).GetMappedData().subspan(offset, byteSize),
+    };
+}
+
+std::vector<Buffer> StagingAllocator::ExtractPages()
+{
+    currentPageOffset = 0;
+    return std::exchange(pages, {});
+}
+
+void StagingAllocator::ReleasePages()
+{
+    // Pages are extracted on submission, the remaining ones were never submitted.
+    if (!pages.empty())
+    {
+        graphics->ReleaseStagingPages(ExtractPages());
+    }
+}
+
+} // namespace vex
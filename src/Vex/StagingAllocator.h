@@ -0,0 +1,57 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <Vex/Buffer.h>
+#include <Vex/Containers/Span.h>
+#include <Vex/Types.h>
+#include <Vex/Utility/NonNullPtr.h>
+
+namespace vex
+{
+
+class Graphics;
+
+struct StagingAllocation
+{
+    Buffer buffer;
+    u64 offset = 0;
+    // Persistently mapped memory of the allocation inside the buffer.
+    Span<byte> mappedData;
+};
+
+// Linearly sub-allocates upload memory from large persistently mapped staging pages, avoiding the creation of a staging
+// buffer per upload. Pages are shared by all command contexts: once a context is submitted its pages are handed back to
+// Graphics, which recycles them as soon as the GPU is done executing that submission. The pages of a context destroyed
+// without being submitted are handed back right away, the GPU never used them.
+class StagingAllocator
+{
+public:
+    static constexpr u64 PageByteSize = 4 * 1024 * 1024;
+
+    StagingAllocator(NonNullPtr<Graphics> graphics);
+    ~StagingAllocator();
+
+    StagingAllocator(const StagingAllocator&) = delete;
+    StagingAllocator& operator=(const StagingAllocator&) = delete;
+
+    StagingAllocator(StagingAllocator&& other);
+    StagingAllocator& operator=(StagingAllocator&& other);
+
+    // Returns std::nullopt for allocations larger than a page, these require a dedicated staging buffer.
+    // Can create a new page, which invalidates pointers to existing RHI buffers.
+    std::optional<StagingAllocation> Allocate(u64 byteSize, u64 alignment);
+
+    // Returns all pages used so far, leaving the allocator empty.
+    std::vector<Buffer> ExtractPages();
+
+private:
+    void ReleasePages();
+
+    NonNullPtr<Graphics> graphics;
+    std::vector<Buffer> pages;
+    u64 currentPageOffset = 0;
+};
+
+} // namespace vex
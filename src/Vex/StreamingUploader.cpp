@@ -0,0 +1,212 @@
+#include "StreamingUploader.h"
+
+#include <exception>
+#include <utility>
+
+#include <Vex/Graphics.h>
+#include <Vex/Utility/Visitor.h>
+
+namespace vex
+{
+
+StreamingUploader::RecordedBatch::RecordedBatch(Graphics& graphics)
+    : ctx(graphics.CreateCommandContext(QueueType::Copy))
+{
+}
+
+StreamingUploader::StreamingUploader(NonNullPtr<Graphics> graphics, u64 frameByteBudget)
+    : graphics(graphics)
+    , frameByteBudget(frameByteBudget)
+    , worker([this](std::stop_token stopToken) { WorkerLoop(std::move(stopToken)); })
+{
+}
+
+StreamingUploader::~StreamingUploader()
+{
+    worker.request_stop();
+    worker.join();
+
+    // The recorded command context must be submitted before being destroyed.
+    if (recordedBatch)
+    {
+        SubmitBatch(*recordedBatch, {});
+    }
+}
+
+std::future<SyncToken> StreamingUploader::EnqueueUpload(const Buffer& buffer,
+                                                        std::vector<byte> data,
+                                                        const BufferRegion& region)
+{
+    return EnqueueRequest({
+        .destination = BufferUpload{ .buffer = buffer, .region = region },
+        .data = std::move(data),
+    });
+}
+
+std::future<SyncToken> StreamingUploader::EnqueueUpload(const Texture& texture,
+                                                        std::vector<byte> packedData,
+                                                        std::vector<TextureRegion> textureRegions)
+{
+    return EnqueueRequest({
+        .destination = TextureUpload{ .texture = texture, .regions = std::move(textureRegions) },
+        .data = std::move(packedData),
+    });
+}
+
+std::optional<SyncToken> StreamingUploader::Flush(Span<const SyncToken> dependencies)
+{
+    // The worker thread only records the next batch once the recorded one is reset, it is left in place until it is
+    // submitted so that the worker does not use its command pool meanwhile.
+    RecordedBatch* batch;
+    {
+        std::scoped_lock lock(mutex);
+        batch = recordedBatch.get();
+    }
+    if (!batch)
+    {
+        return std::nullopt;
+    }
+
+    const SyncToken token = SubmitBatch(*batch, dependencies);
+    {
+        std::scoped_lock lock(mutex);
+        recordedBatch.reset();
+    }
+    workAvailable.notify_one();
+    return token;
+}
+
+std::vector<SyncToken> StreamingUploader::FlushAll(Span<const SyncToken> dependencies)
+{
+    std::vector<SyncToken> tokens;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            batchRecorded.wait(lock, [this] { return recordedBatch || (pendingRequests.empty() && !isRecording); });
+            if (!recordedBatch)
+            {
+                return tokens;
+            }
+        }
+        tokens.push_back(*Flush(dependencies));
+    }
+}
+
+u64 StreamingUploader::GetPendingByteSize() const
+{
+    std::scoped_lock lock(mutex);
+    return pendingByteSize;
+}
+
+std::future<SyncToken> StreamingUploader::EnqueueRequest(UploadRequest&& request)
+{
+    std::future<SyncToken> future = request.promise.get_future();
+    {
+        std::scoped_lock lock(mutex);
+        pendingByteSize += request.data.size();
+        pendingRequests.push_back(std::move(request));
+    }
+    workAvailable.notify_one();
+    return future;
+}
+
+void StreamingUploader::WorkerLoop(std::stop_token stopToken)
+{
+    while (true)
+    {
+        std::vector<UploadRequest> requests;
+        u64 batchByteSize = 0;
+        {
+            std::unique_lock lock(mutex);
+            workAvailable.wait(lock, stopToken, [this] { return !pendingRequests.empty() && !recordedBatch; });
+            if (stopToken.stop_requested())
+            {
+                return;
+            }
+
+            // Requests are recorded in order, up to the frame budget.
+            while (!pendingRequests.empty() &&
+                   (requests.empty() || batchByteSize + pendingRequests.front().data.size() <= frameByteBudget))
+            {
+                batchByteSize += pendingRequests.front().data.size();
+                requests.push_back(std::move(pendingRequests.front()));
+                pendingRequests.pop_front();
+            }
+            isRecording = true;
+        }
+
+        // Copying the data into staging memory is the costly part of an upload, it happens outside of the lock.
+        std::unique_ptr<RecordedBatch> batch;
+        try
+        {
+            batch = RecordBatch(requests, batchByteSize);
+        }
+        catch (...)
+        {
+            // The uploads of the batch are dropped, their callers receive the exception through their futures.
+            const std::exception_ptr exception = std::current_exception();
+            for (UploadRequest& request : requests)
+            {
+                request.promise.set_exception(exception);
+            }
+        }
+
+        {
+            std::scoped_lock lock(mutex);
+            if (batch)
+            {
+                recordedBatch = std::move(batch);
+            }
+            else
+            {
+                pendingByteSize -= batchByteSize;
+            }
+            isRecording = false;
+        }
+        batchRecorded.notify_all();
+    }
+}
+
+std::unique_ptr<StreamingUploader::RecordedBatch> StreamingUploader::RecordBatch(std::vector<UploadRequest>& requests,
+                                                                                  u64 batchByteSize)
+{
+    auto batch = std::make_unique<RecordedBatch>(*graphics);
+    batch->byteSize = batchByteSize;
+    for (UploadRequest& request : requests)
+    {
+        std::visit(Visitor{
+                       [&](const BufferUpload& upload)
+                       { batch->ctx.EnqueueDataUpload(upload.buffer, request.data, upload.region); },
+                       [&](const TextureUpload& upload)
+                       { batch->ctx.EnqueueDataUpload(upload.texture, request.data, upload.regions); },
+                   },
+                   request.destination);
+    }
+
+    // The context is closed on this thread, its command list is allocated from this thread's command pool.
+    batch->ctx.Close();
+
+    // Only taken once the batch is recorded, so that the promises can be given the exception of a failed recording.
+    batch->promises.reserve(requests.size());
+    for (UploadRequest& request : requests)
+    {
+        batch->promises.push_back(std::move(request.promise));
+    }
+    return batch;
+}
+
+SyncToken StreamingUploader::SubmitBatch(RecordedBatch& batch, Span<const SyncToken> dependencies)
+{
+    const SyncToken token = graphics->Submit(batch.ctx, dependencies);
+    for (std::promise<SyncToken>& promise : batch.promises)
+    {
+        promise.set_value(token);
+    }
+
+    std::scoped_lock lock(mutex);
+    pendingByteSize -= batch.byteSize;
+    return token;
+}
+
+} // namespace vex
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <Vex/Buffer.h>
+#include <Vex/CommandContext.h>
+#include <Vex/Containers/Span.h>
+#include <Vex/Synchronization.h>
+#include <Vex/Texture.h>
+#include <Vex/Types.h>
+#include <Vex/Utility/NonNullPtr.h>
+
+namespace vex
+{
+
+class Graphics;
+
+// Streams data into buffers and textures through the copy queue, without stalling the queues rendering the frame.
+// Uploads can be enqueued from any thread. A worker thread records them into copy command contexts, in batches of at
+// most the per-frame byte budget (a single upload larger than the budget is recorded on its own). Flush submits at
+// most one recorded batch, it must be called from the thread which submits to Graphics, typically once per frame.
+// Work using an uploaded resource must depend on the sync token returned for its upload.
+class StreamingUploader
+{
+public:
+    static constexpr u64 DefaultFrameByteBudget = 32 * 1024 * 1024;
+
+    StreamingUploader(NonNullPtr<Graphics> graphics, u64 frameByteBudget = DefaultFrameByteBudget);
+    // Must be destroyed from the thread which submits to Graphics. The batch already recorded is submitted, the uploads
+    // which were not recorded yet are discarded and their futures report a broken promise.
+    ~StreamingUploader();
+
+    StreamingUploader(const StreamingUploader&) = delete;
+    StreamingUploader& operator=(const StreamingUploader&) = delete;
+    StreamingUploader(StreamingUploader&&) = delete;
+    StreamingUploader& operator=(StreamingUploader&&) = delete;
+
+    // The returned future holds the token of the submission performing the upload once it is submitted, or the
+    // exception raised while recording it.
+    std::future<SyncToken> EnqueueUpload(const Buffer& buffer,
+                                         std::vector<byte> data,
+                                         const BufferRegion& region = BufferRegion::FullBuffer());
+    // The regions should match the layout of the tightly packed data, as for CommandContext::EnqueueDataUpload.
+    std::future<SyncToken> EnqueueUpload(const Texture& texture,
+                                         std::vector<byte> packedData,
+                                         std::vector<TextureRegion> textureRegions = { TextureRegion::AllMips() });
+
+    // Submits the next recorded batch of uploads, if any, after the passed in dependencies.
+    std::optional<SyncToken> Flush(Span<const SyncToken> dependencies = {});
+    // Blocks until all uploads enqueued so far are recorded, submitting them regardless of the frame budget.
+    std::vector<SyncToken> FlushAll(Span<const SyncToken> dependencies = {});
+
+    // Byte size of the uploads which are not yet submitted.
+    [[nodiscard]] u64 GetPendingByteSize() const;
+
+private:
+    struct BufferUpload
+    {
+        Buffer buffer;
+        BufferRegion region;
+    };
+    struct TextureUpload
+    {
+        Texture texture;
+        std::vector<TextureRegion> regions;
+    };
+    struct UploadRequest
+    {
+        std::variant<BufferUpload, TextureUpload> destination;
+        std::vector<byte> data;
+        std::promise<SyncToken> promise;
+    };
+
+    // Held behind a pointer, as moving a command context which is still open is not allowed.
+    struct RecordedBatch
+    {
+        RecordedBatch(Graphics& graphics);
+
+        CommandContext ctx;
+        u64 byteSize = 0;
+        std::vector<std::promise<SyncToken>> promises;
+    };
+
+    std::future<SyncToken> EnqueueRequest(UploadRequest&& request);
+    void WorkerLoop(std::stop_token stopToken);
+    // Records the requests into a closed command context, called from the worker thread.
+    std::unique_ptr<RecordedBatch> RecordBatch(std::vector<UploadRequest>& requests, u64 batchByteSize);
+    SyncToken SubmitBatch(RecordedBatch& batch, Span<const SyncToken> dependencies);
+
+    NonNullPtr<Graphics> graphics;
+    u64 frameByteBudget;
+
+    mutable std::mutex mutex;
+    // Signals the worker thread that requests are pending, or that the recorded batch was submitted.
+    std::condition_variable_any workAvailable;
+    // Signals the submitting thread that a batch was recorded.
+    std::condition_variable batchRecorded;
+    std::deque<UploadRequest> pendingRequests;
+    // Only one batch is recorded ahead of its submission, which bounds the staging memory held by the uploader. Reset
+    // once submitted.
+    std::unique_ptr<RecordedBatch> recordedBatch;
+    bool isRecording = false;
+    u64 pendingByteSize = 0;
+
+    // Declared last, so that the worker thread is stopped before the members it uses are destroyed.
+    std::jthread worker;
+};
+
+} // namespace vex
@@ -0,0 +1,64 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace vex
+{
+
+ThreadPool::ThreadPool(u32 threadCount)
+{
+    threadCount = std::max(threadCount, 1u);
+    workers.reserve(threadCount);
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock(mutex);
+        isStopping = true;
+    }
+    taskAvailable.notify_all();
+    // jthreads join upon destruction.
+    workers.clear();
+}
+
+void ThreadPool::Enqueue(MoveOnlyFunction<void()>&& task)
+{
+    {
+        std::scoped_lock lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+u32 ThreadPool::GetDefaultThreadCount()
+{
+    const u32 hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        MoveOnlyFunction<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            taskAvailable.wait(lock, [this] { return isStopping || !tasks.empty(); });
+            // Pending tasks are drained before stopping, this guarantees all returned futures are eventually satisfied.
+            if (tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace vex
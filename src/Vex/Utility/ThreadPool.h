@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <Vex/Types.h>
+#include <Vex/Utility/MoveOnlyFunction.h>
+
+namespace vex
+{
+
+// Simple fixed-size pool of worker threads consuming tasks in FIFO order.
+// Tasks still pending when the pool is destroyed are executed before the worker threads are joined.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(u32 threadCount = GetDefaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // Enqueues a task to be executed on one of the worker threads.
+    void Enqueue(MoveOnlyFunction<void()>&& task);
+
+    // Enqueues a task to be executed on one of the worker threads, the returned future will contain the task's result.
+    template <class F>
+        requires std::is_invocable_v<F>
+    std::future<std::invoke_result_t<F>> Submit(F&& func)
+    {
+        std::packaged_task<std::invoke_result_t<F>()> task(std::forward<F>(func));
+        std::future<std::invoke_result_t<F>> future = task.get_future();
+        Enqueue([task = std::move(task)]() mutable { task(); });
+        return future;
+    }
+
+    [[nodiscard]] u32 GetThreadCount() const
+    {
+        return static_cast<u32>(workers.size());
+    }
+
+    // Leaves one hardware thread for the thread that owns the pool.
+    static u32 GetDefaultThreadCount();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::jthread> workers;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::deque<MoveOnlyFunction<void()>> tasks;
+    bool isStopping = false;
+};
+
+} // namespace vex
@@ -68,6 +68,41 @@ VkAccelerationStructure::VkAccelerationStructure(NonNullPtr<VkGPUContext> ctx, c
 
 const RHIAccelerationStructureBuildInfo& VkAccelerationStructure::SetupBLASBuild(RHIAllocator& allocator,
                                                                                  const RHIBLASBuildDesc& desc)
+{
+    InitBLASGeometry(desc);
+    BuildAccelerationStructure(::vk::AccelerationStructureTypeKHR::eBottomLevel, allocator);
+
+    return prebuildInfo;
+}
+
+const RHIAccelerationStructureBuildInfo& VkAccelerationStructure::SetupTLASBuild(RHIAllocator& allocator,
+                                                                                 const RHITLASBuildDesc& desc)
+{
+    InitTLASGeometry(desc);
+    BuildAccelerationStructure(::vk::AccelerationStructureTypeKHR::eTopLevel, allocator);
+
+    return prebuildInfo;
+}
+
+void VkAccelerationStructure::SetupBLASUpdate(const RHIBLASBuildDesc& desc)
+{
+    VEX_ASSERT(vkAccelerationStructure, "Cannot update an acceleration structure which was never built!");
+    const std::vector<u32> builtGeometryCount = geometryCount;
+    InitBLASGeometry(desc);
+    VEX_ASSERT(geometryCount == builtGeometryCount,
+               "Cannot update a BLAS with different geometry or primitive counts than the ones it was built with.");
+}
+
+void VkAccelerationStructure::SetupTLASUpdate(const RHITLASBuildDesc& desc)
+{
+    VEX_ASSERT(vkAccelerationStructure, "Cannot update an acceleration structure which was never built!");
+    const std::vector<u32> builtGeometryCount = geometryCount;
+    InitTLASGeometry(desc);
+    VEX_ASSERT(geometryCount == builtGeometryCount,
+               "Cannot update a TLAS with a different instance count than the one it was built with.");
+}
+
+void VkAccelerationStructure::InitBLASGeometry(const RHIBLASBuildDesc& desc)
 {
     geometries.clear();
     ranges.clear();
@@ -162,14 +197,9 @@ const RHIAccelerationStructureBuildInfo& VkAccelerationStructure::SetupBLASBuild
 
         geometries.push_back(geometry);
     }
-
-    BuildAccelerationStructure(::vk::AccelerationStructureTypeKHR::eBottomLevel, allocator);
-
-    return prebuildInfo;
 }
 
-const RHIAccelerationStructureBuildInfo& VkAccelerationStructure::SetupTLASBuild(RHIAllocator& allocator,
-                                                                                 const RHITLASBuildDesc& desc)
+void VkAccelerationStructure::InitTLASGeometry(const RHITLASBuildDesc& desc)
 {
     geometries.clear();
     ranges.clear();
@@ -192,10 +222,20 @@ const RHIAccelerationStructureBuildInfo& VkAccelerationStructure::SetupTLASBuild
         .primitiveOffset = 0,
     });
     geometryCount.push_back(primitiveCount);
+}
 
-    BuildAccelerationStructure(::vk::AccelerationStructureTypeKHR::eTopLevel, allocator);
+void VkAccelerationStructure::SetupCompaction(RHIAllocator& allocator, u64 compactedByteSize)
+{
+    VEX_ASSERT(!vkAccelerationStructure, "Cannot call setup when the acceleration structure is already setup!");
 
-    return prebuildInfo;
+    geometries.clear();
+    ranges.clear();
+    geometryCount.clear();
+
+    CreateAccelerationStructure(GetDesc().type == ASType::BottomLevel ? ::vk::AccelerationStructureTypeKHR::eBottomLevel
+                                                                      : ::vk::AccelerationStructureTypeKHR::eTopLevel,
+                                allocator,
+                                compactedByteSize);
 }
 
 std::vector<std::byte> VkAccelerationStructure::GetInstanceBufferData(const RHITLASBuildDesc& desc)
@@ -260,12 +300,19 @@ void VkAccelerationStructure::BuildAccelerationStructure(::vk::AccelerationStruc
     prebuildInfo = {
         .asByteSize = asBuildSize.accelerationStructureSize,
         .scratchByteSize = AlignUp(static_cast<u32>(asBuildSize.buildScratchSize), minASscratchAlignment),
-        .updateScratchByteSize = asBuildSize.updateScratchSize,
+        .updateScratchByteSize = AlignUp(static_cast<u32>(asBuildSize.updateScratchSize), minASscratchAlignment),
     };
 
+    CreateAccelerationStructure(type, allocator, prebuildInfo.asByteSize);
+}
+
+void VkAccelerationStructure::CreateAccelerationStructure(::vk::AccelerationStructureTypeKHR type,
+                                                          RHIAllocator& allocator,
+                                                          u64 byteSize)
+{
     BufferDesc asBufferDesc{
         .name = GetDesc().name,
-        .byteSize = prebuildInfo.asByteSize,
+        .byteSize = byteSize,
         .usage = BufferUsage::AccelerationStructure,
         .memoryLocality = ResourceMemoryLocality::GPUOnly,
     };
@@ -273,7 +320,7 @@ void VkAccelerationStructure::BuildAccelerationStructure(::vk::AccelerationStruc
 
     ::vk::AccelerationStructureCreateInfoKHR asCreateInfo{
         .buffer = accelerationStructure->GetNativeBuffer(),
-        .size = asBuildSize.accelerationStructureSize,
+        .size = byteSize,
         .type = type,
     };
     vkAccelerationStructure = VEX_VK_CHECK <<= ctx->device.createAccelerationStructureKHRUnique(asCreateInfo);
@@ -14,6 +14,11 @@ public:
     virtual const RHIAccelerationStructureBuildInfo& SetupTLASBuild(RHIAllocator& allocator,
                                                                     const RHITLASBuildDesc& desc) override;
 
+    virtual void SetupBLASUpdate(const RHIBLASBuildDesc& desc) override;
+    virtual void SetupTLASUpdate(const RHITLASBuildDesc& desc) override;
+
+    virtual void SetupCompaction(RHIAllocator& allocator, u64 compactedByteSize) override;
+
     virtual std::vector<std::byte> GetInstanceBufferData(const RHITLASBuildDesc& desc) override;
     virtual u32 GetInstanceBufferStride() override;
 
@@ -26,7 +31,10 @@ public:
 
     ::vk::DeviceAddress GetNativeAddress();
 
+    void InitBLASGeometry(const RHIBLASBuildDesc& desc);
+    void InitTLASGeometry(const RHITLASBuildDesc& desc);
     void BuildAccelerationStructure(::vk::AccelerationStructureTypeKHR type, RHIAllocator& allocator);
+    void CreateAccelerationStructure(::vk::AccelerationStructureTypeKHR type, RHIAllocator& allocator, u64 byteSize);
 };
 
 ::vk::GeometryInstanceFlagsKHR ASInstanceFlagsToVkGeometryInstanceFlags(ASInstance::Flags flags);
@@ -85,13 +85,15 @@ VkAllocator::~VkAllocator()
 }
 
 std::pair<::vk::DeviceMemory, Allocation> VkAllocator::AllocateResource(ResourceMemoryLocality memLocality,
-                                                                        const ::vk::MemoryRequirements& memoryRequs)
+                                                                        const ::vk::MemoryRequirements& memoryRequs,
+                                                                        ResourceLifetime lifetime,
+                                                                        TransientMemoryPool* transientPool)
 {
     ::vk::MemoryPropertyFlags memPropFlags = AllocatorUtils::GetMemoryPropsFromLocality(memLocality);
     u32 memoryTypeIndex =
         AllocatorUtils::GetBestSuitedMemoryTypeIndex(ctx->physDevice, memoryRequs.memoryTypeBits, memPropFlags);
 
-    Allocation alloc = Allocate(memoryRequs.size, memoryRequs.alignment, memoryTypeIndex);
+    Allocation alloc = Allocate(memoryRequs.size, memoryRequs.alignment, memoryTypeIndex, lifetime, transientPool);
     ::vk::DeviceMemory memory = memoryPagesByType[memoryTypeIndex].at(alloc.pageHandle).first;
     return { memory, alloc };
 }
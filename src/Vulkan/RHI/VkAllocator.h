@@ -10,6 +10,7 @@
 namespace vex
 {
 enum class ResourceMemoryLocality : u8;
+enum class ResourceLifetime : u8;
 }
 
 namespace vex::vk
@@ -32,7 +33,9 @@ public:
     ~VkAllocator();
 
     std::pair<::vk::DeviceMemory, Allocation> AllocateResource(ResourceMemoryLocality type,
-                                                               const ::vk::MemoryRequirements& memoryRequs);
+                                                               const ::vk::MemoryRequirements& memoryRequs,
+                                                               ResourceLifetime lifetime = ResourceLifetime::Static,
+                                                               TransientMemoryPool* transientPool = nullptr);
     void FreeResource(const Allocation& alloc);
 
     ::vk::DeviceMemory GetMemoryFromAllocation(const Allocation& allocation);
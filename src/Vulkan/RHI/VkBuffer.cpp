@@ -52,8 +52,11 @@ static ::vk::BufferUsageFlags GetVkBufferUsageFromDesc(const BufferDesc& desc)
     return flags;
 }
 
-VkBuffer::VkBuffer(NonNullPtr<VkGPUContext> ctx, VkAllocator& allocator, const BufferDesc& desc)
-    : RHIBufferBase{ allocator, desc }
+VkBuffer::VkBuffer(NonNullPtr<VkGPUContext> ctx,
+                   VkAllocator& allocator,
+                   const BufferDesc& desc,
+                   ResourceLifetime lifetime)
+    : RHIBufferBase{ allocator, desc, lifetime }
     , ctx{ ctx }
 {
     auto bufferUsage = GetVkBufferUsageFromDesc(desc);
@@ -77,7 +80,7 @@ VkBuffer::VkBuffer(NonNullPtr<VkGPUContext> ctx, VkAllocator& allocator, const B
     const ::vk::MemoryRequirements reqs = ctx->device.getBufferMemoryRequirements(*buffer);
 
 #if VEX_USE_CUSTOM_RESOURCE_ALLOCATOR
-    auto [memory, newAllocation] = allocator.AllocateResource(desc.memoryLocality, reqs);
+    auto [memory, newAllocation] = allocator.AllocateResource(desc.memoryLocality, reqs, lifetime);
     allocation = newAllocation;
     VEX_VK_CHECK << ctx->device.bindBufferMemory(*buffer, memory, allocation.memoryRange.offset);
 #else
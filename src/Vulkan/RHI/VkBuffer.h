@@ -21,7 +21,10 @@ struct VkDirectBufferMemory;
 class VkBuffer final : public RHIBufferBase
 {
 public:
-    VkBuffer(NonNullPtr<VkGPUContext> ctx, VkAllocator& allocator, const BufferDesc& desc);
+    VkBuffer(NonNullPtr<VkGPUContext> ctx,
+             VkAllocator& allocator,
+             const BufferDesc& desc,
+             ResourceLifetime lifetime = ResourceLifetime::Static);
 
     void AllocateBindlessHandle(RHIDescriptorPool& descriptorPool,
                                 BindlessHandle handle,
@@ -1,7 +1,9 @@
 ﻿#include "VkCommandList.h"
 
 #include <algorithm>
+#include <optional>
 #include <ranges>
+#include <vector>
 
 #include <Vex/Bindings.h>
 #include <Vex/DrawHelpers.h>
@@ -74,12 +76,120 @@ static std::vector<::vk::BufferImageCopy> GetBufferImageCopyFromBufferToImageDes
     return regions;
 }
 
+// Barriers folded into the structures expected by Vulkan, the dependency info points into this struct.
+struct BarrierDependency
+{
+    std::vector<::vk::ImageMemoryBarrier2> imageBarriers;
+    std::optional<::vk::MemoryBarrier2> memoryBarrier;
+
+    ::vk::DependencyInfo GetDependencyInfo() const
+    {
+        return {
+            .memoryBarrierCount = memoryBarrier.has_value() ? 1u : 0u,
+            .pMemoryBarriers = memoryBarrier.has_value() ? &*memoryBarrier : nullptr,
+            .imageMemoryBarrierCount = static_cast<u32>(imageBarriers.size()),
+            .pImageMemoryBarriers = imageBarriers.data(),
+        };
+    }
+};
+
+static BarrierDependency GetBarrierDependency(Span<const RHIBufferBarrier> bufferBarriers,
+                                              Span<const RHITextureBarrier> textureBarriers,
+                                              Span<const RHIGlobalBarrier> globalBarriers)
+{
+    ::vk::PipelineStageFlags2 srcSyncMask;
+    ::vk::PipelineStageFlags2 dstSyncMask;
+    ::vk::AccessFlags2 srcAccessMask;
+    ::vk::AccessFlags2 dstAccessMask;
+
+    BarrierDependency dependency;
+    dependency.imageBarriers.reserve(textureBarriers.size());
+
+    for (const auto& tb : textureBarriers)
+    {
+        const TextureDesc& desc = tb.texture->GetDesc();
+        // Unified Image Layouts allows us to only consider a few image transitions.
+        // We only need to emit an image barrier when: eUndefined<->eGeneral<->ePresentSrcKHR
+        const bool isFullResource = tb.subresource.IsFullResource(desc);
+        const ::vk::ImageLayout oldLayout = RHITextureLayoutToVulkan(tb.srcLayout);
+        const ::vk::ImageLayout newLayout = RHITextureLayoutToVulkan(tb.dstLayout);
+        const bool needsLayoutTransition = oldLayout != newLayout;
+
+        if (!isFullResource || needsLayoutTransition)
+        {
+            ::vk::ImageMemoryBarrier2 ib;
+            ib.srcStageMask = (tb.texture->IsBackBufferTexture() && oldLayout == ::vk::ImageLayout::eUndefined)
+                                  ? ::vk::PipelineStageFlagBits2::eColorAttachmentOutput
+                                  : RHIBarrierSyncToVulkan(tb.srcSync);
+            ib.dstStageMask = RHIBarrierSyncToVulkan(tb.dstSync);
+            ib.srcAccessMask = RHIBarrierAccessToVulkan(tb.srcAccess);
+            ib.dstAccessMask = RHIBarrierAccessToVulkan(tb.dstAccess);
+            ib.oldLayout = oldLayout;
+            ib.newLayout = newLayout;
+            ib.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            ib.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            ib.image = tb.texture->GetRawTexture();
+            ib.subresourceRange = {
+                .aspectMask = VkTextureUtil::GetFormatAspectFlags(desc.format),
+                .baseMipLevel = tb.subresource.startMip,
+                .levelCount = tb.subresource.GetMipCount(desc),
+                .baseArrayLayer = tb.subresource.startSlice,
+                .layerCount = tb.subresource.GetSliceCount(desc),
+            };
+            dependency.imageBarriers.push_back(std::move(ib));
+        }
+        else
+        {
+            // UIL fast path: no layout transition, just fold into memory barrier.
+            srcSyncMask |= RHIBarrierSyncToVulkan(tb.srcSync);
+            dstSyncMask |= RHIBarrierSyncToVulkan(tb.dstSync);
+            srcAccessMask |= RHIBarrierAccessToVulkan(tb.srcAccess);
+            dstAccessMask |= RHIBarrierAccessToVulkan(tb.dstAccess);
+        }
+    }
+
+    // Buffers and global barriers always fold into memory barrier.
+    for (const auto& bb : bufferBarriers)
+    {
+        srcSyncMask |= RHIBarrierSyncToVulkan(bb.srcSync);
+        dstSyncMask |= RHIBarrierSyncToVulkan(bb.dstSync);
+        srcAccessMask |= RHIBarrierAccessToVulkan(bb.srcAccess);
+        dstAccessMask |= RHIBarrierAccessToVulkan(bb.dstAccess);
+    }
+    for (const auto& gb : globalBarriers)
+    {
+        srcSyncMask |= RHIBarrierSyncToVulkan(gb.srcSync);
+        dstSyncMask |= RHIBarrierSyncToVulkan(gb.dstSync);
+        srcAccessMask |= RHIBarrierAccessToVulkan(gb.srcAccess);
+        dstAccessMask |= RHIBarrierAccessToVulkan(gb.dstAccess);
+    }
+    if (srcSyncMask || dstSyncMask || srcAccessMask || dstAccessMask)
+    {
+        dependency.memoryBarrier = ::vk::MemoryBarrier2{
+            .srcStageMask = srcSyncMask,
+            .srcAccessMask = srcAccessMask,
+            .dstStageMask = dstSyncMask,
+            .dstAccessMask = dstAccessMask,
+        };
+    }
+
+    return dependency;
+}
+
 } // namespace CommandList_Internal
 
 void VkCommandList::Open()
 {
     VEX_VK_CHECK << commandBuffer->reset();
 
+    // The GPU is done with the previous recording, its split barrier events can be reused.
+    for (u32 i = 0; i < usedSplitBarrierEventCount; ++i)
+    {
+        VEX_VK_CHECK << ctx->device.resetEvent(*splitBarrierEvents[i]);
+    }
+    usedSplitBarrierEventCount = 0;
+    compactedSizeQueryPools.clear();
+
     constexpr ::vk::CommandBufferBeginInfo beginInfo{};
     VEX_VK_CHECK << commandBuffer->begin(beginInfo);
 
@@ -132,9 +242,8 @@ void VkCommandList::SetPipelineState(const RHIRayTracingPipelineState& rayTracin
     commandBuffer->bindPipeline(::vk::PipelineBindPoint::eRayTracingKHR, *rayTracingPipelineState.rtPipeline);
 }
 
-void VkCommandList::SetLayout(RHIResourceLayout& layout)
+void VkCommandList::SetLayout(RHIResourceLayout& layout, Span<const byte> localConstantsData)
 {
-    Span<const byte> localConstantsData = layout.GetLocalConstantsData();
     if (localConstantsData.empty())
     {
         return;
@@ -149,6 +258,12 @@ void VkCommandList::SetLayout(RHIResourceLayout& layout)
 
 void VkCommandList::SetDescriptorPool(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout)
 {
+    if (ctx->useDescriptorBuffer)
+    {
+        SetDescriptorBuffer(descriptorPool, resourceLayout);
+        return;
+    }
+
     const std::array descriptorSets{ *descriptorPool.bindlessSet->descriptorSet,
                                      resourceLayout.GetStaticSamplerDescriptorSet() };
     switch (type)
@@ -183,6 +298,42 @@ void VkCommandList::SetDescriptorPool(RHIDescriptorPool& descriptorPool, RHIReso
     }
 }
 
+void VkCommandList::SetDescriptorBuffer(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout)
+{
+    const VkBindlessDescriptorSet::DescriptorBuffer& descriptorBuffer = descriptorPool.bindlessSet->descriptorBuffer;
+    const ::vk::DescriptorBufferBindingInfoEXT bindingInfo{
+        .address = descriptorBuffer.address,
+        .usage = ::vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+                 ::vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT,
+    };
+    commandBuffer->bindDescriptorBuffersEXT(bindingInfo);
+
+    // The bindless set points to the start of the only bound descriptor buffer, the static samplers are embedded in
+    // the layout of the second set.
+    const ::vk::PipelineLayout pipelineLayout = resourceLayout.GetPipelineLayout();
+    const u32 bufferIndex = 0;
+    const ::vk::DeviceSize bufferOffset = 0;
+    auto BindDescriptors = [&](::vk::PipelineBindPoint bindPoint)
+    {
+        commandBuffer->setDescriptorBufferOffsetsEXT(bindPoint, pipelineLayout, 0, bufferIndex, bufferOffset);
+        commandBuffer->bindDescriptorBufferEmbeddedSamplersEXT(bindPoint, pipelineLayout, 1);
+    };
+
+    switch (type)
+    {
+    case QueueTypes::Graphics:
+        BindDescriptors(::vk::PipelineBindPoint::eGraphics);
+        [[fallthrough]];
+    case QueueTypes::Compute:
+        BindDescriptors(::vk::PipelineBindPoint::eCompute);
+        BindDescriptors(::vk::PipelineBindPoint::eRayTracingKHR);
+        break;
+    default:
+        VEX_ASSERT(false, "Operation not supported on this queue type");
+        break;
+    }
+}
+
 void VkCommandList::SetInputAssembly(InputAssembly inputAssembly)
 {
     commandBuffer->setPrimitiveRestartEnable(inputAssembly.primitiveRestartEnabled);
@@ -298,87 +449,38 @@ void VkCommandList::EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
                                  Span<const RHITextureBarrier> textureBarriers,
                                  Span<const RHIGlobalBarrier> globalBarriers)
 {
-    ::vk::PipelineStageFlags2 srcSyncMask;
-    ::vk::PipelineStageFlags2 dstSyncMask;
-    ::vk::AccessFlags2 srcAccessMask;
-    ::vk::AccessFlags2 dstAccessMask;
+    const CommandList_Internal::BarrierDependency dependency =
+        CommandList_Internal::GetBarrierDependency(bufferBarriers, textureBarriers, globalBarriers);
+    commandBuffer->pipelineBarrier2(dependency.GetDependencyInfo());
+}
 
-    std::vector<::vk::ImageMemoryBarrier2> imageBarriers;
-    imageBarriers.reserve(textureBarriers.size());
+u32 VkCommandList::BeginSplitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                      Span<const RHITextureBarrier> textureBarriers)
+{
+    VEX_ASSERT(!isRendering, "Split barriers cannot be begun while rendering.");
 
-    for (const auto& tb : textureBarriers)
+    if (usedSplitBarrierEventCount == splitBarrierEvents.size())
     {
-        const TextureDesc& desc = tb.texture->GetDesc();
-        // Unified Image Layouts allows us to only consider a few image transitions.
-        // We only need to emit an image barrier when: eUndefined<->eGeneral<->ePresentSrcKHR
-        const bool isFullResource = tb.subresource.IsFullResource(desc);
-        const ::vk::ImageLayout oldLayout = RHITextureLayoutToVulkan(tb.srcLayout);
-        const ::vk::ImageLayout newLayout = RHITextureLayoutToVulkan(tb.dstLayout);
-        const bool needsLayoutTransition = oldLayout != newLayout;
-
-        if (!isFullResource || needsLayoutTransition)
-        {
-            ::vk::ImageMemoryBarrier2 ib;
-            ib.srcStageMask = (tb.texture->IsBackBufferTexture() && oldLayout == ::vk::ImageLayout::eUndefined)
-                                  ? ::vk::PipelineStageFlagBits2::eColorAttachmentOutput
-                                  : RHIBarrierSyncToVulkan(tb.srcSync);
-            ib.dstStageMask = RHIBarrierSyncToVulkan(tb.dstSync);
-            ib.srcAccessMask = RHIBarrierAccessToVulkan(tb.srcAccess);
-            ib.dstAccessMask = RHIBarrierAccessToVulkan(tb.dstAccess);
-            ib.oldLayout = oldLayout;
-            ib.newLayout = newLayout;
-            ib.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            ib.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            ib.image = tb.texture->GetRawTexture();
-            ib.subresourceRange = {
-                .aspectMask = VkTextureUtil::GetFormatAspectFlags(desc.format),
-                .baseMipLevel = tb.subresource.startMip,
-                .levelCount = tb.subresource.GetMipCount(desc),
-                .baseArrayLayer = tb.subresource.startSlice,
-                .layerCount = tb.subresource.GetSliceCount(desc),
-            };
-            imageBarriers.push_back(std::move(ib));
-        }
-        else
-        {
-            // UIL fast path: no layout transition, just fold into memory barrier.
-            srcSyncMask |= RHIBarrierSyncToVulkan(tb.srcSync);
-            dstSyncMask |= RHIBarrierSyncToVulkan(tb.dstSync);
-            srcAccessMask |= RHIBarrierAccessToVulkan(tb.srcAccess);
-            dstAccessMask |= RHIBarrierAccessToVulkan(tb.dstAccess);
-        }
+        splitBarrierEvents.push_back(VEX_VK_CHECK <<= ctx->device.createEventUnique({}));
     }
+    const u32 splitBarrierIndex = usedSplitBarrierEventCount++;
 
-    // Buffers and global barriers always fold into memory barrier.
-    for (const auto& bb : bufferBarriers)
-    {
-        srcSyncMask |= RHIBarrierSyncToVulkan(bb.srcSync);
-        dstSyncMask |= RHIBarrierSyncToVulkan(bb.dstSync);
-        srcAccessMask |= RHIBarrierAccessToVulkan(bb.srcAccess);
-        dstAccessMask |= RHIBarrierAccessToVulkan(bb.dstAccess);
-    }
-    for (const auto& gb : globalBarriers)
-    {
-        srcSyncMask |= RHIBarrierSyncToVulkan(gb.srcSync);
-        dstSyncMask |= RHIBarrierSyncToVulkan(gb.dstSync);
-        srcAccessMask |= RHIBarrierAccessToVulkan(gb.srcAccess);
-        dstAccessMask |= RHIBarrierAccessToVulkan(gb.dstAccess);
-    }
-    const bool useMemoryBarrier = srcSyncMask || dstSyncMask || srcAccessMask || dstAccessMask;
-    ::vk::MemoryBarrier2 memoryBarrier{
-        .srcStageMask = srcSyncMask,
-        .srcAccessMask = srcAccessMask,
-        .dstStageMask = dstSyncMask,
-        .dstAccessMask = dstAccessMask,
-    };
+    const CommandList_Internal::BarrierDependency dependency =
+        CommandList_Internal::GetBarrierDependency(bufferBarriers, textureBarriers, {});
+    commandBuffer->setEvent2(*splitBarrierEvents[splitBarrierIndex], dependency.GetDependencyInfo());
+    return splitBarrierIndex;
+}
 
-    ::vk::DependencyInfo info{
-        .memoryBarrierCount = useMemoryBarrier ? 1u : 0u,
-        .pMemoryBarriers = useMemoryBarrier ? &memoryBarrier : nullptr,
-        .imageMemoryBarrierCount = static_cast<u32>(imageBarriers.size()),
-        .pImageMemoryBarriers = imageBarriers.data(),
-    };
-    commandBuffer->pipelineBarrier2(info);
+void VkCommandList::EndSplitBarriers(u32 splitBarrierIndex,
+                                     Span<const RHIBufferBarrier> bufferBarriers,
+                                     Span<const RHITextureBarrier> textureBarriers)
+{
+    VEX_ASSERT(splitBarrierIndex < usedSplitBarrierEventCount, "Invalid split barrier index.");
+
+    // Vulkan requires the wait to use the same dependency info as the one used to set the event.
+    const CommandList_Internal::BarrierDependency dependency =
+        CommandList_Internal::GetBarrierDependency(bufferBarriers, textureBarriers, {});
+    commandBuffer->waitEvents2(*splitBarrierEvents[splitBarrierIndex], dependency.GetDependencyInfo());
 }
 
 void VkCommandList::BeginRendering(const RHIDrawResources& resources)
@@ -447,37 +549,57 @@ void VkCommandList::EndRendering()
 
 void VkCommandList::Draw(u32 vertexCount, u32 instanceCount, u32 vertexOffset, u32 instanceOffset)
 {
-    if (!cachedViewport || !cachedScissor)
-    {
-        VEX_LOG(Fatal, "SetScissor and SetViewport need to be called before Draw is ever called")
-    }
-
-    if (!isRendering)
-    {
-        VEX_LOG(Fatal, "You need to call BeginRendering before calling any draw commands")
-    }
-
-    commandBuffer->setViewportWithCount(1, &*cachedViewport);
-    commandBuffer->setScissorWithCount(1, &*cachedScissor);
+    PrepareDraw();
     commandBuffer->draw(vertexCount, instanceCount, vertexOffset, instanceOffset);
 }
 
 void VkCommandList::DrawIndexed(
     u32 indexCount, u32 instanceCount, u32 indexOffset, u32 vertexOffset, u32 instanceOffset)
 {
-    if (!cachedViewport || !cachedScissor)
+    PrepareDraw();
+    commandBuffer->drawIndexed(indexCount, instanceCount, indexOffset, vertexOffset, instanceOffset);
+}
+
+void VkCommandList::DrawIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    PrepareDraw();
+    if (indirectArgs.countBuffer)
     {
-        VEX_LOG(Fatal, "SetScissor and SetViewport need to be called before Draw is ever called")
+        commandBuffer->drawIndirectCount(indirectArgs.argsBuffer->GetNativeBuffer(),
+                                         indirectArgs.argsOffsetByteSize,
+                                         indirectArgs.countBuffer->GetNativeBuffer(),
+                                         indirectArgs.countOffsetByteSize,
+                                         indirectArgs.maxCommandCount,
+                                         indirectArgs.argsStrideByteSize);
     }
-
-    if (!isRendering)
+    else
     {
-        VEX_LOG(Fatal, "You need to call BeginRendering before calling any draw commands")
+        commandBuffer->drawIndirect(indirectArgs.argsBuffer->GetNativeBuffer(),
+                                    indirectArgs.argsOffsetByteSize,
+                                    indirectArgs.maxCommandCount,
+                                    indirectArgs.argsStrideByteSize);
     }
+}
 
-    commandBuffer->setViewportWithCount(1, &*cachedViewport);
-    commandBuffer->setScissorWithCount(1, &*cachedScissor);
-    commandBuffer->drawIndexed(indexCount, instanceCount, indexOffset, vertexOffset, instanceOffset);
+void VkCommandList::DrawIndexedIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    PrepareDraw();
+    if (indirectArgs.countBuffer)
+    {
+        commandBuffer->drawIndexedIndirectCount(indirectArgs.argsBuffer->GetNativeBuffer(),
+                                                indirectArgs.argsOffsetByteSize,
+                                                indirectArgs.countBuffer->GetNativeBuffer(),
+                                                indirectArgs.countOffsetByteSize,
+                                                indirectArgs.maxCommandCount,
+                                                indirectArgs.argsStrideByteSize);
+    }
+    else
+    {
+        commandBuffer->drawIndexedIndirect(indirectArgs.argsBuffer->GetNativeBuffer(),
+                                           indirectArgs.argsOffsetByteSize,
+                                           indirectArgs.maxCommandCount,
+                                           indirectArgs.argsStrideByteSize);
+    }
 }
 
 void VkCommandList::SetVertexBuffers(u32 startSlot, Span<const RHIBufferBinding> vertexBuffers)
@@ -522,6 +644,13 @@ void VkCommandList::Dispatch(const std::array<u32, 3>& groupCount)
     commandBuffer->dispatch(groupCount[0], groupCount[1], groupCount[2]);
 }
 
+void VkCommandList::DispatchIndirect(const RHIIndirectArgsBinding& indirectArgs)
+{
+    // Vulkan has no count variant for dispatches, the CommandContext only allows single indirect dispatches.
+    VEX_ASSERT(indirectArgs.maxCommandCount == 1 && !indirectArgs.countBuffer);
+    commandBuffer->dispatchIndirect(indirectArgs.argsBuffer->GetNativeBuffer(), indirectArgs.argsOffsetByteSize);
+}
+
 void VkCommandList::TraceRays(const TraceRaysDesc& rayTracingArgs,
                               const RHIRayTracingPipelineState& rayTracingPipelineState)
 {
@@ -644,41 +773,106 @@ void VkCommandList::ResolveTimestampQueries(u32 firstQuery, u32 queryCount)
                                         ::vk::QueryResultFlagBits::e64 | ::vk::QueryResultFlagBits::eWait);
 }
 
-void VkCommandList::BuildBLAS(RHIAccelerationStructure& as, RHIBuffer& scratchBuffer)
+void VkCommandList::BuildBLAS(Span<const RHIBLASBuild> builds, RHIBuffer& scratchBuffer)
 {
-    ::vk::AccelerationStructureBuildGeometryInfoKHR asBuildInfo{
-        .type = ::vk::AccelerationStructureTypeKHR::eBottomLevel,
-        .flags = ASBuildFlagsToVkASBuildFlags(as.GetDesc().buildFlags),
-        .mode = ::vk::BuildAccelerationStructureModeKHR::eBuild,
-        .geometryCount = static_cast<u32>(as.geometries.size()),
-        .pGeometries = as.geometries.data(),
-    };
+    std::vector<::vk::AccelerationStructureBuildGeometryInfoKHR> asBuildInfos;
+    std::vector<const ::vk::AccelerationStructureBuildRangeInfoKHR*> asBuildRanges;
+    asBuildInfos.reserve(builds.size());
+    asBuildRanges.reserve(builds.size());
+    for (const RHIBLASBuild& build : builds)
+    {
+        RHIAccelerationStructure& as = *build.accelerationStructure;
+        ::vk::AccelerationStructureBuildGeometryInfoKHR& asBuildInfo = asBuildInfos.emplace_back(
+            ::vk::AccelerationStructureBuildGeometryInfoKHR{
+                .type = ::vk::AccelerationStructureTypeKHR::eBottomLevel,
+                .flags = ASBuildFlagsToVkASBuildFlags(as.GetDesc().buildFlags),
+                .mode = build.isUpdate ? ::vk::BuildAccelerationStructureModeKHR::eUpdate
+                                       : ::vk::BuildAccelerationStructureModeKHR::eBuild,
+                .geometryCount = static_cast<u32>(as.geometries.size()),
+                .pGeometries = as.geometries.data(),
+            });
 
-    asBuildInfo.dstAccelerationStructure = *as.vkAccelerationStructure;
-    asBuildInfo.scratchData.deviceAddress = scratchBuffer.GetDeviceAddress();
+        // Updates are performed in place.
+        if (build.isUpdate)
+        {
+            asBuildInfo.srcAccelerationStructure = *as.vkAccelerationStructure;
+        }
+        asBuildInfo.dstAccelerationStructure = *as.vkAccelerationStructure;
+        asBuildInfo.scratchData.deviceAddress = scratchBuffer.GetDeviceAddress() + build.scratchOffset;
+        asBuildRanges.push_back(as.ranges.data());
+    }
 
-    commandBuffer->buildAccelerationStructuresKHR({ asBuildInfo }, { as.ranges.data() });
+    // All the BLAS are built by a single command.
+    commandBuffer->buildAccelerationStructuresKHR(asBuildInfos, asBuildRanges);
 }
 
 void VkCommandList::BuildTLAS(RHIAccelerationStructure& as,
                               RHIBuffer& scratchBuffer,
                               RHIBuffer& uploadBuffer,
-                              const RHITLASBuildDesc& desc)
+                              const RHITLASBuildDesc& desc,
+                              bool isUpdate)
 {
     ::vk::AccelerationStructureBuildGeometryInfoKHR asBuildInfo{
         .type = ::vk::AccelerationStructureTypeKHR::eTopLevel,
         .flags = ASBuildFlagsToVkASBuildFlags(as.GetDesc().buildFlags),
-        .mode = ::vk::BuildAccelerationStructureModeKHR::eBuild,
+        .mode = isUpdate ? ::vk::BuildAccelerationStructureModeKHR::eUpdate
+                         : ::vk::BuildAccelerationStructureModeKHR::eBuild,
         .geometryCount = static_cast<u32>(as.geometries.size()),
         .pGeometries = as.geometries.data(),
     };
 
+    // Updates are performed in place.
+    if (isUpdate)
+    {
+        asBuildInfo.srcAccelerationStructure = *as.vkAccelerationStructure;
+    }
     asBuildInfo.dstAccelerationStructure = *as.vkAccelerationStructure;
     asBuildInfo.scratchData.deviceAddress = scratchBuffer.GetDeviceAddress();
 
     commandBuffer->buildAccelerationStructuresKHR({ asBuildInfo }, { as.ranges.data() });
 }
 
+void VkCommandList::WriteCompactedSizes(Span<const NonNullPtr<RHIAccelerationStructure>> accelerationStructures,
+                                        RHIBuffer& dstBuffer)
+{
+    const u32 queryCount = static_cast<u32>(accelerationStructures.size());
+
+    std::vector<::vk::AccelerationStructureKHR> vkAccelerationStructures;
+    vkAccelerationStructures.reserve(queryCount);
+    for (const NonNullPtr<RHIAccelerationStructure>& as : accelerationStructures)
+    {
+        vkAccelerationStructures.push_back(*as->vkAccelerationStructure);
+    }
+
+    // Vulkan writes the sizes to a query pool, which must stay alive until the command list is done executing.
+    compactedSizeQueryPools.push_back(VEX_VK_CHECK <<= ctx->device.createQueryPoolUnique({
+        .queryType = ::vk::QueryType::eAccelerationStructureCompactedSizeKHR,
+        .queryCount = queryCount,
+    }));
+    const ::vk::QueryPool queryPool = *compactedSizeQueryPools.back();
+    commandBuffer->resetQueryPool(queryPool, 0, queryCount);
+    commandBuffer->writeAccelerationStructuresPropertiesKHR(vkAccelerationStructures,
+                                                            ::vk::QueryType::eAccelerationStructureCompactedSizeKHR,
+                                                            queryPool,
+                                                            0);
+    commandBuffer->copyQueryPoolResults(queryPool,
+                                        0,
+                                        queryCount,
+                                        dstBuffer.GetNativeBuffer(),
+                                        0,
+                                        sizeof(u64),
+                                        ::vk::QueryResultFlagBits::e64 | ::vk::QueryResultFlagBits::eWait);
+}
+
+void VkCommandList::CompactAccelerationStructure(RHIAccelerationStructure& src, RHIAccelerationStructure& dst)
+{
+    commandBuffer->copyAccelerationStructureKHR(::vk::CopyAccelerationStructureInfoKHR{
+        .src = *src.vkAccelerationStructure,
+        .dst = *dst.vkAccelerationStructure,
+        .mode = ::vk::CopyAccelerationStructureModeKHR::eCompact,
+    });
+}
+
 void VkCommandList::Copy(RHITexture& src, RHITexture& dst, Span<const TextureCopyDesc> textureCopyDescriptions)
 {
     const auto& srcDesc = src.desc;
@@ -758,4 +952,20 @@ VkCommandList::VkCommandList(NonNullPtr<VkGPUContext> ctx, ::vk::UniqueCommandBu
 {
 }
 
+void VkCommandList::PrepareDraw()
+{
+    if (!cachedViewport || !cachedScissor)
+    {
+        VEX_LOG(Fatal, "SetScissor and SetViewport need to be called before Draw is ever called")
+    }
+
+    if (!isRendering)
+    {
+        VEX_LOG(Fatal, "You need to call BeginRendering before calling any draw commands")
+    }
+
+    commandBuffer->setViewportWithCount(1, &*cachedViewport);
+    commandBuffer->setScissorWithCount(1, &*cachedScissor);
+}
+
 } // namespace vex::vk
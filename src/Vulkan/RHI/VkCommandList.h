@@ -35,7 +35,7 @@ public:
     virtual void SetPipelineState(const RHIComputePipelineState& computePipelineState) override;
     virtual void SetPipelineState(const RHIRayTracingPipelineState& rayTracingPipelineState) override;
 
-    virtual void SetLayout(RHIResourceLayout& layout) override;
+    virtual void SetLayout(RHIResourceLayout& layout, Span<const byte> localConstantsData) override;
     virtual void SetDescriptorPool(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout) override;
     virtual void SetInputAssembly(InputAssembly inputAssembly) override;
 
@@ -50,6 +50,11 @@ public:
     virtual void EmitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
                               Span<const RHITextureBarrier> textureBarriers,
                               Span<const RHIGlobalBarrier> globalBarriers) override;
+    virtual u32 BeginSplitBarriers(Span<const RHIBufferBarrier> bufferBarriers,
+                                   Span<const RHITextureBarrier> textureBarriers) override;
+    virtual void EndSplitBarriers(u32 splitBarrierIndex,
+                                  Span<const RHIBufferBarrier> bufferBarriers,
+                                  Span<const RHITextureBarrier> textureBarriers) override;
 
     virtual void BeginRendering(const RHIDrawResources& resources) override;
     virtual void EndRendering() override;
@@ -57,11 +62,14 @@ public:
     virtual void Draw(u32 vertexCount, u32 instanceCount = 1, u32 vertexOffset = 0, u32 instanceOffset = 0) override;
     virtual void DrawIndexed(
         u32 indexCount, u32 instanceCount, u32 indexOffset, u32 vertexOffset, u32 instanceOffset) override;
+    virtual void DrawIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
+    virtual void DrawIndexedIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
 
     virtual void SetVertexBuffers(u32 startSlot, Span<const RHIBufferBinding> vertexBuffers) override;
     virtual void SetIndexBuffer(const RHIBufferBinding& indexBuffer) override;
 
     virtual void Dispatch(const std::array<u32, 3>& groupCount) override;
+    virtual void DispatchIndirect(const RHIIndirectArgsBinding& indirectArgs) override;
 
     virtual void TraceRays(const TraceRaysDesc& rayTracingArgs,
                            const RHIRayTracingPipelineState& rayTracingPipelineState) override;
@@ -72,11 +80,15 @@ public:
     virtual void EndTimestampQuery(QueryHandle handle) override;
     virtual void ResolveTimestampQueries(u32 firstQuery, u32 queryCount) override;
 
-    virtual void BuildBLAS(RHIAccelerationStructure& as, RHIBuffer& scratchBuffer) override;
+    virtual void BuildBLAS(Span<const RHIBLASBuild> builds, RHIBuffer& scratchBuffer) override;
     virtual void BuildTLAS(RHIAccelerationStructure& as,
                            RHIBuffer& scratchBuffer,
                            RHIBuffer& uploadBuffer,
-                           const RHITLASBuildDesc& desc) override;
+                           const RHITLASBuildDesc& desc,
+                           bool isUpdate) override;
+    virtual void WriteCompactedSizes(Span<const NonNullPtr<RHIAccelerationStructure>> accelerationStructures,
+                                     RHIBuffer& dstBuffer) override;
+    virtual void CompactAccelerationStructure(RHIAccelerationStructure& src, RHIAccelerationStructure& dst) override;
 
     using RHICommandListBase::Copy;
     virtual void Copy(RHITexture& src, RHITexture& dst, Span<const TextureCopyDesc> textureCopyDesc) override;
@@ -92,9 +104,21 @@ public:
     virtual RHIScopedGPUEvent CreateScopedMarker(const char* label, std::array<float, 3> labelColor) override;
 
 private:
+    // Validates that draws can be recorded and sets the dynamic viewport and scissor state.
+    void PrepareDraw();
+    // Binds the bindless descriptors when they live in a descriptor buffer, instead of a descriptor set.
+    void SetDescriptorBuffer(RHIDescriptorPool& descriptorPool, RHIResourceLayout& resourceLayout);
+
     NonNullPtr<VkGPUContext> ctx;
     ::vk::UniqueCommandBuffer commandBuffer;
 
+    // Events used to implement split barriers, they are reset once the command list is reopened.
+    std::vector<::vk::UniqueEvent> splitBarrierEvents;
+    u32 usedSplitBarrierEventCount = 0;
+
+    // Query pools used to read back compacted acceleration structure sizes, destroyed once the command list reopens.
+    std::vector<::vk::UniqueQueryPool> compactedSizeQueryPools;
+
     bool isRendering = false;
 
     std::optional<::vk::Viewport> cachedViewport{};
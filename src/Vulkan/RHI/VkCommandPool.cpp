@@ -21,57 +21,48 @@ VkCommandPool::VkCommandPool(RHI& rhi,
 {
     for (u8 i = 0; i < QueueTypes::Count; ++i)
     {
-        commandPoolPerQueue[i] = VEX_VK_CHECK <<= ctx->device.createCommandPoolUnique({
-            .flags = ::vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-            .queueFamilyIndex = commandQueues[i].family,
-        });
+        queueFamilyPerQueue[i] = commandQueues[i].family;
     }
 }
 
 VkCommandPool::~VkCommandPool()
 {
     // Reset our parent class's command buffers BEFORE destroying command pools.
-    commandListsPerQueue = {};
-    // Command pool will now be destroyed by class destructor.
+    commandListsPerThread = {};
+    // Command pools will now be destroyed by class destructor.
 }
 
-NonNullPtr<RHICommandList> VkCommandPool::GetOrCreateCommandList(QueueType queueType)
+std::unique_ptr<RHICommandList> VkCommandPool::CreateCommandList(QueueType queueType)
 {
-    VkCommandList* cmdListPtr = nullptr;
-
-    auto& commandLists = GetCommandLists(queueType);
-    if (auto res = std::find_if(commandLists.begin(),
-                                commandLists.end(),
-                                [](const std::unique_ptr<VkCommandList>& cmdList)
-                                { return cmdList->GetState() == RHICommandListState::Available; });
-        res != commandLists.end())
-    {
-        cmdListPtr = res->get();
-    }
-    else
-    {
-        ::vk::UniqueCommandPool& commandPool = GetCommandPool(queueType);
-        auto allocatedBuffers = VEX_VK_CHECK <<= ctx->device.allocateCommandBuffersUnique({
-            .commandPool = *commandPool,
-            .level = ::vk::CommandBufferLevel::ePrimary,
-            .commandBufferCount = 1,
-        });
-        ::vk::UniqueCommandBuffer newBuffer = std::move(allocatedBuffers[0]);
+    ::vk::UniqueCommandPool& commandPool = GetCommandPool(queueType);
+    auto allocatedBuffers = VEX_VK_CHECK <<= ctx->device.allocateCommandBuffersUnique({
+        .commandPool = *commandPool,
+        .level = ::vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1,
+    });
+    ::vk::UniqueCommandBuffer newBuffer = std::move(allocatedBuffers[0]);
 
-        commandLists.push_back(std::make_unique<VkCommandList>(ctx, std::move(newBuffer), queueType));
-        cmdListPtr = commandLists.back().get();
-        VEX_LOG(Verbose, "Created new commandlist for queue {}", magic_enum::enum_name(queueType));
-    }
-
-    VEX_ASSERT(cmdListPtr != nullptr);
-    cmdListPtr->SetState(RHICommandListState::Recording);
+    VEX_LOG(Verbose, "Created new commandlist for queue {}", magic_enum::enum_name(queueType));
+    return std::make_unique<VkCommandList>(ctx, std::move(newBuffer), queueType);
+}
 
-    return NonNullPtr(cmdListPtr);
+void VkCommandPool::ReleaseThreadResources(std::thread::id threadId)
+{
+    // The command buffers allocated from these pools were destroyed along with the thread's command lists.
+    commandPoolsPerThread.erase(threadId);
 }
 
 ::vk::UniqueCommandPool& VkCommandPool::GetCommandPool(QueueType queueType)
 {
-    return commandPoolPerQueue[queueType];
+    ::vk::UniqueCommandPool& commandPool = commandPoolsPerThread[std::this_thread::get_id()][queueType];
+    if (!commandPool)
+    {
+        commandPool = VEX_VK_CHECK <<= ctx->device.createCommandPoolUnique({
+            .flags = ::vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueFamilyIndex = queueFamilyPerQueue[queueType],
+        });
+    }
+    return commandPool;
 }
 
 } // namespace vex::vk
@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include <thread>
+#include <unordered_map>
+
 #include <Vex/QueueType.h>
 #include <Vex/Utility/NonNullPtr.h>
 
@@ -14,6 +17,8 @@ namespace vex::vk
 
 struct VkGPUContext;
 
+// Vulkan command pools must be externally synchronized, a native command pool is therefore created for each thread
+// which records command lists.
 class VkCommandPool final : public RHICommandPoolBase
 {
 public:
@@ -25,14 +30,18 @@ public:
     VkCommandPool(VkCommandPool&&) = default;
     VkCommandPool& operator=(VkCommandPool&&) = default;
 
-    virtual NonNullPtr<RHICommandList> GetOrCreateCommandList(QueueType queueType) override;
+protected:
+    virtual std::unique_ptr<RHICommandList> CreateCommandList(QueueType queueType) override;
+    virtual void ReleaseThreadResources(std::thread::id threadId) override;
 
 private:
     ::vk::UniqueCommandPool& GetCommandPool(QueueType queueType);
 
     NonNullPtr<VkGPUContext> ctx;
 
-    std::array<::vk::UniqueCommandPool, QueueTypes::Count> commandPoolPerQueue;
+    std::array<u32, QueueTypes::Count> queueFamilyPerQueue;
+    std::unordered_map<std::thread::id, std::array<::vk::UniqueCommandPool, QueueTypes::Count>>
+        commandPoolsPerThread;
 };
 
 } // namespace vex::vk
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "VkDescriptorPool.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <Vulkan/VkErrorHandler.h>
 #include <Vulkan/VkGPUContext.h>
 #include <Vulkan/VkSampler.h>
@@ -7,14 +10,56 @@
 namespace vex::vk
 {
 
+namespace VkDescriptorPool_Internal
+{
+
+static u32 GetMaxBindlessDescriptorCount(const VkGPUContext& ctx)
+{
+    // Mutable descriptors count towards the limits of every type they can hold.
+    const ::vk::PhysicalDeviceVulkan12Properties properties =
+        ctx.physDevice.getProperties2<::vk::PhysicalDeviceProperties2, ::vk::PhysicalDeviceVulkan12Properties>()
+            .get<::vk::PhysicalDeviceVulkan12Properties>();
+    u32 maxDescriptorCount = std::min({
+        GMaxDescriptorPoolSize,
+        properties.maxPerStageUpdateAfterBindResources,
+        properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+        properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        properties.maxPerStageDescriptorUpdateAfterBindStorageImages,
+        properties.maxPerStageDescriptorUpdateAfterBindUniformBuffers,
+        properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+        properties.maxDescriptorSetUpdateAfterBindSamplers,
+        properties.maxDescriptorSetUpdateAfterBindSampledImages,
+        properties.maxDescriptorSetUpdateAfterBindStorageImages,
+        properties.maxDescriptorSetUpdateAfterBindUniformBuffers,
+        properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+    });
+
+    if (ctx.useDescriptorBuffer)
+    {
+        // The descriptor buffer holds both samplers and resources, its size is limited by both ranges.
+        const ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT bufferProperties =
+            ctx.physDevice
+                .getProperties2<::vk::PhysicalDeviceProperties2, ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT>()
+                .get<::vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+        const u64 stride =
+            VkBindlessDescriptorSet::GetDescriptorBufferStride(bufferProperties, ctx.robustBufferAccess);
+        maxDescriptorCount = static_cast<u32>(std::min<u64>({
+            maxDescriptorCount,
+            bufferProperties.maxResourceDescriptorBufferRange / stride,
+            bufferProperties.maxSamplerDescriptorBufferRange / stride,
+        }));
+    }
+    return maxDescriptorCount;
+}
+
+} // namespace VkDescriptorPool_Internal
+
 VkDescriptorPool::VkDescriptorPool(NonNullPtr<VkGPUContext> ctx)
-    : ctx{ ctx }
+    : RHIDescriptorPoolBase(VkDescriptorPool_Internal::GetMaxBindlessDescriptorCount(*ctx))
+    , ctx{ ctx }
 {
+    // Pool used by the descriptor sets other than the bindless one, which allocates its own pool.
     std::array poolSize{ ::vk::DescriptorPoolSize{
-                             .type = ::vk::DescriptorType::eMutableEXT,
-                             .descriptorCount = GDefaultDescriptorPoolSize,
-                         },
-                         ::vk::DescriptorPoolSize{
                              .type = ::vk::DescriptorType::eSampler,
                              .descriptorCount = GDefaultDescriptorPoolSize,
                          },
@@ -34,7 +79,7 @@ VkDescriptorPool::VkDescriptorPool(NonNullPtr<VkGPUContext> ctx)
 
     descriptorPool = VEX_VK_CHECK <<= ctx->device.createDescriptorPoolUnique(descriptorPoolInfo);
 
-    bindlessSet.emplace(ctx, *descriptorPool);
+    bindlessSet.emplace(ctx, GDefaultDescriptorPoolSize, maxResourceDescriptorCount);
 }
 
 BindlessHandle VkDescriptorPool::CreateBindlessSampler(const BindlessTextureSampler& textureSampler)
@@ -69,6 +114,58 @@ void VkDescriptorPool::CopyNullDescriptor(DescriptorType, u32 slotIndex)
     bindlessSet->SetDescriptorToNull(slotIndex);
 }
 
+void VkDescriptorPool::FlushPendingDescriptorWrites()
+{
+    bindlessSet->FlushPendingWrites();
+}
+
+void VkDescriptorPool::DiscardPendingDescriptorWrites(u32 firstSlot, u32 slotCount)
+{
+    bindlessSet->DiscardPendingWrites(firstSlot, slotCount);
+}
+
+void VkDescriptorPool::ReleaseRetiredHeaps(u32 oldestUsedHeapVersion)
+{
+    std::erase_if(retiredSets,
+                  [oldestUsedHeapVersion](const RetiredSet& retiredSet)
+                  { return retiredSet.heapVersion <= oldestUsedHeapVersion; });
+}
+
+void VkDescriptorPool::GrowResourceHeap(u32 newSize)
+{
+    // Command buffers recorded before the growth keep using the retired set, it must hold all pending writes.
+    // Descriptor buffers are always up to date, their descriptors are never deferred.
+    bindlessSet->FlushPendingWrites();
+
+    const u32 size = static_cast<u32>(allocator.generations.size());
+    RetiredSet& retiredSet = retiredSets.emplace_back(RetiredSet{
+        .heapVersion = GetHeapVersion(),
+        .descriptorPool = std::move(bindlessSet->descriptorPool),
+        .descriptorSet = std::move(bindlessSet->descriptorSet),
+        .descriptorBuffer = std::move(bindlessSet->descriptorBuffer),
+    });
+    bindlessSet->Allocate(newSize);
+
+    if (ctx->useDescriptorBuffer)
+    {
+        std::memcpy(bindlessSet->descriptorBuffer.mappedData,
+                    retiredSet.descriptorBuffer.mappedData,
+                    bindlessSet->GetDescriptorBufferByteSize(size));
+        return;
+    }
+
+    const ::vk::CopyDescriptorSet copy{
+        .srcSet = *retiredSet.descriptorSet,
+        .srcBinding = 0,
+        .srcArrayElement = 0,
+        .dstSet = *bindlessSet->descriptorSet,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = size,
+    };
+    ctx->device.updateDescriptorSets(0, nullptr, 1, &copy);
+}
+
 VkBindlessDescriptorSet& VkDescriptorPool::GetBindlessSet()
 {
     return *bindlessSet;
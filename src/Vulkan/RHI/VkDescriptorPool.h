@@ -1,5 +1,8 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include <Vex/Utility/NonNullPtr.h>
 
 #include <RHI/RHIDescriptorPool.h>
@@ -24,9 +27,25 @@ public:
     }
     virtual void CopyNullDescriptor(DescriptorType descriptorType, u32 slotIndex) override;
 
+    virtual void FlushPendingDescriptorWrites() override;
+    virtual void DiscardPendingDescriptorWrites(u32 firstSlot, u32 slotCount) override;
+
     VkBindlessDescriptorSet& GetBindlessSet();
 
+protected:
+    virtual void GrowResourceHeap(u32 newSize) override;
+    virtual void ReleaseRetiredHeaps(u32 oldestUsedHeapVersion) override;
+
 private:
+    // Bindless set replaced by a larger one, which command buffers recorded before the growth might still use.
+    struct RetiredSet
+    {
+        u32 heapVersion;
+        ::vk::UniqueDescriptorPool descriptorPool;
+        ::vk::UniqueDescriptorSet descriptorSet;
+        VkBindlessDescriptorSet::DescriptorBuffer descriptorBuffer;
+    };
+
     NonNullPtr<VkGPUContext> ctx;
     ::vk::UniqueDescriptorPool descriptorPool;
 
@@ -34,6 +53,8 @@ private:
 
     std::unordered_map<BindlessHandle, ::vk::UniqueSampler> samplers;
 
+    std::vector<RetiredSet> retiredSets;
+
     friend class VkCommandList;
     friend class VkResourceLayout;
 };
@@ -1,11 +1,15 @@
 ﻿#include "VkDescriptorSet.h"
 
+#include <algorithm>
+
 #include <Vex/PhysicalDevice.h>
 #include <Vex/Utility/Formattable.h>
 #include <Vex/Utility/Validation.h>
+#include <Vex/Utility/Visitor.h>
 
 #include <RHI/RHIDescriptorPool.h>
 
+#include <Vulkan/RHI/VkAllocator.h>
 #include <Vulkan/VkDebug.h>
 #include <Vulkan/VkErrorHandler.h>
 #include <Vulkan/VkGPUContext.h>
@@ -39,6 +43,52 @@ static void ValidateBufferDescriptor(::vk::DescriptorType type){
               type)
 }
 
+// Types which the mutable bindless descriptors can hold.
+static std::vector<::vk::DescriptorType> GetBindlessDescriptorTypes()
+{
+    using enum ::vk::DescriptorType;
+    std::vector descriptorTypes{ eSampler,       eSampledImage, eStorageImage, eUniformTexelBuffer, eStorageTexelBuffer,
+                                 eUniformBuffer, eStorageBuffer };
+    if (GPhysicalDevice->IsFeatureSupported(Feature::RayTracing))
+    {
+        descriptorTypes.push_back(eAccelerationStructureKHR);
+    }
+    return descriptorTypes;
+}
+
+static u64 GetDescriptorBufferDescriptorSize(const ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT& properties,
+                                             ::vk::DescriptorType type,
+                                             bool robustBufferAccess)
+{
+    // The robust sizes only apply when robustBufferAccess is enabled, robustBufferAccess2 does not change them.
+    switch (type)
+    {
+    case ::vk::DescriptorType::eSampler:
+        return properties.samplerDescriptorSize;
+    case ::vk::DescriptorType::eSampledImage:
+        return properties.sampledImageDescriptorSize;
+    case ::vk::DescriptorType::eStorageImage:
+        return properties.storageImageDescriptorSize;
+    case ::vk::DescriptorType::eUniformTexelBuffer:
+        return robustBufferAccess ? properties.robustUniformTexelBufferDescriptorSize
+                                  : properties.uniformTexelBufferDescriptorSize;
+    case ::vk::DescriptorType::eStorageTexelBuffer:
+        return robustBufferAccess ? properties.robustStorageTexelBufferDescriptorSize
+                                  : properties.storageTexelBufferDescriptorSize;
+    case ::vk::DescriptorType::eUniformBuffer:
+        return robustBufferAccess ? properties.robustUniformBufferDescriptorSize
+                                  : properties.uniformBufferDescriptorSize;
+    case ::vk::DescriptorType::eStorageBuffer:
+        return robustBufferAccess ? properties.robustStorageBufferDescriptorSize
+                                  : properties.storageBufferDescriptorSize;
+    case ::vk::DescriptorType::eAccelerationStructureKHR:
+        return properties.accelerationStructureDescriptorSize;
+    default:
+        VEX_LOG(Fatal, "Unsupported descriptor type in a descriptor buffer: {}", type);
+        return 0;
+    }
+}
+
 VkDescriptorSet::VkDescriptorSet(NonNullPtr<VkGPUContext> ctx,
                                  const ::vk::DescriptorPool& descriptorPool,
                                  Span<::vk::DescriptorType> descriptorTypes)
@@ -160,7 +210,8 @@ void VkDescriptorSet::UpdateDescriptors(u32 startIndex, Span<const ::vk::Descrip
 }
 
 VkBindlessDescriptorSet::VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx,
-                                                 const ::vk::DescriptorPool& descriptorPool)
+                                                 u32 descriptorCount,
+                                                 u32 maxDescriptorCount)
     : ctx{ ctx }
 {
     // Create a mutable descriptor binding set, this allows us to use the ResourceDescriptorHeap in HLSL shaders
@@ -180,13 +231,7 @@ VkBindlessDescriptorSet::VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx,
     // the descriptors types are no longer statically known at layout creation time."
     //
     // I believe this trade off is worth it given it greatly simplifies our code.
-    using enum ::vk::DescriptorType;
-    std::vector descriptorTypes{ eSampler,       eSampledImage, eStorageImage, eUniformTexelBuffer, eStorageTexelBuffer,
-                                 eUniformBuffer, eStorageBuffer };
-    if (GPhysicalDevice->IsFeatureSupported(Feature::RayTracing))
-    {
-        descriptorTypes.push_back(eAccelerationStructureKHR);
-    }
+    std::vector<::vk::DescriptorType> descriptorTypes = GetBindlessDescriptorTypes();
 
     ::vk::MutableDescriptorTypeListEXT mutableDescriptorTypeList = {
         .descriptorTypeCount = static_cast<u32>(descriptorTypes.size()),
@@ -201,14 +246,17 @@ VkBindlessDescriptorSet::VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx,
 
     ::vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = {
         .binding = 0,
-        .descriptorType = eMutableEXT,
-        .descriptorCount = GDefaultDescriptorPoolSize,
+        .descriptorType = ::vk::DescriptorType::eMutableEXT,
+        .descriptorCount = maxDescriptorCount,
         .stageFlags = ::vk::ShaderStageFlagBits::eAll,
         .pImmutableSamplers = nullptr,
     };
 
-    ::vk::DescriptorBindingFlagsEXT bindingFlags =
-        ::vk::DescriptorBindingFlagBits::ePartiallyBound | ::vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+    // The variable descriptor count allows growing the set without changing its layout, which would invalidate every
+    // pipeline layout.
+    ::vk::DescriptorBindingFlagsEXT bindingFlags = ::vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                   ::vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                   ::vk::DescriptorBindingFlagBits::eVariableDescriptorCount;
 
     ::vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {
         .pNext = &mutableTypeInfo,
@@ -221,12 +269,61 @@ VkBindlessDescriptorSet::VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx,
         .bindingCount = 1,
         .pBindings = &descriptorSetLayoutBinding,
     };
+    if (ctx->useDescriptorBuffer)
+    {
+        // Descriptors of a descriptor buffer are plain memory: they can always be written while unused by the GPU,
+        // and the set is grown by allocating a new descriptor buffer.
+        createInfo.pNext = &mutableTypeInfo;
+        createInfo.flags = ::vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT;
+    }
 
     // Create layout
     descriptorLayout = VEX_VK_CHECK <<= ctx->device.createDescriptorSetLayoutUnique(createInfo);
 
+    if (ctx->useDescriptorBuffer)
+    {
+        descriptorBufferProperties =
+            ctx->physDevice
+                .getProperties2<::vk::PhysicalDeviceProperties2, ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT>()
+                .get<::vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+        descriptorBufferOffset = ctx->device.getDescriptorSetLayoutBindingOffsetEXT(*descriptorLayout, 0);
+        descriptorBufferStride = GetDescriptorBufferStride(descriptorBufferProperties, ctx->robustBufferAccess);
+    }
+
+    Allocate(descriptorCount);
+}
+
+void VkBindlessDescriptorSet::Allocate(u32 descriptorCount)
+{
+    if (ctx->useDescriptorBuffer)
+    {
+        AllocateDescriptorBuffer(descriptorCount);
+        return;
+    }
+
+    // The set must be freed before the pool it was allocated from.
+    descriptorSet.reset();
+
+    const ::vk::DescriptorPoolSize poolSize{
+        .type = ::vk::DescriptorType::eMutableEXT,
+        .descriptorCount = descriptorCount,
+    };
+    const ::vk::DescriptorPoolCreateInfo descriptorPoolInfo{
+        .flags = ::vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind |
+                 ::vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize,
+    };
+    descriptorPool = VEX_VK_CHECK <<= ctx->device.createDescriptorPoolUnique(descriptorPoolInfo);
+
+    const ::vk::DescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{
+        .descriptorSetCount = 1,
+        .pDescriptorCounts = &descriptorCount,
+    };
     ::vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo{
-        .descriptorPool = descriptorPool,
+        .pNext = &variableCountInfo,
+        .descriptorPool = *descriptorPool,
         .descriptorSetCount = 1,
         .pSetLayouts = &*descriptorLayout,
     };
@@ -239,70 +336,199 @@ VkBindlessDescriptorSet::VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx,
     SetDebugName(ctx->device, *descriptorSet, "Bindless Descriptor Set");
 }
 
+void VkBindlessDescriptorSet::AllocateDescriptorBuffer(u32 descriptorCount)
+{
+    const bool needsConcurrent = ctx->queueFamilyIndices.size() > 1;
+    descriptorBuffer.buffer = VEX_VK_CHECK <<= ctx->device.createBufferUnique(::vk::BufferCreateInfo{
+        .size = GetDescriptorBufferByteSize(descriptorCount),
+        .usage = ::vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+                 ::vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+                 ::vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        .sharingMode = needsConcurrent ? ::vk::SharingMode::eConcurrent : ::vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = needsConcurrent ? static_cast<u32>(ctx->queueFamilyIndices.size()) : 0,
+        .pQueueFamilyIndices = needsConcurrent ? ctx->queueFamilyIndices.data() : nullptr,
+    });
+
+    // Descriptors are written from the CPU straight into the memory read by the GPU.
+    const ::vk::MemoryRequirements reqs = ctx->device.getBufferMemoryRequirements(*descriptorBuffer.buffer);
+    const ::vk::MemoryAllocateFlagsInfo allocateFlags{ .flags = ::vk::MemoryAllocateFlagBits::eDeviceAddress };
+    descriptorBuffer.memory = VEX_VK_CHECK <<= ctx->device.allocateMemoryUnique({
+        .pNext = &allocateFlags,
+        .allocationSize = reqs.size,
+        .memoryTypeIndex = AllocatorUtils::GetBestSuitedMemoryTypeIndex(
+            ctx->physDevice,
+            reqs.memoryTypeBits,
+            AllocatorUtils::GetMemoryPropsFromLocality(ResourceMemoryLocality::CPUWrite)),
+    });
+    VEX_VK_CHECK << ctx->device.bindBufferMemory(*descriptorBuffer.buffer, *descriptorBuffer.memory, 0);
+
+    void* ptr = VEX_VK_CHECK <<= ctx->device.mapMemory(*descriptorBuffer.memory, 0, VK_WHOLE_SIZE);
+    descriptorBuffer.mappedData = static_cast<byte*>(ptr);
+
+    const ::vk::BufferDeviceAddressInfo addressInfo{ .buffer = *descriptorBuffer.buffer };
+    descriptorBuffer.address = VEX_VK_CHECK <<= ctx->device.getBufferAddress(addressInfo);
+
+    SetDebugName(ctx->device, *descriptorBuffer.buffer, "Bindless Descriptor Buffer");
+}
+
+u64 VkBindlessDescriptorSet::GetDescriptorBufferByteSize(u32 descriptorCount) const
+{
+    return descriptorBufferOffset + descriptorCount * descriptorBufferStride;
+}
+
+u64 VkBindlessDescriptorSet::GetDescriptorBufferStride(
+    const ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT& properties, bool robustBufferAccess)
+{
+    // A mutable descriptor takes up as much memory as the largest type it can hold.
+    u64 stride = 0;
+    for (::vk::DescriptorType type : GetBindlessDescriptorTypes())
+    {
+        stride = std::max(stride, GetDescriptorBufferDescriptorSize(properties, type, robustBufferAccess));
+    }
+    return stride;
+}
+
 void VkBindlessDescriptorSet::UpdateDescriptor(BindlessHandle targetDescriptor,
                                                ::vk::DescriptorImageInfo createInfo,
                                                bool hasGPUWriteAccess)
 {
     ::vk::DescriptorType type =
         hasGPUWriteAccess ? ::vk::DescriptorType::eStorageImage : ::vk::DescriptorType::eSampledImage;
-    const ::vk::WriteDescriptorSet writeSet{
-        .dstSet = *descriptorSet,
-        .dstBinding = 0,
-        .dstArrayElement = targetDescriptor.GetIndex(),
-        .descriptorCount = 1,
-        .descriptorType = type,
-        .pImageInfo = &createInfo,
-    };
-
-    ctx->device.updateDescriptorSets(1, &writeSet, 0, nullptr);
+    Write(targetDescriptor.GetIndex(), { .type = type, .info = createInfo });
 }
 
 void VkBindlessDescriptorSet::UpdateDescriptor(BindlessHandle targetDescriptor,
                                                ::vk::DescriptorType descType,
                                                ::vk::DescriptorBufferInfo createInfo)
 {
-    const ::vk::WriteDescriptorSet writeSet{
-        .dstSet = *descriptorSet,
-        .dstBinding = 0,
-        .dstArrayElement = targetDescriptor.GetIndex(),
-        .descriptorCount = 1,
-        .descriptorType = descType,
-        .pBufferInfo = &createInfo,
-    };
-
-    ctx->device.updateDescriptorSets(1, &writeSet, 0, nullptr);
+    Write(targetDescriptor.GetIndex(), { .type = descType, .info = createInfo });
 }
 
 void VkBindlessDescriptorSet::UpdateDescriptor(BindlessHandle targetDescriptor,
                                                ::vk::DescriptorImageInfo createInfo,
                                                ::vk::DescriptorType descType)
 {
-    const ::vk::WriteDescriptorSet writeSet{
-        .dstSet = *descriptorSet,
-        .dstBinding = 0,
-        .dstArrayElement = targetDescriptor.GetIndex(),
-        .descriptorCount = 1,
-        .descriptorType = descType,
-        .pImageInfo = &createInfo,
-    };
-
-    ctx->device.updateDescriptorSets(1, &writeSet, 0, nullptr);
+    Write(targetDescriptor.GetIndex(), { .type = descType, .info = createInfo });
 }
 
 void VkBindlessDescriptorSet::SetDescriptorToNull(u32 index)
 {
     // We copy in any arbitrary null descriptor, in this case its a null buffer.
-    const ::vk::WriteDescriptorSet nullWriteDescriptorSet{
-        .dstSet = *descriptorSet,
-        .dstBinding = 0,
-        .dstArrayElement = index,
-        .descriptorCount = 1,
-        .descriptorType = ::vk::DescriptorType::eStorageBuffer,
-        .pImageInfo = nullptr,
-        .pBufferInfo = &NullDescriptorBufferInfo,
-        .pTexelBufferView = nullptr,
-    };
-    ctx->device.updateDescriptorSets(1, &nullWriteDescriptorSet, 0, nullptr);
+    Write(index, { .type = ::vk::DescriptorType::eStorageBuffer, .info = NullDescriptorBufferInfo });
+}
+
+void VkBindlessDescriptorSet::FlushPendingWrites()
+{
+    if (pendingWrites.empty())
+    {
+        return;
+    }
+
+    std::vector<::vk::WriteDescriptorSet> writeSets;
+    writeSets.reserve(pendingWrites.size());
+    for (const auto& [index, pendingWrite] : pendingWrites)
+    {
+        ::vk::WriteDescriptorSet writeSet{
+            .dstSet = *descriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = pendingWrite.type,
+        };
+        std::visit(Visitor{
+                       [&writeSet](const ::vk::DescriptorImageInfo& imageInfo) { writeSet.pImageInfo = &imageInfo; },
+                       [&writeSet](const ::vk::DescriptorBufferInfo& bufferInfo)
+                       { writeSet.pBufferInfo = &bufferInfo; },
+                   },
+                   pendingWrite.info);
+        writeSets.push_back(writeSet);
+    }
+
+    ctx->device.updateDescriptorSets(writeSets.size(), writeSets.data(), 0, nullptr);
+    pendingWrites.clear();
+}
+
+void VkBindlessDescriptorSet::DiscardPendingWrites(u32 firstIndex, u32 count)
+{
+    // Freed ranges can span the whole dynamic descriptor ring, iterate over whichever is smaller.
+    if (count < pendingWrites.size())
+    {
+        for (u32 index = firstIndex; index < firstIndex + count; ++index)
+        {
+            pendingWrites.erase(index);
+        }
+        return;
+    }
+
+    std::erase_if(pendingWrites,
+                  [firstIndex, count](const auto& pendingWrite)
+                  { return pendingWrite.first >= firstIndex && pendingWrite.first - firstIndex < count; });
+}
+
+void VkBindlessDescriptorSet::Write(u32 index, const PendingWrite& write)
+{
+    if (ctx->useDescriptorBuffer)
+    {
+        // Each descriptor owns its bytes of the mapped buffer, writing it does not touch any other descriptor or driver
+        // state, so there is nothing to batch.
+        WriteToDescriptorBuffer(index, write);
+        return;
+    }
+
+    pendingWrites[index] = write;
+}
+
+void VkBindlessDescriptorSet::WriteToDescriptorBuffer(u32 index, const PendingWrite& pendingWrite)
+{
+    ::vk::DescriptorGetInfoEXT getInfo{ .type = pendingWrite.type };
+    // Referenced by getInfo, buffer descriptors are described by their device address.
+    ::vk::DescriptorAddressInfoEXT addressInfo;
+    std::visit(Visitor{
+                   [&](const ::vk::DescriptorImageInfo& imageInfo)
+                   {
+                       switch (pendingWrite.type)
+                       {
+                       case ::vk::DescriptorType::eSampler:
+                           getInfo.data.pSampler = &imageInfo.sampler;
+                           break;
+                       case ::vk::DescriptorType::eStorageImage:
+                           getInfo.data.pStorageImage = &imageInfo;
+                           break;
+                       default:
+                           getInfo.data.pSampledImage = &imageInfo;
+                           break;
+                       }
+                   },
+                   [&](const ::vk::DescriptorBufferInfo& bufferInfo)
+                   {
+                       // A null address info results in a null descriptor.
+                       const ::vk::DescriptorAddressInfoEXT* bufferAddressInfo = nullptr;
+                       if (bufferInfo.buffer)
+                       {
+                           const ::vk::BufferDeviceAddressInfo deviceAddressInfo{ .buffer = bufferInfo.buffer };
+                           const ::vk::DeviceAddress address = VEX_VK_CHECK <<=
+                               ctx->device.getBufferAddress(deviceAddressInfo);
+                           addressInfo = { .address = address + bufferInfo.offset, .range = bufferInfo.range };
+                           bufferAddressInfo = &addressInfo;
+                       }
+
+                       if (pendingWrite.type == ::vk::DescriptorType::eUniformBuffer)
+                       {
+                           getInfo.data.pUniformBuffer = bufferAddressInfo;
+                       }
+                       else
+                       {
+                           getInfo.data.pStorageBuffer = bufferAddressInfo;
+                       }
+                   },
+               },
+               pendingWrite.info);
+
+    const u64 descriptorSize =
+        GetDescriptorBufferDescriptorSize(descriptorBufferProperties, pendingWrite.type, ctx->robustBufferAccess);
+    ctx->device.getDescriptorEXT(getInfo,
+                                 descriptorSize,
+                                 descriptorBuffer.mappedData + descriptorBufferOffset + index * descriptorBufferStride);
 }
 
 } // namespace vex::vk
\ No newline at end of file
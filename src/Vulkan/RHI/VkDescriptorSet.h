@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <unordered_map>
 #include <variant>
 
 #include <Vex/Utility/NonNullPtr.h>
@@ -35,21 +36,72 @@ private:
     friend class VkCommandList;
 };
 
+// Descriptor writes are deferred until FlushPendingWrites, so that creating many bindless views results in a single
+// descriptor update.
+// When the device uses descriptor buffers, the descriptors are instead written immediately into a host visible
+// descriptor buffer, bound by command lists in place of the descriptor set. Writes to different descriptors are then
+// independent of each other.
 class VkBindlessDescriptorSet final
 {
 public:
-    VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx, const ::vk::DescriptorPool& descriptorPool);
+    struct DescriptorBuffer
+    {
+        ::vk::UniqueDeviceMemory memory;
+        ::vk::UniqueBuffer buffer;
+        ::vk::DeviceAddress address = 0;
+        byte* mappedData = nullptr;
+    };
+
+    // The layout allows up to maxDescriptorCount descriptors, the set itself is allocated with descriptorCount.
+    VkBindlessDescriptorSet(NonNullPtr<VkGPUContext> ctx, u32 descriptorCount, u32 maxDescriptorCount);
     void UpdateDescriptor(BindlessHandle targetDescriptor, ::vk::DescriptorImageInfo createInfo, bool writeAccess);
     void UpdateDescriptor(BindlessHandle targetDescriptor,
                           ::vk::DescriptorType descType,
                           ::vk::DescriptorBufferInfo createInfo);
     void UpdateDescriptor(BindlessHandle targetDescriptor, ::vk::DescriptorImageInfo createInfo, ::vk::DescriptorType descType);
     void SetDescriptorToNull(u32 index);
+    void FlushPendingWrites();
+    // Drops the pending writes of the descriptors in [firstIndex, firstIndex + count).
+    void DiscardPendingWrites(u32 firstIndex, u32 count);
+
+    // Allocates a new pool and set holding descriptorCount descriptors, replacing the current ones. With descriptor
+    // buffers, allocates a new descriptor buffer instead.
+    void Allocate(u32 descriptorCount);
 
+    // Byte size of a descriptor buffer holding descriptorCount descriptors.
+    u64 GetDescriptorBufferByteSize(u32 descriptorCount) const;
+    // Byte size of a bindless descriptor in a descriptor buffer, the largest size of the types it can hold.
+    static u64 GetDescriptorBufferStride(const ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT& properties,
+                                         bool robustBufferAccess);
+
+    // The set is allocated from its own pool, so that both can be replaced when growing the set.
+    ::vk::UniqueDescriptorPool descriptorPool;
     ::vk::UniqueDescriptorSet descriptorSet;
     ::vk::UniqueDescriptorSetLayout descriptorLayout;
+    // Only used with descriptor buffers, replaces the pool and set.
+    DescriptorBuffer descriptorBuffer;
     NonNullPtr<VkGPUContext> ctx;
 
+private:
+    struct PendingWrite
+    {
+        ::vk::DescriptorType type;
+        std::variant<::vk::DescriptorImageInfo, ::vk::DescriptorBufferInfo> info;
+    };
+
+    void AllocateDescriptorBuffer(u32 descriptorCount);
+    // Writes the descriptor into the descriptor buffer, or defers it to the next flush when using descriptor sets.
+    void Write(u32 index, const PendingWrite& write);
+    void WriteToDescriptorBuffer(u32 index, const PendingWrite& pendingWrite);
+    // Only used with descriptor sets. Keyed by descriptor index: a later write replaces the pending one, which also
+    // avoids flushing a write referencing a view destroyed since then.
+    std::unordered_map<u32, PendingWrite> pendingWrites;
+
+    ::vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties;
+    // Offset of the bindless binding within the descriptor buffer, and byte size of each of its descriptors.
+    ::vk::DeviceSize descriptorBufferOffset = 0;
+    u64 descriptorBufferStride = 0;
+
     friend class VkDescriptorPool;
     friend class VkResourceLayout;
 };
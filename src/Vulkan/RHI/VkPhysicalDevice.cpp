@@ -20,6 +20,13 @@ VkPhysicalDevice::VkPhysicalDevice(const ::vk::PhysicalDevice& dev)
     ::vk::PhysicalDeviceFeatures2 features2_vk12;
     physicalDevice.getFeatures2(&features2_vk12);
 
+    // Get the draw indirect count feature
+    ::vk::PhysicalDeviceVulkan12Features drawIndirectCountFeatures;
+    ::vk::PhysicalDeviceFeatures2 drawIndirectCountFeatures2;
+    drawIndirectCountFeatures2.setPNext(&drawIndirectCountFeatures);
+    physicalDevice.getFeatures2(&drawIndirectCountFeatures2);
+    supportsDrawIndirectCount = drawIndirectCountFeatures.drawIndirectCount;
+
     // Get vk 1.3 features
     ::vk::PhysicalDeviceFeatures2 features2_vk13;
     features2_vk13.setPNext(&vulkan13Features);
@@ -39,6 +46,23 @@ VkPhysicalDevice::VkPhysicalDevice(const ::vk::PhysicalDevice& dev)
     ::vk::PhysicalDeviceFeatures2 descriptorIndexingFeatures2;
     descriptorIndexingFeatures2.setPNext(&descriptorIndexingFeatures);
     physicalDevice.getFeatures2(&descriptorIndexingFeatures2);
+
+    // Get descriptor buffer features
+    ::vk::PhysicalDeviceFeatures2 descriptorBufferFeatures2;
+    descriptorBufferFeatures2.setPNext(&descriptorBufferFeatures);
+    physicalDevice.getFeatures2(&descriptorBufferFeatures2);
+
+    // Get graphics pipeline library features
+    ::vk::PhysicalDeviceFeatures2 graphicsPipelineLibraryFeatures2;
+    graphicsPipelineLibraryFeatures2.setPNext(&graphicsPipelineLibraryFeatures);
+    physicalDevice.getFeatures2(&graphicsPipelineLibraryFeatures2);
+
+    if (graphicsPipelineLibraryFeatures.graphicsPipelineLibrary)
+    {
+        ::vk::PhysicalDeviceProperties2 graphicsPipelineLibraryProperties2;
+        graphicsPipelineLibraryProperties2.setPNext(&graphicsPipelineLibraryProperties);
+        physicalDevice.getProperties2(&graphicsPipelineLibraryProperties2);
+    }
 }
 
 double VkPhysicalDevice::GetDeviceVRAMSize(const ::vk::PhysicalDevice& physicalDevice)
@@ -68,6 +92,10 @@ bool VkPhysicalDevice::IsFeatureSupported(Feature feature) const
         return meshShaderFeatures.meshShader && meshShaderFeatures.taskShader;
     case Feature::RayTracing:
         return rayTracingFeatures.rayTracingPipeline;
+    case Feature::MultiDrawIndirect:
+        return deviceFeatures.multiDrawIndirect;
+    case Feature::DrawIndirectCount:
+        return supportsDrawIndirectCount;
     default:
         VEX_LOG(Fatal, "Unable to determine feature support for {}", feature);
         return false;
@@ -245,7 +273,8 @@ bool VkPhysicalDevice::SupportsMinimalRequirements() const
                             descriptorIndexingFeatures.shaderUniformBufferArrayNonUniformIndexing &&
                             descriptorIndexingFeatures.descriptorBindingUniformBufferUpdateAfterBind &&
                             descriptorIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing &&
-                            descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind;
+                            descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind &&
+                            descriptorIndexingFeatures.descriptorBindingVariableDescriptorCount;
     if (!supportsBindless)
     {
         return false;
@@ -258,6 +287,17 @@ bool VkPhysicalDevice::SupportsMinimalRequirements() const
     return true;
 }
 
+bool VkPhysicalDevice::SupportsDescriptorBuffer() const
+{
+    return descriptorBufferFeatures.descriptorBuffer;
+}
+
+bool VkPhysicalDevice::SupportsGraphicsPipelineLibrary() const
+{
+    return graphicsPipelineLibraryFeatures.graphicsPipelineLibrary &&
+           graphicsPipelineLibraryProperties.graphicsPipelineLibraryFastLinking;
+}
+
 bool VkPhysicalDevice::FormatSupportsLinearFiltering(TextureFormat format, bool isSRGB) const
 {
     ::vk::FormatProperties formatProperties = physicalDevice.getFormatProperties(TextureFormatToVulkan(format, isSRGB));
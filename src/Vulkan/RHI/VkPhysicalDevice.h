@@ -37,6 +37,9 @@ public:
     std::string_view GetMaxSupportedSpirVVersion() const;
     std::string_view GetMaxSupportedVulkanVersion() const;
     bool SupportsMinimalRequirements() const override;
+    bool SupportsDescriptorBuffer() const;
+    // Graphics pipeline libraries are only used when they can be fast-linked.
+    bool SupportsGraphicsPipelineLibrary() const;
 
 private:
     ::vk::PhysicalDeviceProperties deviceProperties;
@@ -46,6 +49,10 @@ private:
     ::vk::PhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures;
     ::vk::PhysicalDeviceRayTracingPipelineFeaturesKHR rayTracingFeatures;
     ::vk::PhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures;
+    ::vk::PhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures;
+    ::vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures;
+    ::vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphicsPipelineLibraryProperties;
+    bool supportsDrawIndirectCount = false;
 };
 
 } // namespace vex::vk
\ No newline at end of file
@@ -17,17 +17,170 @@
 
 namespace vex::vk
 {
-VkGraphicsPipelineState::VkGraphicsPipelineState(const Key& key, ::vk::Device device, ::vk::PipelineCache psoCache)
+VkGraphicsPipelineLibraryCache::VkGraphicsPipelineLibraryCache(::vk::Device device)
+    : device{ device }
+{
+}
+
+VkGraphicsPipelineLibraryCache::Libraries VkGraphicsPipelineLibraryCache::GetLibraries(
+    ::vk::PipelineCache psoCache,
+    const GraphicsPSOKey& key,
+    const ::vk::GraphicsPipelineCreateInfo& pipelineCI,
+    u32 layoutVersion)
+{
+    using enum ::vk::GraphicsPipelineLibraryFlagBitsEXT;
+    return {
+        GetOrCreateLibrary(psoCache,
+                           vertexInputLibraries,
+                           VkVertexInputLibraryKey{ key.vertexInputLayout, key.inputAssembly },
+                           layoutVersion,
+                           eVertexInputInterface,
+                           pipelineCI),
+        GetOrCreateLibrary(psoCache,
+                           preRasterizationLibraries,
+                           VkPreRasterizationLibraryKey{ key.vertexShader, key.rasterizerState },
+                           layoutVersion,
+                           ePreRasterizationShaders,
+                           pipelineCI),
+        GetOrCreateLibrary(psoCache,
+                           fragmentShaderLibraries,
+                           VkFragmentShaderLibraryKey{ key.pixelShader, key.depthStencilState },
+                           layoutVersion,
+                           eFragmentShader,
+                           pipelineCI),
+        GetOrCreateLibrary(psoCache,
+                           fragmentOutputLibraries,
+                           VkFragmentOutputLibraryKey{ key.colorBlendState, key.renderTargetState },
+                           layoutVersion,
+                           eFragmentOutputInterface,
+                           pipelineCI),
+    };
+}
+
+::vk::UniquePipeline VkGraphicsPipelineLibraryCache::Link(::vk::PipelineCache psoCache,
+                                                          const Libraries& libraries,
+                                                          ::vk::PipelineCreateFlags flags,
+                                                          ::vk::PipelineLayout layout,
+                                                          bool fastLink)
+{
+    std::array<::vk::Pipeline, std::tuple_size_v<Libraries>> libraryHandles;
+    std::ranges::transform(libraries,
+                           libraryHandles.begin(),
+                           [](const Library& library) { return library->get(); });
+
+    ::vk::PipelineLibraryCreateInfoKHR libraryCI{
+        .libraryCount = static_cast<u32>(libraryHandles.size()),
+        .pLibraries = libraryHandles.data(),
+    };
+
+    if (!fastLink)
+    {
+        flags |= ::vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+    }
+
+    ::vk::GraphicsPipelineCreateInfo graphicsPipelineCI{
+        .pNext = &libraryCI,
+        .flags = flags,
+        .layout = layout,
+    };
+
+    return VEX_VK_CHECK <<= device.createGraphicsPipelineUnique(psoCache, graphicsPipelineCI);
+}
+
+template <class Key>
+VkGraphicsPipelineLibraryCache::Library VkGraphicsPipelineLibraryCache::GetOrCreateLibrary(
+    ::vk::PipelineCache psoCache,
+    std::unordered_map<Key, CachedLibrary>& libraries,
+    const Key& key,
+    u32 layoutVersion,
+    ::vk::GraphicsPipelineLibraryFlagBitsEXT part,
+    const ::vk::GraphicsPipelineCreateInfo& pipelineCI)
+{
+    {
+        std::scoped_lock lock(mutex);
+        if (auto it = libraries.find(key); it != libraries.end() && it->second.layoutVersion == layoutVersion)
+        {
+            return it->second.library;
+        }
+    }
+
+    // Compiled outside of the lock, so that other threads can compile libraries meanwhile. Two threads could compile
+    // the same library, in which case the last one is kept.
+    Library library = std::make_shared<const ::vk::UniquePipeline>(CreateLibrary(psoCache, part, pipelineCI));
+
+    std::scoped_lock lock(mutex);
+    libraries.insert_or_assign(key, CachedLibrary{ .layoutVersion = layoutVersion, .library = library });
+    return library;
+}
+
+::vk::UniquePipeline VkGraphicsPipelineLibraryCache::CreateLibrary(::vk::PipelineCache psoCache,
+                                                                   ::vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                                                   const ::vk::GraphicsPipelineCreateInfo& pipelineCI)
+{
+    using enum ::vk::GraphicsPipelineLibraryFlagBitsEXT;
+
+    // The rendering info is only consumed by the fragment output part, other parts are compiled regardless of the
+    // render target formats.
+    ::vk::GraphicsPipelineLibraryCreateInfoEXT libraryPartCI{
+        .pNext = part == eFragmentOutputInterface ? pipelineCI.pNext : nullptr,
+        .flags = part,
+    };
+
+    ::vk::GraphicsPipelineCreateInfo libraryCI{
+        .pNext = &libraryPartCI,
+        .flags = pipelineCI.flags | ::vk::PipelineCreateFlagBits::eLibraryKHR |
+                 ::vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT,
+        .pDynamicState = pipelineCI.pDynamicState,
+        .layout = pipelineCI.layout,
+    };
+
+    // Each part only holds the states of its pipeline stages.
+    switch (part)
+    {
+    case eVertexInputInterface:
+        libraryCI.pVertexInputState = pipelineCI.pVertexInputState;
+        libraryCI.pInputAssemblyState = pipelineCI.pInputAssemblyState;
+        break;
+    case ePreRasterizationShaders:
+        libraryCI.stageCount = 1;
+        libraryCI.pStages = &pipelineCI.pStages[0];
+        libraryCI.pViewportState = pipelineCI.pViewportState;
+        libraryCI.pRasterizationState = pipelineCI.pRasterizationState;
+        break;
+    case eFragmentShader:
+        libraryCI.stageCount = 1;
+        libraryCI.pStages = &pipelineCI.pStages[1];
+        libraryCI.pMultisampleState = pipelineCI.pMultisampleState;
+        libraryCI.pDepthStencilState = pipelineCI.pDepthStencilState;
+        break;
+    case eFragmentOutputInterface:
+        libraryCI.pMultisampleState = pipelineCI.pMultisampleState;
+        libraryCI.pColorBlendState = pipelineCI.pColorBlendState;
+        break;
+    default:
+        VEX_ASSERT(false, "Unsupported graphics pipeline library part.");
+        break;
+    }
+
+    return VEX_VK_CHECK <<= device.createGraphicsPipelineUnique(psoCache, libraryCI);
+}
+
+VkGraphicsPipelineState::VkGraphicsPipelineState(const Key& key,
+                                                 ::vk::Device device,
+                                                 ::vk::PipelineCache psoCache,
+                                                 VkGraphicsPipelineLibraryCache* libraryCache)
     : RHIGraphicsPipelineStateBase(key)
     , device{ device }
     , psoCache{ psoCache }
+    , libraryCache{ libraryCache }
 {
     GraphicsPiplineUtils::ValidateGraphicsPipeline(key);
 }
 
 void VkGraphicsPipelineState::Compile(const ShaderView& vertexShader,
                                       const ShaderView& pixelShader,
-                                      RHIResourceLayout& resourceLayout)
+                                      RHIResourceLayout& resourceLayout,
+                                      bool allowFastLink)
 {
     Span<const byte> vsCode = vertexShader.bytecode;
     ::vk::ShaderModuleCreateInfo vsShaderModuleCreateInfo{
@@ -182,6 +335,7 @@ void VkGraphicsPipelineState::Compile(const ShaderView& vertexShader,
     };
 
     ::vk::GraphicsPipelineCreateInfo graphicsPipelineCI{ .pNext = &pipelineRenderingCI,
+                                                         .flags = resourceLayout.GetPipelineCreateFlags(),
                                                          .stageCount = stages.size(),
                                                          .pStages = stages.data(),
                                                          .pVertexInputState = &pipelineVertexInputStateCI,
@@ -198,7 +352,19 @@ void VkGraphicsPipelineState::Compile(const ShaderView& vertexShader,
                                                          .basePipelineHandle = nullptr,
                                                          .basePipelineIndex = -1 };
 
-    graphicsPipeline = VEX_VK_CHECK <<= device.createGraphicsPipelineUnique(psoCache, graphicsPipelineCI);
+    if (libraryCache)
+    {
+        // Only the parts of the pipeline which were never compiled before are compiled, then the parts are linked.
+        // Fast-linked pipelines are later replaced by a link time optimized one.
+        libraries = libraryCache->GetLibraries(psoCache, key, graphicsPipelineCI, resourceLayout.version);
+        graphicsPipeline = libraryCache->Link(
+            psoCache, libraries, graphicsPipelineCI.flags, graphicsPipelineCI.layout, allowFastLink);
+        isFastLinked = allowFastLink;
+    }
+    else
+    {
+        graphicsPipeline = VEX_VK_CHECK <<= device.createGraphicsPipelineUnique(psoCache, graphicsPipelineCI);
+    }
 
     rootSignatureVersion = resourceLayout.version;
 
@@ -211,8 +377,9 @@ std::unique_ptr<RHIGraphicsPipelineState> VkGraphicsPipelineState::Cleanup()
     {
         return nullptr;
     }
-    auto cleanupPSO = std::make_unique<VkGraphicsPipelineState>(key, device, psoCache);
+    auto cleanupPSO = std::make_unique<VkGraphicsPipelineState>(key, device, psoCache, libraryCache);
     std::swap(cleanupPSO->graphicsPipeline, graphicsPipeline);
+    std::swap(cleanupPSO->libraries, libraries);
     return cleanupPSO;
 }
 
@@ -236,6 +403,7 @@ void VkComputePipelineState::Compile(const ShaderView& computeShader, RHIResourc
     std::string computeShaderEntryPoint{ computeShader.entryPoint };
 
     ::vk::ComputePipelineCreateInfo computePipelineCreateInfo{
+        .flags = resourceLayout.GetPipelineCreateFlags(),
         .stage =
             ::vk::PipelineShaderStageCreateInfo{
                 .stage = ::vk::ShaderStageFlagBits::eCompute,
@@ -363,6 +531,7 @@ std::vector<MaybeUninitialized<RHIBuffer>> VkRayTracingPipelineState::Compile(
     }
 
     ::vk::RayTracingPipelineCreateInfoKHR rtPSOCI{
+        .flags = resourceLayout.GetPipelineCreateFlags(),
         .stageCount = static_cast<u32>(stages.size()),
         .pStages = stages.data(),
         .groupCount = static_cast<u32>(groups.size()),
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <Vex/GraphicsPipeline.h>
+#include <Vex/Utility/Hash.h>
 #include <Vex/Utility/MaybeUninitialized.h>
 
 #include <RHI/RHIPipelineState.h>
@@ -11,6 +18,121 @@
 namespace vex::vk
 {
 
+// Keys of the parts of a graphics pipeline compiled as pipeline libraries, each only holding the state of its part.
+struct VkVertexInputLibraryKey
+{
+    VertexInputLayout vertexInputLayout;
+    InputAssembly inputAssembly;
+
+    constexpr bool operator==(const VkVertexInputLibraryKey&) const = default;
+};
+
+struct VkPreRasterizationLibraryKey
+{
+    SHA1HashDigest vertexShader;
+    RasterizerState rasterizerState;
+
+    constexpr bool operator==(const VkPreRasterizationLibraryKey&) const = default;
+};
+
+struct VkFragmentShaderLibraryKey
+{
+    SHA1HashDigest pixelShader;
+    DepthStencilState depthStencilState;
+
+    constexpr bool operator==(const VkFragmentShaderLibraryKey&) const = default;
+};
+
+struct VkFragmentOutputLibraryKey
+{
+    ColorBlendState colorBlendState;
+    RenderTargetState renderTargetState;
+
+    constexpr bool operator==(const VkFragmentOutputLibraryKey&) const = default;
+};
+
+} // namespace vex::vk
+
+// clang-format off
+
+VEX_MAKE_HASHABLE(vex::vk::VkVertexInputLibraryKey,
+    VEX_HASH_COMBINE(seed, obj.vertexInputLayout);
+    VEX_HASH_COMBINE(seed, obj.inputAssembly);
+);
+
+VEX_MAKE_HASHABLE(vex::vk::VkPreRasterizationLibraryKey,
+    VEX_HASH_COMBINE(seed, obj.vertexShader);
+    VEX_HASH_COMBINE(seed, obj.rasterizerState);
+);
+
+VEX_MAKE_HASHABLE(vex::vk::VkFragmentShaderLibraryKey,
+    VEX_HASH_COMBINE(seed, obj.pixelShader);
+    VEX_HASH_COMBINE(seed, obj.depthStencilState);
+);
+
+VEX_MAKE_HASHABLE(vex::vk::VkFragmentOutputLibraryKey,
+    VEX_HASH_COMBINE(seed, obj.colorBlendState);
+    VEX_HASH_COMBINE(seed, obj.renderTargetState);
+);
+
+// clang-format on
+
+namespace vex::vk
+{
+
+// Caches the parts of graphics pipelines compiled separately with VK_EXT_graphics_pipeline_library: vertex input,
+// pre-rasterization shaders, fragment shader and fragment output. A new pipeline state only compiles the parts which
+// are not cached yet, the parts are then linked together. Thread-safe, pipeline states are compiled on worker threads.
+class VkGraphicsPipelineLibraryCache
+{
+public:
+    // Linked pipelines keep their libraries alive.
+    using Library = std::shared_ptr<const ::vk::UniquePipeline>;
+    using Libraries = std::array<Library, 4>;
+
+    VkGraphicsPipelineLibraryCache(::vk::Device device);
+
+    // Returns the libraries of each part of the pipeline, compiled from the matching states of pipelineCI.
+    Libraries GetLibraries(::vk::PipelineCache psoCache,
+                           const GraphicsPSOKey& key,
+                           const ::vk::GraphicsPipelineCreateInfo& pipelineCI,
+                           u32 layoutVersion);
+
+    // Fast-linking skips link time optimizations, the resulting pipeline is quick to create but can execute slower.
+    ::vk::UniquePipeline Link(::vk::PipelineCache psoCache,
+                              const Libraries& libraries,
+                              ::vk::PipelineCreateFlags flags,
+                              ::vk::PipelineLayout layout,
+                              bool fastLink);
+
+private:
+    struct CachedLibrary
+    {
+        // Libraries compiled against a previous version of the resource layout are recompiled.
+        u32 layoutVersion;
+        Library library;
+    };
+
+    template <class Key>
+    Library GetOrCreateLibrary(::vk::PipelineCache psoCache,
+                               std::unordered_map<Key, CachedLibrary>& libraries,
+                               const Key& key,
+                               u32 layoutVersion,
+                               ::vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                               const ::vk::GraphicsPipelineCreateInfo& pipelineCI);
+    ::vk::UniquePipeline CreateLibrary(::vk::PipelineCache psoCache,
+                                       ::vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                       const ::vk::GraphicsPipelineCreateInfo& pipelineCI);
+
+    ::vk::Device device;
+
+    std::mutex mutex;
+    std::unordered_map<VkVertexInputLibraryKey, CachedLibrary> vertexInputLibraries;
+    std::unordered_map<VkPreRasterizationLibraryKey, CachedLibrary> preRasterizationLibraries;
+    std::unordered_map<VkFragmentShaderLibraryKey, CachedLibrary> fragmentShaderLibraries;
+    std::unordered_map<VkFragmentOutputLibraryKey, CachedLibrary> fragmentOutputLibraries;
+};
+
 class VkGraphicsPipelineState final : public RHIGraphicsPipelineStateBase
 {
 public:
@@ -30,12 +152,18 @@ public:
         return seed;
     });
 
-    VkGraphicsPipelineState(const Key& key, ::vk::Device device, ::vk::PipelineCache psoCache);
+    // The library cache is null when fast linking is disabled or the device does not support graphics pipeline
+    // libraries, pipelines are then always compiled as a whole.
+    VkGraphicsPipelineState(const Key& key,
+                            ::vk::Device device,
+                            ::vk::PipelineCache psoCache,
+                            VkGraphicsPipelineLibraryCache* libraryCache);
     VkGraphicsPipelineState(VkGraphicsPipelineState&&) = default;
     VkGraphicsPipelineState& operator=(VkGraphicsPipelineState&&) = default;
     virtual void Compile(const ShaderView& vertexShader,
                          const ShaderView& pixelShader,
-                         RHIResourceLayout& resourceLayout) override;
+                         RHIResourceLayout& resourceLayout,
+                         bool allowFastLink) override;
     virtual std::unique_ptr<RHIGraphicsPipelineState> Cleanup() override;
 
     ::vk::UniquePipeline graphicsPipeline;
@@ -43,6 +171,8 @@ public:
 private:
     ::vk::Device device;
     ::vk::PipelineCache psoCache;
+    VkGraphicsPipelineLibraryCache* libraryCache;
+    VkGraphicsPipelineLibraryCache::Libraries libraries;
 };
 
 class VkComputePipelineState final : public RHIComputePipelineStateBase
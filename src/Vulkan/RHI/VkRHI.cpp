@@ -1,6 +1,7 @@
 #include "VkRHI.h"
 
 #include <algorithm>
+#include <cstring>
 #include <set>
 #include <utility>
 #include <variant>
@@ -88,7 +89,35 @@ struct DispatcherLifetime
 
 static DispatcherLifetime GDispatcherLifetime{};
 
-VkRHI::VkRHI(const PlatformWindowHandle& windowHandle, bool enableGPUDebugLayer, bool enableGPUBasedValidation)
+namespace VkRHI_Internal
+{
+
+// Serialized pipeline cache data can only be used by the exact device and driver which produced it, this is validated
+// using the header present at the start of the data.
+static bool IsPipelineCacheDataCompatible(::vk::PhysicalDevice physDevice, Span<const byte> cacheData)
+{
+    ::vk::PipelineCacheHeaderVersionOne header;
+    if (cacheData.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, cacheData.data(), sizeof(header));
+
+    const ::vk::PhysicalDeviceProperties properties = physDevice.getProperties();
+    return header.headerSize >= sizeof(header) && header.headerVersion == ::vk::PipelineCacheHeaderVersion::eOne &&
+           header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+           header.pipelineCacheUUID == properties.pipelineCacheUUID;
+}
+
+} // namespace VkRHI_Internal
+
+VkRHI::VkRHI(const PlatformWindowHandle& windowHandle,
+             bool enableGPUDebugLayer,
+             bool enableGPUBasedValidation,
+             bool useDescriptorBuffer,
+             bool enableGraphicsPipelineFastLinking)
+    : useDescriptorBuffer(useDescriptorBuffer)
+    , enableGraphicsPipelineFastLinking(enableGraphicsPipelineFastLinking)
 {
     // Reset global dispatcher, avoids potentially using stale pointers if a VulkanRHI was created previously.
     ::vk::ApplicationInfo appInfo{
@@ -369,6 +398,27 @@ void VkRHI::Init()
         };
     }
 
+    std::optional<::vk::PhysicalDeviceDescriptorBufferFeaturesEXT> featuresDescriptorBuffer;
+    if (useDescriptorBuffer && GPhysicalDevice->SupportsDescriptorBuffer())
+    {
+        ValidateAndAddExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        featuresDescriptorBuffer = { .descriptorBuffer = true };
+    }
+    else if (useDescriptorBuffer)
+    {
+        VEX_LOG(Warning, "Descriptor buffers are not supported by the device, falling back to descriptor sets.");
+    }
+
+    // Allows compiling graphics pipelines in separate parts, which are then quickly linked together. Only used for fast
+    // linking, graphics pipelines are otherwise compiled as a whole.
+    std::optional<::vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT> featuresGraphicsPipelineLibrary;
+    if (enableGraphicsPipelineFastLinking && GPhysicalDevice->SupportsGraphicsPipelineLibrary())
+    {
+        ValidateAndAddExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        ValidateAndAddExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        featuresGraphicsPipelineLibrary = { .graphicsPipelineLibrary = true };
+    }
+
     ::vk::PhysicalDeviceUnifiedImageLayoutsFeaturesKHR featuresUnifiedImageLayouts;
     featuresUnifiedImageLayouts.pNext = featuresAccelerationStructure ? &featuresAccelerationStructure : nullptr;
     featuresUnifiedImageLayouts.unifiedImageLayouts = true;
@@ -420,12 +470,15 @@ void VkRHI::Init()
     features12.descriptorBindingStorageBufferUpdateAfterBind = true;
     features12.descriptorBindingSampledImageUpdateAfterBind = true;
     features12.descriptorBindingStorageImageUpdateAfterBind = true;
+    features12.descriptorBindingVariableDescriptorCount = true;
     features12.bufferDeviceAddress = true;
     features12.vulkanMemoryModel = true;
     features12.vulkanMemoryModelDeviceScope = true;
     features12.storageBuffer8BitAccess = true;
     features12.scalarBlockLayout = true;
     features12.separateDepthStencilLayouts = true;
+    // Allows indirect draws to read their draw count from a GPU buffer.
+    features12.drawIndirectCount = GPhysicalDevice->IsFeatureSupported(Feature::DrawIndirectCount);
 
     ::vk::PhysicalDeviceVulkan11Features features11;
     features11.pNext = &features12;
@@ -439,7 +492,19 @@ void VkRHI::Init()
     // Without this, the semantic doesn't work in pixel shaders.
     physDeviceFeatures.geometryShader = true;
 
-    ::vk::DeviceCreateInfo deviceCreateInfo{ .pNext = &features11,
+    void* deviceFeatures = &features11;
+    if (featuresDescriptorBuffer)
+    {
+        featuresDescriptorBuffer->pNext = deviceFeatures;
+        deviceFeatures = &*featuresDescriptorBuffer;
+    }
+    if (featuresGraphicsPipelineLibrary)
+    {
+        featuresGraphicsPipelineLibrary->pNext = deviceFeatures;
+        deviceFeatures = &*featuresGraphicsPipelineLibrary;
+    }
+
+    ::vk::DeviceCreateInfo deviceCreateInfo{ .pNext = deviceFeatures,
                                              .queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size()),
                                              .pQueueCreateInfos = queueCreateInfos.data(),
                                              .enabledExtensionCount = static_cast<u32>(extensions.size()),
@@ -493,9 +558,15 @@ void VkRHI::Init()
     fences = { VkFence(*device), VkFence(*device), VkFence(*device) };
 
     PSOCache = VEX_VK_CHECK <<= device->createPipelineCacheUnique({});
+    if (featuresGraphicsPipelineLibrary)
+    {
+        pipelineLibraryCache = std::make_unique<VkGraphicsPipelineLibraryCache>(*device);
+    }
 
     // Initializes values for the first time
     GetGPUContext();
+    ctx->useDescriptorBuffer = featuresDescriptorBuffer.has_value();
+    ctx->robustBufferAccess = physDeviceFeatures.robustBufferAccess;
 
     // Collect unique, valid queue family indices for concurrent resource sharing (eConcurrent SharedMode flag).
     for (i32 family : { graphicsQueueFamily, computeQueueFamily, copyQueueFamily })
@@ -524,7 +595,7 @@ RHICommandPool VkRHI::CreateCommandPool()
 
 RHIGraphicsPipelineState VkRHI::CreateGraphicsPipelineState(const GraphicsPSOKey& key)
 {
-    return { key, *device, *PSOCache };
+    return { key, *device, *PSOCache, pipelineLibraryCache.get() };
 }
 
 RHIComputePipelineState VkRHI::CreateComputePipelineState(const ComputePSOKey& key)
@@ -542,14 +613,21 @@ RHIResourceLayout VkRHI::CreateResourceLayout(RHIDescriptorPool& descriptorPool)
     return { GetGPUContext(), descriptorPool };
 }
 
-RHITexture VkRHI::CreateTexture(RHIAllocator& allocator, const TextureDesc& desc)
+RHITexture VkRHI::CreateTexture(RHIAllocator& allocator, const TextureDesc& desc, ResourceLifetime lifetime)
+{
+    return { GetGPUContext(), allocator, TextureDesc(desc), lifetime };
+}
+
+RHIBuffer VkRHI::CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime)
 {
-    return { GetGPUContext(), allocator, TextureDesc(desc) };
+    return { GetGPUContext(), allocator, desc, lifetime };
 }
 
-RHIBuffer VkRHI::CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc)
+RHITexture VkRHI::CreateTransientTexture(RHIAllocator& allocator,
+                                         const TextureDesc& desc,
+                                         TransientMemoryPool& transientPool)
 {
-    return { GetGPUContext(), allocator, desc };
+    return { GetGPUContext(), allocator, TextureDesc(desc), ResourceLifetime::Transient, &transientPool };
 }
 
 RHIDescriptorPool VkRHI::CreateDescriptorPool()
@@ -572,6 +650,30 @@ RHIAccelerationStructure VkRHI::CreateAS(const AccelerationStructureDesc& desc)
     return { GetGPUContext(), desc };
 }
 
+void VkRHI::LoadPipelineCache(Span<const byte> cacheData)
+{
+    if (!VkRHI_Internal::IsPipelineCacheDataCompatible(physDevice, cacheData))
+    {
+        VEX_LOG(Warning,
+                "Pipeline cache data was created by another device or driver version, starting from an empty cache.");
+        return;
+    }
+
+    PSOCache = VEX_VK_CHECK <<= device->createPipelineCacheUnique({
+        .initialDataSize = cacheData.size(),
+        .pInitialData = cacheData.data(),
+    });
+    VEX_LOG(Info, "Loaded pipeline cache ({} bytes).", cacheData.size());
+}
+
+std::vector<byte> VkRHI::GetPipelineCacheData()
+{
+    const std::vector<u8> cacheData = VEX_VK_CHECK <<= device->getPipelineCacheData(*PSOCache);
+    std::vector<byte> result(cacheData.size());
+    std::memcpy(result.data(), cacheData.data(), cacheData.size());
+    return result;
+}
+
 ::vk::Instance VkRHI::GetNativeInstance()
 {
     return *instance;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <utility>
 
 #include <Vex/Utility/NonNullPtr.h>
@@ -20,10 +21,16 @@ struct PlatformWindowHandle;
 namespace vex::vk
 {
 
+class VkGraphicsPipelineLibraryCache;
+
 class VkRHI final : public RHIBase
 {
 public:
-    VkRHI(const PlatformWindowHandle& windowHandle, bool enableGPUDebugLayer, bool enableGPUBasedValidation);
+    VkRHI(const PlatformWindowHandle& windowHandle,
+          bool enableGPUDebugLayer,
+          bool enableGPUBasedValidation,
+          bool useDescriptorBuffer,
+          bool enableGraphicsPipelineFastLinking);
     VkRHI(const VkRHI&) = delete;
     VkRHI& operator=(const VkRHI&) = delete;
     VkRHI(VkRHI&&) = default;
@@ -42,8 +49,13 @@ public:
     virtual RHIRayTracingPipelineState CreateRayTracingPipelineState(const RayTracingPSOKey& key) override;
     virtual RHIResourceLayout CreateResourceLayout(RHIDescriptorPool& descriptorPool) override;
 
-    virtual RHITexture CreateTexture(RHIAllocator& allocator, const TextureDesc& desc) override;
-    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc) override;
+    virtual RHITexture CreateTexture(RHIAllocator& allocator,
+                                     const TextureDesc& desc,
+                                     ResourceLifetime lifetime) override;
+    virtual RHIBuffer CreateBuffer(RHIAllocator& allocator, const BufferDesc& desc, ResourceLifetime lifetime) override;
+    virtual RHITexture CreateTransientTexture(RHIAllocator& allocator,
+                                              const TextureDesc& desc,
+                                              TransientMemoryPool& transientPool) override;
 
     virtual RHIDescriptorPool CreateDescriptorPool() override;
 
@@ -53,6 +65,9 @@ public:
 
     virtual RHIAccelerationStructure CreateAS(const AccelerationStructureDesc& desc) override;
 
+    virtual void LoadPipelineCache(Span<const byte> cacheData) override;
+    virtual std::vector<byte> GetPipelineCacheData() override;
+
     ::vk::Instance GetNativeInstance();
     ::vk::Device GetNativeDevice()
     {
@@ -105,6 +120,8 @@ private:
     ::vk::UniqueDevice device;
     ::vk::PhysicalDevice physDevice;
     ::vk::UniquePipelineCache PSOCache;
+    // Null when fast linking is disabled or not supported by the device.
+    std::unique_ptr<VkGraphicsPipelineLibraryCache> pipelineLibraryCache;
 
     std::array<VkCommandQueue, QueueTypes::Count> queues;
     std::optional<std::array<VkFence, QueueTypes::Count>> fences;
@@ -112,6 +129,11 @@ private:
     // To be submitted when the next submission happens. Avoids submitting with an empty command buffer.
     std::array<std::vector<SyncToken>, QueueTypes::Count> pendingWaits;
 
+    // Requested at creation, only used if the device supports descriptor buffers.
+    bool useDescriptorBuffer = false;
+    // Requested at creation, only used if the device supports graphics pipeline libraries.
+    bool enableGraphicsPipelineFastLinking = false;
+
     friend class VkSwapChain;
 };
 
@@ -16,31 +16,40 @@ VkResourceLayout::VkResourceLayout(NonNullPtr<VkGPUContext> ctx, NonNullPtr<VkDe
     : ctx{ ctx }
     , descriptorPool{ descriptorPool }
 {
-    std::array<::vk::DescriptorType, MaxSamplerCount> descriptorTypes{};
-    std::fill_n(descriptorTypes.begin(), staticSamplers.size(), ::vk::DescriptorType::eSampler);
-    samplerSet = VkDescriptorSet(ctx, *descriptorPool->descriptorPool, descriptorTypes);
+    if (!ctx->useDescriptorBuffer)
+    {
+        std::array<::vk::DescriptorType, MaxSamplerCount> descriptorTypes{};
+        std::fill_n(descriptorTypes.begin(), staticSamplers.size(), ::vk::DescriptorType::eSampler);
+        samplerSet = VkDescriptorSet(ctx, *descriptorPool->descriptorPool, descriptorTypes);
+    }
 }
 
-::vk::PipelineLayout VkResourceLayout::GetPipelineLayout()
+void VkResourceLayout::UpdateLayout()
 {
     if (isDirty)
     {
         pipelineLayout = CreateLayout();
         isDirty = false;
     }
+}
+
+::vk::PipelineLayout VkResourceLayout::GetPipelineLayout()
+{
+    UpdateLayout();
     return *pipelineLayout;
 }
 
 ::vk::DescriptorSet VkResourceLayout::GetStaticSamplerDescriptorSet()
 {
-    if (isDirty)
-    {
-        pipelineLayout = CreateLayout();
-        isDirty = false;
-    }
+    UpdateLayout();
     return *samplerSet->descriptorSet;
 }
 
+::vk::PipelineCreateFlags VkResourceLayout::GetPipelineCreateFlags() const
+{
+    return ctx->useDescriptorBuffer ? ::vk::PipelineCreateFlagBits::eDescriptorBufferEXT : ::vk::PipelineCreateFlags{};
+}
+
 ::vk::ShaderStageFlags VkResourceLayout::GetPushConstantStageFlags()
 {
     return ::vk::ShaderStageFlagBits::eAll;
@@ -52,21 +61,12 @@ VkResourceLayout::VkResourceLayout(NonNullPtr<VkGPUContext> ctx, NonNullPtr<VkDe
                                    .offset = 0,
                                    .size = GPhysicalDevice->GetMaxLocalConstantsByteSize() };
 
-    std::array layouts = { *descriptorPool->GetBindlessSet().descriptorLayout, *samplerSet->descriptorLayout };
-    ::vk::PipelineLayoutCreateInfo createInfo{ .setLayoutCount = static_cast<u32>(layouts.size()),
-                                               .pSetLayouts = layouts.data(),
-                                               .pushConstantRangeCount = 1,
-                                               .pPushConstantRanges = &range };
-
-    ::vk::UniquePipelineLayout vkPipelineLayout = VEX_VK_CHECK <<= ctx->device.createPipelineLayoutUnique(createInfo);
-
-    std::vector<::vk::WriteDescriptorSet> writeSets;
-    // Needed because writeSets stores a pointer to descriptorImageInfos
+    // The previous samplers are only destroyed once the layouts using them are replaced.
+    std::vector<::vk::UniqueSampler> newSamplers;
     std::vector<::vk::DescriptorImageInfo> descriptorImageInfos;
-    writeSets.reserve(staticSamplers.size());
+    newSamplers.reserve(staticSamplers.size());
     descriptorImageInfos.reserve(staticSamplers.size());
 
-    vkSamplers.clear();
     for (u32 i = 0; i < staticSamplers.size(); ++i)
     {
         const StaticTextureSampler& sampler = staticSamplers[i];
@@ -75,10 +75,54 @@ VkResourceLayout::VkResourceLayout(NonNullPtr<VkGPUContext> ctx, NonNullPtr<VkDe
 
         descriptorImageInfos.emplace_back(*vkSampler);
 
-        vkSamplers.push_back(std::move(vkSampler));
+        newSamplers.push_back(std::move(vkSampler));
+    }
+
+    ::vk::DescriptorSetLayout samplerLayout;
+    if (ctx->useDescriptorBuffer)
+    {
+        // Pipelines using descriptor buffers cannot use descriptor sets, static samplers are embedded in the layout
+        // instead, which requires no memory in the descriptor buffer.
+        std::vector<::vk::DescriptorSetLayoutBinding> bindings;
+        bindings.reserve(newSamplers.size());
+        for (u32 i = 0; i < newSamplers.size(); ++i)
+        {
+            bindings.push_back(::vk::DescriptorSetLayoutBinding{
+                .binding = i,
+                .descriptorType = ::vk::DescriptorType::eSampler,
+                .descriptorCount = 1,
+                .stageFlags = ::vk::ShaderStageFlagBits::eAll,
+                .pImmutableSamplers = &*newSamplers[i],
+            });
+        }
+
+        ::vk::DescriptorSetLayoutCreateInfo samplerLayoutCI{
+            .flags = ::vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT |
+                     ::vk::DescriptorSetLayoutCreateFlagBits::eEmbeddedImmutableSamplersEXT,
+            .bindingCount = static_cast<u32>(bindings.size()),
+            .pBindings = bindings.data(),
+        };
+        embeddedSamplerLayout = VEX_VK_CHECK <<= ctx->device.createDescriptorSetLayoutUnique(samplerLayoutCI);
+        samplerLayout = *embeddedSamplerLayout;
+    }
+    else
+    {
+        samplerLayout = *samplerSet->descriptorLayout;
     }
 
-    samplerSet->UpdateDescriptors(0, descriptorImageInfos);
+    std::array layouts = { *descriptorPool->GetBindlessSet().descriptorLayout, samplerLayout };
+    ::vk::PipelineLayoutCreateInfo createInfo{ .setLayoutCount = static_cast<u32>(layouts.size()),
+                                               .pSetLayouts = layouts.data(),
+                                               .pushConstantRangeCount = 1,
+                                               .pPushConstantRanges = &range };
+
+    ::vk::UniquePipelineLayout vkPipelineLayout = VEX_VK_CHECK <<= ctx->device.createPipelineLayoutUnique(createInfo);
+
+    if (!ctx->useDescriptorBuffer)
+    {
+        samplerSet->UpdateDescriptors(0, descriptorImageInfos);
+    }
+    vkSamplers = std::move(newSamplers);
 
     version++;
 
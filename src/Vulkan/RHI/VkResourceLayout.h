@@ -18,14 +18,21 @@ class VkResourceLayout final : public RHIResourceLayoutBase
 public:
     VkResourceLayout(NonNullPtr<VkGPUContext> ctx, NonNullPtr<VkDescriptorPool> descriptorPool);
 
+    // Recreates the pipeline layout if it is dirty. Once updated, the layout can safely be read from multiple threads.
+    void UpdateLayout();
+
     ::vk::PipelineLayout GetPipelineLayout();
+    // Not used with descriptor buffers, static samplers are then embedded in the layout of the sampler set.
     ::vk::DescriptorSet GetStaticSamplerDescriptorSet();
+    // Flags required by the pipelines created with this layout.
+    ::vk::PipelineCreateFlags GetPipelineCreateFlags() const;
 
     static ::vk::ShaderStageFlags GetPushConstantStageFlags();
 
 private:
     ::vk::UniquePipelineLayout CreateLayout();
     MaybeUninitialized<VkDescriptorSet> samplerSet;
+    ::vk::UniqueDescriptorSetLayout embeddedSamplerLayout;
     std::vector<::vk::UniqueSampler> vkSamplers;
 
     NonNullPtr<VkGPUContext> ctx;
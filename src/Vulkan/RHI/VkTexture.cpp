@@ -166,13 +166,17 @@ VkTexture::VkTexture(NonNullPtr<VkGPUContext> ctx, TextureDesc&& inDescription,
     SetDebugName(ctx->device, *rawImage, std::format("{}: {}", magic_enum::enum_name(desc.type), desc.name).c_str());
 }
 
-VkTexture::VkTexture(NonNullPtr<VkGPUContext> ctx, RHIAllocator& allocator, TextureDesc&& inDescription)
-    : RHITextureBase(allocator)
+VkTexture::VkTexture(NonNullPtr<VkGPUContext> ctx,
+                     RHIAllocator& allocator,
+                     TextureDesc&& inDescription,
+                     ResourceLifetime lifetime,
+                     TransientMemoryPool* transientPool)
+    : RHITextureBase(allocator, lifetime)
     , ctx(ctx)
     , isBackBuffer(false)
 {
     desc = std::move(inDescription);
-    CreateImage(allocator);
+    CreateImage(allocator, transientPool);
 }
 
 ::vk::Image VkTexture::GetRawTexture()
@@ -207,10 +211,36 @@ BindlessHandle VkTexture::GetOrCreateBindlessView(const TextureBinding& binding,
         return it->second.handle;
     }
 
+    const BindlessHandle handle = descriptorPool.AllocateResourceDescriptor(lifetime);
+    bindlessCache[view] = CreateBindlessView(view, handle, descriptorPool);
+
+    return handle;
+}
+
+void VkTexture::TakeBindlessViews(RHITexture& source, RHIDescriptorPool& descriptorPool)
+{
+    for (auto& [view, entry] : source.bindlessCache)
+    {
+        if (entry.handle == GInvalidBindlessHandle)
+        {
+            continue;
+        }
+
+        bindlessCache[view] = CreateBindlessView(view, entry.handle, descriptorPool);
+    }
+    // The source's image views are destroyed along with it.
+    source.bindlessCache.clear();
+}
+
+VkTexture::CacheEntry VkTexture::CreateBindlessView(const VkTextureView& view,
+                                                    BindlessHandle handle,
+                                                    RHIDescriptorPool& descriptorPool)
+{
     ::vk::ImageViewUsageCreateInfo viewUsageInfo{};
     ::vk::ImageUsageFlags viewUsage = GetImageUsage(desc);
     // If creating an sRGB view, it can't have storage usage
-    if (binding.isSRGB)
+    const bool isSRGB = view.format != TextureFormatToVulkan(desc.format, false);
+    if (isSRGB)
     {
         viewUsage &= ~::vk::ImageUsageFlagBits::eStorage;
     }
@@ -222,16 +252,15 @@ BindlessHandle VkTexture::GetOrCreateBindlessView(const TextureBinding& binding,
         .viewType = TextureTypeToVulkan(view.viewType),
         .format = view.format,
         .subresourceRange = {
-            .aspectMask = VkTextureUtil::BindingAspectToVkAspectFlags(binding.subresource.GetSingleAspect(binding.texture.desc)),
+            .aspectMask = VkTextureUtil::BindingAspectToVkAspectFlags(view.subresource.GetSingleAspect(desc)),
             .baseMipLevel = view.subresource.startMip,
-            .levelCount = view.subresource.GetMipCount(binding.texture.desc),
+            .levelCount = view.subresource.GetMipCount(desc),
             .baseArrayLayer = view.subresource.startSlice,
-            .layerCount = view.subresource.GetSliceCount(binding.texture.desc),
+            .layerCount = view.subresource.GetSliceCount(desc),
         },
     };
 
     ::vk::UniqueImageView imageView = VEX_VK_CHECK <<= ctx->device.createImageViewUnique(viewCreate);
-    const BindlessHandle handle = descriptorPool.AllocateStaticDescriptor(DescriptorType::Resource);
 
     ::vk::ImageLayout viewLayout = ::vk::ImageLayout::eGeneral;
 
@@ -240,9 +269,7 @@ BindlessHandle VkTexture::GetOrCreateBindlessView(const TextureBinding& binding,
         ::vk::DescriptorImageInfo{ .sampler = nullptr, .imageView = *imageView, .imageLayout = viewLayout },
         view.usage & TextureUsage::ShaderReadWrite);
 
-    bindlessCache[view] = { .handle = handle, .view = std::move(imageView) };
-
-    return handle;
+    return { .handle = handle, .view = std::move(imageView) };
 }
 
 ::vk::ImageView VkTexture::GetOrCreateImageView(const TextureBinding& binding, TextureUsage::Type usage)
@@ -307,13 +334,17 @@ void VkTexture::FreeBindlessHandles(RHIDescriptorPool& descriptorPool)
 void VkTexture::FreeAllocation(RHIAllocator& allocator)
 {
 #if VEX_USE_CUSTOM_RESOURCE_ALLOCATOR
-    allocator.FreeResource(allocation);
+    // Transient memory is returned to its pool by the command context which created the texture.
+    if (lifetime != ResourceLifetime::Transient)
+    {
+        allocator.FreeResource(allocation);
+    }
 #else
     memory.release();
 #endif
 }
 
-void VkTexture::CreateImage(RHIAllocator& allocator)
+void VkTexture::CreateImage(RHIAllocator& allocator, TransientMemoryPool* transientPool)
 {
     if (isBackBuffer)
     {
@@ -386,7 +417,8 @@ void VkTexture::CreateImage(RHIAllocator& allocator)
     ::vk::MemoryRequirements imageMemoryReq = ctx->device.getImageMemoryRequirements(*imageTmp);
 
 #if VEX_USE_CUSTOM_RESOURCE_ALLOCATOR
-    auto [memory, newAllocation] = allocator.AllocateResource(desc.memoryLocality, imageMemoryReq);
+    auto [memory, newAllocation] =
+        allocator.AllocateResource(desc.memoryLocality, imageMemoryReq, lifetime, transientPool);
     allocation = newAllocation;
     VEX_VK_CHECK << ctx->device.bindImageMemory(*imageTmp, memory, allocation.memoryRange.offset);
 #else
@@ -65,8 +65,12 @@ public:
     VkTexture(NonNullPtr<VkGPUContext> ctx, const TextureDesc& desc, ::vk::UniqueImage rawImage);
     VkTexture(NonNullPtr<VkGPUContext> ctx, TextureDesc&& desc, ::vk::UniqueImage rawImage);
 
-    // Creates a new image from the description
-    VkTexture(NonNullPtr<VkGPUContext> ctx, RHIAllocator& allocator, TextureDesc&& desc);
+    // Creates a new image from the description, transient images are placed in the memory of the transient pool.
+    VkTexture(NonNullPtr<VkGPUContext> ctx,
+              RHIAllocator& allocator,
+              TextureDesc&& desc,
+              ResourceLifetime lifetime = ResourceLifetime::Static,
+              TransientMemoryPool* transientPool = nullptr);
 
     [[nodiscard]] ::vk::Image GetRawTexture();
 
@@ -81,6 +85,7 @@ public:
     ::vk::ImageView GetOrCreateImageView(const TextureBinding& binding, TextureUsage::Type usage);
 
     virtual void FreeBindlessHandles(RHIDescriptorPool& descriptorPool) override;
+    virtual void TakeBindlessViews(RHITexture& source, RHIDescriptorPool& descriptorPool) override;
     virtual void FreeAllocation(RHIAllocator& allocator) override;
 
     struct CacheEntry
@@ -93,7 +98,9 @@ public:
     std::unordered_map<VkTextureView, ::vk::UniqueImageView> viewCache;
 
 private:
-    void CreateImage(RHIAllocator& allocator);
+    void CreateImage(RHIAllocator& allocator, TransientMemoryPool* transientPool);
+    // Creates the image view of a bindless view and writes its descriptor to the passed-in handle.
+    CacheEntry CreateBindlessView(const VkTextureView& view, BindlessHandle handle, RHIDescriptorPool& descriptorPool);
 
     NonNullPtr<VkGPUContext> ctx;
 
@@ -17,6 +17,11 @@ struct VkGPUContext
     VkCommandQueue& graphicsPresentQueue;
 
     std::vector<u32> queueFamilyIndices;
+
+    // Bindless descriptors live in a descriptor buffer (VK_EXT_descriptor_buffer) instead of a descriptor set.
+    bool useDescriptorBuffer = false;
+    // Whether the robustBufferAccess feature is enabled on the device, buffer descriptors are larger when it is.
+    bool robustBufferAccess = false;
 };
 
 } // namespace vex::vk
@@ -130,6 +130,137 @@ TEST_F(AccelerationStructureTest, CreateMultipleTriangleBLAS_VertexAndIndex_Tran
     graphics.DestroyAccelerationStructure(blas2);
 }
 
+TEST_F(AccelerationStructureTest, BatchedBLASBuildAndCompaction)
+{
+    std::array<AccelerationStructure, 2> blas{
+        graphics.CreateAccelerationStructure(AccelerationStructureDesc{
+            .name = "BLAS1",
+            .type = ASType::BottomLevel,
+            .buildFlags = ASBuild::PreferFastTrace | ASBuild::AllowCompaction,
+        }),
+        graphics.CreateAccelerationStructure(AccelerationStructureDesc{
+            .name = "BLAS2",
+            .type = ASType::BottomLevel,
+            .buildFlags = ASBuild::PreferFastTrace | ASBuild::AllowCompaction,
+        }),
+    };
+
+    const BLASGeometryDesc geometry{
+        .vertexBufferBinding = { .buffer = triangleVertexBuffer, .strideByteSize = static_cast<u32>(sizeof(Vertex)), },
+        .indexBufferBinding = BufferBinding{ .buffer = triangleIndexBuffer, .strideByteSize = static_cast<u32>(sizeof(u32)), },
+        .transform = {{
+                1, 0, 0, 1,
+                0, 1, 0, 5,
+                0, 0, 1, -10,
+        }},
+        .flags = ASGeometry::Opaque,
+    };
+
+    auto ctx = graphics.CreateCommandContext(QueueType::Compute);
+    // Both BLAS share the same scratch buffer and are built by a single command.
+    ctx.BuildBLAS({
+        BLASBuild{ .accelerationStructure = blas[0], .desc = { .geometry = { geometry } } },
+        BLASBuild{ .accelerationStructure = blas[1], .desc = { .geometry = { geometry, geometry } } },
+    });
+    BufferReadbackContext readback = ctx.EnqueueCompactedSizeReadback(blas);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    std::array<u64, 2> compactedSizes{};
+    readback.ReadData(std::as_writable_bytes(std::span{ compactedSizes }));
+    EXPECT_GT(compactedSizes[0], 0);
+    // The second BLAS holds twice the geometry.
+    EXPECT_GT(compactedSizes[1], compactedSizes[0]);
+
+    auto compactCtx = graphics.CreateCommandContext(QueueType::Compute);
+    std::array<AccelerationStructure, 2> compactedBLAS;
+    for (u32 i = 0; i < blas.size(); ++i)
+    {
+        compactedBLAS[i] = graphics.CreateAccelerationStructure(
+            AccelerationStructureDesc{ .name = "CompactedBLAS", .type = ASType::BottomLevel });
+        compactCtx.CompactAccelerationStructure(blas[i], compactedBLAS[i], compactedSizes[i]);
+    }
+    graphics.WaitForTokenOnCPU(graphics.Submit(compactCtx));
+
+    // The compacted BLAS must no longer depend on the original ones.
+    for (const AccelerationStructure& originalBLAS : blas)
+    {
+        graphics.DestroyAccelerationStructure(originalBLAS);
+    }
+
+    // Trace a ray against each compacted BLAS, the instance transform moves the triangle back in front of the ray.
+    const std::string shaderPath = (VexRootPath / "tests/shaders/RayTracingAABB.hlsl").string();
+    const RayTracingShaderKey shaderKey{
+        .maxRecursionDepth = 1,
+        .maxPayloadByteSize = sizeof(float),
+        .maxAttributeByteSize = sizeof(float) * 2,
+        .rayGenerationShaders = {
+            ShaderKey{ .filepath = shaderPath, .entryPoint = "RayGenMain", .type = ShaderType::RayGenerationShader },
+        },
+        .rayMissShaders = {
+            ShaderKey{ .filepath = shaderPath, .entryPoint = "MissMain", .type = ShaderType::RayMissShader },
+        },
+        .hitGroups = {
+            HitGroupKey{
+                .name = "CompactedBLASHitGroup",
+                .rayClosestHitShader = {
+                    .filepath = shaderPath,
+                    .entryPoint = "ClosestHitMain",
+                    .type = ShaderType::RayClosestHitShader,
+                },
+            },
+        },
+    };
+    for (u32 i = 0; i < compactedBLAS.size(); ++i)
+    {
+        auto tlas = graphics.CreateAccelerationStructure(
+            AccelerationStructureDesc{ .name = "CompactedBLAS_TLAS", .type = ASType::TopLevel });
+        Buffer out = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("DataOut", sizeof(float), true));
+        const BufferBinding binding{
+            .buffer = out,
+            .usage = BufferBindingUsage::RWStructuredBuffer,
+            .strideByteSize = sizeof(float),
+        };
+
+        auto traceCtx = graphics.CreateCommandContext(QueueType::Compute);
+        traceCtx.BuildTLAS(tlas,
+                           { .instances = { TLASInstanceDesc{
+                                 .transform = {
+                                     1.0f, 0.0f, 0.0f, -0.5f,
+                                     0.0f, 1.0f, 0.0f, -4.3f,
+                                     0.0f, 0.0f, 1.0f, 10.0f,
+                                 },
+                                 .blas = compactedBLAS[i],
+                             } } });
+        struct Data
+        {
+            BindlessHandle outputHandle;
+            BindlessHandle tlasHandle;
+        } data{
+            .outputHandle = graphics.GetBindlessHandle(binding),
+            .tlasHandle = graphics.GetBindlessHandle(tlas),
+        };
+        traceCtx.TraceRays(shaderCompiler.GetRayTracingShaderCollection(shaderKey),
+                           ConstantBinding(data),
+                           { binding },
+                           { 1, 1, 1 });
+        BufferReadbackContext traceReadback = traceCtx.EnqueueDataReadback(out);
+        graphics.WaitForTokenOnCPU(graphics.Submit(traceCtx));
+
+        float result;
+        traceReadback.ReadData(std::as_writable_bytes(std::span<float>(&result, 1)));
+        // Written by the closest hit shader, the miss shader writes -1.
+        EXPECT_FLOAT_EQ(result, 1.0f);
+
+        graphics.DestroyAccelerationStructure(tlas);
+        graphics.DestroyBuffer(out);
+    }
+
+    for (const AccelerationStructure& compacted : compactedBLAS)
+    {
+        graphics.DestroyAccelerationStructure(compacted);
+    }
+}
+
 struct BLASFlagTestData
 {
     ASGeometry::Flags geometryFlags;
@@ -322,6 +453,54 @@ TEST_F(TLASAccelerationStructureTest, CreateSimpleTriangleTLAS_2Instances_Instan
     graphics.DestroyAccelerationStructure(tlas);
 }
 
+TEST_F(TLASAccelerationStructureTest, RefitBLASAndUpdateTLAS)
+{
+    auto blas = graphics.CreateAccelerationStructure(AccelerationStructureDesc{
+        .name = "Dynamic BLAS", .type = ASType::BottomLevel, .buildFlags = ASBuild::AllowUpdate });
+    auto tlas = graphics.CreateAccelerationStructure(AccelerationStructureDesc{
+        .name = "Dynamic TLAS", .type = ASType::TopLevel, .buildFlags = ASBuild::AllowUpdate });
+
+    auto getGeometry = [&](float offset)
+    {
+        return BLASGeometryDesc{
+            .vertexBufferBinding = { .buffer = triangleVertexBuffer, .strideByteSize = static_cast<u32>(sizeof(Vertex)), },
+            .indexBufferBinding = BufferBinding{ .buffer = triangleIndexBuffer, .strideByteSize = static_cast<u32>(sizeof(u32)), },
+            .transform = {{
+                    1, 0, 0, offset,
+                    0, 1, 0, 0,
+                    0, 0, 1, 0,
+            }},
+            .flags = ASGeometry::Opaque,
+        };
+    };
+    auto getInstances = [&](float offset)
+    {
+        return std::array{
+            TLASInstanceDesc{ .transform = { 1, 0, 0, offset, 0, 1, 0, 0, 0, 0, 1, 0 }, .blas = blas },
+            TLASInstanceDesc{ .transform = { 1, 0, 0, -offset, 0, 1, 0, 0, 0, 0, 1, 0 }, .blas = triangleBLAS },
+        };
+    };
+
+    auto ctx = graphics.CreateCommandContext(QueueType::Compute);
+    ctx.BuildBLAS(blas, { .geometry = { getGeometry(0) } });
+    ctx.BuildTLAS(tlas, { .instances = getInstances(0) });
+    SyncToken token = graphics.Submit(ctx);
+
+    // Animate the geometry and the instances over a few frames, refitting the acceleration structures in place.
+    for (u32 frame = 1; frame <= 3; ++frame)
+    {
+        const float offset = static_cast<float>(frame) * 0.1f;
+        auto updateCtx = graphics.CreateCommandContext(QueueType::Compute);
+        updateCtx.RefitBLAS(blas, { .geometry = { getGeometry(offset) } });
+        updateCtx.UpdateTLAS(tlas, { .instances = getInstances(offset) });
+        token = graphics.Submit(updateCtx, { token });
+    }
+    graphics.WaitForTokenOnCPU(token);
+
+    graphics.DestroyAccelerationStructure(tlas);
+    graphics.DestroyAccelerationStructure(blas);
+}
+
 struct TLASFlagTestData
 {
     ASInstance::Flags instanceFlags;
@@ -1,9 +1,17 @@
 ﻿#include "VexTest.h"
 
+#include <algorithm>
+#include <format>
+#include <functional>
+
 #include <gtest/gtest.h>
 
 #include "ShaderCompiler/Shader.h"
 
+#include <Vex/PhysicalDevice.h>
+
+#include <RHI/RHIDescriptorPool.h>
+
 using namespace vex;
 
 struct BufferBindingTestData
@@ -222,4 +230,428 @@ INSTANTIATE_TEST_SUITE_P(ByteAddressBufferTests,
                                                                     1.f * 10.f,
                                                                     2.f * 10.f,
                                                                     3.f * 10.f,
-                                                                } }));
\ No newline at end of file
+                                                                } }));
+
+TEST_F(VexTest, DispatchIndirectArgumentsReadFromBuffer)
+{
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Compute);
+
+    const std::array<float, 3> data{ 1.f, 2.f, 3.f };
+    Buffer dataBuffer = graphics.CreateBuffer(BufferDesc{ .name = "DataBuffer",
+                                                          .byteSize = sizeof(data),
+                                                          .usage = BufferUsage::ShaderRead });
+    Buffer resultBuffer =
+        graphics.CreateBuffer(BufferDesc{ .name = "ResultBuffer",
+                                          .byteSize = sizeof(data),
+                                          .usage = BufferUsage::ShaderRead | BufferUsage::ShaderReadWrite });
+    Buffer argsBuffer = graphics.CreateBuffer(BufferDesc{ .name = "ArgsBuffer",
+                                                          .byteSize = sizeof(DispatchIndirectArgs),
+                                                          .usage = BufferUsage::IndirectArgs });
+
+    const DispatchIndirectArgs args{ .groupCountX = 1, .groupCountY = 1, .groupCountZ = 1 };
+    ctx.EnqueueDataUpload(dataBuffer, std::as_bytes(std::span{ data }));
+    ctx.EnqueueDataUpload(argsBuffer, std::as_bytes(std::span{ &args, 1 }));
+
+    std::array<ResourceBinding, 2> bindings{
+        BufferBinding::CreateStructuredBuffer(dataBuffer, sizeof(data)),
+        BufferBinding::CreateRWStructuredBuffer(resultBuffer, sizeof(data)),
+    };
+    std::vector<BindlessHandle> handles = graphics.GetBindlessHandles(bindings);
+
+    struct ShaderUniform
+    {
+        BindlessHandle inputBuffer;
+        BindlessHandle outputBuffer;
+        u32 numElements{};
+    };
+    ShaderUniform uniforms{ handles[0], handles[1], 1 };
+
+    ShaderKey key {
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "0" },
+            { "STRUCTURED_BUFFER", "1" },
+            { "BYTE_ADDRESS_BUFFER", "0" },
+            { "READ_WRITE", "0" },
+        },
+    };
+
+    EXPECT_TRUE(ctx.DispatchIndirect(shaderCompiler.GetShaderView(key),
+                                     ConstantBinding(std::span{ &uniforms, 1 }),
+                                     bindings,
+                                     IndirectArgsBinding{ .argsBuffer = argsBuffer }));
+
+    BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(resultBuffer);
+
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    std::array<float, 3> result{};
+    readbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+
+    EXPECT_TRUE(result == data);
+}
+
+// Records the passed in indirect draw of IndirectDraw.hlsl's green fullscreen triangle into a render target cleared to
+// black, then returns the readback of the render target.
+template <class DrawFunc>
+static TextureReadbackContext ReadBackIndirectDraw(Graphics& graphics,
+                                               ShaderCompiler& shaderCompiler,
+                                               std::span<const std::byte> indirectArgs,
+                                               std::optional<u32> drawCount,
+                                               DrawFunc&& draw)
+{
+    static constexpr u32 RenderTargetSize = 16;
+    Texture renderTarget =
+        graphics.CreateTexture(CreateRenderTargetDesc("IndirectDrawRenderTarget", { 0, 0, 0, 1 }, RenderTargetSize));
+    Buffer argsBuffer = graphics.CreateBuffer(BufferDesc{ .name = "IndirectDrawArgsBuffer",
+                                                          .byteSize = indirectArgs.size(),
+                                                          .usage = BufferUsage::IndirectArgs });
+    // The count is placed after some padding, to make use of the count offset.
+    const std::array<u32, 2> counts{ 0, drawCount.value_or(0) };
+    Buffer countBuffer = graphics.CreateBuffer(BufferDesc{ .name = "IndirectDrawCountBuffer",
+                                                           .byteSize = sizeof(counts),
+                                                           .usage = BufferUsage::IndirectArgs });
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    ctx.EnqueueDataUpload(argsBuffer, indirectArgs);
+    ctx.EnqueueDataUpload(countBuffer, std::as_bytes(std::span{ counts }));
+    ctx.ClearTexture(renderTarget);
+    ctx.SetViewport(0, 0, RenderTargetSize, RenderTargetSize);
+    ctx.SetScissor(0, 0, RenderTargetSize, RenderTargetSize);
+
+    const std::string filepath = (VexRootPath / "tests/shaders/IndirectDraw.hlsl").string();
+    const DrawDesc drawDesc{
+        .vertexShader = shaderCompiler.GetShaderView({
+            .filepath = filepath,
+            .entryPoint = "VSMain",
+            .type = ShaderType::VertexShader,
+        }),
+        .pixelShader = shaderCompiler.GetShaderView({
+            .filepath = filepath,
+            .entryPoint = "PSMain",
+            .type = ShaderType::PixelShader,
+        }),
+        .rasterizerState = { .cullMode = CullMode::None },
+    };
+    const std::array renderTargets{ TextureBinding{ .texture = renderTarget } };
+    IndirectArgsBinding indirectArgsBinding{ .argsBuffer = argsBuffer };
+    if (drawCount)
+    {
+        indirectArgsBinding.maxCommandCount = 2;
+        indirectArgsBinding.countBuffer = countBuffer;
+        indirectArgsBinding.countOffsetByteSize = sizeof(u32);
+    }
+    EXPECT_TRUE(draw(ctx, drawDesc, renderTargets, indirectArgsBinding));
+
+    TextureReadbackContext readbackContext = ctx.EnqueueDataReadback(renderTarget);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    graphics.DestroyTexture(renderTarget);
+    graphics.DestroyBuffer(argsBuffer);
+    graphics.DestroyBuffer(countBuffer);
+    return readbackContext;
+}
+
+static constexpr std::array<u8, 4> IndirectDrawGreen{ 0x00, 0xFF, 0x00, 0xFF };
+static constexpr std::array<u8, 4> IndirectDrawBlack{ 0x00, 0x00, 0x00, 0xFF };
+
+TEST_F(VexTest, DrawIndirectArgumentsReadFromBuffer)
+{
+    const DrawIndirectArgs args{ .vertexCount = 3, .instanceCount = 1, .vertexOffset = 0, .instanceOffset = 0 };
+    const TextureReadbackContext readback = ReadBackIndirectDraw(
+        graphics,
+        shaderCompiler,
+        std::as_bytes(std::span{ &args, 1 }),
+        std::nullopt,
+        [](CommandContext& ctx,
+           const DrawDesc& drawDesc,
+           Span<const TextureBinding> renderTargets,
+           const IndirectArgsBinding& indirectArgs)
+        { return ctx.DrawIndirect(drawDesc, { .renderTargets = renderTargets }, {}, {}, indirectArgs); });
+
+    EXPECT_TRUE(ValidateTextureValue(readback, IndirectDrawGreen));
+}
+
+TEST_F(VexTest, DrawIndexedIndirectArgumentsReadFromBuffer)
+{
+    const std::array<u32, 3> indices{ 0, 1, 2 };
+    Buffer indexBuffer = graphics.CreateBuffer(BufferDesc::CreateIndexBufferDesc("IndirectDrawIndexBuffer",
+                                                                                  sizeof(indices)));
+    {
+        CommandContext uploadCtx = graphics.CreateCommandContext(QueueType::Graphics);
+        uploadCtx.EnqueueDataUpload(indexBuffer, std::as_bytes(std::span{ indices }));
+        graphics.WaitForTokenOnCPU(graphics.Submit(uploadCtx));
+    }
+
+    const DrawIndexedIndirectArgs args{
+        .indexCount = 3, .instanceCount = 1, .indexOffset = 0, .vertexOffset = 0, .instanceOffset = 0
+    };
+    const BufferBinding indexBufferBinding{ .buffer = indexBuffer, .strideByteSize = sizeof(u32) };
+    const TextureReadbackContext readback = ReadBackIndirectDraw(
+        graphics,
+        shaderCompiler,
+        std::as_bytes(std::span{ &args, 1 }),
+        std::nullopt,
+        [&indexBufferBinding](CommandContext& ctx,
+                              const DrawDesc& drawDesc,
+                              Span<const TextureBinding> renderTargets,
+                              const IndirectArgsBinding& indirectArgs)
+        {
+            return ctx.DrawIndexedIndirect(drawDesc,
+                                           { .renderTargets = renderTargets, .indexBuffer = indexBufferBinding },
+                                           {},
+                                           {},
+                                           indirectArgs);
+        });
+
+    EXPECT_TRUE(ValidateTextureValue(readback, IndirectDrawGreen));
+
+    graphics.DestroyBuffer(indexBuffer);
+}
+
+TEST_F(VexTest, DrawIndirectCountReadFromBuffer)
+{
+    if (!GPhysicalDevice->IsFeatureSupported(Feature::MultiDrawIndirect) ||
+        !GPhysicalDevice->IsFeatureSupported(Feature::DrawIndirectCount))
+    {
+        GTEST_SKIP() << "Indirect draw count buffers are not supported, skipping indirect draw count tests.";
+    }
+
+    const std::array<DrawIndirectArgs, 2> args{
+        DrawIndirectArgs{ .vertexCount = 3, .instanceCount = 1, .vertexOffset = 0, .instanceOffset = 0 },
+        DrawIndirectArgs{ .vertexCount = 3, .instanceCount = 1, .vertexOffset = 0, .instanceOffset = 0 },
+    };
+    const auto drawIndirect = [](CommandContext& ctx,
+                                 const DrawDesc& drawDesc,
+                                 Span<const TextureBinding> renderTargets,
+                                 const IndirectArgsBinding& indirectArgs)
+    { return ctx.DrawIndirect(drawDesc, { .renderTargets = renderTargets }, {}, {}, indirectArgs); };
+
+    // A count of zero skips every draw, regardless of the maximum command count.
+    EXPECT_TRUE(ValidateTextureValue(
+        ReadBackIndirectDraw(graphics, shaderCompiler, std::as_bytes(std::span{ args }), 0u, drawIndirect),
+        IndirectDrawBlack));
+    // Counts above the maximum command count are clamped to it.
+    EXPECT_TRUE(ValidateTextureValue(
+        ReadBackIndirectDraw(graphics, shaderCompiler, std::as_bytes(std::span{ args }), 5u, drawIndirect),
+        IndirectDrawGreen));
+}
+
+// Views created one at a time have their descriptor writes deferred to the next submission (Vulkan descriptor sets).
+TEST_F(VexTest, DeferredDescriptorWritesOfFreedViews)
+{
+    using Element = std::array<float, 3>;
+    static constexpr u32 BufferCount = 32;
+    static constexpr u32 FreedBufferIndex = 7;
+
+    std::vector<Buffer> dataBuffers;
+    std::vector<BufferBinding> dataBindings;
+    std::vector<BindlessHandle> dataHandles;
+    for (u32 i = 0; i < BufferCount; ++i)
+    {
+        const Buffer& buffer = dataBuffers.emplace_back(graphics.CreateBuffer(BufferDesc{
+            .name = std::format("DeferredWriteDataBuffer{}", i),
+            .byteSize = sizeof(Element),
+            .usage = BufferUsage::ShaderRead,
+        }));
+        const BufferBinding& binding =
+            dataBindings.emplace_back(BufferBinding::CreateStructuredBuffer(buffer, sizeof(Element)));
+        dataHandles.push_back(graphics.GetBindlessHandle(binding));
+    }
+    Buffer resultBuffer =
+        graphics.CreateBuffer(BufferDesc{ .name = "DeferredWriteResultBuffer",
+                                          .byteSize = sizeof(Element),
+                                          .usage = BufferUsage::ShaderRead | BufferUsage::ShaderReadWrite });
+    const BufferBinding resultBinding = BufferBinding::CreateRWStructuredBuffer(resultBuffer, sizeof(Element));
+    const BindlessHandle resultHandle = graphics.GetBindlessHandle(resultBinding);
+
+    // Freed before any submission flushed the writes of the views.
+    graphics.DestroyBuffer(dataBuffers[FreedBufferIndex]);
+    {
+        Buffer dynamicBuffer = graphics.CreateBuffer(BufferDesc{ .name = "DeferredWriteDynamicBuffer",
+                                                                 .byteSize = sizeof(Element),
+                                                                 .usage = BufferUsage::ShaderRead },
+                                                     ResourceLifetime::Dynamic);
+        std::ignore =
+            graphics.GetBindlessHandle(BufferBinding::CreateStructuredBuffer(dynamicBuffer, sizeof(Element)));
+        graphics.EndFrame();
+    }
+    graphics.FlushGPU();
+
+    struct ShaderUniform
+    {
+        BindlessHandle inputBuffer;
+        BindlessHandle outputBuffer;
+        u32 numElements{};
+    };
+    ShaderKey key {
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "0" },
+            { "STRUCTURED_BUFFER", "1" },
+            { "BYTE_ADDRESS_BUFFER", "0" },
+            { "READ_WRITE", "0" },
+        },
+    };
+
+    // Each remaining view is accumulated into the result, reading a wrong descriptor would change the sum.
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Compute);
+    static constexpr Element Zeroes{};
+    ctx.EnqueueDataUpload(resultBuffer, std::as_bytes(std::span{ Zeroes }));
+    Element expectedResult{};
+    for (u32 i = 0; i < BufferCount; ++i)
+    {
+        if (i == FreedBufferIndex)
+        {
+            continue;
+        }
+
+        const Element data{ static_cast<float>(i), static_cast<float>(2 * i), static_cast<float>(3 * i) };
+        ctx.EnqueueDataUpload(dataBuffers[i], std::as_bytes(std::span{ data }));
+        std::ranges::transform(expectedResult, data, expectedResult.begin(), std::plus{});
+
+        ShaderUniform uniforms{ dataHandles[i], resultHandle, 1 };
+        const std::array<ResourceBinding, 2> bindings{ dataBindings[i], resultBinding };
+        EXPECT_TRUE(ctx.Dispatch(shaderCompiler.GetShaderView(key),
+                                 ConstantBinding(std::span{ &uniforms, 1 }),
+                                 bindings,
+                                 { 1u, 1u, 1u }));
+    }
+
+    BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(resultBuffer);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    Element result{};
+    readbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+    EXPECT_EQ(result, expectedResult);
+
+    for (u32 i = 0; i < BufferCount; ++i)
+    {
+        if (i != FreedBufferIndex)
+        {
+            graphics.DestroyBuffer(dataBuffers[i]);
+        }
+    }
+    graphics.DestroyBuffer(resultBuffer);
+}
+
+// Parameterized on GraphicsCreateDesc::useDescriptorBuffer, which only changes the Vulkan backend.
+struct DescriptorPoolGrowthTest : VexTestParam<bool>
+{
+    DescriptorPoolGrowthTest()
+        : VexTestParam(GraphicsCreateDesc{
+              .useSwapChain = false,
+              .enableGPUDebugLayer = VEX_DEBUG,
+              .enableGPUBasedValidation = VEX_DEBUG,
+              .useDescriptorBuffer = GetParam(),
+          })
+    {
+    }
+
+protected:
+    void SetUp() override
+    {
+        if (!GetParam())
+        {
+            return;
+        }
+#if VEX_VULKAN
+        if (!GPhysicalDevice->SupportsDescriptorBuffer())
+        {
+            GTEST_SKIP() << "Descriptor buffers are not supported, skipping descriptor buffer tests.";
+        }
+#else
+        GTEST_SKIP() << "Descriptor buffers only exist in Vulkan, skipping descriptor buffer tests.";
+#endif
+    }
+};
+
+TEST_P(DescriptorPoolGrowthTest, HandlesRemainValidAfterGrowth)
+{
+    // Opened before the growth, the context must bind the new heap before dispatching.
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Compute);
+
+    const std::array<float, 3> data{ 1.f, 2.f, 3.f };
+    Buffer dataBuffer = graphics.CreateBuffer(BufferDesc{ .name = "DataBuffer",
+                                                          .byteSize = sizeof(data),
+                                                          .usage = BufferUsage::ShaderRead });
+    Buffer resultBuffer =
+        graphics.CreateBuffer(BufferDesc{ .name = "ResultBuffer",
+                                          .byteSize = sizeof(data),
+                                          .usage = BufferUsage::ShaderRead | BufferUsage::ShaderReadWrite });
+    ctx.EnqueueDataUpload(dataBuffer, std::as_bytes(std::span{ data }));
+
+    // Allocated before the growth, the descriptor is copied over to the new heap.
+    const BufferBinding dataBinding = BufferBinding::CreateStructuredBuffer(dataBuffer, sizeof(data));
+    const BindlessHandle dataHandle = graphics.GetBindlessHandle(dataBinding);
+
+    // Allocating one view per element exhausts the default pool size.
+    static constexpr u32 ViewCount = GDefaultDescriptorPoolSize;
+    Buffer viewsBuffer = graphics.CreateBuffer(BufferDesc{ .name = "ViewsBuffer",
+                                                           .byteSize = ViewCount * sizeof(u32),
+                                                           .usage = BufferUsage::ShaderRead });
+    std::vector<ResourceBinding> viewBindings;
+    viewBindings.reserve(ViewCount);
+    for (u32 i = 0; i < ViewCount; ++i)
+    {
+        viewBindings.push_back(BufferBinding::CreateStructuredBuffer(viewsBuffer, sizeof(u32), i, 1));
+    }
+    std::vector<BindlessHandle> viewHandles = graphics.GetBindlessHandles(viewBindings);
+    EXPECT_GE(viewHandles.back().GetIndex(), GDefaultDescriptorPoolSize);
+
+    // Ending the frame and running the cleanup of another submission must not release the heap the context bound.
+    graphics.EndFrame();
+    {
+        CommandContext otherCtx = graphics.CreateCommandContext(QueueType::Compute);
+        graphics.WaitForTokenOnCPU(graphics.Submit(otherCtx));
+    }
+
+    // Allocated after the growth, the descriptor only exists in the new heap.
+    const BufferBinding resultBinding = BufferBinding::CreateRWStructuredBuffer(resultBuffer, sizeof(data));
+    const BindlessHandle resultHandle = graphics.GetBindlessHandle(resultBinding);
+
+    struct ShaderUniform
+    {
+        BindlessHandle inputBuffer;
+        BindlessHandle outputBuffer;
+        u32 numElements{};
+    };
+    ShaderUniform uniforms{ dataHandle, resultHandle, 1 };
+
+    ShaderKey key {
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "0" },
+            { "STRUCTURED_BUFFER", "1" },
+            { "BYTE_ADDRESS_BUFFER", "0" },
+            { "READ_WRITE", "0" },
+        },
+    };
+
+    const std::array<ResourceBinding, 2> bindings{ dataBinding, resultBinding };
+    EXPECT_TRUE(ctx.Dispatch(shaderCompiler.GetShaderView(key),
+                             ConstantBinding(std::span{ &uniforms, 1 }),
+                             bindings,
+                             { 1u, 1u, 1u }));
+
+    BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(resultBuffer);
+
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    std::array<float, 3> result{};
+    readbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+
+    EXPECT_TRUE(result == data);
+
+    graphics.DestroyBuffer(dataBuffer);
+    graphics.DestroyBuffer(resultBuffer);
+    graphics.DestroyBuffer(viewsBuffer);
+}
+
+INSTANTIATE_TEST_SUITE_P(DescriptorPoolGrowth, DescriptorPoolGrowthTest, testing::Bool());
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <Vex/Containers/FreeList.h>
+#include <Vex/Logger.h>
+
+namespace vex
+{
+
+namespace FreeListTest_Internal
+{
+
+// Previous implementation of FreeListAllocator, sorting all free indices on each deallocation. Kept as a baseline for
+// the benchmark below.
+struct SortedFreeListAllocator
+{
+    SortedFreeListAllocator(u32 size)
+    {
+        freeIndices.reserve(size);
+        for (u32 i = 0; i < size; ++i)
+        {
+            freeIndices.push_back(size - 1 - i);
+        }
+    }
+
+    u32 Allocate()
+    {
+        u32 idx = freeIndices.back();
+        freeIndices.pop_back();
+        return idx;
+    }
+
+    void Deallocate(u32 index)
+    {
+        freeIndices.push_back(index);
+        std::sort(freeIndices.begin(), freeIndices.end(), std::greater{});
+    }
+
+    std::vector<u32> freeIndices;
+};
+
+// Frees a random live index and allocates a new one, churnCount times. Returns the elapsed time in microseconds.
+template <class AllocatorT>
+i64 MeasureChurn(AllocatorT& allocator, u32 liveCount, u32 churnCount)
+{
+    std::vector<u32> liveIndices;
+    liveIndices.reserve(liveCount);
+    for (u32 i = 0; i < liveCount; ++i)
+    {
+        liveIndices.push_back(allocator.Allocate());
+    }
+
+    std::mt19937 rng{ 42 };
+    std::uniform_int_distribution<u32> distribution{ 0, liveCount - 1 };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < churnCount; ++i)
+    {
+        u32& liveIndex = liveIndices[distribution(rng)];
+        allocator.Deallocate(liveIndex);
+        liveIndex = allocator.Allocate();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+} // namespace FreeListTest_Internal
+
+TEST(FreeListAllocatorTest, AllocatesSmallestFreeIndex)
+{
+    FreeListAllocator32 allocator{ 8 };
+    for (u32 i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(allocator.Allocate(), i);
+    }
+
+    allocator.Deallocate(5);
+    allocator.Deallocate(2);
+    allocator.Deallocate(7);
+    EXPECT_EQ(allocator.Allocate(), 2);
+    EXPECT_EQ(allocator.Allocate(), 5);
+    EXPECT_EQ(allocator.Allocate(), 7);
+
+    // The allocator grows once all indices are allocated.
+    EXPECT_EQ(allocator.Allocate(), 8);
+    EXPECT_EQ(allocator.size, 16);
+}
+
+TEST(FreeListAllocatorTest, BatchDeallocationAndResize)
+{
+    FreeListAllocator32 allocator{ 4 };
+    for (u32 i = 0; i < 4; ++i)
+    {
+        allocator.Allocate();
+    }
+
+    std::vector<u32> indices{ 3, 0, 1 };
+    allocator.DeallocateBatch(indices);
+    allocator.Resize(6);
+    EXPECT_EQ(allocator.freeIndices.size(), 5);
+
+    for (u32 expected : std::array<u32, 5>{ 0, 1, 3, 4, 5 })
+    {
+        EXPECT_EQ(allocator.Allocate(), expected);
+    }
+    EXPECT_TRUE(allocator.freeIndices.empty());
+}
+
+// Timing comparison only, disabled by default as its results depend on the machine running it.
+// Run with --gtest_also_run_disabled_tests --gtest_filter=*ChurnBenchmark.
+TEST(FreeListAllocatorTest, DISABLED_ChurnBenchmark)
+{
+    using namespace FreeListTest_Internal;
+
+    // Half of the indices are live, so that the previous implementation sorts 100k free indices per deallocation.
+    static constexpr u32 LiveCount = 100'000;
+    static constexpr u32 ChurnCount = 1'000;
+
+    SortedFreeListAllocator sortedAllocator{ 2 * LiveCount };
+    const i64 sortedMicroseconds = MeasureChurn(sortedAllocator, LiveCount, ChurnCount);
+
+    FreeListAllocator32 heapAllocator{ 2 * LiveCount };
+    const i64 heapMicroseconds = MeasureChurn(heapAllocator, LiveCount, ChurnCount);
+
+    VEX_LOG(Info,
+            "FreeListAllocator churn of {} indices with {} live handles: sorted {}us, heap {}us.",
+            ChurnCount,
+            LiveCount,
+            sortedMicroseconds,
+            heapMicroseconds);
+}
+
+} // namespace vex
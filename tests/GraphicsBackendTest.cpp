@@ -1,8 +1,53 @@
 #include "VexTest.h"
 
+#include <Vex/PhysicalDevice.h>
+#include <Vex/PipelineStateCache.h>
+
 namespace vex
 {
 
+static DrawDesc CreatePipelineStateTestDrawDesc(ShaderCompiler& shaderCompiler)
+{
+    const std::string filepath = (VexRootPath / "tests/shaders/VertexInputLayoutTest.hlsl").string();
+    return DrawDesc{
+        .vertexShader = shaderCompiler.GetShaderView({
+            .filepath = filepath,
+            .entryPoint = "VSMain",
+            .type = ShaderType::VertexShader,
+        }),
+        .pixelShader = shaderCompiler.GetShaderView({
+            .filepath = filepath,
+            .entryPoint = "PSMain",
+            .type = ShaderType::PixelShader,
+        }),
+        .vertexInputLayout = {
+            .attributes = {
+                {
+                    .semanticName = "POSITION",
+                    .semanticIndex = 0,
+                    .binding = 0,
+                    .format = TextureFormat::RGB32_FLOAT,
+                    .offset = 0,
+                },
+                {
+                    .semanticName = "TEXCOORD",
+                    .semanticIndex = 0,
+                    .binding = 0,
+                    .format = TextureFormat::RG32_FLOAT,
+                    .offset = sizeof(float) * 3,
+                },
+            },
+            .bindings = {
+                {
+                    .binding = 0,
+                    .strideByteSize = sizeof(float) * 5,
+                    .inputRate = VertexInputLayout::InputRate::PerVertex,
+                },
+            },
+        },
+    };
+}
+
 TEST(GraphicsTests, CreateGraphicsWithoutDebugLayers)
 {
     Graphics{ GraphicsCreateDesc{
@@ -30,4 +75,307 @@ TEST(GraphicsTests, CreateGraphicsDebugLayerWithoutGPUValidation)
     } };
 }
 
+TEST(GraphicsTests, CreateGraphicsWithPipelineCacheRoundTrip)
+{
+#if !VEX_VULKAN
+    GTEST_SKIP() << "Only Vulkan exposes its pipeline cache data, DX12 relies on the driver's own PSO cache.";
+#endif
+
+    const std::filesystem::path pipelineCacheFilepath =
+        std::filesystem::temp_directory_path() / "VexGraphicsTests" / "PipelineCache.bin";
+    std::filesystem::remove(pipelineCacheFilepath);
+
+    const GraphicsCreateDesc graphicsDesc{
+        .useSwapChain = false,
+        .enableGPUDebugLayer = VEX_DEBUG,
+        .enableGPUBasedValidation = VEX_DEBUG,
+        .pipelineCacheFilepath = pipelineCacheFilepath,
+    };
+
+    // First run populates the cache with a compute pipeline state and writes it to disk on destruction.
+    {
+        Graphics graphics{ graphicsDesc };
+        ShaderCompiler shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } });
+        const ShaderView computeShader = shaderCompiler.GetShaderView({
+            .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+            .entryPoint = "CSMain",
+            .type = ShaderType::ComputeShader,
+            .defines = {
+                { "CONSTANT_BUFFER", "0" },
+                { "STRUCTURED_BUFFER", "1" },
+                { "BYTE_ADDRESS_BUFFER", "0" },
+                { "READ_WRITE", "0" },
+            },
+        });
+        graphics.PrecompilePipelines(std::span(&computeShader, 1));
+    }
+
+    ASSERT_TRUE(std::filesystem::exists(pipelineCacheFilepath));
+    const std::uintmax_t cacheFileByteSize = std::filesystem::file_size(pipelineCacheFilepath);
+    EXPECT_GT(cacheFileByteSize, 0u);
+
+    // Second run creates its pipeline cache from the file, so it starts out with at least the saved data.
+    {
+        Graphics graphics{ graphicsDesc };
+        EXPECT_GE(RHIAccessor{ graphics }.GetRHI().GetPipelineCacheData().size(), cacheFileByteSize);
+    }
+
+    std::filesystem::remove(pipelineCacheFilepath);
+}
+
+TEST(GraphicsTests, AsyncPipelineCompilation)
+{
+    Graphics graphics{ GraphicsCreateDesc{
+        .useSwapChain = false,
+        .enableGPUDebugLayer = VEX_DEBUG,
+        .enableGPUBasedValidation = VEX_DEBUG,
+        .enableAsyncPipelineCompilation = true,
+    } };
+    ShaderCompiler shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } });
+
+    const std::array<float, 3> data{ 1.f, 2.f, 3.f };
+    static constexpr std::array<float, 3> Zeroes{};
+    Buffer dataBuffer = graphics.CreateBuffer(BufferDesc{ .name = "AsyncCompilationDataBuffer",
+                                                          .byteSize = sizeof(data),
+                                                          .usage = BufferUsage::ShaderRead });
+    Buffer resultBuffer =
+        graphics.CreateBuffer(BufferDesc{ .name = "AsyncCompilationResultBuffer",
+                                          .byteSize = sizeof(data),
+                                          .usage = BufferUsage::ShaderRead | BufferUsage::ShaderReadWrite });
+
+    std::array<ResourceBinding, 2> bindings{
+        BufferBinding::CreateStructuredBuffer(dataBuffer, sizeof(data)),
+        BufferBinding::CreateRWStructuredBuffer(resultBuffer, sizeof(data)),
+    };
+    std::vector<BindlessHandle> handles = graphics.GetBindlessHandles(bindings);
+
+    struct ShaderUniform
+    {
+        BindlessHandle inputBuffer;
+        BindlessHandle outputBuffer;
+        u32 numElements{};
+    };
+    ShaderUniform uniforms{ handles[0], handles[1], 1 };
+
+    ShaderKey key{
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "0" },
+            { "STRUCTURED_BUFFER", "1" },
+            { "BYTE_ADDRESS_BUFFER", "0" },
+            { "READ_WRITE", "0" },
+        },
+    };
+
+    // The first dispatch using a new pipeline state is skipped while it is compiled in the background.
+    {
+        CommandContext ctx = graphics.CreateCommandContext(QueueType::Compute);
+        ctx.EnqueueDataUpload(dataBuffer, std::as_bytes(std::span{ data }));
+        ctx.EnqueueDataUpload(resultBuffer, std::as_bytes(std::span{ Zeroes }));
+        EXPECT_FALSE(ctx.Dispatch(shaderCompiler.GetShaderView(key),
+                                  ConstantBinding(std::span{ &uniforms, 1 }),
+                                  bindings,
+                                  { 1u, 1u, 1u }));
+        BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(resultBuffer);
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+        std::array<float, 3> result{};
+        readbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+        EXPECT_EQ(result, Zeroes);
+    }
+
+    graphics.WaitForPipelineCompilations();
+    EXPECT_FALSE(graphics.HasPendingPipelineCompilations());
+
+    // Once compiled, the same dispatch is executed.
+    {
+        CommandContext ctx = graphics.CreateCommandContext(QueueType::Compute);
+        EXPECT_TRUE(ctx.Dispatch(shaderCompiler.GetShaderView(key),
+                                 ConstantBinding(std::span{ &uniforms, 1 }),
+                                 bindings,
+                                 { 1u, 1u, 1u }));
+        BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(resultBuffer);
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+        std::array<float, 3> result{};
+        readbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+        EXPECT_EQ(result, data);
+    }
+
+#if VEX_SLANG
+    // Precompiled pipeline states are compiled in the background as well.
+    key.filepath = (VexRootPath / "tests/shaders/BufferView.cs.slang").string();
+    const ShaderView computeShader = shaderCompiler.GetShaderView(key);
+    graphics.PrecompilePipelines(std::span(&computeShader, 1));
+    graphics.WaitForPipelineCompilations();
+    EXPECT_FALSE(graphics.HasPendingPipelineCompilations());
+#endif
+
+    graphics.DestroyBuffer(dataBuffer);
+    graphics.DestroyBuffer(resultBuffer);
+}
+
+TEST(GraphicsTests, FastLinkedGraphicsPipelineStateIsReplacedByOptimizedVersion)
+{
+    Graphics graphics{ GraphicsCreateDesc{
+        .useSwapChain = false,
+        .enableGPUDebugLayer = VEX_DEBUG,
+        .enableGPUBasedValidation = VEX_DEBUG,
+        .enableAsyncPipelineCompilation = true,
+        .enableGraphicsPipelineFastLinking = true,
+    } };
+#if VEX_VULKAN
+    const bool supportsFastLinking = GPhysicalDevice->SupportsGraphicsPipelineLibrary();
+#else
+    const bool supportsFastLinking = false;
+#endif
+    if (!supportsFastLinking)
+    {
+        GTEST_SKIP() << "Fast linking graphics pipeline states is not supported, skipping fast linking tests.";
+    }
+
+    ShaderCompiler shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } });
+    const DrawDesc drawDesc = CreatePipelineStateTestDrawDesc(shaderCompiler);
+    const RenderTargetState renderTargetState{ .colorFormats = { { .format = TextureFormat::RGBA8_UNORM } } };
+
+    static constexpr bool EnableAsyncCompilation = true;
+    static constexpr bool RecordManifest = false;
+    static constexpr bool EnableGraphicsFastLinking = true;
+    const RHIAccessor accessor{ graphics };
+    std::unique_ptr<RHIGraphicsPipelineState> oldPSO;
+    PipelineStateCache psCache(accessor.GetRHI(),
+                               accessor.GetDescriptorPool(),
+                               EnableAsyncCompilation,
+                               RecordManifest,
+                               EnableGraphicsFastLinking);
+
+    // The first lookup launches the fast link in the background.
+    EXPECT_EQ(psCache.GetGraphicsPipelineState(drawDesc, renderTargetState, oldPSO), nullptr);
+    psCache.WaitForPendingCompilations();
+
+    // The fast-linked pipeline state is used right away, its lookup launches the optimized compilation.
+    RHIGraphicsPipelineState* fastLinkedPSO = psCache.GetGraphicsPipelineState(drawDesc, renderTargetState, oldPSO);
+    ASSERT_NE(fastLinkedPSO, nullptr);
+    EXPECT_TRUE(fastLinkedPSO->isFastLinked);
+    EXPECT_EQ(oldPSO, nullptr);
+    psCache.WaitForPendingCompilations();
+
+    // The optimized version replaces it, the fast-linked pipeline is handed back to be kept alive by in-flight frames.
+    RHIGraphicsPipelineState* optimizedPSO = psCache.GetGraphicsPipelineState(drawDesc, renderTargetState, oldPSO);
+    ASSERT_NE(optimizedPSO, nullptr);
+    EXPECT_FALSE(optimizedPSO->isFastLinked);
+    EXPECT_NE(oldPSO, nullptr);
+    EXPECT_FALSE(psCache.HasPendingCompilations());
+}
+
+TEST(GraphicsTests, SynchronousGraphicsPipelineStatesAreNeverFastLinked)
+{
+    Graphics graphics{ GraphicsCreateDesc{
+        .useSwapChain = false,
+        .enableGPUDebugLayer = VEX_DEBUG,
+        .enableGPUBasedValidation = VEX_DEBUG,
+    } };
+    ShaderCompiler shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } });
+    const DrawDesc drawDesc = CreatePipelineStateTestDrawDesc(shaderCompiler);
+    const RenderTargetState renderTargetState{ .colorFormats = { { .format = TextureFormat::RGBA8_UNORM } } };
+
+    // Fast linking is ignored without async compilation, whose worker threads compile the optimized versions.
+    static constexpr bool EnableAsyncCompilation = false;
+    static constexpr bool RecordManifest = false;
+    static constexpr bool EnableGraphicsFastLinking = true;
+    const RHIAccessor accessor{ graphics };
+    std::unique_ptr<RHIGraphicsPipelineState> oldPSO;
+    PipelineStateCache psCache(accessor.GetRHI(),
+                               accessor.GetDescriptorPool(),
+                               EnableAsyncCompilation,
+                               RecordManifest,
+                               EnableGraphicsFastLinking);
+
+    RHIGraphicsPipelineState* pso = psCache.GetGraphicsPipelineState(drawDesc, renderTargetState, oldPSO);
+    ASSERT_NE(pso, nullptr);
+    EXPECT_FALSE(pso->isFastLinked);
+    EXPECT_FALSE(psCache.HasPendingCompilations());
+    EXPECT_EQ(psCache.GetGraphicsPipelineState(drawDesc, renderTargetState, oldPSO), pso);
+}
+
+TEST(GraphicsTests, PipelineStateManifestRoundTrip)
+{
+    const std::filesystem::path manifestFilepath =
+        std::filesystem::temp_directory_path() / "VexGraphicsTests" / "PipelineStateManifest.bin";
+    std::filesystem::remove(manifestFilepath);
+
+    ShaderCompiler shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } });
+    const ShaderView computeShader = shaderCompiler.GetShaderView({
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "1" },
+            { "STRUCTURED_BUFFER", "0" },
+            { "BYTE_ADDRESS_BUFFER", "0" },
+            { "READ_WRITE", "0" },
+        },
+    });
+
+    // Record the pipeline states of a first session.
+    {
+        Graphics graphics{ GraphicsCreateDesc{
+            .useSwapChain = false,
+            .enableGPUDebugLayer = VEX_DEBUG,
+            .enableGPUBasedValidation = VEX_DEBUG,
+            .recordPipelineStateManifest = true,
+        } };
+        graphics.PrecompilePipelines(std::span(&computeShader, 1));
+        graphics.SavePipelineStateManifest(manifestFilepath);
+    }
+    ASSERT_TRUE(std::filesystem::exists(manifestFilepath));
+
+    const std::optional<PipelineStateManifest> manifest = PipelineStateManifest::Load(manifestFilepath);
+    ASSERT_TRUE(manifest.has_value());
+    ASSERT_EQ(manifest->GetComputePipelineStates().size(), 1u);
+    // Only the shader's hash is stored, its bytecode comes from the shaders passed in when replaying.
+    EXPECT_EQ(manifest->GetComputePipelineStates()[0].hash, computeShader.hash);
+    EXPECT_TRUE(manifest->GetComputePipelineStates()[0].bytecode.empty());
+    EXPECT_LT(std::filesystem::file_size(manifestFilepath), computeShader.bytecode.size());
+
+    // Shaders which are not provided cannot be resolved.
+    PipelineStateManifest unresolvedManifest = *PipelineStateManifest::Load(manifestFilepath);
+    EXPECT_EQ(unresolvedManifest.ResolveShaders({}), 1u);
+    EXPECT_TRUE(unresolvedManifest.IsEmpty());
+
+    // Replay them in a second session.
+    {
+        Graphics graphics{ GraphicsCreateDesc{
+            .useSwapChain = false,
+            .enableGPUDebugLayer = VEX_DEBUG,
+            .enableGPUBasedValidation = VEX_DEBUG,
+            .enableAsyncPipelineCompilation = true,
+        } };
+        graphics.ReplayPipelineStateManifest(manifestFilepath, std::span(&computeShader, 1));
+        graphics.WaitForPipelineCompilations();
+        EXPECT_FALSE(graphics.HasPendingPipelineCompilations());
+    }
+
+    std::filesystem::remove(manifestFilepath);
+}
+
+TEST(GraphicsTests, PipelineStateManifestRecordsPipelineStatesOnce)
+{
+    static constexpr std::array<byte, 4> Bytecode{ 1, 2, 3, 4 };
+    const ShaderView computeShader("Compute",
+                                   "CSMain",
+                                   Bytecode,
+                                   SHA1HashDigest{ 1, 2, 3, 4, 5 },
+                                   ShaderType::ComputeShader);
+
+    // Replaying a manifest while recording compiles the same pipeline states again.
+    PipelineStateManifest manifest;
+    manifest.RecordComputePipelineState(computeShader);
+    manifest.RecordComputePipelineState(computeShader);
+    ASSERT_EQ(manifest.GetComputePipelineStates().size(), 1u);
+    EXPECT_EQ(manifest.GetComputePipelineStates()[0].hash, computeShader.hash);
+}
+
 } // namespace vex
\ No newline at end of file
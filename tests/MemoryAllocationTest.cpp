@@ -0,0 +1,178 @@
+#include <array>
+#include <chrono>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Vex/MemoryAllocation.h>
+
+#include <RHI/RHIAllocator.h>
+
+namespace vex
+{
+
+TEST(MemoryPageInfoTest, AllocationsAreAlignedAndDisjoint)
+{
+    static constexpr u64 PageByteSize = 16 * 1024 * 1024;
+    MemoryPageInfo page(0, PageByteSize);
+
+    std::mt19937_64 rng(42);
+    std::map<u64, u64> liveRanges;
+    for (u32 i = 0; i < 20000; ++i)
+    {
+        if (liveRanges.empty() || rng() % 3 != 0)
+        {
+            const u64 size = 1 + rng() % (64 * 1024);
+            const u64 alignment = u64{ 1 } << (rng() % 17);
+            std::optional<MemoryRange> range = page.Allocate(size, alignment);
+            if (!range.has_value())
+            {
+                continue;
+            }
+
+            ASSERT_EQ(range->offset % alignment, 0);
+            ASSERT_LE(range->end(), PageByteSize);
+            auto next = liveRanges.lower_bound(range->offset);
+            ASSERT_TRUE(next == liveRanges.end() || range->end() <= next->first);
+            ASSERT_TRUE(next == liveRanges.begin() ||
+                        std::prev(next)->first + std::prev(next)->second <= range->offset);
+            liveRanges.emplace(range->offset, size);
+        }
+        else
+        {
+            auto it = std::next(liveRanges.begin(), rng() % liveRanges.size());
+            page.Free({ .offset = it->first, .size = it->second });
+            liveRanges.erase(it);
+        }
+    }
+
+    for (const auto& [offset, size] : liveRanges)
+    {
+        page.Free({ .offset = offset, .size = size });
+    }
+    EXPECT_EQ(page.GetFreeSpace(), PageByteSize);
+
+    // All freed blocks must have been coalesced back into a single one.
+    std::optional<MemoryRange> fullRange = page.Allocate(PageByteSize, 1);
+    ASSERT_TRUE(fullRange.has_value());
+    EXPECT_EQ(fullRange->offset, 0);
+}
+
+TEST(MemoryPageInfoTest, FreedRangeIsReused)
+{
+    MemoryPageInfo page(0, 1024);
+
+    std::optional<MemoryRange> first = page.Allocate(512, 256);
+    std::optional<MemoryRange> second = page.Allocate(512, 256);
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    EXPECT_FALSE(page.Allocate(1, 1).has_value());
+    EXPECT_EQ(page.GetFreeSpace(), 0);
+
+    page.Free(*first);
+    std::optional<MemoryRange> third = page.Allocate(256, 256);
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(third->offset, first->offset);
+    EXPECT_EQ(page.GetFreeSpace(), 256);
+}
+
+namespace MemoryAllocationTest_Internal
+{
+
+// Allocator without a graphics API, only counting the pages it holds.
+struct PageCountingAllocator final : RHIAllocatorBase
+{
+    PageCountingAllocator()
+        : RHIAllocatorBase(1)
+    {
+    }
+
+    using RHIAllocatorBase::Allocate;
+    using RHIAllocatorBase::Free;
+
+    void OnPageAllocated(PageHandle, u32) override
+    {
+        ++pageCount;
+    }
+    void OnPageFreed(PageHandle, u32) override
+    {
+        --pageCount;
+    }
+
+    u32 pageCount = 0;
+};
+
+} // namespace MemoryAllocationTest_Internal
+
+TEST(RHIAllocatorTest, IdlePagesAreReleasedAfterTheirDelay)
+{
+    using namespace MemoryAllocationTest_Internal;
+    static constexpr u64 PageByteSize = MemoryPageInfo::DefaultPageByteSize;
+
+    PageCountingAllocator allocator;
+    allocator.Free(allocator.Allocate(PageByteSize, 1, 0));
+    ASSERT_EQ(allocator.pageCount, 1);
+
+    // The page only just became empty.
+    allocator.ReleaseIdlePages(std::chrono::hours(1), 0);
+    EXPECT_EQ(allocator.pageCount, 1);
+
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 0);
+    EXPECT_EQ(allocator.pageCount, 0);
+}
+
+TEST(RHIAllocatorTest, MostRecentlyEmptiedPagesAreKeptWithinBudget)
+{
+    using namespace MemoryAllocationTest_Internal;
+    static constexpr u64 PageByteSize = MemoryPageInfo::DefaultPageByteSize;
+
+    PageCountingAllocator allocator;
+    std::array<Allocation, 3> allocations;
+    for (Allocation& allocation : allocations)
+    {
+        allocation = allocator.Allocate(PageByteSize, 1, 0);
+    }
+    for (const Allocation& allocation : allocations)
+    {
+        allocator.Free(allocation);
+    }
+    ASSERT_EQ(allocator.pageCount, 3);
+
+    // Only the first emptied page exceeds the budget.
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 2 * PageByteSize);
+    EXPECT_EQ(allocator.pageCount, 2);
+
+    // Kept pages are reused by new allocations, which are then no longer idle.
+    const Allocation reused = allocator.Allocate(PageByteSize, 1, 0);
+    EXPECT_EQ(allocator.pageCount, 2);
+    EXPECT_NE(reused.pageHandle, allocations[0].pageHandle);
+
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 0);
+    EXPECT_EQ(allocator.pageCount, 1);
+
+    allocator.Free(reused);
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 0);
+    EXPECT_EQ(allocator.pageCount, 0);
+}
+
+TEST(RHIAllocatorTest, IdleDynamicArenaPagesAreReleasedAfterTheirDelay)
+{
+    using namespace MemoryAllocationTest_Internal;
+
+    PageCountingAllocator allocator;
+    allocator.Allocate(1024, 1, 0, ResourceLifetime::Dynamic);
+    ASSERT_EQ(allocator.pageCount, 1);
+
+    // Pages of the ongoing frame are never released.
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 0);
+    EXPECT_EQ(allocator.pageCount, 1);
+
+    allocator.RecycleDynamicArenaPages(allocator.EndDynamicFrame());
+    allocator.ReleaseIdlePages(std::chrono::hours(1), 0);
+    EXPECT_EQ(allocator.pageCount, 1);
+
+    allocator.ReleaseIdlePages(std::chrono::steady_clock::duration::zero(), 0);
+    EXPECT_EQ(allocator.pageCount, 0);
+}
+
+} // namespace vex
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "VexTest.h"
+
+#include <gtest/gtest.h>
+
+namespace vex
+{
+
+TEST_F(VexTest, RenderGraphCulledPassesAreNotExecuted)
+{
+    static constexpr std::array<u32, 4> Data{ 1, 2, 3, 4 };
+    Buffer result = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("Result", sizeof(Data)));
+
+    RenderGraph renderGraph{ graphics };
+    RenderGraphResource importedResult = renderGraph.ImportBuffer(result);
+    RenderGraphResource intermediate =
+        renderGraph.CreateBuffer(BufferDesc::CreateGenericBufferDesc("Intermediate", sizeof(Data)));
+    RenderGraphResource unused = renderGraph.CreateBuffer(BufferDesc::CreateGenericBufferDesc("Unused", sizeof(Data)));
+
+    renderGraph.AddPass({ .name = "Upload",
+                          .queue = QueueType::Copy,
+                          .writes = { { intermediate, RHIBarrierAccess::CopyDest } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        { ctx.EnqueueDataUpload(graph.GetBuffer(intermediate), std::as_bytes(std::span{ Data })); });
+
+    // Nothing reads the unused buffer, this pass must be culled.
+    bool hasExecutedUnusedPass = false;
+    renderGraph.AddPass({ .name = "Unused",
+                          .queue = QueueType::Graphics,
+                          .reads = { { intermediate, RHIBarrierAccess::CopySource } },
+                          .writes = { { unused, RHIBarrierAccess::CopyDest } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        {
+                            hasExecutedUnusedPass = true;
+                            ctx.Copy(graph.GetBuffer(intermediate), graph.GetBuffer(unused));
+                        });
+
+    // Runs on the async compute queue, after the copy queue's submission.
+    renderGraph.AddPass({ .name = "Copy",
+                          .queue = QueueType::Compute,
+                          .reads = { { intermediate, RHIBarrierAccess::CopySource } },
+                          .writes = { { importedResult, RHIBarrierAccess::CopyDest } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        { ctx.Copy(graph.GetBuffer(intermediate), graph.GetBuffer(importedResult)); });
+
+    std::vector<SyncToken> tokens = renderGraph.Execute();
+    EXPECT_FALSE(hasExecutedUnusedPass);
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].queueType, QueueType::Copy);
+    EXPECT_EQ(tokens[1].queueType, QueueType::Compute);
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    BufferReadbackContext readback = ctx.EnqueueDataReadback(result);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx, tokens));
+
+    std::array<u32, 4> readbackData{};
+    readback.ReadData(std::as_writable_bytes(std::span{ readbackData }));
+    EXPECT_EQ(readbackData, Data);
+
+    graphics.DestroyBuffer(result);
+}
+
+TEST_F(VexTest, RenderGraphTransientTexturesAreSynchronizedAcrossPasses)
+{
+    Texture result = graphics.CreateTexture(CreateRenderTargetDesc("Result", { 0, 0, 0, 0 }));
+    Texture other = graphics.CreateTexture(CreateRenderTargetDesc("Other", { 0, 0, 1, 1 }));
+
+    RenderGraph renderGraph{ graphics };
+    RenderGraphResource importedResult = renderGraph.ImportTexture(result);
+    RenderGraphResource importedOther = renderGraph.ImportTexture(other);
+    RenderGraphResource transient = renderGraph.CreateTexture(CreateRenderTargetDesc("Transient", { 1, 0, 0, 1 }));
+
+    renderGraph.AddPass({ .name = "ClearTransient", .writes = { { transient, RHIBarrierAccess::RenderTarget } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        { ctx.ClearTexture(graph.GetTexture(transient)); });
+    // Recorded between the write and the read of the transient texture, which are synchronized by a split barrier.
+    renderGraph.AddPass({ .name = "ClearOther", .writes = { { importedOther, RHIBarrierAccess::RenderTarget } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        { ctx.ClearTexture(graph.GetTexture(importedOther)); });
+    renderGraph.AddPass({ .name = "CopyTransient",
+                          .reads = { { transient, RHIBarrierAccess::CopySource } },
+                          .writes = { { importedResult, RHIBarrierAccess::CopyDest } } },
+                        [&](CommandContext& ctx, const RenderGraph& graph)
+                        { ctx.Copy(graph.GetTexture(transient), graph.GetTexture(importedResult)); });
+
+    std::vector<SyncToken> tokens = renderGraph.Execute();
+    // All passes run on the graphics queue, in a single command context.
+    ASSERT_EQ(tokens.size(), 1);
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    TextureReadbackContext readback = ctx.EnqueueDataReadback(result);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx, tokens));
+
+    EXPECT_TRUE(ValidateTextureValue(readback, std::array<u8, 4>{ 0xFF, 0, 0, 0xFF }));
+
+    graphics.DestroyTexture(result);
+    graphics.DestroyTexture(other);
+}
+
+} // namespace vex
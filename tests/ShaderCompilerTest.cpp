@@ -0,0 +1,56 @@
+#include "VexTest.h"
+
+#include <gtest/gtest.h>
+
+namespace vex
+{
+
+struct ParallelShaderCompilationTest : VexPerShaderCompilerTest
+{
+};
+
+TEST_P(ParallelShaderCompilationTest, BatchedCompilationMatchesSerialCompilation)
+{
+    // Every permutation of the BufferView shader.
+    std::vector<ShaderKey> keys;
+    for (const std::string_view bufferType : { "CONSTANT_BUFFER", "STRUCTURED_BUFFER", "BYTE_ADDRESS_BUFFER" })
+    {
+        for (const char* readWrite : { "0", "1" })
+        {
+            keys.push_back({
+                .filepath = std::format("{}/tests/shaders/BufferView.cs.{}",
+                                        VexRootPath.string(),
+                                        GetShaderExtension(GetShaderCompilerBackend())),
+                .entryPoint = "CSMain",
+                .type = ShaderType::ComputeShader,
+                .defines = {
+                    { "CONSTANT_BUFFER", bufferType == "CONSTANT_BUFFER" ? "1" : "0" },
+                    { "STRUCTURED_BUFFER", bufferType == "STRUCTURED_BUFFER" ? "1" : "0" },
+                    { "BYTE_ADDRESS_BUFFER", bufferType == "BYTE_ADDRESS_BUFFER" ? "1" : "0" },
+                    { "READ_WRITE", readWrite },
+                },
+            });
+        }
+    }
+
+    ShaderCompiler batchedCompiler{ { .shaderIncludeDirectories = { VexRootPath / "shaders" },
+                                      .numShaderCompilationThreads = 4 } };
+    std::future<std::vector<std::pair<ShaderKey, std::string>>> errors =
+        batchedCompiler.CompileShadersFromFilepathAsync(keys);
+    ASSERT_TRUE(errors.get().empty());
+
+    for (const ShaderKey& key : keys)
+    {
+        ASSERT_FALSE(shaderCompiler.CompileShaderFromFilepath(key).has_value());
+
+        const Shader& batchedShader = *batchedCompiler.GetShader(key);
+        const Shader& serialShader = *shaderCompiler.GetShader(key);
+        EXPECT_TRUE(batchedShader.IsValid());
+        EXPECT_EQ(batchedShader.GetHash(), serialShader.GetHash());
+        EXPECT_TRUE(std::ranges::equal(batchedShader.GetBlob(), serialShader.GetBlob()));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(PerShaderCompilerBackend, ParallelShaderCompilationTest, ShaderCompilerBackendValues);
+
+} // namespace vex
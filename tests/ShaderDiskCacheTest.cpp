@@ -0,0 +1,75 @@
+#include "VexTest.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace vex
+{
+
+struct ShaderDiskCacheTest : VexPerShaderCompilerTest
+{
+};
+
+TEST_P(ShaderDiskCacheTest, ShaderIsLoadedFromDiskCache)
+{
+    const std::filesystem::path cacheDirectory =
+        std::filesystem::temp_directory_path() /
+        std::format("VexShaderDiskCacheTest_{}", magic_enum::enum_name(GetShaderCompilerBackend()));
+    std::filesystem::remove_all(cacheDirectory);
+
+    const ShaderCompilerSettings settings{
+        .shaderIncludeDirectories = { VexRootPath / "shaders" },
+        .enableShaderDiskCache = true,
+        .shaderDiskCacheDirectory = cacheDirectory,
+    };
+
+    const ShaderKey key{
+        .filepath = std::format("{}/tests/shaders/VertexInputLayoutTest.{}",
+                                VexRootPath.string(),
+                                GetShaderExtension(GetShaderCompilerBackend())),
+        .entryPoint = "VSMain",
+        .type = ShaderType::VertexShader,
+    };
+
+    // The first compiler populates the cache.
+    ShaderCompiler coldCompiler{ settings };
+    ASSERT_FALSE(coldCompiler.CompileShaderFromFilepath(key).has_value());
+    const Shader& coldShader = *coldCompiler.GetShader(key);
+
+    // Flip the last byte of the cached bytecode, the second compiler only sees it if it does not invoke the compiler.
+    const auto cacheEntry = std::filesystem::directory_iterator(cacheDirectory);
+    ASSERT_NE(cacheEntry, std::filesystem::directory_iterator{});
+    const std::filesystem::path cacheEntryPath = cacheEntry->path();
+    std::vector<char> entryData(std::filesystem::file_size(cacheEntryPath));
+    std::ifstream(cacheEntryPath, std::ios::binary)
+        .read(entryData.data(), static_cast<std::streamsize>(entryData.size()));
+    const std::span<const char> coldBlob{ reinterpret_cast<const char*>(coldShader.GetBlob().data()),
+                                          coldShader.GetBlob().size() };
+    const auto blobInEntry = std::ranges::search(entryData, coldBlob);
+    ASSERT_FALSE(blobInEntry.empty());
+    blobInEntry.back() = static_cast<char>(~blobInEntry.back());
+    std::ofstream(cacheEntryPath, std::ios::binary | std::ios::trunc)
+        .write(entryData.data(), static_cast<std::streamsize>(entryData.size()));
+
+    // The second compiler should obtain the (modified) result from the cache.
+    ShaderCompiler warmCompiler{ settings };
+    ASSERT_FALSE(warmCompiler.CompileShaderFromFilepath(key).has_value());
+
+    const Shader& warmShader = *warmCompiler.GetShader(key);
+    EXPECT_EQ(coldShader.GetHash(), warmShader.GetHash());
+    std::vector<char> expectedBlob{ coldBlob.begin(), coldBlob.end() };
+    expectedBlob.back() = static_cast<char>(~expectedBlob.back());
+    EXPECT_TRUE(std::ranges::equal(std::as_bytes(std::span{ expectedBlob }), warmShader.GetBlob()));
+    ASSERT_EQ(coldShader.GetReflection() != nullptr, warmShader.GetReflection() != nullptr);
+    if (coldShader.GetReflection())
+    {
+        EXPECT_EQ(*coldShader.GetReflection(), *warmShader.GetReflection());
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+INSTANTIATE_TEST_SUITE_P(PerShaderCompilerBackend, ShaderDiskCacheTest, ShaderCompilerBackendValues);
+
+} // namespace vex
@@ -0,0 +1,129 @@
+#include "VexTest.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace vex
+{
+
+TEST_F(VexTest, StreamingUploaderUploadsFromMultipleThreads)
+{
+    static constexpr u32 ThreadCount = 4;
+    static constexpr u32 FloatCount = 1024;
+
+    std::vector<Buffer> buffers;
+    for (u32 i = 0; i < ThreadCount; ++i)
+    {
+        buffers.push_back(graphics.CreateBuffer(
+            BufferDesc::CreateGenericBufferDesc(std::format("StreamedBuffer_{}", i), sizeof(float) * FloatCount)));
+    }
+
+    // A budget smaller than the uploads forces one batch per upload.
+    StreamingUploader uploader{ graphics, sizeof(float) * FloatCount };
+    std::vector<std::future<SyncToken>> futures(ThreadCount);
+    {
+        std::vector<std::jthread> threads;
+        for (u32 i = 0; i < ThreadCount; ++i)
+        {
+            threads.emplace_back(
+                [&, i]
+                {
+                    std::vector<float> values(FloatCount, static_cast<float>(i));
+                    std::vector<byte> data(sizeof(float) * FloatCount);
+                    std::memcpy(data.data(), values.data(), data.size());
+                    futures[i] = uploader.EnqueueUpload(buffers[i], std::move(data));
+                });
+        }
+    }
+
+    std::vector<SyncToken> tokens = uploader.FlushAll();
+    EXPECT_EQ(tokens.size(), ThreadCount);
+    EXPECT_EQ(uploader.GetPendingByteSize(), 0);
+
+    for (u32 i = 0; i < ThreadCount; ++i)
+    {
+        const SyncToken token = futures[i].get();
+        EXPECT_EQ(token.queueType, QueueType::Copy);
+
+        CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+        BufferReadbackContext readback = ctx.EnqueueDataReadback(buffers[i]);
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx, { &token, 1 }));
+
+        std::vector<float> readbackData(FloatCount);
+        readback.ReadData(std::as_writable_bytes(std::span{ readbackData }));
+        for (float value : readbackData)
+        {
+            ASSERT_EQ(value, static_cast<float>(i));
+        }
+    }
+
+    for (const Buffer& buffer : buffers)
+    {
+        graphics.DestroyBuffer(buffer);
+    }
+}
+
+TEST_F(VexTest, StreamingUploaderTextureUploadRespectsFrameBudget)
+{
+    static constexpr u32 Width = 32;
+    static constexpr u32 Height = 32;
+    static constexpr u64 TextureByteSize = Width * Height * sizeof(std::array<u8, 4>);
+
+    std::array<Texture, 2> textures;
+    for (u32 i = 0; i < textures.size(); ++i)
+    {
+        textures[i] = graphics.CreateTexture(TextureDesc::CreateTexture2DDesc(
+            std::format("StreamedTexture_{}", i), TextureFormat::RGBA8_UNORM, Width, Height, 1));
+    }
+
+    StreamingUploader uploader{ graphics, TextureByteSize };
+    std::array<std::future<SyncToken>, 2> futures;
+    for (u32 i = 0; i < textures.size(); ++i)
+    {
+        futures[i] = uploader.EnqueueUpload(textures[i], std::vector<byte>(TextureByteSize, static_cast<byte>(i + 1)));
+    }
+
+    // Only one texture fits in the budget of a frame. The worker thread records it in the background.
+    std::optional<SyncToken> firstToken = uploader.Flush();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!firstToken && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        firstToken = uploader.Flush();
+    }
+    ASSERT_TRUE(firstToken.has_value());
+    EXPECT_EQ(futures[0].get(), *firstToken);
+    EXPECT_EQ(uploader.GetPendingByteSize(), TextureByteSize);
+
+    std::vector<SyncToken> remainingTokens = uploader.FlushAll();
+    ASSERT_EQ(remainingTokens.size(), 1);
+    EXPECT_EQ(futures[1].get(), remainingTokens[0]);
+
+    for (u32 i = 0; i < textures.size(); ++i)
+    {
+        const SyncToken token = i == 0 ? *firstToken : remainingTokens[0];
+        CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+        TextureReadbackContext readback = ctx.EnqueueDataReadback(textures[i]);
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx, { &token, 1 }));
+
+        std::vector<byte> texels(readback.GetDataByteSize());
+        readback.ReadData(texels);
+        for (byte texel : texels)
+        {
+            ASSERT_EQ(texel, static_cast<byte>(i + 1));
+        }
+    }
+
+    for (const Texture& texture : textures)
+    {
+        graphics.DestroyTexture(texture);
+    }
+}
+
+} // namespace vex
@@ -1,8 +1,10 @@
 #include "VexTest.h"
 
 #include <cstddef>
+#include <optional>
 #include <random>
 #include <span>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -371,4 +373,281 @@ TEST_F(SynchronizationTest, FinalStressTest)
     }
 }
 
-} // namespace vex
\ No newline at end of file
+TEST_F(SynchronizationTest, ParallelCommandContextRecording)
+{
+    static constexpr u32 ThreadCount = 4;
+    static constexpr u32 FloatCount = 1024;
+
+    std::vector<std::optional<CommandContext>> recordedContexts(ThreadCount);
+    std::vector<std::optional<BufferReadbackContext>> readbackContexts(ThreadCount);
+
+    // Each thread records its own context, creating resources and uploading data concurrently.
+    {
+        std::vector<std::jthread> threads;
+        for (u32 threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+        {
+            threads.emplace_back(
+                [&, threadIndex]
+                {
+                    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+
+                    std::vector<float> data(FloatCount, static_cast<float>(threadIndex));
+                    Buffer source = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc(
+                        std::format("ParallelSource_{}", threadIndex), sizeof(float) * FloatCount));
+                    Buffer destination = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc(
+                        std::format("ParallelDestination_{}", threadIndex), sizeof(float) * FloatCount));
+
+                    ctx.EnqueueDataUpload(source, std::as_bytes(std::span(data)));
+                    ctx.Copy(source, destination);
+                    readbackContexts[threadIndex].emplace(ctx.EnqueueDataReadback(destination));
+
+                    // The context must be closed on its recording thread before the main thread submits it.
+                    ctx.Close();
+                    recordedContexts[threadIndex].emplace(std::move(ctx));
+                });
+        }
+    }
+
+    // The main thread submits all contexts at once.
+    std::vector<CommandContext> contexts;
+    for (std::optional<CommandContext>& ctx : recordedContexts)
+    {
+        contexts.push_back(std::move(*ctx));
+    }
+    for (const SyncToken& token : graphics.Submit(contexts))
+    {
+        graphics.WaitForTokenOnCPU(token);
+    }
+
+    for (u32 threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        std::vector<float> readback(FloatCount);
+        readbackContexts[threadIndex]->ReadData(std::as_writable_bytes(std::span(readback)));
+        for (float value : readback)
+        {
+            ASSERT_EQ(value, static_cast<float>(threadIndex));
+        }
+    }
+}
+
+TEST_F(SynchronizationTest, SplitBarrierOverlappingCopies)
+{
+    static constexpr u32 FloatCount = 1024;
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+
+    std::vector<float> data(FloatCount, 1.0f);
+    Buffer written =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("SplitBarrierWritten", sizeof(float) * FloatCount));
+    Buffer unrelated =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("SplitBarrierUnrelated", sizeof(float) * FloatCount));
+
+    // The transition of the written buffer overlaps with the unrelated upload, and ends upon its readback.
+    ctx.EnqueueDataUpload(written, std::as_bytes(std::span(data)));
+    ctx.BeginSplitBarrier(written, RHIBarrierSync::Copy, RHIBarrierAccess::CopySource);
+    ctx.EnqueueDataUpload(unrelated, std::as_bytes(std::span(data)));
+    BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(written);
+
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    std::vector<float> readback(FloatCount);
+    readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+    for (float value : readback)
+    {
+        ASSERT_EQ(value, 1.0f);
+    }
+}
+
+TEST_F(SynchronizationTest, TextureHandoffToComputeQueue)
+{
+    Texture texture = graphics.CreateTexture(
+        TextureDesc::CreateTexture2DDesc("HandoffTexture",
+                                         TextureFormat::RGBA8_UNORM,
+                                         64,
+                                         64,
+                                         1,
+                                         TextureUsage::RenderTarget,
+                                         TextureClearValue{ .color = { 0, 1, 0, 1 } }));
+
+    CommandContext graphicsCtx = graphics.CreateCommandContext(QueueType::Graphics);
+    graphicsCtx.ClearTexture(texture);
+    // The texture is left in the copy source layout, for the compute queue to use as is.
+    graphicsCtx.ReleaseToQueue(texture, QueueType::Compute, RHIBarrierAccess::CopySource);
+    SyncToken releaseToken = graphics.Submit(graphicsCtx);
+
+    CommandContext computeCtx = graphics.CreateCommandContext(QueueType::Compute);
+    computeCtx.AcquireFromQueue(texture, QueueType::Graphics, RHIBarrierAccess::CopySource);
+    TextureReadbackContext readbackContext = computeCtx.EnqueueDataReadback(texture);
+    graphics.WaitForTokenOnCPU(graphics.Submit(computeCtx, { &releaseToken, 1 }));
+
+    std::vector<std::array<u8, 4>> texels(readbackContext.GetDataByteSize() / sizeof(std::array<u8, 4>));
+    readbackContext.ReadData(std::as_writable_bytes(std::span(texels)));
+    for (const std::array<u8, 4>& texel : texels)
+    {
+        ASSERT_EQ(texel, (std::array<u8, 4>{ 0x00, 0xFF, 0x00, 0xFF }));
+    }
+
+    graphics.DestroyTexture(texture);
+}
+
+TEST_F(SynchronizationTest, TextureStateCarriesAcrossSubmissions)
+{
+    Texture texture = graphics.CreateTexture(
+        TextureDesc::CreateTexture2DDesc("CarriedTexture",
+                                         TextureFormat::RGBA8_UNORM,
+                                         64,
+                                         64,
+                                         1,
+                                         TextureUsage::RenderTarget,
+                                         TextureClearValue{ .color = { 1, 0, 1, 1 } }));
+
+    // The texture is left in the render target layout by the first submission.
+    CommandContext clearCtx = graphics.CreateCommandContext(QueueType::Graphics);
+    clearCtx.ClearTexture(texture);
+    SyncToken clearToken = graphics.Submit(clearCtx);
+
+    // The copy queue cannot transition out of the render target layout, the graphics queue does it beforehand.
+    CommandContext copyCtx = graphics.CreateCommandContext(QueueType::Copy);
+    TextureReadbackContext readbackContext = copyCtx.EnqueueDataReadback(texture);
+    graphics.WaitForTokenOnCPU(graphics.Submit(copyCtx, { &clearToken, 1 }));
+
+    std::vector<std::array<u8, 4>> texels(readbackContext.GetDataByteSize() / sizeof(std::array<u8, 4>));
+    readbackContext.ReadData(std::as_writable_bytes(std::span(texels)));
+    for (const std::array<u8, 4>& texel : texels)
+    {
+        ASSERT_EQ(texel, (std::array<u8, 4>{ 0xFF, 0x00, 0xFF, 0xFF }));
+    }
+
+    graphics.DestroyTexture(texture);
+}
+
+TEST_F(SynchronizationTest, SameQueueTextureWriteThenRead)
+{
+    Texture texture = graphics.CreateTexture(
+        TextureDesc::CreateTexture2DDesc("SameQueueTexture",
+                                         TextureFormat::RGBA8_UNORM,
+                                         64,
+                                         64,
+                                         1,
+                                         TextureUsage::RenderTarget,
+                                         TextureClearValue{ .color = { 0, 0, 1, 1 } }));
+
+    // Each submission starts from the state the previous one left the texture in, without any explicit dependency.
+    const auto ClearAndReadBack = [&](std::optional<TextureClearValue> clearValue)
+    {
+        CommandContext clearCtx = graphics.CreateCommandContext(QueueType::Graphics);
+        clearCtx.ClearTexture(texture, clearValue);
+        graphics.Submit(clearCtx);
+
+        CommandContext readbackCtx = graphics.CreateCommandContext(QueueType::Graphics);
+        TextureReadbackContext readbackContext = readbackCtx.EnqueueDataReadback(texture);
+        graphics.WaitForTokenOnCPU(graphics.Submit(readbackCtx));
+
+        std::vector<std::array<u8, 4>> texels(readbackContext.GetDataByteSize() / sizeof(std::array<u8, 4>));
+        readbackContext.ReadData(std::as_writable_bytes(std::span(texels)));
+        return texels;
+    };
+
+    for (const std::array<u8, 4>& texel : ClearAndReadBack(std::nullopt))
+    {
+        ASSERT_EQ(texel, (std::array<u8, 4>{ 0x00, 0x00, 0xFF, 0xFF }));
+    }
+    // Writing again after the read.
+    for (const std::array<u8, 4>& texel : ClearAndReadBack(TextureClearValue{ .color = { 1, 1, 0, 1 } }))
+    {
+        ASSERT_EQ(texel, (std::array<u8, 4>{ 0xFF, 0xFF, 0x00, 0xFF }));
+    }
+
+    graphics.DestroyTexture(texture);
+}
+
+TEST_F(SynchronizationTest, BufferStateCarriesAcrossSubmissions)
+{
+    static constexpr u32 FloatCount = 256;
+
+    Buffer source =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("CarriedBufferSource", sizeof(float) * FloatCount));
+    Buffer destination = graphics.CreateBuffer(
+        BufferDesc::CreateGenericBufferDesc("CarriedBufferDestination", sizeof(float) * FloatCount));
+
+    // The submissions are only ordered by the queue, the state of the buffers each one leaves behind is what the next
+    // one transitions from.
+    const auto UploadAndCopy = [&](float value)
+    {
+        std::vector<float> data(FloatCount, value);
+        CommandContext uploadCtx = graphics.CreateCommandContext(QueueType::Graphics);
+        uploadCtx.EnqueueDataUpload(source, std::as_bytes(std::span(data)));
+        graphics.Submit(uploadCtx);
+
+        CommandContext copyCtx = graphics.CreateCommandContext(QueueType::Graphics);
+        copyCtx.Copy(source, destination);
+        BufferReadbackContext readbackContext = copyCtx.EnqueueDataReadback(destination);
+        graphics.WaitForTokenOnCPU(graphics.Submit(copyCtx));
+
+        std::vector<float> readback(FloatCount);
+        readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+        return readback;
+    };
+
+    // Left as a copy destination by the upload, then as a copy source by the copy before being written again.
+    EXPECT_EQ(UploadAndCopy(1.0f), std::vector<float>(FloatCount, 1.0f));
+    EXPECT_EQ(UploadAndCopy(2.0f), std::vector<float>(FloatCount, 2.0f));
+
+    graphics.DestroyBuffer(source);
+    graphics.DestroyBuffer(destination);
+}
+
+TEST_F(SynchronizationTest, RedundantBufferBarriersAreSkipped)
+{
+    static constexpr u32 FloatCount = 256;
+
+    Buffer source =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("SkippedBarrierSource", sizeof(float) * FloatCount));
+    Buffer firstDestination =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("SkippedBarrierFirst", sizeof(float) * FloatCount));
+    Buffer secondDestination =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("SkippedBarrierSecond", sizeof(float) * FloatCount));
+
+    // First accesses are resolved upon submission, and reading the source again as a copy source needs no barrier.
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    ctx.Copy(source, firstDestination);
+    ctx.Copy(source, secondDestination);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    EXPECT_EQ(ctx.GetEmittedBufferBarrierCount(), 0u);
+
+    graphics.DestroyBuffer(source);
+    graphics.DestroyBuffer(firstDestination);
+    graphics.DestroyBuffer(secondDestination);
+}
+
+TEST_F(SynchronizationTest, ExplicitBufferBarriersAreAlwaysEmitted)
+{
+    static constexpr u32 FloatCount = 256;
+
+    std::vector<float> data(FloatCount, 2.0f);
+    Buffer buffer =
+        graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("ExplicitBarrierBuffer", sizeof(float) * FloatCount));
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    // Untracked until now, the barrier must still be emitted.
+    ctx.Barrier(buffer, RHIBarrierAccess::CopyDest);
+    ctx.EnqueueDataUpload(buffer, std::as_bytes(std::span(data)));
+    // Following a tracked access, emitted as well.
+    ctx.Barrier(buffer, RHIBarrierAccess::CopySource);
+    BufferReadbackContext readbackContext = ctx.EnqueueDataReadback(buffer);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    EXPECT_GE(ctx.GetEmittedBufferBarrierCount(), 2u);
+
+    std::vector<float> readback(FloatCount);
+    readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+    for (float value : readback)
+    {
+        ASSERT_EQ(value, 2.0f);
+    }
+
+    graphics.DestroyBuffer(buffer);
+}
+
+} // namespace vex
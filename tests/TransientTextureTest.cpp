@@ -0,0 +1,42 @@
+#include "VexTest.h"
+
+#include <gtest/gtest.h>
+
+namespace vex
+{
+
+TEST_F(VexTest, TransientTextureReleasedMemoryIsReused)
+{
+    Texture result = graphics.CreateTexture(CreateRenderTargetDesc("Result", { 0, 0, 0, 0 }));
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+
+    Texture first = ctx.CreateTransientTexture(CreateRenderTargetDesc("First", { 1, 0, 0, 1 }));
+    ctx.ClearTexture(first);
+    ctx.Copy(first, result);
+    ctx.ReleaseTransientTexture(first);
+
+    // Placed over the memory of the first texture, which must have been copied before being overwritten.
+    Texture second = ctx.CreateTransientTexture(CreateRenderTargetDesc("Second", { 0, 1, 0, 1 }));
+    ctx.ClearTexture(second);
+
+#if VEX_USE_CUSTOM_RESOURCE_ALLOCATOR
+    const RHIAccessor accessor{ graphics };
+    const Allocation& firstAllocation = accessor.GetTexture(first).GetAllocation();
+    const Allocation& secondAllocation = accessor.GetTexture(second).GetAllocation();
+    EXPECT_EQ(firstAllocation.memoryTypeIndex, secondAllocation.memoryTypeIndex);
+    EXPECT_EQ(firstAllocation.pageHandle, secondAllocation.pageHandle);
+    EXPECT_EQ(firstAllocation.memoryRange, secondAllocation.memoryRange);
+#endif
+
+    TextureReadbackContext resultReadback = ctx.EnqueueDataReadback(result);
+    TextureReadbackContext secondReadback = ctx.EnqueueDataReadback(second);
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    EXPECT_TRUE(ValidateTextureValue(resultReadback, std::array<u8, 4>{ 0xFF, 0x00, 0x00, 0xFF }));
+    EXPECT_TRUE(ValidateTextureValue(secondReadback, std::array<u8, 4>{ 0x00, 0xFF, 0x00, 0xFF }));
+
+    graphics.DestroyTexture(result);
+}
+
+} // namespace vex
@@ -1,6 +1,7 @@
 ﻿#include "VexTest.h"
 
 #include <array>
+#include <numeric>
 
 #include <gtest/gtest.h>
 
@@ -9,6 +10,7 @@
 #include <Vex/Graphics.h>
 #include <Vex/Logger.h>
 #include <Vex/Types.h>
+#include <Vex/RHIImpl/RHIDescriptorPool.h>
 
 namespace vex
 {
@@ -433,6 +435,189 @@ TEST_P(BufferUploadReadbackTests, BufferUploadAndFullReadback)
     }
 }
 
+struct StagingUploadTests : public VexPerQueueTest
+{
+};
+
+TEST_P(StagingUploadTests, ManySmallBufferUploads)
+{
+    static constexpr u32 UploadCount = 256;
+    static constexpr u32 FloatsPerUpload = 4;
+
+    Buffer buffer = graphics.CreateBuffer(
+        BufferDesc::CreateGenericBufferDesc("GPUBuffer", sizeof(float) * FloatsPerUpload * UploadCount));
+
+    // The second round reuses the staging pages recycled from the first submission.
+    for (u32 round = 0; round < 2; ++round)
+    {
+        CommandContext ctx = graphics.CreateCommandContext(GetParam());
+
+        std::array<float, FloatsPerUpload> data;
+        for (u32 i = 0; i < UploadCount; ++i)
+        {
+            data.fill(static_cast<float>(round * UploadCount + i));
+            ctx.EnqueueDataUpload(buffer,
+                                  std::as_bytes(std::span(data)),
+                                  BufferRegion{ .offset = sizeof(data) * i, .byteSize = sizeof(data) });
+        }
+
+        auto readbackContext = ctx.EnqueueDataReadback(buffer);
+
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+        std::vector<float> readback(FloatsPerUpload * UploadCount);
+        readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+
+        for (u32 i = 0; i < readback.size(); ++i)
+        {
+            ASSERT_EQ(readback[i], static_cast<float>(round * UploadCount + i / FloatsPerUpload));
+        }
+    }
+}
+
+struct DynamicResourceTests : public VexPerQueueTest
+{
+};
+
+TEST_P(DynamicResourceTests, UploadReadbackAcrossFrames)
+{
+    static constexpr u32 FloatCount = 64;
+    static constexpr u32 FrameCount = 4;
+
+    // Each frame allocates its buffers from memory and descriptors recycled from the previous frames.
+    for (u32 frame = 0; frame < FrameCount; ++frame)
+    {
+        std::array<Buffer, 2> buffers;
+        for (u32 i = 0; i < buffers.size(); ++i)
+        {
+            buffers[i] = graphics.CreateBuffer(
+                BufferDesc::CreateGenericBufferDesc(std::format("DynamicBuffer_{}_{}", frame, i),
+                                                    sizeof(float) * FloatCount),
+                ResourceLifetime::Dynamic);
+        }
+
+        CommandContext ctx = graphics.CreateCommandContext(GetParam());
+
+        std::array<float, FloatCount> data;
+        data.fill(static_cast<float>(frame));
+        ctx.EnqueueDataUpload(buffers[0], std::as_bytes(std::span(data)));
+        ctx.Copy(buffers[0], buffers[1]);
+
+        auto readbackContext = ctx.EnqueueDataReadback(buffers[1]);
+
+        graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+        graphics.EndFrame();
+
+        std::array<float, FloatCount> readback;
+        readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+        ASSERT_EQ(readback, data);
+    }
+}
+
+TEST_F(VexTest, DynamicBindlessHandlesAreInvalidatedOnceFreed)
+{
+    const RHIAccessor accessor{ graphics };
+    Buffer buffer = graphics.CreateBuffer(BufferDesc{ .name = "DynamicBindlessBuffer",
+                                                      .byteSize = sizeof(float),
+                                                      .usage = BufferUsage::ShaderRead },
+                                          ResourceLifetime::Dynamic);
+    const BindlessHandle handle =
+        graphics.GetBindlessHandle(BufferBinding::CreateStructuredBuffer(buffer, sizeof(float)));
+    EXPECT_TRUE(accessor.GetDescriptorPool().IsValid(handle));
+
+    // The descriptor slot is freed with the frame, the next handle allocated in it must not compare equal.
+    graphics.EndFrame();
+    graphics.FlushGPU();
+    EXPECT_FALSE(accessor.GetDescriptorPool().IsValid(handle));
+}
+
+TEST_F(VexTest, DefragmentationMovedBufferKeepsItsContentsAndBindlessHandle)
+{
+    static constexpr u64 MB = 1024 * 1024;
+    static constexpr u32 FloatCount = 1024;
+
+    // Fills a first page, forcing the buffer into a second page which ends up mostly empty once the other resources of
+    // that page are destroyed.
+    Buffer fillerA = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("FillerA", 200 * MB));
+    Buffer fillerB = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("FillerB", 54 * MB));
+    Buffer buffer = graphics.CreateBuffer(BufferDesc{ .name = "MovedBuffer",
+                                                      .byteSize = 4 * MB,
+                                                      .usage = BufferUsage::ShaderRead });
+    Buffer fillerC = graphics.CreateBuffer(BufferDesc::CreateGenericBufferDesc("FillerC", 100 * MB));
+
+    std::array<float, FloatCount> data;
+    std::iota(data.begin(), data.end(), 0.0f);
+    {
+        CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+        ctx.EnqueueDataUpload(buffer, std::as_bytes(std::span(data)), BufferRegion{ .byteSize = sizeof(data) });
+        graphics.Submit(ctx);
+    }
+    const BufferBinding binding{ .buffer = buffer, .usage = BufferBindingUsage::ByteAddressBuffer };
+    const BindlessHandle handle = graphics.GetBindlessHandle(binding);
+
+    graphics.DestroyBuffer(fillerB);
+    graphics.DestroyBuffer(fillerC);
+    graphics.FlushGPU();
+
+    EXPECT_GT(graphics.DefragmentMemory(~0ull), 0);
+    EXPECT_EQ(graphics.GetBindlessHandle(binding), handle);
+
+    // Sums the buffer's contents in a shader which only accesses it through its (unchanged) bindless handle.
+    using Element = std::array<float, 3>;
+    static constexpr u32 ElementCount = FloatCount / 3;
+    Buffer resultBuffer =
+        graphics.CreateBuffer(BufferDesc{ .name = "DefragmentationResultBuffer",
+                                          .byteSize = sizeof(Element),
+                                          .usage = BufferUsage::ShaderRead | BufferUsage::ShaderReadWrite });
+    const BufferBinding resultBinding = BufferBinding::CreateRWStructuredBuffer(resultBuffer, sizeof(Element));
+    struct ShaderUniform
+    {
+        BindlessHandle inputBuffer;
+        BindlessHandle outputBuffer;
+        u32 numElements{};
+    } uniforms{ handle, graphics.GetBindlessHandle(resultBinding), ElementCount };
+    const ShaderKey key{
+        .filepath = (VexRootPath / "tests/shaders/BufferView.cs.hlsl").string(),
+        .entryPoint = "CSMain",
+        .type = ShaderType::ComputeShader,
+        .defines = {
+            { "CONSTANT_BUFFER", "0" },
+            { "STRUCTURED_BUFFER", "0" },
+            { "BYTE_ADDRESS_BUFFER", "1" },
+            { "READ_WRITE", "0" },
+        },
+    };
+
+    CommandContext ctx = graphics.CreateCommandContext(QueueType::Graphics);
+    static constexpr Element Zeroes{};
+    ctx.EnqueueDataUpload(resultBuffer, std::as_bytes(std::span{ Zeroes }));
+    const std::array<ResourceBinding, 2> bindings{ binding, resultBinding };
+    EXPECT_TRUE(ctx.Dispatch(shaderCompiler.GetShaderView(key),
+                             ConstantBinding(std::span{ &uniforms, 1 }),
+                             bindings,
+                             { 1u, 1u, 1u }));
+    auto resultReadbackContext = ctx.EnqueueDataReadback(resultBuffer);
+    auto readbackContext = ctx.EnqueueDataReadback(buffer, BufferRegion{ .byteSize = sizeof(data) });
+    graphics.WaitForTokenOnCPU(graphics.Submit(ctx));
+
+    std::array<float, FloatCount> readback;
+    readbackContext.ReadData(std::as_writable_bytes(std::span(readback)));
+    EXPECT_EQ(readback, data);
+
+    Element expectedResult{};
+    for (u32 i = 0; i < ElementCount * 3; ++i)
+    {
+        expectedResult[i % 3] += data[i];
+    }
+    Element result{};
+    resultReadbackContext.ReadData(std::as_writable_bytes(std::span{ result }));
+    EXPECT_EQ(result, expectedResult);
+
+    graphics.DestroyBuffer(fillerA);
+    graphics.DestroyBuffer(buffer);
+    graphics.DestroyBuffer(resultBuffer);
+}
+
 INSTANTIATE_TEST_SUITE_P(VariousSizes,
                          FixedSizeTexture2DTest,
                          testing::Values(Texture2DTestParam{ 256, 256 }, Texture2DTestParam{ 546, 627 }));
@@ -458,6 +643,10 @@ INSTANTIATE_PER_QUEUE_TEST_SUITE_P(
             .uploadRegion = { .offset = sizeof(float) * 23, .byteSize = sizeof(float) * 50 },
             .readbackRegion = { .offset = sizeof(float) * 32, .byteSize = sizeof(float) * 10 } }));
 
+INSTANTIATE_TEST_SUITE_P(PerQueueType, StagingUploadTests, QueueTypeValue);
+
+INSTANTIATE_TEST_SUITE_P(PerQueueType, DynamicResourceTests, QueueTypeValue);
+
 struct ScalarBlockLayoutTests : public VexTestParam<ShaderCompilerBackend>
 {
     struct WeirdlyPackedData
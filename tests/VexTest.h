@@ -31,11 +31,15 @@ struct VexTestParam : testing::TestWithParam<ParamT>
     Graphics graphics;
     ShaderCompiler shaderCompiler;
     VexTestParam()
-        : graphics{ GraphicsCreateDesc{
+        : VexTestParam(GraphicsCreateDesc{
               .useSwapChain = false,
               .enableGPUDebugLayer = VEX_DEBUG,
               .enableGPUBasedValidation = VEX_DEBUG,
-          } }
+          })
+    {
+    }
+    explicit VexTestParam(const GraphicsCreateDesc& graphicsDesc)
+        : graphics{ graphicsDesc }
         , shaderCompiler({ .shaderIncludeDirectories = { VexRootPath / "shaders" } })
     {
         GLogger.SetLogLevelFilter(Warning);
@@ -84,6 +88,28 @@ protected:
     }
 };
 
+// Returns whether every texel read back by the context is equal to expectedValue.
+template <class T>
+bool ValidateTextureValue(const TextureReadbackContext& ctx, T expectedValue)
+{
+    std::vector<T> texels;
+    texels.resize(ctx.GetDataByteSize() / sizeof(T));
+    ctx.ReadData(std::as_writable_bytes(std::span{ texels }));
+    return std::ranges::all_of(texels, [&](auto v) { return v == expectedValue; });
+}
+
+// Square RGBA8 render target, cleared to clearColor by ClearTexture.
+inline TextureDesc CreateRenderTargetDesc(std::string name, std::array<float, 4> clearColor, u32 size = 64)
+{
+    return TextureDesc::CreateTexture2DDesc(std::move(name),
+                                            TextureFormat::RGBA8_UNORM,
+                                            size,
+                                            size,
+                                            1,
+                                            TextureUsage::RenderTarget,
+                                            TextureClearValue{ .color = clearColor });
+}
+
 const auto ShaderCompilerBackendValues = testing::Values(ShaderCompilerBackend::DXC, ShaderCompilerBackend::Slang);
 
 inline std::string_view GetShaderExtension(ShaderCompilerBackend backend)
@@ -0,0 +1,20 @@
+// Fullscreen triangle covering the render target in green, used to check that indirect draws are executed.
+
+struct VSOutput
+{
+    float4 position : SV_POSITION;
+};
+
+VSOutput VSMain(uint vertexID : SV_VertexID)
+{
+    const float2 uv = float2((vertexID << 1) & 2, vertexID & 2);
+
+    VSOutput output;
+    output.position = float4(uv * float2(2, -2) + float2(-1, 1), 0, 1);
+    return output;
+}
+
+float4 PSMain(VSOutput input) : SV_Target
+{
+    return float4(0, 1, 0, 1);
+}